@@ -0,0 +1,93 @@
+#[=======================================================================[.rst:
+----
+
+Finds or fetches the meshoptimizer library.
+If USD_FILEFORMATS_FORCE_FETCHCONTENT or USD_FILEFORMATS_FETCH_MESHOPT are
+TRUE, meshoptimizer will be fetched. Otherwise it will be searched via find
+commands. The search is hinted to look into pxr_ROOT, but can be overriden by
+setting meshoptimizer_ROOT.
+
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+This module provides the following imported targets, if found or fetched:
+
+``meshoptimizer::meshoptimizer``
+  The meshoptimizer library
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+This will define the following variables:
+
+``meshoptimizer_FOUND``
+  True if the system has the meshoptimizer library.
+
+Cache Variables
+^^^^^^^^^^^^^^^
+
+The following cache variables may also be set:
+
+``meshoptimizer_INCLUDE_DIR``
+  The directory containing ``meshoptimizer.h``.
+``meshoptimizer_LIBRARY``
+  The path to the meshoptimizer library.
+
+#]=======================================================================]
+
+if (TARGET meshoptimizer::meshoptimizer)
+    return()
+endif()
+
+
+if(USD_FILEFORMATS_FORCE_FETCHCONTENT OR USD_FILEFORMATS_FETCH_MESHOPT)
+    message(STATUS "Fetching meshoptimizer")
+    include(CPM)
+    CPMAddPackage(
+        NAME meshoptimizer
+        GIT_REPOSITORY "https://github.com/zeux/meshoptimizer.git"
+        GIT_TAG        "v0.22"
+    )
+    set_property(TARGET meshoptimizer PROPERTY POSITION_INDEPENDENT_CODE ON)
+    add_library(meshoptimizer::meshoptimizer ALIAS meshoptimizer)
+    set(meshoptimizer_FOUND TRUE)
+else()
+    include(SelectLibraryConfigurations)
+    include(FindPackageHandleStandardArgs)
+
+    find_path(meshoptimizer_INCLUDE_DIR
+        HINTS ${pxr_ROOT}/include
+        NAMES meshoptimizer.h
+    )
+
+    find_library(meshoptimizer_LIBRARY_DEBUG
+        HINTS ${pxr_ROOT}/lib
+        NAMES meshoptimizerd meshoptimizer
+    )
+
+    find_library(meshoptimizer_LIBRARY_RELEASE
+        HINTS ${pxr_ROOT}/lib
+        NAMES meshoptimizer
+    )
+
+    select_library_configurations(meshoptimizer)
+    find_package_handle_standard_args(meshoptimizer
+        REQUIRED_VARS meshoptimizer_INCLUDE_DIR meshoptimizer_LIBRARIES
+    )
+
+    if(meshoptimizer_FOUND)
+        add_library(meshoptimizer::meshoptimizer STATIC IMPORTED)
+        set_target_properties(meshoptimizer::meshoptimizer PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${meshoptimizer_INCLUDE_DIR}")
+        if (meshoptimizer_LIBRARY_DEBUG)
+            set_property(TARGET meshoptimizer::meshoptimizer        PROPERTY IMPORTED_LOCATION_DEBUG ${meshoptimizer_LIBRARY_DEBUG})
+            set_property(TARGET meshoptimizer::meshoptimizer APPEND PROPERTY IMPORTED_CONFIGURATIONS "Debug")
+        endif()
+        if (meshoptimizer_LIBRARY_RELEASE)
+            set_property(TARGET meshoptimizer::meshoptimizer        PROPERTY IMPORTED_LOCATION_RELEASE ${meshoptimizer_LIBRARY_RELEASE})
+            set_property(TARGET meshoptimizer::meshoptimizer APPEND PROPERTY IMPORTED_CONFIGURATIONS   "Release")
+        endif()
+    elseif(${meshoptimizer_FIND_REQUIRED})
+        message(FATAL_ERROR "Could not find meshoptimizer")
+    endif()
+endif()
@@ -250,8 +250,14 @@ UsdGltfFileFormat::WriteToFile(const SdfLayer& layer,
     bool binary = "glb" == TfGetExtension(filename);
     bool embedImages = true;
     bool useMaterialExtensions = true;
+    bool quantize = false;
+    bool meshopt = false;
+    bool gpuInstancing = false;
     argReadBool(args, "embedImages", embedImages, DEBUG_TAG);
     argReadBool(args, "useMaterialExtensions", useMaterialExtensions, DEBUG_TAG);
+    argReadBool(args, "quantize", quantize, DEBUG_TAG);
+    argReadBool(args, "meshopt", meshopt, DEBUG_TAG);
+    argReadBool(args, "gpuInstancing", gpuInstancing, DEBUG_TAG);
 
     ReadLayerOptions options;
     options.triangulate = true;
@@ -262,6 +268,11 @@ UsdGltfFileFormat::WriteToFile(const SdfLayer& layer,
     // glTF doesn't support invisible primitives, so we filter them out here
     options.ignoreInvisible = true;
 
+    // Point instancers are exported with EXT_mesh_gpu_instancing, rather than a node per instance.
+    // The extension is required, hence this is opt in, so that viewers without it can still load
+    // the output by default.
+    options.pointInstancers = gpuInstancing;
+
     UsdData usd;
     GUARD(readLayer(options, layer, usd, DEBUG_TAG), "Error reading USD file\n");
 
@@ -269,12 +280,15 @@ UsdGltfFileFormat::WriteToFile(const SdfLayer& layer,
     exportOptions.binary = binary;
     exportOptions.embedImages = embedImages;
     exportOptions.useMaterialExtensions = useMaterialExtensions;
+    exportOptions.quantize = quantize;
+    exportOptions.meshopt = meshopt;
     tinygltf::Model gltf;
-    GUARD(exportGltf(exportOptions, usd, gltf), "Error translating USD to glTF\n");
+    BufferReferences references;
+    GUARD(exportGltf(exportOptions, usd, gltf, references), "Error translating USD to glTF\n");
 
     WriteGltfOptions writeOptions;
     writeOptions.embedImages = embedImages;
-    GUARD(writeGltf(writeOptions, gltf, filename), "Error writing glTF file\n");
+    GUARD(writeGltf(writeOptions, gltf, references, filename), "Error writing glTF file\n");
 
     w.Stop();
     TF_DEBUG_MSG(FILE_FORMAT_GLTF, "Total time: %ld\n", static_cast<long int>(w.GetMilliseconds()));
@@ -11,8 +11,13 @@ governing permissions and limitations under the License.
 */
 #include "gltf.h"
 #include "debugCodes.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <type_traits>
 #include <fileformatutils/common.h>
 #include <fileformatutils/neuralAssetsHelper.h>
 #include <pxr/base/tf/fileUtils.h>
@@ -27,6 +32,13 @@ governing permissions and limitations under the License.
 #include <pxr/usd/usdSkel/utils.h>
 #include <tiny_gltf.h>
 
+#ifdef USDGLTF_ENABLE_MESHOPT
+#include <atomic>
+#include <meshoptimizer.h>
+#include <pxr/base/work/loops.h>
+#include <string_view>
+#endif
+
 // Defined in IMPLEMENTATION sector in tinygltf.h but needed here
 namespace tinygltf {
 std::string
@@ -41,13 +53,131 @@ namespace {
 const std::string base64Prefix = "data:application/octet-stream;base64,";
 }
 
-tinygltf::Buffer&
-getBuffer(tinygltf::Model* gltf)
+// Adds a bufferView with a buffer of its own for its data. Exported bufferViews are kept in
+// separate buffers, so that no single buffer is grown and copied again as the export proceeds, and
+// their sizes are not limited to 2 GB. They are only laid out into one buffer when written. The
+// buffer is left empty if `data` is null, for data that is referenced rather than copied.
+int
+addBufferView(tinygltf::Model* gltf,
+              const std::string& name,
+              size_t byteLength,
+              size_t byteStride,
+              int target,
+              uint8_t** data)
+{
+    tinygltf::BufferView bufferView;
+    bufferView.name = name;
+    bufferView.buffer = gltf->buffers.size();
+    bufferView.byteOffset = 0;
+    bufferView.byteLength = byteLength;
+    bufferView.byteStride = byteStride;
+    bufferView.target = target;
+    gltf->buffers.push_back(tinygltf::Buffer());
+    if (data) {
+        gltf->buffers.back().data.resize(byteLength);
+        *data = gltf->buffers.back().data.data();
+    }
+    int bufferViewIndex = gltf->bufferViews.size();
+    gltf->bufferViews.push_back(bufferView);
+    return bufferViewIndex;
+}
+
+const uint8_t*
+getBufferData(const tinygltf::Model& gltf,
+              const BufferReferences& references,
+              int bufferIndex,
+              size_t& size)
 {
-    if (gltf->buffers.empty()) {
-        gltf->buffers.push_back(tinygltf::Buffer());
+    auto it = references.find(bufferIndex);
+    if (it != references.end()) {
+        size = it->second.size;
+        return it->second.data;
+    }
+    const std::vector<unsigned char>& data = gltf.buffers[bufferIndex].data;
+    size = data.size();
+    return data.data();
+}
+
+namespace {
+// Fallback buffers of EXT_meshopt_compression hold no data, since the bufferViews in them are only
+// read once decoded. They are written with their byte length only.
+bool
+isMeshoptFallbackBuffer(const tinygltf::Buffer& buffer)
+{
+    auto it = buffer.extensions.find("EXT_meshopt_compression");
+    if (it == buffer.extensions.end()) {
+        return false;
+    }
+    const tinygltf::Value& fallback = it->second.Get("fallback");
+    return fallback.IsBool() && fallback.Get<bool>();
+}
+
+// The JSON of a fallback buffer, whose byte length is the end of the last bufferView in it
+nlohmann::json
+meshoptFallbackBufferJson(const tinygltf::Model& gltf, int bufferIndex)
+{
+    size_t byteLength = 0;
+    for (const tinygltf::BufferView& bufferView : gltf.bufferViews) {
+        if (bufferView.buffer == bufferIndex) {
+            byteLength = std::max(byteLength, bufferView.byteOffset + bufferView.byteLength);
+        }
+    }
+    nlohmann::json buffer;
+    buffer["byteLength"] = byteLength;
+    buffer["extensions"]["EXT_meshopt_compression"]["fallback"] = true;
+    return buffer;
+}
+}
+
+// Computes the offsets of the buffers when they are laid out one after the other, each starting on
+// a 4 byte boundary, and returns the total byte length. The fallback buffers are not laid out.
+// `indices` holds the index of each buffer in the written file, which is 0 for the laid out
+// buffers, followed by the fallback buffers.
+size_t
+layoutBuffers(const tinygltf::Model& gltf,
+              const BufferReferences& references,
+              std::vector<size_t>& offsets,
+              std::vector<int>& indices)
+{
+    size_t byteLength = 0;
+    int numFallbackBuffers = 0;
+    offsets.assign(gltf.buffers.size(), 0);
+    indices.assign(gltf.buffers.size(), 0);
+    for (size_t i = 0; i < gltf.buffers.size(); i++) {
+        if (isMeshoptFallbackBuffer(gltf.buffers[i])) {
+            indices[i] = ++numFallbackBuffers;
+            continue;
+        }
+        byteLength = (byteLength + 3) / 4 * 4;
+        offsets[i] = byteLength;
+        size_t size = 0;
+        getBufferData(gltf, references, static_cast<int>(i), size);
+        byteLength += size;
+    }
+    return byteLength;
+}
+
+// Points the bufferViews at their data in the buffers laid out by layoutBuffers
+void
+rebaseBufferViews(tinygltf::Model& gltf,
+                  const std::vector<size_t>& offsets,
+                  const std::vector<int>& indices)
+{
+    for (tinygltf::BufferView& bufferView : gltf.bufferViews) {
+        if (bufferView.buffer >= 0 && static_cast<size_t>(bufferView.buffer) < offsets.size()) {
+            bufferView.byteOffset += offsets[bufferView.buffer];
+            bufferView.buffer = indices[bufferView.buffer];
+        }
+        // The compressed data of EXT_meshopt_compression is in a buffer of its own as well
+        auto it = bufferView.extensions.find("EXT_meshopt_compression");
+        if (it != bufferView.extensions.end()) {
+            const tinygltf::Value& buffer = it->second.Get("buffer");
+            const int bufferIndex = buffer.IsNumber() ? buffer.GetNumberAsInt() : -1;
+            if (bufferIndex >= 0 && static_cast<size_t>(bufferIndex) < offsets.size()) {
+                rebaseMeshoptCompression(it->second, indices[bufferIndex], offsets[bufferIndex]);
+            }
+        }
     }
-    return gltf->buffers.back();
 }
 
 const tinygltf::Image*
@@ -180,6 +310,241 @@ preValidateGLB(const unsigned char* buffer, size_t bufferSize)
     return true;
 }
 
+#ifdef USDGLTF_ENABLE_MESHOPT
+namespace {
+bool
+isMeshoptFallbackBuffer(const nlohmann::json& buffer)
+{
+    auto extensions = buffer.find("extensions");
+    if (extensions == buffer.end() || !extensions->is_object()) {
+        return false;
+    }
+    auto ext = extensions->find("EXT_meshopt_compression");
+    if (ext == extensions->end() || !ext->is_object()) {
+        return false;
+    }
+    auto fallback = ext->find("fallback");
+    return fallback != ext->end() && fallback->is_boolean() && fallback->get<bool>();
+}
+
+// The strides and counts that the meshopt decoders accept for each mode and filter
+bool
+isValidMeshoptLayout(const std::string& mode,
+                     const std::string& filter,
+                     size_t byteStride,
+                     size_t count)
+{
+    if (mode == "ATTRIBUTES") {
+        if (byteStride % 4 != 0 || byteStride > 256) {
+            return false;
+        }
+        if (filter == "OCTAHEDRAL") {
+            return byteStride == 4 || byteStride == 8;
+        } else if (filter == "QUATERNION") {
+            return byteStride == 8;
+        }
+        return filter == "NONE" || filter == "EXPONENTIAL";
+    } else if (mode == "TRIANGLES") {
+        return (byteStride == 2 || byteStride == 4) && count % 3 == 0;
+    } else if (mode == "INDICES") {
+        return byteStride == 2 || byteStride == 4;
+    }
+    return false;
+}
+}
+
+// Fallback buffers of EXT_meshopt_compression have no uri, since their data only exists once the
+// compressed bufferViews are decoded. tinygltf can't load such buffers, so they are replaced by
+// empty data URIs in a copy of the file. Returns false if the file needs no patching.
+bool
+patchMeshoptFallbackBuffers(bool isAscii,
+                            const char* buffer,
+                            size_t bufferSize,
+                            std::vector<char>& patchedBuffer)
+{
+    const char* jsonData = buffer;
+    size_t jsonSize = bufferSize;
+    if (!isAscii) {
+        // The JSON chunk directly follows the 12 byte GLB header
+        uint32_t chunkLength = 0;
+        if (bufferSize < 20) {
+            return false;
+        }
+        memcpy(&chunkLength, buffer + 12, sizeof(chunkLength));
+        if (chunkLength > bufferSize - 20) {
+            return false;
+        }
+        jsonData = buffer + 20;
+        jsonSize = chunkLength;
+    }
+    if (std::string_view(jsonData, jsonSize).find("EXT_meshopt_compression") ==
+        std::string_view::npos) {
+        return false;
+    }
+
+    nlohmann::json json = nlohmann::json::parse(jsonData, jsonData + jsonSize, nullptr, false);
+    if (json.is_discarded() || !json.contains("buffers") || !json["buffers"].is_array()) {
+        return false;
+    }
+    bool patched = false;
+    for (nlohmann::json& gbuffer : json["buffers"]) {
+        if (gbuffer.is_object() && !gbuffer.contains("uri") && isMeshoptFallbackBuffer(gbuffer)) {
+            gbuffer["uri"] = "data:application/octet-stream;base64,";
+            gbuffer["byteLength"] = 0;
+            patched = true;
+        }
+    }
+    if (!patched) {
+        return false;
+    }
+
+    std::string text = json.dump();
+    if (isAscii) {
+        patchedBuffer.assign(text.begin(), text.end());
+        return true;
+    }
+    // Rebuild the GLB with the patched JSON chunk, padded with spaces, and the original chunks
+    // that follow it
+    text.resize((text.size() + 3) / 4 * 4, ' ');
+    const size_t restSize = bufferSize - 20 - jsonSize;
+    patchedBuffer.resize(20 + text.size() + restSize);
+    const uint32_t totalLength = static_cast<uint32_t>(patchedBuffer.size());
+    const uint32_t chunkLength = static_cast<uint32_t>(text.size());
+    memcpy(patchedBuffer.data(), buffer, 8);
+    memcpy(patchedBuffer.data() + 8, &totalLength, sizeof(totalLength));
+    memcpy(patchedBuffer.data() + 12, &chunkLength, sizeof(chunkLength));
+    memcpy(patchedBuffer.data() + 16, buffer + 16, 4);
+    memcpy(patchedBuffer.data() + 20, text.data(), text.size());
+    memcpy(patchedBuffer.data() + 20 + text.size(), jsonData + jsonSize, restSize);
+    return true;
+}
+
+bool
+decodeMeshoptBufferViews(tinygltf::Model& gltf)
+{
+    struct CompressedView
+    {
+        int bufferView;
+        const uint8_t* data;
+        size_t byteLength;
+        size_t byteStride;
+        size_t count;
+        std::string mode;
+        std::string filter;
+        size_t decodedOffset;
+    };
+    std::vector<CompressedView> views;
+    size_t decodedSize = 0;
+    for (size_t i = 0; i < gltf.bufferViews.size(); i++) {
+        const tinygltf::BufferView& bufferView = gltf.bufferViews[i];
+        auto it = bufferView.extensions.find("EXT_meshopt_compression");
+        if (it == bufferView.extensions.end()) {
+            continue;
+        }
+        const tinygltf::Value& ext = it->second;
+        // The sizes are read as doubles, which hold any integer up to 2^53, rather than as ints,
+        // which would wrap the sizes of buffers over 2 GB
+        auto getSize = [&ext](const char* name, size_t& size) {
+            const tinygltf::Value& value = ext.Get(name);
+            if (!value.IsNumber()) {
+                return false;
+            }
+            const double number = value.GetNumberAsDouble();
+            if (!(number >= 0.0) || number > 9007199254740992.0 || std::floor(number) != number) {
+                return false;
+            }
+            size = static_cast<size_t>(number);
+            return true;
+        };
+        CompressedView view;
+        view.bufferView = static_cast<int>(i);
+        size_t buffer = 0;
+        size_t byteOffset = 0;
+        view.mode = ext.Get("mode").IsString() ? ext.Get("mode").Get<std::string>() : "";
+        view.filter = ext.Get("filter").IsString() ? ext.Get("filter").Get<std::string>() : "NONE";
+        const bool validSizes = getSize("buffer", buffer) &&
+                                (!ext.Has("byteOffset") || getSize("byteOffset", byteOffset)) &&
+                                getSize("byteLength", view.byteLength) &&
+                                getSize("byteStride", view.byteStride) &&
+                                getSize("count", view.count);
+        // The decoded data must fill the bufferView exactly, so that the accessors that were
+        // validated against it stay within the decoded data
+        if (!validSizes || buffer >= gltf.buffers.size() ||
+            view.byteLength > gltf.buffers[buffer].data.size() ||
+            byteOffset > gltf.buffers[buffer].data.size() - view.byteLength ||
+            view.count == 0 || view.byteStride == 0 ||
+            !isValidMeshoptLayout(view.mode, view.filter, view.byteStride, view.count) ||
+            bufferView.byteLength % view.byteStride != 0 ||
+            bufferView.byteLength / view.byteStride != view.count) {
+            TF_WARN("Invalid EXT_meshopt_compression data in bufferView %zu", i);
+            return false;
+        }
+        view.data = gltf.buffers[buffer].data.data() + byteOffset;
+        view.decodedOffset = decodedSize;
+        decodedSize += (view.count * view.byteStride + 3) / 4 * 4;
+        views.push_back(view);
+    }
+    if (views.empty()) {
+        return true;
+    }
+
+    // All the bufferViews are decoded into one new buffer, at offsets computed above, so that they
+    // can be decoded in parallel
+    const int decodedBuffer = gltf.buffers.size();
+    gltf.buffers.push_back(tinygltf::Buffer());
+    gltf.buffers[decodedBuffer].name = "EXT_meshopt_compression";
+    gltf.buffers[decodedBuffer].data.resize(decodedSize);
+    uint8_t* decodedData = gltf.buffers[decodedBuffer].data.data();
+    std::atomic<bool> failed = false;
+    WorkParallelForN(views.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const CompressedView& view = views[i];
+            uint8_t* dst = decodedData + view.decodedOffset;
+            int result = -1;
+            if (view.mode == "ATTRIBUTES") {
+                result = meshopt_decodeVertexBuffer(
+                  dst, view.count, view.byteStride, view.data, view.byteLength);
+                if (result == 0 && view.filter == "OCTAHEDRAL") {
+                    meshopt_decodeFilterOct(dst, view.count, view.byteStride);
+                } else if (result == 0 && view.filter == "QUATERNION") {
+                    meshopt_decodeFilterQuat(dst, view.count, view.byteStride);
+                } else if (result == 0 && view.filter == "EXPONENTIAL") {
+                    meshopt_decodeFilterExp(dst, view.count, view.byteStride);
+                }
+            } else if (view.mode == "TRIANGLES") {
+                result = meshopt_decodeIndexBuffer(
+                  dst, view.count, view.byteStride, view.data, view.byteLength);
+            } else if (view.mode == "INDICES") {
+                result = meshopt_decodeIndexSequence(
+                  dst, view.count, view.byteStride, view.data, view.byteLength);
+            }
+            if (result != 0) {
+                TF_WARN("Failed to decode EXT_meshopt_compression bufferView %d (mode %s)",
+                        view.bufferView,
+                        view.mode.c_str());
+                failed = true;
+            }
+        }
+    });
+    if (failed) {
+        return false;
+    }
+
+    // Point the bufferViews at the decoded data, which replaces their fallback data
+    for (const CompressedView& view : views) {
+        tinygltf::BufferView& bufferView = gltf.bufferViews[view.bufferView];
+        bufferView.buffer = decodedBuffer;
+        bufferView.byteOffset = view.decodedOffset;
+        bufferView.byteLength = view.count * view.byteStride;
+        bufferView.extensions.erase("EXT_meshopt_compression");
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_GLTF,
+                 "glTF::read decoded %zu EXT_meshopt_compression bufferViews\n",
+                 views.size());
+    return true;
+}
+#endif
+
 bool
 readGltfFromMemory(tinygltf::Model& gltf,
                    const std::string& baseDir,
@@ -193,6 +558,14 @@ readGltfFromMemory(tinygltf::Model& gltf,
         return false;
     }
 
+#ifdef USDGLTF_ENABLE_MESHOPT
+    std::vector<char> patchedBuffer;
+    if (patchMeshoptFallbackBuffers(isAscii, buffer, bufferSize, patchedBuffer)) {
+        buffer = patchedBuffer.data();
+        bufferSize = patchedBuffer.size();
+    }
+#endif
+
     tinygltf::TinyGLTF loader;
     loader.SetImageLoader(CustomLoadImageData, nullptr);
 
@@ -217,25 +590,249 @@ readGltfFromMemory(tinygltf::Model& gltf,
         return false;
     }
 
+#ifdef USDGLTF_ENABLE_MESHOPT
+    if (!decodeMeshoptBufferViews(gltf)) {
+        TF_DEBUG_MSG(FILE_FORMAT_GLTF, "Failed to decode EXT_meshopt_compression data\n");
+        return false;
+    }
+#endif
+
     return true;
 }
 
+namespace {
+void
+writeUint32(std::ostream& out, uint32_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Streams the data of the buffers laid out by layoutBuffers, followed by zeros up to
+// `paddedLength` bytes
+void
+writeBuffers(std::ostream& out,
+             const tinygltf::Model& gltf,
+             const BufferReferences& references,
+             const std::vector<size_t>& offsets,
+             const std::vector<int>& indices,
+             size_t paddedLength)
+{
+    static const char zeros[4] = {};
+    size_t written = 0;
+    for (size_t i = 0; i < gltf.buffers.size(); i++) {
+        if (indices[i] != 0) {
+            continue;
+        }
+        size_t size = 0;
+        const uint8_t* data = getBufferData(gltf, references, static_cast<int>(i), size);
+        out.write(zeros, offsets[i] - written);
+        out.write(reinterpret_cast<const char*>(data), size);
+        written = offsets[i] + size;
+    }
+    out.write(zeros, paddedLength - written);
+}
+
+// The EXT_meshopt_compression sizes are doubles in the model, which are written with a fraction.
+// Those that fit an int are written as integers, since some readers reject fractions for integer
+// properties, while tinygltf reads integers as ints, so that larger ones are kept as doubles.
+void
+writeMeshoptSizesAsIntegers(nlohmann::json& json)
+{
+    auto bufferViews = json.find("bufferViews");
+    if (bufferViews == json.end() || !bufferViews->is_array()) {
+        return;
+    }
+    for (nlohmann::json& bufferView : *bufferViews) {
+        auto extensions = bufferView.find("extensions");
+        if (extensions == bufferView.end() || !extensions->is_object()) {
+            continue;
+        }
+        auto ext = extensions->find("EXT_meshopt_compression");
+        if (ext == extensions->end() || !ext->is_object()) {
+            continue;
+        }
+        for (const char* name : { "byteOffset", "byteLength", "byteStride", "count" }) {
+            auto value = ext->find(name);
+            if (value != ext->end() && value->is_number_float() &&
+                value->get<double>() <= std::numeric_limits<int>::max()) {
+                *value = static_cast<int>(value->get<double>());
+            }
+        }
+    }
+}
+
+// Serializes the JSON of a model whose buffers are laid out by layoutBuffers. The laid out buffers
+// are replaced by a single one of `binLength` bytes, which is at `uri`, or in the binary chunk of a
+// GLB if the uri is empty, and the fallback buffers follow it.
 bool
-writeGltf(const WriteGltfOptions& options, tinygltf::Model& gltf, const std::string& filename)
+serializeJson(const WriteGltfOptions& options,
+              tinygltf::Model& gltf,
+              const std::vector<int>& indices,
+              size_t binLength,
+              const std::string& uri,
+              const std::string& filename,
+              std::string& text)
+{
+    // Images that are not in a bufferView are written next to the file, like tinygltf does
+    std::string baseDir = TfGetPathName(filename);
+    if (!baseDir.empty()) {
+        baseDir.pop_back();
+    }
+    for (tinygltf::Image& image : gltf.images) {
+        if (image.bufferView < 0 && !image.image.empty() && !image.uri.empty()) {
+            const std::string imageFilename = TfGetBaseName(image.uri);
+            std::string imageUri;
+            if (!CustomWriteImageData(&baseDir,
+                                      &imageFilename,
+                                      &image,
+                                      options.embedImages,
+                                      nullptr,
+                                      &imageUri,
+                                      nullptr)) {
+                return false;
+            }
+            image.uri = imageUri;
+            image.image.clear();
+        }
+    }
+
+    // The JSON is serialized without the buffers, which are added once laid out
+    std::vector<tinygltf::Buffer> buffers = std::move(gltf.buffers);
+    gltf.buffers.clear();
+    std::stringstream stream;
+    tinygltf::TinyGLTF writer;
+    writer.SetImageWriter(CustomWriteImageData, nullptr);
+    const bool serialized = writer.WriteGltfSceneToStream(&gltf, stream, true, false);
+    gltf.buffers = std::move(buffers);
+    if (!serialized) {
+        TF_RUNTIME_ERROR("Failed to serialize glTF JSON for %s", filename.c_str());
+        return false;
+    }
+    nlohmann::json json = nlohmann::json::parse(stream.str(), nullptr, false);
+    if (json.is_discarded()) {
+        TF_RUNTIME_ERROR("Failed to serialize glTF JSON for %s", filename.c_str());
+        return false;
+    }
+    writeMeshoptSizesAsIntegers(json);
+    nlohmann::json jsonBuffers = nlohmann::json::array();
+    const int numFallbackBuffers =
+      indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+    if (binLength || numFallbackBuffers) {
+        nlohmann::json buffer;
+        buffer["byteLength"] = binLength;
+        if (binLength && !uri.empty()) {
+            buffer["uri"] = uri;
+        }
+        jsonBuffers.push_back(buffer);
+    }
+    for (int i = 1; i <= numFallbackBuffers; i++) {
+        jsonBuffers.push_back(meshoptFallbackBufferJson(gltf, i));
+    }
+    if (!jsonBuffers.empty()) {
+        json["buffers"] = jsonBuffers;
+    }
+    text = json.dump(2);
+    return true;
+}
+}
+
+// Writes a GLB without assembling its binary chunk in memory. The buffers are laid out with 64 bit
+// offsets in a first pass, and after the JSON chunk the data of each buffer is streamed to the
+// file in a second pass.
+bool
+writeGlb(const WriteGltfOptions& options,
+         tinygltf::Model& gltf,
+         const BufferReferences& references,
+         const std::string& filename)
+{
+    std::vector<size_t> offsets;
+    std::vector<int> indices;
+    const size_t binLength = layoutBuffers(gltf, references, offsets, indices);
+    rebaseBufferViews(gltf, offsets, indices);
+
+    std::string text;
+    if (!serializeJson(options, gltf, indices, binLength, std::string(), filename, text)) {
+        return false;
+    }
+    text.resize((text.size() + 3) / 4 * 4, ' ');
+
+    const size_t paddedBinLength = (binLength + 3) / 4 * 4;
+    const size_t totalLength = 12 + 8 + text.size() + (binLength ? 8 + paddedBinLength : 0);
+    if (totalLength > std::numeric_limits<uint32_t>::max()) {
+        TF_RUNTIME_ERROR("%s would be %zu bytes, which exceeds the 4 GB size limit of GLB",
+                         filename.c_str(),
+                         totalLength);
+        return false;
+    }
+
+    std::ofstream file(std::filesystem::u8path(filename), std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        TF_RUNTIME_ERROR("Failed to open %s for writing", filename.c_str());
+        return false;
+    }
+    writeUint32(file, 0x46546C67); // "glTF"
+    writeUint32(file, 2);
+    writeUint32(file, static_cast<uint32_t>(totalLength));
+    writeUint32(file, static_cast<uint32_t>(text.size()));
+    writeUint32(file, 0x4E4F534A); // "JSON"
+    file.write(text.data(), text.size());
+    if (binLength) {
+        writeUint32(file, static_cast<uint32_t>(paddedBinLength));
+        writeUint32(file, 0x004E4942); // "BIN"
+        writeBuffers(file, gltf, references, offsets, indices, paddedBinLength);
+    }
+    if (!file.good()) {
+        TF_RUNTIME_ERROR("Failed to write %s", filename.c_str());
+        return false;
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_GLTF,
+                 "glTF::write GLB with %zu bytes of JSON and %zu bytes of binary data\n",
+                 text.size(),
+                 binLength);
+    return true;
+}
+
+bool
+writeGltf(const WriteGltfOptions& options,
+          tinygltf::Model& gltf,
+          const BufferReferences& references,
+          const std::string& filename)
 {
     const std::string parentPath = TfGetPathName(filename);
     const std::string extension = TfGetExtension(filename);
     TfMakeDirs(parentPath, -1, true);
     bool binary = extension == "glb";
-    tinygltf::TinyGLTF writer;
-    writer.SetImageWriter(CustomWriteImageData, nullptr);
-    return writer.WriteGltfSceneToFile(&gltf,
-                                       filename,
-                                       options.embedImages, // embedImages
-                                       binary,              // embedBuffers
-                                       true,                // prettyPrint
-                                       binary               // writeBinary
-    );
+    if (binary) {
+        return writeGlb(options, gltf, references, filename);
+    }
+
+    // The buffers are streamed to a .bin file named after the file, like tinygltf does, and the
+    // JSON is written once with the fallback buffers, which tinygltf would write as empty files
+    std::vector<size_t> offsets;
+    std::vector<int> indices;
+    const size_t binLength = layoutBuffers(gltf, references, offsets, indices);
+    rebaseBufferViews(gltf, offsets, indices);
+    const std::string binUri = TfStringGetBeforeSuffix(TfGetBaseName(filename)) + ".bin";
+    std::string text;
+    if (!serializeJson(options, gltf, indices, binLength, binUri, filename, text)) {
+        return false;
+    }
+    if (binLength) {
+        std::ofstream bin(std::filesystem::u8path(parentPath + binUri),
+                          std::ios::out | std::ios::binary);
+        writeBuffers(bin, gltf, references, offsets, indices, binLength);
+        if (!bin.good()) {
+            TF_RUNTIME_ERROR("Failed to write %s%s", parentPath.c_str(), binUri.c_str());
+            return false;
+        }
+    }
+    std::ofstream out(std::filesystem::u8path(filename), std::ios::out | std::ios::binary);
+    out.write(text.data(), text.size());
+    if (!out.good()) {
+        TF_RUNTIME_ERROR("Failed to write %s", filename.c_str());
+        return false;
+    }
+    return true;
 }
 
 void
@@ -389,6 +986,49 @@ suppressInvalidFloats(void* data, size_t numBytes)
     return foundInfiniteValue;
 }
 
+template<typename T>
+bool
+hasInvalidFloats(const void* data, size_t numBytes)
+{
+    const T* values = reinterpret_cast<const T*>(data);
+    return std::any_of(
+      values, values + numBytes / sizeof(T), [](T value) { return !std::isfinite(value); });
+}
+
+void
+computeRange(tinygltf::Accessor& accessor, const void* data, int elementCount, int componentCount)
+{
+    switch (accessor.componentType) {
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+            computeRange<int8_t>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            computeRange<uint8_t>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+            computeRange<int16_t>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            computeRange<uint16_t>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_INT:
+            computeRange<int32_t>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            computeRange<uint32_t>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+            computeRange<float>(accessor, data, elementCount, componentCount);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_DOUBLE:
+            computeRange<double>(accessor, data, elementCount, componentCount);
+            break;
+        default:
+            TF_RUNTIME_ERROR("Unexpected component type %d for range computation",
+                             accessor.componentType);
+    }
+}
+
 int
 addAccessor(tinygltf::Model* gltf,
             const std::string& name,
@@ -405,13 +1045,9 @@ addAccessor(tinygltf::Model* gltf,
 
     int componentCount = tinygltf::GetNumComponentsInType(type);
     int componentSize = tinygltf::GetComponentSizeInBytes(componentType);
-    tinygltf::Buffer& buffer = getBuffer(gltf);
-    int currentSize = buffer.data.size();
-    int extraBytes = currentSize % 4;
-    int padding = extraBytes ? 4 - extraBytes : 0;
-    int addedSize = componentCount * componentSize * elementCount;
-    buffer.data.resize(currentSize + padding + addedSize);
-    void* dstData = &buffer.data[currentSize + padding];
+    size_t addedSize = static_cast<size_t>(componentCount) * componentSize * elementCount;
+    uint8_t* dstData = nullptr;
+    int bufferViewIndex = addBufferView(gltf, name, addedSize, 0, target, &dstData);
     memcpy(dstData, srcData, addedSize);
 
     // For float values we do a pass on the just copied data to suppress any non-finite values
@@ -425,16 +1061,6 @@ addAccessor(tinygltf::Model* gltf,
         }
     }
 
-    tinygltf::BufferView bufferView;
-    bufferView.name = name;
-    bufferView.buffer = 0;
-    bufferView.byteOffset = currentSize + padding;
-    bufferView.byteLength = addedSize;
-    bufferView.byteStride = 0; // tightly packed
-    bufferView.target = target;
-    int bufferViewIndex = gltf->bufferViews.size();
-    gltf->bufferViews.push_back(bufferView);
-
     tinygltf::Accessor accessor;
     accessor.bufferView = bufferViewIndex;
     accessor.name = name;
@@ -446,35 +1072,7 @@ addAccessor(tinygltf::Model* gltf,
     if (withRange) {
         // Note, we compute the range on the freshly copied data, since it might have been processed
         // relative to the source data
-        switch (componentType) {
-            case TINYGLTF_COMPONENT_TYPE_BYTE:
-                computeRange<int8_t>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                computeRange<uint8_t>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_SHORT:
-                computeRange<int16_t>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                computeRange<uint16_t>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_INT:
-                computeRange<int32_t>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                computeRange<uint32_t>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_FLOAT:
-                computeRange<float>(accessor, dstData, elementCount, componentCount);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_DOUBLE:
-                computeRange<double>(accessor, dstData, elementCount, componentCount);
-                break;
-            default:
-                TF_RUNTIME_ERROR("Unexpected component type %d for range computation",
-                                 componentType);
-        }
+        computeRange(accessor, dstData, elementCount, componentCount);
     }
     int accessorIndex = gltf->accessors.size();
     gltf->accessors.push_back(accessor);
@@ -482,26 +1080,109 @@ addAccessor(tinygltf::Model* gltf,
 }
 
 int
-addImageBufferView(tinygltf::Model* gltf, const std::string& name, int dataSize, const void* data)
+addAccessor(tinygltf::Model* gltf,
+            BufferReferences& references,
+            const std::string& name,
+            int target,
+            int type,
+            int componentType,
+            int elementCount,
+            const VtValue& source,
+            const void* data,
+            bool withRange)
 {
-    tinygltf::Buffer& buffer = getBuffer(gltf);
-    int currentSize = buffer.data.size();
-    int extraBytes = currentSize % 4;
-    int padding = extraBytes ? 4 - extraBytes : 0;
-    buffer.data.resize(currentSize + padding + dataSize);
-    if (dataSize > 0) {
-        memcpy(&buffer.data[currentSize + padding], data, dataSize);
+    if (elementCount <= 0) {
+        return -1;
     }
 
-    tinygltf::BufferView bufferView;
-    bufferView.name = name;
-    bufferView.buffer = 0;
-    bufferView.byteOffset = currentSize + padding;
-    bufferView.byteLength = dataSize;
-    bufferView.byteStride = 0;
-    bufferView.target = 0;
-    int bufferViewIndex = gltf->bufferViews.size();
-    gltf->bufferViews.push_back(bufferView);
+    int componentCount = tinygltf::GetNumComponentsInType(type);
+    int componentSize = tinygltf::GetComponentSizeInBytes(componentType);
+    size_t addedSize = static_cast<size_t>(componentCount) * componentSize * elementCount;
+    // Non-finite values are suppressed in a copy of the data
+    if ((componentType == TINYGLTF_COMPONENT_TYPE_FLOAT &&
+         hasInvalidFloats<float>(data, addedSize)) ||
+        (componentType == TINYGLTF_COMPONENT_TYPE_DOUBLE &&
+         hasInvalidFloats<double>(data, addedSize))) {
+        return addAccessor(gltf, name, target, type, componentType, elementCount, data, withRange);
+    }
+    int bufferViewIndex = addBufferView(gltf, name, addedSize, 0, target, nullptr);
+    BufferReference& reference = references[gltf->bufferViews[bufferViewIndex].buffer];
+    reference.source = source;
+    reference.data = static_cast<const uint8_t*>(data);
+    reference.size = addedSize;
+
+    tinygltf::Accessor accessor;
+    accessor.bufferView = bufferViewIndex;
+    accessor.name = name;
+    accessor.byteOffset = 0;
+    accessor.normalized = false;
+    accessor.componentType = componentType;
+    accessor.count = elementCount;
+    accessor.type = type;
+    if (withRange) {
+        computeRange(accessor, data, elementCount, componentCount);
+    }
+    int accessorIndex = gltf->accessors.size();
+    gltf->accessors.push_back(accessor);
+    return accessorIndex;
+}
+
+int
+addQuantizedAccessor(tinygltf::Model* gltf,
+                     const std::string& name,
+                     int type,
+                     int componentType,
+                     bool normalized,
+                     int elementCount,
+                     const void* srcData)
+{
+    if (elementCount <= 0) {
+        return -1;
+    }
+
+    int componentCount = tinygltf::GetNumComponentsInType(type);
+    int componentSize = tinygltf::GetComponentSizeInBytes(componentType);
+    int elementSize = componentCount * componentSize;
+    // Vertex attributes must be aligned to 4 bytes, so elements like a VEC3 of shorts are padded
+    int stride = (elementSize + 3) / 4 * 4;
+    uint8_t* dstData = nullptr;
+    int bufferViewIndex = addBufferView(gltf,
+                                        name,
+                                        static_cast<size_t>(stride) * elementCount,
+                                        stride == elementSize ? 0 : stride,
+                                        TINYGLTF_TARGET_ARRAY_BUFFER,
+                                        &dstData);
+    const uint8_t* src = static_cast<const uint8_t*>(srcData);
+    for (size_t i = 0; i < static_cast<size_t>(elementCount); i++) {
+        memcpy(dstData + i * stride, src + i * elementSize, elementSize);
+    }
+
+    tinygltf::Accessor accessor;
+    accessor.bufferView = bufferViewIndex;
+    accessor.name = name;
+    accessor.byteOffset = 0;
+    accessor.normalized = normalized;
+    accessor.componentType = componentType;
+    accessor.count = elementCount;
+    accessor.type = type;
+    // The range is computed on the tightly packed source data
+    computeRange(accessor, srcData, elementCount, componentCount);
+    int accessorIndex = gltf->accessors.size();
+    gltf->accessors.push_back(accessor);
+    return accessorIndex;
+}
+
+int
+addImageBufferView(tinygltf::Model* gltf,
+                   const std::string& name,
+                   size_t dataSize,
+                   const void* data)
+{
+    uint8_t* dstData = nullptr;
+    int bufferViewIndex = addBufferView(gltf, name, dataSize, 0, 0, &dstData);
+    if (dataSize > 0) {
+        memcpy(dstData, data, dataSize);
+    }
     return bufferViewIndex;
 }
 
@@ -521,282 +1202,305 @@ getAccessorElementCount(const tinygltf::Model& model, int accessorIndex)
     return model.accessors[accessorIndex].count;
 }
 
-void
-readAccessorData(const tinygltf::Model& model, int accessorIndex, uint8_t* dst)
+namespace {
+// Returns the `size` bytes at `byteOffset` in a buffer view, or nullptr if they are out of the
+// bounds of the view or its buffer
+const uint8_t*
+getBufferViewData(const tinygltf::Model& model,
+                  int bufferViewIndex,
+                  size_t byteOffset,
+                  size_t size,
+                  int accessorIndex)
 {
-    if (accessorIndex < 0) {
-        TF_CODING_ERROR("Accessor index %d is invalid (< 0). File should be rejected.", accessorIndex);
-        return;
-    }
-    if (static_cast<size_t>(accessorIndex) >= model.accessors.size()) {
-        TF_CODING_ERROR("Accessor %d out of bounds (length %zu). File should be rejected.", 
-                        accessorIndex, model.accessors.size());
-        return;
-    }
-    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
-
-    if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size()) {
-        TF_WARN("Accessor %d has invalid buffer view index %d", accessorIndex, accessor.bufferView);
-        return;
+    if (bufferViewIndex < 0 || static_cast<size_t>(bufferViewIndex) >= model.bufferViews.size()) {
+        TF_WARN("Accessor %d has invalid buffer view index %d", accessorIndex, bufferViewIndex);
+        return nullptr;
     }
-    const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+    const tinygltf::BufferView& bufferView = model.bufferViews[bufferViewIndex];
 
     if (bufferView.buffer < 0 || static_cast<size_t>(bufferView.buffer) >= model.buffers.size()) {
-        TF_WARN("Buffer view %d has invalid buffer index %d", accessor.bufferView, bufferView.buffer);
-        return;
+        TF_WARN("Buffer view %d has invalid buffer index %d", bufferViewIndex, bufferView.buffer);
+        return nullptr;
     }
     const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
 
-    size_t componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    size_t componentCount = tinygltf::GetNumComponentsInType(accessor.type);
-    size_t elementSize = componentSize * componentCount;
-    size_t elementStride = accessor.ByteStride(bufferView);
-
     // Validate buffer view bounds to prevent buffer over-read attacks
     if (bufferView.byteOffset >= buffer.data.size()) {
         TF_WARN("Buffer view %d has byteOffset %zu exceeding or equal to buffer size %zu",
-                accessor.bufferView, bufferView.byteOffset, buffer.data.size());
-        return;
+                bufferViewIndex, bufferView.byteOffset, buffer.data.size());
+        return nullptr;
     }
     if (bufferView.byteOffset + bufferView.byteLength > buffer.data.size()) {
         TF_WARN("Buffer view %d extends beyond buffer bounds (offset %zu + length %zu > buffer size %zu)",
-                accessor.bufferView, bufferView.byteOffset, bufferView.byteLength, buffer.data.size());
-        return;
+                bufferViewIndex, bufferView.byteOffset, bufferView.byteLength, buffer.data.size());
+        return nullptr;
     }
 
     // Validate accessor count to prevent buffer over-read attacks
-    size_t accessorStartOffset = accessor.byteOffset;
-    size_t accessorTotalSize = (elementStride == elementSize) ? 
-        accessor.count * elementSize : 
-        (accessor.count > 0 ? (accessor.count - 1) * elementStride + elementSize : 0);
-
-    if (accessorStartOffset + accessorTotalSize > bufferView.byteLength) {
+    if (byteOffset + size > bufferView.byteLength) {
         TF_WARN("Accessor %d data extends beyond buffer view bounds (accessor offset %zu + size %zu > view length %zu)",
-                accessorIndex, accessorStartOffset, accessorTotalSize, bufferView.byteLength);
-        return;
-    }
-
-    const uint8_t* src = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
-    if (elementStride == elementSize) {
-        memcpy(dst, src, accessor.count * elementSize);
-    } else {
-        for (size_t i = 0; i < accessor.count; i++) {
-            memcpy(dst, src, elementSize);
-            dst += elementSize;
-            src += elementStride;
-        }
+                accessorIndex, byteOffset, size, bufferView.byteLength);
+        return nullptr;
     }
+    return buffer.data.data() + bufferView.byteOffset + byteOffset;
 }
 
-// Converts integer typed values into normalized float values
-// If the integer type is signed, the output range is [-1.0f, 1.0f], otherwise its [0.0f, 1.0f]
 template<typename T>
-float
-normalizedFloat(T value)
+T
+loadComponent(const uint8_t* p)
 {
-    return value < 0 ? -static_cast<float>(value) / std::numeric_limits<T>::lowest()
-                     : static_cast<float>(value) / std::numeric_limits<T>::max();
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
 }
 
-// Specialization for floating point source values. In this case we assume the floating point values
-// are already normalized and we pass them through.
-// Note, if we want to enforce the expected range we could clamp the values.
-template<>
-float
-normalizedFloat<float>(float value)
+size_t
+loadSparseIndex(const AccessorView& view, size_t k)
 {
-    return value;
+    const uint8_t* p = view.sparseIndices + k * view.sparseIndexSize;
+    switch (view.sparseIndexSize) {
+        case 1: return *p;
+        case 2: return loadComponent<uint16_t>(p);
+        default: return loadComponent<uint32_t>(p);
+    }
+}
 }
 
-// This function copies/converts a buffer of an accessor component type to a buffer of floats
-void
-readAccessorDataToFloat(const tinygltf::Model& model, int accessorIndex, float* dst)
+bool
+getAccessorView(const tinygltf::Model& model, int accessorIndex, AccessorView& view)
 {
+    view = AccessorView();
     if (accessorIndex < 0) {
         TF_CODING_ERROR("Accessor index %d is invalid (< 0). File should be rejected.", accessorIndex);
-        return;
+        return false;
     }
     if (static_cast<size_t>(accessorIndex) >= model.accessors.size()) {
         TF_CODING_ERROR("Accessor %d out of bounds (length %zu). File should be rejected.", 
                         accessorIndex, model.accessors.size());
-        return;
+        return false;
     }
     const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
 
-    if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size()) {
-        TF_WARN("Accessor %d has invalid buffer view index %d", accessorIndex, accessor.bufferView);
-        return;
+    const int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    const int componentCount = tinygltf::GetNumComponentsInType(accessor.type);
+    if (componentSize <= 0 || componentCount <= 0) {
+        TF_WARN("Accessor %d has invalid component type %d or type %d",
+                accessorIndex, accessor.componentType, accessor.type);
+        return false;
     }
-    const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
-
-    if (bufferView.buffer < 0 || static_cast<size_t>(bufferView.buffer) >= model.buffers.size()) {
-        TF_WARN("Buffer view %d has invalid buffer index %d", accessor.bufferView, bufferView.buffer);
-        return;
+    view.componentType = accessor.componentType;
+    view.componentSize = componentSize;
+    view.componentCount = componentCount;
+    view.normalized = accessor.normalized;
+    view.count = accessor.count;
+    const size_t elementSize = view.elementSize();
+
+    // Sparse accessors without a buffer view are initialized with zeros
+    if (accessor.bufferView >= 0 || !accessor.sparse.isSparse) {
+        if (accessor.bufferView < 0 ||
+            static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size()) {
+            TF_WARN("Accessor %d has invalid buffer view index %d", accessorIndex, accessor.bufferView);
+            return false;
+        }
+        const int stride = accessor.ByteStride(model.bufferViews[accessor.bufferView]);
+        if (stride <= 0) {
+            TF_WARN("Accessor %d has an invalid byte stride", accessorIndex);
+            return false;
+        }
+        view.stride = stride;
+        const size_t size = view.count > 0 ? (view.count - 1) * view.stride + elementSize : 0;
+        view.data =
+          getBufferViewData(model, accessor.bufferView, accessor.byteOffset, size, accessorIndex);
+        if (!view.data) {
+            return false;
+        }
     }
-    const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
 
-    size_t componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    size_t componentCount = tinygltf::GetNumComponentsInType(accessor.type);
-    size_t elementSize = componentSize * componentCount;
-    size_t elementStride = accessor.ByteStride(bufferView);
-    bool normalized = accessor.normalized;
+    if (accessor.sparse.isSparse && accessor.sparse.count > 0) {
+        const int indexSize = tinygltf::GetComponentSizeInBytes(accessor.sparse.indices.componentType);
+        if (indexSize != 1 && indexSize != 2 && indexSize != 4) {
+            TF_WARN("Accessor %d has invalid sparse index component type %d",
+                    accessorIndex, accessor.sparse.indices.componentType);
+            return false;
+        }
+        view.sparseCount = accessor.sparse.count;
+        view.sparseIndexSize = indexSize;
+        view.sparseIndices = getBufferViewData(model,
+                                               accessor.sparse.indices.bufferView,
+                                               accessor.sparse.indices.byteOffset,
+                                               view.sparseCount * indexSize,
+                                               accessorIndex);
+        view.sparseValues = getBufferViewData(model,
+                                              accessor.sparse.values.bufferView,
+                                              accessor.sparse.values.byteOffset,
+                                              view.sparseCount * elementSize,
+                                              accessorIndex);
+        if (!view.sparseIndices || !view.sparseValues) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    // Validate buffer view bounds to prevent buffer over-read attacks
-    if (bufferView.byteOffset >= buffer.data.size()) {
-        TF_WARN("Buffer view %d has byteOffset %zu exceeding or equal to buffer size %zu",
-                accessor.bufferView, bufferView.byteOffset, buffer.data.size());
+void
+readAccessorData(const tinygltf::Model& model, int accessorIndex, uint8_t* dst)
+{
+    AccessorView view;
+    if (!getAccessorView(model, accessorIndex, view)) {
         return;
     }
-    if (bufferView.byteOffset + bufferView.byteLength > buffer.data.size()) {
-        TF_WARN("Buffer view %d extends beyond buffer bounds (offset %zu + length %zu > buffer size %zu)",
-                accessor.bufferView, bufferView.byteOffset, bufferView.byteLength, buffer.data.size());
-        return;
+    const size_t elementSize = view.elementSize();
+    if (!view.data) {
+        memset(dst, 0, view.count * elementSize);
+    } else if (view.stride == elementSize) {
+        memcpy(dst, view.data, view.count * elementSize);
+    } else {
+        for (size_t i = 0; i < view.count; i++) {
+            memcpy(dst + i * elementSize, view.data + i * view.stride, elementSize);
+        }
+    }
+    for (size_t k = 0; k < view.sparseCount; k++) {
+        const size_t index = loadSparseIndex(view, k);
+        if (index < view.count) {
+            memcpy(dst + index * elementSize, view.sparseValues + k * elementSize, elementSize);
+        }
     }
+}
 
-    // Validate accessor count to prevent buffer over-read attacks
-    size_t accessorStartOffset = accessor.byteOffset;
-    size_t accessorTotalSize = (elementStride == elementSize) ? 
-        accessor.count * elementSize : 
-        (accessor.count > 0 ? (accessor.count - 1) * elementStride + elementSize : 0);
+// Converts integer typed values into normalized float values, as in the glTF specification
+// If the integer type is signed, the output range is [-1.0f, 1.0f], otherwise its [0.0f, 1.0f]
+// For signed types both the lowest value and the one above it map to -1.0f
+template<typename T>
+float
+normalizedFloat(T value)
+{
+    return std::max(static_cast<float>(value) / std::numeric_limits<T>::max(), -1.0f);
+}
 
-    if (accessorStartOffset + accessorTotalSize > bufferView.byteLength) {
-        TF_WARN("Accessor %d data extends beyond buffer view bounds (accessor offset %zu + size %zu > view length %zu)",
-                accessorIndex, accessorStartOffset, accessorTotalSize, bufferView.byteLength);
-        return;
-    }
+// Specialization for floating point source values. In this case we assume the floating point values
+// are already normalized and we pass them through.
+// Note, if we want to enforce the expected range we could clamp the values.
+template<>
+float
+normalizedFloat<float>(float value)
+{
+    return value;
+}
 
-    const uint8_t* src = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
-    const size_t elementCount = accessor.count;
-    if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT) {
-        if (elementStride == elementSize) {
-            memcpy(dst, src, elementCount * elementSize);
-        } else {
-            for (size_t i = 0; i < elementCount; i++) {
-                memcpy(dst, src, elementSize);
-                src += elementStride;
-                dst += componentCount;
-            }
-        }
-    } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_BYTE) {
-        if (normalized) {
-            for (size_t i = 0; i < elementCount; i++) {
-                int8_t* p = (int8_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = normalizedFloat(p[j]);
+namespace {
+// Calls `f(i, values)` with the components of every element i of the view converted to D, first
+// from the strided buffer data and then from the sparse values, which replace the elements at
+// their indices. The component type and normalization are dispatched once per view, so that the
+// inner loops are tight and get vectorized by the compiler. The VEC2, VEC3 and VEC4 views of
+// floats, bytes and shorts, which hold positions, normals and texture coordinates, including
+// quantized ones, are also specialized for their number of components, so that the loops over
+// the components are unrolled.
+template<typename D, typename F>
+bool
+forEachAccessorElement(const AccessorView& view, bool normalized, F&& f)
+{
+    auto convert = [&](auto zero, auto normalize, auto fixedCount) {
+        using T = decltype(zero);
+        constexpr size_t numComponents = decltype(fixedCount)::value;
+        // Constant for the specialized views, so that the loop over the components is unrolled
+        const size_t componentCount = numComponents ? numComponents : view.componentCount;
+        D values[16] = {};
+        auto load = [&](const uint8_t* p) {
+            for (size_t j = 0; j < componentCount; j++) {
+                const T value = loadComponent<T>(p + j * sizeof(T));
+                if constexpr (decltype(normalize)::value) {
+                    values[j] = static_cast<D>(normalizedFloat(value));
+                } else {
+                    values[j] = static_cast<D>(value);
                 }
-                src += elementStride;
-                dst += componentCount;
             }
-        } else {
-            for (size_t i = 0; i < elementCount; i++) {
-                int8_t* p = (int8_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = p[j];
-                }
-                src += elementStride;
-                dst += componentCount;
+        };
+        for (size_t i = 0; i < view.count; i++) {
+            if (view.data) {
+                load(view.data + i * view.stride);
             }
+            f(i, values);
         }
-    } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-        if (normalized) {
-            for (size_t i = 0; i < elementCount; i++) {
-                uint8_t* p = (uint8_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = normalizedFloat(p[j]);
-                }
-                src += elementStride;
-                dst += componentCount;
-            }
-        } else {
-            for (size_t i = 0; i < elementCount; i++) {
-                uint8_t* p = (uint8_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = p[j];
-                }
-                src += elementStride;
-                dst += componentCount;
+        for (size_t k = 0; k < view.sparseCount; k++) {
+            const size_t index = loadSparseIndex(view, k);
+            if (index < view.count) {
+                load(view.sparseValues + k * view.elementSize());
+                f(index, values);
             }
         }
-    } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_SHORT) {
-        if (normalized) {
-            for (size_t i = 0; i < elementCount; i++) {
-                int16_t* p = (int16_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = normalizedFloat(p[j]);
-                }
-                src += elementStride;
-                dst += componentCount;
-            }
-        } else {
-            for (size_t i = 0; i < elementCount; i++) {
-                int16_t* p = (int16_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = p[j];
+    };
+    auto dispatch = [&](auto zero, auto vectorized) {
+        auto withCount = [&](auto normalize) {
+            if constexpr (decltype(vectorized)::value) {
+                switch (view.componentCount) {
+                    case 2: convert(zero, normalize, std::integral_constant<size_t, 2>()); return;
+                    case 3: convert(zero, normalize, std::integral_constant<size_t, 3>()); return;
+                    case 4: convert(zero, normalize, std::integral_constant<size_t, 4>()); return;
+                    default: break;
                 }
-                src += elementStride;
-                dst += componentCount;
             }
-        }
-    } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
+            convert(zero, normalize, std::integral_constant<size_t, 0>());
+        };
         if (normalized) {
-            for (size_t i = 0; i < elementCount; i++) {
-                uint16_t* p = (uint16_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = normalizedFloat(p[j]);
-                }
-                src += elementStride;
-                dst += componentCount;
-            }
+            withCount(std::true_type());
         } else {
-            for (size_t i = 0; i < elementCount; i++) {
-                uint16_t* p = (uint16_t*)src;
-                for (size_t j = 0; j < componentCount; j++) {
-                    dst[j] = p[j];
-                }
-                src += elementStride;
-                dst += componentCount;
-            }
+            withCount(std::false_type());
         }
-    } else {
-        TF_WARN("Unsigned Int and Double component types are not supported when converting to "
-                "float arrays");
+    };
+    if (view.componentCount > 16) {
+        return false;
+    }
+    switch (view.componentType) {
+        case TINYGLTF_COMPONENT_TYPE_BYTE: dispatch(int8_t(), std::true_type()); break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: dispatch(uint8_t(), std::true_type()); break;
+        case TINYGLTF_COMPONENT_TYPE_SHORT: dispatch(int16_t(), std::true_type()); break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: dispatch(uint16_t(), std::true_type()); break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: dispatch(uint32_t(), std::false_type()); break;
+        case TINYGLTF_COMPONENT_TYPE_FLOAT: dispatch(float(), std::true_type()); break;
+        default: return false;
     }
+    return true;
+}
 }
 
-template<typename T>
+// This function converts the elements of an accessor of any component type to a buffer of floats
 void
-_readVec4Color(const tinygltf::Model& model,
-               int colorsIndex,
-               int colorCount,
-               VtArray<GfVec3f>& color,
-               VtArray<float>& opacity)
+readAccessorDataToFloat(const tinygltf::Model& model, int accessorIndex, float* dst)
 {
-    std::vector<T> temp(colorCount * 4);
-    readAccessorData(model, colorsIndex, reinterpret_cast<uint8_t*>(temp.data()));
-    color.resize(colorCount);
-    opacity.resize(colorCount);
-    for (int i = 0; i < colorCount; i++) {
-        color[i] = GfVec3f(normalizedFloat(temp[4 * i]),
-                           normalizedFloat(temp[4 * i + 1]),
-                           normalizedFloat(temp[4 * i + 2]));
-        opacity[i] = normalizedFloat(temp[4 * i + 3]);
+    AccessorView view;
+    if (!getAccessorView(model, accessorIndex, view)) {
+        return;
+    }
+    const size_t componentCount = view.componentCount;
+    // Tightly packed floats without sparse values are copied as they are
+    if (view.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && view.data &&
+        view.stride == view.elementSize() && !view.sparseCount) {
+        memcpy(dst, view.data, view.count * view.elementSize());
+        return;
+    }
+    if (!forEachAccessorElement<float>(view, view.normalized, [&](size_t i, const float* values) {
+            std::copy(values, values + componentCount, dst + i * componentCount);
+        })) {
+        TF_WARN("Double component types are not supported when converting to float arrays");
     }
 }
 
-template<typename T>
 void
-_readVec3Color(const tinygltf::Model& model,
-               int colorsIndex,
-               int colorCount,
-               VtArray<GfVec3f>& color)
+readAccessorTexCoords(const tinygltf::Model& model, int accessorIndex, GfVec2f* dst)
 {
-    std::vector<T> temp(colorCount * 3);
-    readAccessorData(model, colorsIndex, reinterpret_cast<uint8_t*>(temp.data()));
-    color.resize(colorCount);
-    for (int i = 0; i < colorCount; i++) {
-        color[i] = GfVec3f(normalizedFloat(temp[3 * i]),
-                           normalizedFloat(temp[3 * i + 1]),
-                           normalizedFloat(temp[3 * i + 2]));
+    AccessorView view;
+    if (!getAccessorView(model, accessorIndex, view)) {
+        return;
+    }
+    if (view.componentCount != 2) {
+        TF_WARN("Accessor %d used as texture coordinates has invalid type", accessorIndex);
+        return;
+    }
+    // The V coordinates are flipped in the same pass, to match the USD convention
+    if (!forEachAccessorElement<float>(view, view.normalized, [&](size_t i, const float* values) {
+            dst[i] = GfVec2f(values[0], 1.0f - values[1]);
+        })) {
+        TF_WARN("Unsupported component type %d for texture coordinates", view.componentType);
     }
 }
 
@@ -819,36 +1523,38 @@ readColor(const tinygltf::Model& model,
         TF_WARN(
           "COLOR_0 data has integer components, but is not normalized. This is not supported");
     }
+    if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT &&
+        accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
+        accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+        TF_WARN("Unexpected component type %d for COLOR_0 accessor. Signed color?",
+                accessor.componentType);
+        return;
+    }
+    if (accessor.type != TINYGLTF_TYPE_VEC4 && accessor.type != TINYGLTF_TYPE_VEC3) {
+        TF_WARN("Unhandled accessor type when reading color data");
+        return;
+    }
+    AccessorView view;
+    if (!getAccessorView(model, colorsIndex, view)) {
+        return;
+    }
+    // Integer colors are always normalized, and the values are written straight into the arrays
+    color.resize(colorCount);
+    GfVec3f* colorDst = color.data();
     if (accessor.type == TINYGLTF_TYPE_VEC4) {
-        if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT) {
-            _readVec4Color<float>(model, colorsIndex, colorCount, color, opacity);
-        } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-            _readVec4Color<uint16_t>(model, colorsIndex, colorCount, color, opacity);
-        } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-            _readVec4Color<uint8_t>(model, colorsIndex, colorCount, color, opacity);
-        } else {
-            TF_WARN("Unexpected component type %d for VEC4 COLOR_0 accessor. Signed color?",
-                    accessor.componentType);
-        }
-    } else if (accessor.type == TINYGLTF_TYPE_VEC3) {
-        if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT) {
-            // No conversion necessary. We can just read the data
-            color.resize(colorCount);
-            readAccessorData(model, colorsIndex, reinterpret_cast<uint8_t*>(color.data()));
-        } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-            _readVec3Color<uint16_t>(model, colorsIndex, colorCount, color);
-        } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-            _readVec3Color<uint8_t>(model, colorsIndex, colorCount, color);
-        } else {
-            TF_WARN("Unexpected component type %d for VEC3 COLOR_0 accessor. Signed color?",
-                    accessor.componentType);
-        }
+        opacity.resize(colorCount);
+        float* opacityDst = opacity.data();
+        forEachAccessorElement<float>(view, true, [&](size_t i, const float* values) {
+            colorDst[i] = GfVec3f(values[0], values[1], values[2]);
+            opacityDst[i] = values[3];
+        });
     } else {
-        TF_WARN("Unhandled accessor type when reading color data");
+        forEachAccessorElement<float>(view, true, [&](size_t i, const float* values) {
+            colorDst[i] = GfVec3f(values[0], values[1], values[2]);
+        });
     }
 }
 
-// Incurs a double copy but handles reading accessors holding integer data with unknown size
 void
 readAccessorInts(const tinygltf::Model& model, int accessorIndex, PXR_NS::VtArray<int>& dst)
 {
@@ -880,19 +1586,16 @@ readAccessorInts(const tinygltf::Model& model, int accessorIndex, PXR_NS::VtArra
                 accessorIndex, accessor.componentType);
         return;
     }
-    
-    int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    if (componentSize == 1) {
-        PXR_NS::VtArray<uint8_t> temp(dst.size());
-        readAccessorData(model, accessorIndex, reinterpret_cast<uint8_t*>(temp.data()));
-        dst.assign(temp.begin(), temp.end());
-    } else if (componentSize == 2) {
-        PXR_NS::VtArray<uint16_t> temp(dst.size());
-        readAccessorData(model, accessorIndex, reinterpret_cast<uint8_t*>(temp.data()));
-        dst.assign(temp.begin(), temp.end());
-    } else { // must be == 4
-        readAccessorData(model, accessorIndex, reinterpret_cast<uint8_t*>(dst.data()));
+
+    AccessorView view;
+    if (!getAccessorView(model, accessorIndex, view)) {
+        return;
     }
+    // The values are widened straight into the destination, which is sized by the caller
+    view.count = std::min(view.count, dst.size());
+    int* ints = dst.data();
+    forEachAccessorElement<int>(
+      view, false, [&](size_t i, const int* values) { ints[i] = values[0]; });
 }
 
 bool
@@ -11,7 +11,15 @@ governing permissions and limitations under the License.
 */
 #pragma once
 #include <cstdint>
+#include <pxr/base/gf/matrix4d.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/vt/array.h>
+#include <pxr/base/vt/types.h>
+#include <pxr/base/vt/value.h>
+#include <string>
 #include <tiny_gltf.h>
+#include <unordered_map>
 
 namespace adobe::usd {
 
@@ -32,6 +40,19 @@ struct WriteGltfOptions
     bool embedImages = true;
 };
 
+// The data of an exported buffer that is not copied into the buffer, but streamed from its source
+// array when the model is written. `source` holds a reference to the array, which keeps the data
+// alive and unchanged, since VtArrays are copied on write.
+struct BufferReference
+{
+    PXR_NS::VtValue source;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// The referenced data of the exported buffers, by buffer index
+using BufferReferences = std::unordered_map<int, BufferReference>;
+
 const tinygltf::Image*
 getImage(const tinygltf::Model* model, size_t textureIndex);
 
@@ -42,7 +63,10 @@ readGltfFromMemory(tinygltf::Model& gltf,
                    const char* buffer,
                    size_t bufferSize);
 bool
-writeGltf(const WriteGltfOptions& options, tinygltf::Model& gltf, const std::string& filename);
+writeGltf(const WriteGltfOptions& options,
+          tinygltf::Model& gltf,
+          const BufferReferences& references,
+          const std::string& filename);
 
 void
 printMatrix(const std::string& name, const PXR_NS::GfMatrix4d& matrix);
@@ -69,17 +93,139 @@ addAccessor(tinygltf::Model* gltf,
             const void* data,
             bool withRange);
 
+// Adds an accessor like addAccessor, whose data is referenced in `references` rather than copied.
+// Float data with non-finite values is copied, since those are replaced by zeros.
+int
+addAccessor(tinygltf::Model* gltf,
+            BufferReferences& references,
+            const std::string& name,
+            int target,
+            int type,
+            int componentType,
+            int elementCount,
+            const PXR_NS::VtValue& source,
+            const void* data,
+            bool withRange);
+
+// Adds an accessor for the values of an array, one per element, which are referenced until the
+// model is written
+template<typename T>
+int
+addAccessor(tinygltf::Model* gltf,
+            BufferReferences& references,
+            const std::string& name,
+            int target,
+            int type,
+            int componentType,
+            const PXR_NS::VtArray<T>& values,
+            bool withRange)
+{
+    return addAccessor(gltf,
+                       references,
+                       name,
+                       target,
+                       type,
+                       componentType,
+                       static_cast<int>(values.size()),
+                       PXR_NS::VtValue(values),
+                       values.cdata(),
+                       withRange);
+}
+
+// Adds a vertex attribute accessor with integer components, which are padded so that the
+// elements are 4 byte aligned as required by KHR_mesh_quantization
 int
-addImageBufferView(tinygltf::Model* gltf, const std::string& name, int dataSize, const void* data);
+addQuantizedAccessor(tinygltf::Model* gltf,
+                     const std::string& name,
+                     int type,
+                     int componentType,
+                     bool normalized,
+                     int elementCount,
+                     const void* data);
+
+int
+addImageBufferView(tinygltf::Model* gltf,
+                   const std::string& name,
+                   size_t dataSize,
+                   const void* data);
+
+// The EXT_meshopt_compression object of a bufferView. The sizes and the offset are doubles, which
+// hold any integer up to 2^53, since the int values of tinygltf would wrap past 2 GB.
+inline tinygltf::Value
+meshoptCompressionValue(int buffer,
+                        size_t byteOffset,
+                        size_t byteLength,
+                        size_t byteStride,
+                        size_t count,
+                        const std::string& mode)
+{
+    tinygltf::Value::Object ext;
+    ext["buffer"] = tinygltf::Value(buffer);
+    ext["byteOffset"] = tinygltf::Value(static_cast<double>(byteOffset));
+    ext["byteLength"] = tinygltf::Value(static_cast<double>(byteLength));
+    ext["byteStride"] = tinygltf::Value(static_cast<double>(byteStride));
+    ext["count"] = tinygltf::Value(static_cast<double>(count));
+    ext["mode"] = tinygltf::Value(mode);
+    return tinygltf::Value(std::move(ext));
+}
+
+// Moves the compressed data of an EXT_meshopt_compression object to `buffer`, `offset` bytes
+// further, when the buffer that holds it is laid out into that buffer
+inline void
+rebaseMeshoptCompression(tinygltf::Value& ext, int buffer, size_t offset)
+{
+    if (!ext.IsObject()) {
+        return;
+    }
+    tinygltf::Value::Object& object = ext.Get<tinygltf::Value::Object>();
+    const size_t byteOffset = static_cast<size_t>(object["byteOffset"].GetNumberAsDouble());
+    object["buffer"] = tinygltf::Value(buffer);
+    object["byteOffset"] = tinygltf::Value(static_cast<double>(byteOffset + offset));
+}
+
+// Returns the data of an exported buffer, which is either referenced or held by the buffer
+const uint8_t*
+getBufferData(const tinygltf::Model& gltf,
+              const BufferReferences& references,
+              int bufferIndex,
+              size_t& size);
 
 int
 getPrimitiveAttribute(const tinygltf::Primitive& primitive, const std::string& name);
 size_t
 getAccessorElementCount(const tinygltf::Model& model, int accessorIndex);
+
+// A view of the elements of an accessor in place in their buffer. The elements are `stride` bytes
+// apart, or all zero if there is no data, and the sparse values replace the elements at the
+// sparse indices.
+struct AccessorView
+{
+    const uint8_t* data = nullptr;
+    size_t count = 0;
+    size_t stride = 0;
+    int componentType = 0;
+    size_t componentSize = 0;
+    size_t componentCount = 0;
+    bool normalized = false;
+
+    const uint8_t* sparseIndices = nullptr;
+    const uint8_t* sparseValues = nullptr;
+    size_t sparseCount = 0;
+    size_t sparseIndexSize = 0;
+
+    size_t elementSize() const { return componentSize * componentCount; }
+};
+
+// Returns false if the accessor or its buffer views are invalid or out of bounds
+bool
+getAccessorView(const tinygltf::Model& model, int accessorIndex, AccessorView& view);
 void
 readAccessorData(const tinygltf::Model& model, int accessorIndex, uint8_t* dst);
 void
 readAccessorDataToFloat(const tinygltf::Model& model, int accessorIndex, float* dst);
+// Reads texture coordinates with the V coordinates flipped to the USD convention
+void
+readAccessorTexCoords(const tinygltf::Model& model, int accessorIndex, PXR_NS::GfVec2f* dst);
 bool
 readAccessorMinMax(const tinygltf::Model& model,
                    int accessorIndex,
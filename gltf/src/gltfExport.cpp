@@ -17,6 +17,7 @@ governing permissions and limitations under the License.
 #include <fileformatutils/geometry.h>
 #include <fileformatutils/images.h>
 #include <fileformatutils/neuralAssetsHelper.h>
+#include <pxr/base/gf/range3d.h>
 #include <pxr/base/tf/token.h>
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/defaultResolver.h>
@@ -57,6 +58,11 @@ governing permissions and limitations under the License.
 #include <pxr/usd/usdSkel/skeletonQuery.h>
 #include <pxr/usd/usdSkel/utils.h>
 
+#ifdef USDGLTF_ENABLE_MESHOPT
+#include <meshoptimizer.h>
+#include <pxr/base/work/loops.h>
+#endif
+
 // TODO refine this description
 /**
  * Export usd to gltf.
@@ -434,14 +440,14 @@ exportNgpExtension(ExportGltfContext& ctx,
 }
 
 size_t
-createGltfMesh(ExportGltfContext& ctx, const Node& node)
+createGltfMesh(ExportGltfContext& ctx, const std::vector<int>& usdMeshIndices)
 {
     // If there are multiple usd meshes, we create one gltf mesh but add all the primitives
     // of all the usd meshes to the single gltf mesh
     size_t meshIndex = ctx.gltf->meshes.size();
     ctx.gltf->meshes.push_back(tinygltf::Mesh());
     tinygltf::Mesh& gmesh = ctx.gltf->meshes[meshIndex];
-    for (int usdMeshIndex : node.staticMeshes) {
+    for (int usdMeshIndex : usdMeshIndices) {
         // Primitives previously written to ctx.primitiveMap
         std::vector<tinygltf::Primitive>& primitives = ctx.primitiveMap[usdMeshIndex];
         for (size_t j = 0; j < primitives.size(); j++) {
@@ -451,6 +457,85 @@ createGltfMesh(ExportGltfContext& ctx, const Node& node)
     return meshIndex;
 }
 
+// Adds a child node with EXT_mesh_gpu_instancing for each prototype of a point instancer, with the
+// transforms of the instances of that prototype
+void
+exportPointInstancer(ExportGltfContext& ctx, int gltfNodeIndex, const PointInstancer& instancer)
+{
+    for (size_t p = 0; p < instancer.prototypes.size(); p++) {
+        std::vector<GfVec3f> translations;
+        std::vector<GfVec4f> rotations;
+        std::vector<GfVec3f> scales;
+        for (size_t i = 0; i < instancer.protoIndices.size(); i++) {
+            if (instancer.protoIndices[i] != static_cast<int>(p)) {
+                continue;
+            }
+            translations.push_back(instancer.positions[i]);
+            if (i < instancer.orientations.size()) {
+                const GfQuatf rotation = GfQuatf(instancer.orientations[i]).GetNormalized();
+                const GfVec3f& imaginary = rotation.GetImaginary();
+                rotations.push_back(
+                  GfVec4f(imaginary[0], imaginary[1], imaginary[2], rotation.GetReal()));
+            } else if (!instancer.orientations.empty()) {
+                rotations.push_back(GfVec4f(0.0f, 0.0f, 0.0f, 1.0f));
+            }
+            if (i < instancer.scales.size()) {
+                scales.push_back(instancer.scales[i]);
+            } else if (!instancer.scales.empty()) {
+                scales.push_back(GfVec3f(1.0f));
+            }
+        }
+        if (translations.empty() || instancer.prototypes[p].empty()) {
+            continue;
+        }
+
+        tinygltf::Value::Object attributes;
+        attributes["TRANSLATION"] = tinygltf::Value(addAccessor(ctx.gltf,
+                                                                "translations",
+                                                                0,
+                                                                TINYGLTF_TYPE_VEC3,
+                                                                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                                                                translations.size(),
+                                                                translations.data(),
+                                                                true));
+        if (!rotations.empty()) {
+            attributes["ROTATION"] = tinygltf::Value(addAccessor(ctx.gltf,
+                                                                 "rotations",
+                                                                 0,
+                                                                 TINYGLTF_TYPE_VEC4,
+                                                                 TINYGLTF_COMPONENT_TYPE_FLOAT,
+                                                                 rotations.size(),
+                                                                 rotations.data(),
+                                                                 true));
+        }
+        if (!scales.empty()) {
+            attributes["SCALE"] = tinygltf::Value(addAccessor(ctx.gltf,
+                                                              "scales",
+                                                              0,
+                                                              TINYGLTF_TYPE_VEC3,
+                                                              TINYGLTF_COMPONENT_TYPE_FLOAT,
+                                                              scales.size(),
+                                                              scales.data(),
+                                                              true));
+        }
+
+        tinygltf::Node prototypeNode;
+        prototypeNode.name = ctx.gltf->nodes[gltfNodeIndex].name + "_Prototype" + std::to_string(p);
+        prototypeNode.mesh = createGltfMesh(ctx, instancer.prototypes[p]);
+        ExtMap instancingExt;
+        instancingExt["attributes"] = tinygltf::Value(attributes);
+        // Without the extension only a single instance would be shown, hence it is required
+        addExtension(ctx, prototypeNode.extensions, "EXT_mesh_gpu_instancing", instancingExt, true);
+        ctx.gltf->nodes[gltfNodeIndex].children.push_back(ctx.gltf->nodes.size());
+        ctx.gltf->nodes.push_back(std::move(prototypeNode));
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_GLTF,
+                 "glTF::write point instancer: { %s } %zu prototypes, %zu instances\n",
+                 instancer.name.c_str(),
+                 instancer.prototypes.size(),
+                 instancer.protoIndices.size());
+}
+
 void
 exportNode(ExportGltfContext& ctx, int usdNodeIndex, int offset)
 {
@@ -543,7 +628,7 @@ exportNode(ExportGltfContext& ctx, int usdNodeIndex, int offset)
             int usdMeshIndex = node.staticMeshes[0];
             auto it = ctx.usdMeshIndexToGltfMeshIndexMap.find(usdMeshIndex);
             if (it == ctx.usdMeshIndexToGltfMeshIndexMap.end()) {
-                size_t meshIndex = createGltfMesh(ctx, node);
+                size_t meshIndex = createGltfMesh(ctx, node.staticMeshes);
                 gnode.mesh = meshIndex;
                 // Add a mapping of usd mesh index to gltf mesh index of possible re-use
                 ctx.usdMeshIndexToGltfMeshIndexMap[usdMeshIndex] = meshIndex;
@@ -552,12 +637,22 @@ exportNode(ExportGltfContext& ctx, int usdNodeIndex, int offset)
                 // mesh
                 gnode.mesh = it->second;
             }
+            if (ctx.positionDequantizations.count(usdMeshIndex)) {
+                // The mesh moves to a child node with the dequantization transform, which is
+                // added in exportGltf
+                ctx.dequantizedMeshNodes.push_back({ gltfNodeIndex, usdMeshIndex });
+                gnode.mesh = -1;
+            }
         } else {
             // When there are multiple static meshes, we combine them into one mesh but this
             // is not common so we don't support instancing
-            gnode.mesh = createGltfMesh(ctx, node);
+            gnode.mesh = createGltfMesh(ctx, node.staticMeshes);
         }
     }
+    if (node.pointInstancer != -1) {
+        // The prototypes are added as child nodes in exportGltf
+        ctx.instancerNodes.push_back({ gltfNodeIndex, node.pointInstancer });
+    }
     if (offset) {
         gnode.children.resize(node.children.size());
         for (size_t i = 0; i < node.children.size(); i++) {
@@ -1840,12 +1935,12 @@ exportPrimitive(ExportGltfContext& ctx,
                 bool isSubset)
 {
     int indicesAccessor = addAccessor(ctx.gltf,
+                                      *ctx.bufferReferences,
                                       "indices",
                                       TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER,
                                       TINYGLTF_TYPE_SCALAR,
                                       TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT,
-                                      indices.size(),
-                                      indices.data(),
+                                      indices,
                                       true);
     primitive.mode = TINYGLTF_MODE_TRIANGLES;
     if (material != -1)
@@ -1896,10 +1991,407 @@ exportPrimitive(ExportGltfContext& ctx,
     return true;
 }
 
+// Quantizes a value within [-1, 1] to a normalized signed byte, with NaNs mapped to 0
+int8_t
+quantizeSnorm8(float value)
+{
+    const float v = std::isnan(value) ? 0.0f : std::clamp(value, -1.0f, 1.0f);
+    return static_cast<int8_t>(std::round(v * 127.0f));
+}
+
+// Quantizes a value within [0, 1] to a normalized unsigned short, with NaNs mapped to 0
+uint16_t
+quantizeUnorm16(float value)
+{
+    const float v = std::isnan(value) ? 0.0f : std::clamp(value, 0.0f, 1.0f);
+    return static_cast<uint16_t>(std::round(v * 65535.0f));
+}
+
+void
+useMeshQuantization(ExportGltfContext& ctx)
+{
+    ctx.extensionsUsed.insert("KHR_mesh_quantization");
+    ctx.extensionsRequired.insert("KHR_mesh_quantization");
+}
+
+// Quantizes positions to 16 bit integers relative to the center of their bounds, and returns the
+// transform that dequantizes them. The scale is uniform, so that the transform does not change the
+// direction of the normals.
+GfMatrix4d
+quantizePositions(const VtVec3fArray& points, std::vector<int16_t>& quantized)
+{
+    GfRange3d bounds;
+    for (const GfVec3f& p : points) {
+        if (std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2])) {
+            bounds.UnionWith(GfVec3d(p));
+        }
+    }
+    GfVec3d center(0.0);
+    double scale = 1.0;
+    if (!bounds.IsEmpty()) {
+        center = bounds.GetMidpoint();
+        const GfVec3d size = bounds.GetSize();
+        const double extent = std::max({ size[0], size[1], size[2] });
+        if (extent > 0.0) {
+            scale = extent / 65534.0;
+        }
+    }
+    quantized.resize(points.size() * 3);
+    for (size_t i = 0; i < points.size(); i++) {
+        for (size_t j = 0; j < 3; j++) {
+            const double q = std::round((points[i][j] - center[j]) / scale);
+            // Non-finite values end up at the center
+            quantized[3 * i + j] = static_cast<int16_t>(std::abs(q) <= 32767.0 ? q : 0.0);
+        }
+    }
+    GfMatrix4d transform;
+    transform.SetScale(scale);
+    transform.SetTranslateOnly(center);
+    return transform;
+}
+
+int
+addNormalsAccessor(ExportGltfContext& ctx, const VtVec3fArray& normals)
+{
+    if (!ctx.options.quantize || normals.empty()) {
+        return addAccessor(ctx.gltf,
+                           *ctx.bufferReferences,
+                           "normals",
+                           TINYGLTF_TARGET_ARRAY_BUFFER,
+                           TINYGLTF_TYPE_VEC3,
+                           TINYGLTF_COMPONENT_TYPE_FLOAT,
+                           normals,
+                           true);
+    }
+    std::vector<int8_t> quantized(normals.size() * 3);
+    for (size_t i = 0; i < normals.size(); i++) {
+        const GfVec3f n = normals[i].GetNormalized();
+        for (size_t j = 0; j < 3; j++) {
+            quantized[3 * i + j] = quantizeSnorm8(n[j]);
+        }
+    }
+    useMeshQuantization(ctx);
+    return addQuantizedAccessor(ctx.gltf,
+                                "normals",
+                                TINYGLTF_TYPE_VEC3,
+                                TINYGLTF_COMPONENT_TYPE_BYTE,
+                                true,
+                                normals.size(),
+                                quantized.data());
+}
+
+int
+addTangentsAccessor(ExportGltfContext& ctx, const GfVec4f* tangents, size_t count)
+{
+    if (!ctx.options.quantize || count == 0) {
+        return addAccessor(ctx.gltf,
+                           "tangents",
+                           TINYGLTF_TARGET_ARRAY_BUFFER,
+                           TINYGLTF_TYPE_VEC4,
+                           TINYGLTF_COMPONENT_TYPE_FLOAT,
+                           count,
+                           tangents,
+                           true);
+    }
+    std::vector<int8_t> quantized(count * 4);
+    for (size_t i = 0; i < count; i++) {
+        const GfVec3f t =
+          GfVec3f(tangents[i][0], tangents[i][1], tangents[i][2]).GetNormalized();
+        for (size_t j = 0; j < 3; j++) {
+            quantized[4 * i + j] = quantizeSnorm8(t[j]);
+        }
+        quantized[4 * i + 3] = tangents[i][3] < 0.0f ? -127 : 127;
+    }
+    useMeshQuantization(ctx);
+    return addQuantizedAccessor(ctx.gltf,
+                                "tangents",
+                                TINYGLTF_TYPE_VEC4,
+                                TINYGLTF_COMPONENT_TYPE_BYTE,
+                                true,
+                                count,
+                                quantized.data());
+}
+
+// Texture coordinates are only quantized when they are all within [0, 1], since wrapping ones
+// would need a texture transform to dequantize them
+int
+addTexCoordsAccessor(ExportGltfContext& ctx, const std::string& name, const VtVec2fArray& uvs)
+{
+    bool quantize = ctx.options.quantize && !uvs.empty();
+    for (size_t i = 0; quantize && i < uvs.size(); i++) {
+        quantize = uvs[i][0] >= 0.0f && uvs[i][0] <= 1.0f && uvs[i][1] >= 0.0f && uvs[i][1] <= 1.0f;
+    }
+    if (!quantize) {
+        return addAccessor(ctx.gltf,
+                           *ctx.bufferReferences,
+                           name,
+                           TINYGLTF_TARGET_ARRAY_BUFFER,
+                           TINYGLTF_TYPE_VEC2,
+                           TINYGLTF_COMPONENT_TYPE_FLOAT,
+                           uvs,
+                           true);
+    }
+    std::vector<uint16_t> quantized(uvs.size() * 2);
+    for (size_t i = 0; i < uvs.size(); i++) {
+        quantized[2 * i + 0] = quantizeUnorm16(uvs[i][0]);
+        quantized[2 * i + 1] = quantizeUnorm16(uvs[i][1]);
+    }
+    useMeshQuantization(ctx);
+    return addQuantizedAccessor(ctx.gltf,
+                                name,
+                                TINYGLTF_TYPE_VEC2,
+                                TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT,
+                                true,
+                                uvs.size(),
+                                quantized.data());
+}
+
+#ifdef USDGLTF_ENABLE_MESHOPT
+template<typename T>
+void
+remapVertexValues(VtArray<T>& values,
+                  const std::vector<unsigned int>& remap,
+                  size_t uniqueCount,
+                  size_t valuesPerVertex = 1)
+{
+    if (values.size() != remap.size() * valuesPerVertex) {
+        return;
+    }
+    VtArray<T> remapped(uniqueCount * valuesPerVertex);
+    for (size_t i = 0; i < remap.size(); i++) {
+        if (remap[i] != ~0u) {
+            std::copy_n(values.cdata() + i * valuesPerVertex,
+                        valuesPerVertex,
+                        remapped.data() + remap[i] * valuesPerVertex);
+        }
+    }
+    values = std::move(remapped);
+}
+
+// Reorders the triangles of each primitive of the mesh for the vertex cache, and then the vertices
+// in the order the triangles first use them, which makes the meshopt encoded data smaller. Only
+// vertex interpolated values are remapped, since forceVertexInterpolation ran on layer read.
+void
+optimizeMeshForMeshopt(Mesh& mesh)
+{
+    const size_t vertexCount = mesh.points.size();
+    std::vector<VtIntArray*> primitiveIndices;
+    for (Subset& subset : mesh.subsets) {
+        primitiveIndices.push_back(&subset.indices);
+    }
+    if (primitiveIndices.empty()) {
+        primitiveIndices.push_back(&mesh.indices);
+    }
+    // The indices of the whole mesh are remapped as well when there are subsets. They come last,
+    // so that the vertices of faces outside of the subsets are placed at the end.
+    std::vector<VtIntArray*> allIndices = primitiveIndices;
+    if (!mesh.subsets.empty()) {
+        allIndices.push_back(&mesh.indices);
+    }
+    size_t indexCount = 0;
+    for (const VtIntArray* indices : allIndices) {
+        for (int index : *indices) {
+            if (index < 0 || static_cast<size_t>(index) >= vertexCount) {
+                return;
+            }
+        }
+        indexCount += indices->size();
+    }
+    if (indexCount == 0) {
+        return;
+    }
+
+    std::vector<unsigned int> optimized;
+    for (VtIntArray* indices : primitiveIndices) {
+        if (indices->size() % 3 == 0) {
+            optimized.resize(indices->size());
+            meshopt_optimizeVertexCache(optimized.data(),
+                                        reinterpret_cast<const unsigned int*>(indices->cdata()),
+                                        indices->size(),
+                                        vertexCount);
+            std::copy(optimized.begin(), optimized.end(), indices->begin());
+        }
+    }
+
+    std::vector<unsigned int> concatenated;
+    concatenated.reserve(indexCount);
+    for (const VtIntArray* indices : allIndices) {
+        concatenated.insert(concatenated.end(), indices->cbegin(), indices->cend());
+    }
+    std::vector<unsigned int> remap(vertexCount);
+    const size_t uniqueCount = meshopt_optimizeVertexFetchRemap(
+      remap.data(), concatenated.data(), concatenated.size(), vertexCount);
+    for (VtIntArray* indices : allIndices) {
+        for (int& index : *indices) {
+            index = remap[index];
+        }
+    }
+
+    remapVertexValues(mesh.points, remap, uniqueCount);
+    remapVertexValues(mesh.normals.values, remap, uniqueCount);
+    remapVertexValues(mesh.tangents.values, remap, uniqueCount);
+    remapVertexValues(mesh.bitangents.values, remap, uniqueCount);
+    remapVertexValues(mesh.uvs.values, remap, uniqueCount);
+    for (Primvar<GfVec2f>& uvs : mesh.extraUVSets) {
+        remapVertexValues(uvs.values, remap, uniqueCount);
+    }
+    for (Primvar<GfVec3f>& colors : mesh.colors) {
+        remapVertexValues(colors.values, remap, uniqueCount);
+    }
+    for (Primvar<float>& opacities : mesh.opacities) {
+        remapVertexValues(opacities.values, remap, uniqueCount);
+    }
+    if (mesh.influenceCount > 0) {
+        remapVertexValues(mesh.joints, remap, uniqueCount, mesh.influenceCount);
+        remapVertexValues(mesh.weights, remap, uniqueCount, mesh.influenceCount);
+    }
+}
+
+// Encodes the vertex attribute and triangle index bufferViews with EXT_meshopt_compression. The
+// extension is required, so the uncompressed ranges of the bufferViews are never read. They are
+// laid out in a fallback buffer, which is written with its byte length only and holds no data.
+// Each bufferView has a buffer of its own, which holds the encoded data in place of its data.
+void
+compressBufferViews(ExportGltfContext& ctx)
+{
+    tinygltf::Model& gltf = *ctx.gltf;
+    BufferReferences& references = *ctx.bufferReferences;
+
+    // The element sizes and component types of the bufferViews, from the accessors that use them
+    std::vector<size_t> elementSizes(gltf.bufferViews.size(), 0);
+    std::vector<int> componentTypes(gltf.bufferViews.size(), -1);
+    for (const tinygltf::Accessor& accessor : gltf.accessors) {
+        if (accessor.bufferView >= 0 &&
+            static_cast<size_t>(accessor.bufferView) < gltf.bufferViews.size()) {
+            elementSizes[accessor.bufferView] =
+              tinygltf::GetComponentSizeInBytes(accessor.componentType) *
+              tinygltf::GetNumComponentsInType(accessor.type);
+            componentTypes[accessor.bufferView] = accessor.componentType;
+        }
+    }
+
+    struct EncodedView
+    {
+        std::vector<unsigned char> data;
+        std::string mode;
+        size_t byteStride = 0;
+        size_t count = 0;
+    };
+    std::vector<EncodedView> encodedViews(gltf.bufferViews.size());
+    meshopt_encodeVertexVersion(0);
+    meshopt_encodeIndexVersion(1);
+    WorkParallelForN(gltf.bufferViews.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const tinygltf::BufferView& bufferView = gltf.bufferViews[i];
+            if (bufferView.buffer < 0 ||
+                static_cast<size_t>(bufferView.buffer) >= gltf.buffers.size()) {
+                continue;
+            }
+            size_t size = 0;
+            const unsigned char* data = getBufferData(gltf, references, bufferView.buffer, size);
+            if (bufferView.byteOffset + bufferView.byteLength > size) {
+                continue;
+            }
+            const unsigned char* src = data + bufferView.byteOffset;
+            EncodedView& encoded = encodedViews[i];
+            if (bufferView.target == TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER &&
+                componentTypes[i] == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT &&
+                bufferView.byteLength % (3 * sizeof(unsigned int)) == 0) {
+                encoded.count = bufferView.byteLength / sizeof(unsigned int);
+                std::vector<unsigned int> indices(encoded.count);
+                memcpy(indices.data(), src, bufferView.byteLength);
+                const size_t vertexCount =
+                  indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
+                encoded.data.resize(meshopt_encodeIndexBufferBound(encoded.count, vertexCount));
+                encoded.data.resize(meshopt_encodeIndexBuffer(
+                  encoded.data.data(), encoded.data.size(), indices.data(), encoded.count));
+                encoded.mode = "TRIANGLES";
+                encoded.byteStride = sizeof(unsigned int);
+            } else if (bufferView.target == TINYGLTF_TARGET_ARRAY_BUFFER) {
+                const size_t stride =
+                  bufferView.byteStride ? bufferView.byteStride : elementSizes[i];
+                if (stride == 0 || stride % 4 != 0 || stride > 256 ||
+                    bufferView.byteLength % stride != 0) {
+                    continue;
+                }
+                encoded.count = bufferView.byteLength / stride;
+                encoded.data.resize(meshopt_encodeVertexBufferBound(encoded.count, stride));
+                encoded.data.resize(meshopt_encodeVertexBuffer(
+                  encoded.data.data(), encoded.data.size(), src, encoded.count, stride));
+                encoded.mode = "ATTRIBUTES";
+                encoded.byteStride = stride;
+            }
+        }
+    });
+
+    // The encoded data replaces the data of the buffer of each encoded bufferView, and the
+    // uncompressed range of the bufferView moves to the fallback buffer, which is added last
+    const int fallbackBuffer = static_cast<int>(gltf.buffers.size());
+    size_t fallbackLength = 0;
+    size_t uncompressedSize = 0;
+    size_t compressedSize = 0;
+    for (size_t i = 0; i < gltf.bufferViews.size(); i++) {
+        tinygltf::BufferView& bufferView = gltf.bufferViews[i];
+        EncodedView& encoded = encodedViews[i];
+        if (encoded.data.empty()) {
+            continue;
+        }
+        const int buffer = bufferView.buffer;
+        bufferView.extensions["EXT_meshopt_compression"] = meshoptCompressionValue(
+          buffer, 0, encoded.data.size(), encoded.byteStride, encoded.count, encoded.mode);
+        uncompressedSize += bufferView.byteLength;
+        compressedSize += encoded.data.size();
+        bufferView.buffer = fallbackBuffer;
+        bufferView.byteOffset = fallbackLength;
+        fallbackLength += (bufferView.byteLength + 3) / 4 * 4;
+        gltf.buffers[buffer].data = std::move(encoded.data);
+        references.erase(buffer);
+    }
+    if (compressedSize == 0) {
+        return;
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_GLTF,
+                 "glTF::write EXT_meshopt_compression: %zu bytes encoded to %zu bytes\n",
+                 uncompressedSize,
+                 compressedSize);
+    tinygltf::Value::Object fallback;
+    fallback["fallback"] = tinygltf::Value(true);
+    gltf.buffers.emplace_back();
+    gltf.buffers[fallbackBuffer].extensions["EXT_meshopt_compression"] = tinygltf::Value(fallback);
+    ctx.extensionsUsed.insert("EXT_meshopt_compression");
+    ctx.extensionsRequired.insert("EXT_meshopt_compression");
+}
+#endif
+
 bool
 exportMeshes(ExportGltfContext& ctx)
 {
     ctx.primitiveMap.resize(ctx.usd->meshes.size());
+
+    // Positions are quantized for meshes that are alone on their nodes and not skinned, since
+    // their dequantization transform is applied by a child node
+    std::vector<bool> quantizePositionsOfMesh(ctx.usd->meshes.size(), ctx.options.quantize);
+    for (const Node& node : ctx.usd->nodes) {
+        for (const auto& [skeletonIndex, meshIndices] : node.skinnedMeshes) {
+            for (int meshIndex : meshIndices) {
+                quantizePositionsOfMesh[meshIndex] = false;
+            }
+        }
+        if (node.staticMeshes.size() > 1) {
+            for (int meshIndex : node.staticMeshes) {
+                quantizePositionsOfMesh[meshIndex] = false;
+            }
+        }
+    }
+    // The instance transforms of EXT_mesh_gpu_instancing apply on top of the node of the mesh,
+    // hence there is no node to carry the dequantization of a prototype
+    for (const PointInstancer& instancer : ctx.usd->pointInstancers) {
+        for (const std::vector<int>& prototype : instancer.prototypes) {
+            for (int meshIndex : prototype) {
+                quantizePositionsOfMesh[meshIndex] = false;
+            }
+        }
+    }
     for (size_t i = 0; i < ctx.usd->meshes.size(); i++) {
         std::vector<tinygltf::Primitive>& primitives = ctx.primitiveMap[i];
         Mesh& mesh = ctx.usd->meshes[i];
@@ -1909,24 +2401,36 @@ exportMeshes(ExportGltfContext& ctx)
 
         // bake the geomBindTransform into the mesh
         transformMesh(mesh, mesh.geomBindTransform);
-
-        int positionsAccessor = addAccessor(ctx.gltf,
+#ifdef USDGLTF_ENABLE_MESHOPT
+        if (ctx.options.meshopt) {
+            optimizeMeshForMeshopt(mesh);
+        }
+#endif
+
+        int positionsAccessor = -1;
+        if (quantizePositionsOfMesh[i] && mesh.joints.empty()) {
+            std::vector<int16_t> quantized;
+            ctx.positionDequantizations[i] = quantizePositions(mesh.points, quantized);
+            useMeshQuantization(ctx);
+            positionsAccessor = addQuantizedAccessor(ctx.gltf,
+                                                     "positions",
+                                                     TINYGLTF_TYPE_VEC3,
+                                                     TINYGLTF_COMPONENT_TYPE_SHORT,
+                                                     false,
+                                                     mesh.points.size(),
+                                                     quantized.data());
+        } else {
+            positionsAccessor = addAccessor(ctx.gltf,
+                                            *ctx.bufferReferences,
                                             "positions",
                                             TINYGLTF_TARGET_ARRAY_BUFFER,
                                             TINYGLTF_TYPE_VEC3,
                                             TINYGLTF_COMPONENT_TYPE_FLOAT,
-                                            mesh.points.size(),
-                                            mesh.points.data(),
+                                            mesh.points,
                                             true);
+        }
 
-        int normalsAccessor = addAccessor(ctx.gltf,
-                                          "normals",
-                                          TINYGLTF_TARGET_ARRAY_BUFFER,
-                                          TINYGLTF_TYPE_VEC3,
-                                          TINYGLTF_COMPONENT_TYPE_FLOAT,
-                                          mesh.normals.values.size(),
-                                          mesh.normals.values.data(),
-                                          true);
+        int normalsAccessor = addNormalsAccessor(ctx, mesh.normals.values);
 
         int tangentsAccessor = -1;
         std::vector<PXR_NS::GfVec4f> gltfTangents;
@@ -1972,24 +2476,12 @@ exportMeshes(ExportGltfContext& ctx)
                     gltfTangents[k] = PXR_NS::GfVec4f(tangentXYZ[0], tangentXYZ[1], tangentXYZ[2], handedness);
                 }
                 
-                tangentsAccessor = addAccessor(ctx.gltf,
-                                              "tangents",
-                                              TINYGLTF_TARGET_ARRAY_BUFFER,
-                                              TINYGLTF_TYPE_VEC4,
-                                              TINYGLTF_COMPONENT_TYPE_FLOAT,
-                                              gltfTangents.size(),
-                                              gltfTangents.data(),
-                                              true);
+                tangentsAccessor =
+                  addTangentsAccessor(ctx, gltfTangents.data(), gltfTangents.size());
             } else {
                 // Only tangents available, use them directly
-                tangentsAccessor = addAccessor(ctx.gltf,
-                                              "tangents",
-                                              TINYGLTF_TARGET_ARRAY_BUFFER,
-                                              TINYGLTF_TYPE_VEC4,
-                                              TINYGLTF_COMPONENT_TYPE_FLOAT,
-                                              mesh.tangents.values.size(),
-                                              mesh.tangents.values.data(),
-                                              true);
+                tangentsAccessor = addTangentsAccessor(
+                  ctx, mesh.tangents.values.data(), mesh.tangents.values.size());
             }
         }
 
@@ -1999,14 +2491,7 @@ exportMeshes(ExportGltfContext& ctx)
         for (auto& uv : flippedUvs) {
             uv[1] = 1.0f - uv[1];
         }
-        int uvsAccessor = addAccessor(ctx.gltf,
-                                      "texCoords",
-                                      TINYGLTF_TARGET_ARRAY_BUFFER,
-                                      TINYGLTF_TYPE_VEC2,
-                                      TINYGLTF_COMPONENT_TYPE_FLOAT,
-                                      flippedUvs.size(),
-                                      flippedUvs.data(),
-                                      true);
+        int uvsAccessor = addTexCoordsAccessor(ctx, "texCoords", flippedUvs);
         if (uvsAccessor >= 0)
             uvsAccessors.push_back(uvsAccessor);
 
@@ -2017,14 +2502,8 @@ exportMeshes(ExportGltfContext& ctx)
             for (auto& uv : flippedExtraUvs) {
                 uv[1] = 1.0f - uv[1];
             }
-            uvsAccessor = addAccessor(ctx.gltf,
-                                      "texCoords" + std::to_string(extraUVsCount + 1),
-                                      TINYGLTF_TARGET_ARRAY_BUFFER,
-                                      TINYGLTF_TYPE_VEC2,
-                                      TINYGLTF_COMPONENT_TYPE_FLOAT,
-                                      flippedExtraUvs.size(),
-                                      flippedExtraUvs.data(),
-                                      true);
+            uvsAccessor = addTexCoordsAccessor(
+              ctx, "texCoords" + std::to_string(extraUVsCount + 1), flippedExtraUvs);
             if (uvsAccessor >= 0) {
                 uvsAccessors.push_back(uvsAccessor);
                 extraUVsCount++;
@@ -2251,12 +2730,16 @@ exportMeshes(ExportGltfContext& ctx)
 }
 
 bool
-exportGltf(const ExportGltfOptions& options, UsdData& usd, tinygltf::Model& gltf)
+exportGltf(const ExportGltfOptions& options,
+           UsdData& usd,
+           tinygltf::Model& gltf,
+           BufferReferences& references)
 {
     ExportGltfContext ctx;
     ctx.options = options;
     ctx.usd = &usd;
     ctx.gltf = &gltf;
+    ctx.bufferReferences = &references;
 
     exportAnimationTracks(ctx);
     exportMetadata(ctx);
@@ -2299,6 +2782,29 @@ exportGltf(const ExportGltfOptions& options, UsdData& usd, tinygltf::Model& gltf
     // index map that is created in exportNode
     exportSkeletons(ctx, offsetNode);
 
+    // Meshes with quantized positions are placed on a child node with the transform that
+    // dequantizes them, which leaves the transform of their node and its children unchanged. These
+    // are added last, since the glTF node indices of the USD nodes are fixed by the offset.
+    for (const auto& [gltfNodeIndex, usdMeshIndex] : ctx.dequantizedMeshNodes) {
+        tinygltf::Node meshNode;
+        meshNode.name = gltf.nodes[gltfNodeIndex].name + "_mesh";
+        meshNode.mesh = ctx.usdMeshIndexToGltfMeshIndexMap[usdMeshIndex];
+        copyMatrix(ctx.positionDequantizations[usdMeshIndex], meshNode.matrix);
+        gltf.nodes[gltfNodeIndex].children.push_back(gltf.nodes.size());
+        gltf.nodes.push_back(std::move(meshNode));
+    }
+    for (const auto& [gltfNodeIndex, instancerIndex] : ctx.instancerNodes) {
+        exportPointInstancer(ctx, gltfNodeIndex, usd.pointInstancers[instancerIndex]);
+    }
+
+    if (options.meshopt) {
+#ifdef USDGLTF_ENABLE_MESHOPT
+        compressBufferViews(ctx);
+#else
+        TF_WARN("meshopt export requires the plugin to be built with meshoptimizer");
+#endif
+    }
+
     // Convert extension sets into vectors
     gltf.extensionsUsed =
       std::vector<std::string>(ctx.extensionsUsed.begin(), ctx.extensionsUsed.end());
@@ -24,6 +24,10 @@ struct ExportGltfOptions
     bool binary = false;
     bool embedImages = false;
     bool useMaterialExtensions = true;
+    // Quantize vertex attributes with KHR_mesh_quantization
+    bool quantize = false;
+    // Optimize and compress meshes with EXT_meshopt_compression
+    bool meshopt = false;
 };
 
 struct ExportGltfContext
@@ -31,6 +35,9 @@ struct ExportGltfContext
     ExportGltfOptions options;
     UsdData* usd = nullptr;
     tinygltf::Model* gltf = nullptr;
+    // Vertex attributes and indices are referenced from their arrays rather than copied into the
+    // buffers, until the model is written
+    BufferReferences* bufferReferences = nullptr;
     // Any GLTF extensions used should be added here and marked as required if needed
     // These will be written to the GLTF model in the end, but the set is more efficient for adding
     // things only once.
@@ -46,6 +53,17 @@ struct ExportGltfContext
 
     // Map to convert from USD node indices to glTF node indices. Created in exportNode()
     std::unordered_map<int, int> usdNodesToGltfNodes;
+
+    // Transforms that dequantize the positions of USD meshes written with KHR_mesh_quantization
+    std::unordered_map<int, PXR_NS::GfMatrix4d> positionDequantizations;
+
+    // Pairs of glTF node index and USD mesh index, for the nodes of meshes with quantized
+    // positions. The mesh is placed on a child node with the dequantization transform.
+    std::vector<std::pair<int, int>> dequantizedMeshNodes;
+
+    // Pairs of glTF node index and USD point instancer index. Each prototype of the instancer is
+    // placed on a child node with EXT_mesh_gpu_instancing.
+    std::vector<std::pair<int, int>> instancerNodes;
 };
 
 /// \ingroup usdgltf
@@ -80,6 +98,9 @@ exportTexture(ExportGltfContext& ctx, const Input& input, int& textureIndex, int
 /// \ingroup usdgltf
 /// \brief Export USD data to a glTF model.
 bool
-exportGltf(const ExportGltfOptions& options, UsdData& data, tinygltf::Model& model);
+exportGltf(const ExportGltfOptions& options,
+           UsdData& data,
+           tinygltf::Model& model,
+           BufferReferences& references);
 
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ governing permissions and limitations under the License.
 #include <fileformatutils/neuralAssetsHelper.h>
 #include <pxr/base/tf/pathUtils.h>
 #include <pxr/base/tf/stringUtils.h>
+#include <pxr/base/work/loops.h>
 
 #include <algorithm>
 #include <numeric>
@@ -1588,246 +1589,253 @@ getIndices(const tinygltf::Model& model,
     }
 }
 
+// Decodes and validates the accessors of a glTF primitive into the mesh that is reserved for it.
+// This only reads the glTF model and only writes that mesh, so that primitives can be decoded in
+// parallel.
 void
-importMeshes(ImportGltfContext& ctx)
+importPrimitive(ImportGltfContext& ctx, const tinygltf::Mesh& gmesh, size_t j, int meshIndex)
 {
-    ctx.meshes.resize(ctx.gltf->meshes.size());
-    ctx.meshUseCount.resize(ctx.gltf->meshes.size(), 0);
-    for (size_t i = 0; i < ctx.gltf->meshes.size(); i++) {
-        const tinygltf::Mesh& gmesh = ctx.gltf->meshes[i];
-        ctx.meshes[i].resize(gmesh.primitives.size());
-        for (size_t j = 0; j < gmesh.primitives.size(); j++) {
+    const tinygltf::Primitive& primitive = gmesh.primitives[j];
+    
+    // Get accessor indices (for early validation)
+    int positionsIndex = getPrimitiveAttribute(primitive, "POSITION");
+    int normalsIndex = getPrimitiveAttribute(primitive, "NORMAL");
+    int tangentsIndex = getPrimitiveAttribute(primitive, "TANGENT");
+    int uvsIndex = getPrimitiveAttribute(primitive, "TEXCOORD_0");
+    int indicesIndex = primitive.indices;
+    
+    // Get vertex count for validation
+    size_t vertexCount = getAccessorElementCount(*ctx.gltf, positionsIndex);
+
+    // The indices are decoded once, and validated before the other mesh data is loaded
+    PXR_NS::VtArray<int> indices;
+    getIndices(*ctx.gltf, indicesIndex, vertexCount, indices);
+    if (indicesIndex >= 0 && !indices.empty() && vertexCount > 0) {
+        int maxIndex = *std::max_element(indices.begin(), indices.end());
+        if (maxIndex >= static_cast<int>(vertexCount)) {
+            TF_WARN("Mesh '%s' primitive %zu has indices (max %d) exceeding vertex count (%zu). Creating empty mesh to prevent crash.",
+                    gmesh.name.c_str(), j, maxIndex, vertexCount);
+            // Leave the mesh empty, which keeps the mesh indices consistent
+            return;
+        }
+    }
 
-            // TODO: Combine primitives into a single large mesh if possible. When different
-            // primitives have different materials, use a mesh subset to store this information.
-            // Be aware of properly combining UV subsets
+    Mesh& mesh = ctx.usd->meshes[meshIndex];
+    mesh.displayName = gmesh.name;
+    // When we have multiple GLTF primitives that we turn into meshes, we create names that
+    // are derived from the primitive index instead of just duplicating the name.
+    if (gmesh.primitives.size() > 1) {
+        mesh.displayName = mesh.displayName + "_primitive" + std::to_string(j);
+    }
 
-            const tinygltf::Primitive& primitive = gmesh.primitives[j];
-            
-            // Get accessor indices before adding mesh (for early validation)
-            int positionsIndex = getPrimitiveAttribute(primitive, "POSITION");
-            int normalsIndex = getPrimitiveAttribute(primitive, "NORMAL");
-            int tangentsIndex = getPrimitiveAttribute(primitive, "TANGENT");
-            int uvsIndex = getPrimitiveAttribute(primitive, "TEXCOORD_0");
-            int indicesIndex = primitive.indices;
-            
-            // Get vertex count for validation
-            size_t vertexCount = getAccessorElementCount(*ctx.gltf, positionsIndex);
-            
-            // Pre-validate indices before loading mesh data
-            bool skipLoadingData = false;
-            if (indicesIndex >= 0) {
-                PXR_NS::VtArray<int> tempIndices;
-                getIndices(*ctx.gltf, indicesIndex, vertexCount, tempIndices);
+    // POSITION is required in GLTF
+    mesh.points =
+      PXR_NS::VtArray<PXR_NS::GfVec3f>(getAccessorElementCount(*ctx.gltf, positionsIndex));
+    readAccessorDataToFloat(
+      *ctx.gltf, positionsIndex, reinterpret_cast<float*>(mesh.points.data()));
+
+    // NORMAL is optional - only read if present
+    if (normalsIndex >= 0) {
+        mesh.normals.values =
+          PXR_NS::VtArray<PXR_NS::GfVec3f>(getAccessorElementCount(*ctx.gltf, normalsIndex));
+        readAccessorDataToFloat(
+          *ctx.gltf, normalsIndex, reinterpret_cast<float*>(mesh.normals.values.data()));
+        mesh.normals.interpolation = UsdGeomTokens->vertex;
+        // Quantized normals from KHR_mesh_quantization are only approximately unit length
+        if (ctx.gltf->accessors[normalsIndex].componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
+            for (PXR_NS::GfVec3f& normal : mesh.normals.values) {
+                normal.Normalize();
+            }
+        }
+    }
+
+    // TANGENT is optional - only read if present
+    if (tangentsIndex >= 0) {
+        mesh.tangents.values =
+          PXR_NS::VtArray<PXR_NS::GfVec4f>(getAccessorElementCount(*ctx.gltf, tangentsIndex));
+        readAccessorDataToFloat(
+          *ctx.gltf, tangentsIndex, reinterpret_cast<float*>(mesh.tangents.values.data()));
+        mesh.tangents.interpolation = UsdGeomTokens->vertex;
+
+        // GLTF tangent format: (x, y, z, w) where w is handedness (+1 or -1)
+        // Binormal = cross(normal, tangent.xyz) * tangent.w
+        // Only compute bitangents if explicitly requested
+        if (ctx.options->computeBitangents && mesh.normals.values.size() == mesh.tangents.values.size()) {
+            mesh.bitangents.values.resize(mesh.tangents.values.size());
+            for (size_t k = 0; k < mesh.tangents.values.size(); k++) {
+                const PXR_NS::GfVec3f& normal = mesh.normals.values[k];
+                const PXR_NS::GfVec4f& tangent = mesh.tangents.values[k];
+                PXR_NS::GfVec3f tangentXYZ(tangent[0], tangent[1], tangent[2]);
+                float handedness = tangent[3];
                 
-                if (!tempIndices.empty() && vertexCount > 0) {
-                    int maxIndex = *std::max_element(tempIndices.begin(), tempIndices.end());
-                    if (maxIndex >= static_cast<int>(vertexCount)) {
-                        TF_WARN("Mesh '%s' primitive %zu has indices (max %d) exceeding vertex count (%zu). Creating empty mesh to prevent crash.",
-                                gmesh.name.c_str(), j, maxIndex, vertexCount);
-                        skipLoadingData = true;
-                    }
+                if (std::abs(handedness) < 0.5f) {
+                    TF_WARN("Invalid handedness value %f in tangent data, assuming +1", handedness);
+                    handedness = 1.0f;
+                } else {
+                    handedness = handedness >= 0.0f ? 1.0f : -1.0f;
                 }
+                
+                // Compute bitangent using cross product: normal × tangentXYZ
+                PXR_NS::GfVec3f crossProduct(
+                    normal[1] * tangentXYZ[2] - normal[2] * tangentXYZ[1],  // x = ny*tz - nz*ty
+                    normal[2] * tangentXYZ[0] - normal[0] * tangentXYZ[2],  // y = nz*tx - nx*tz
+                    normal[0] * tangentXYZ[1] - normal[1] * tangentXYZ[0]   // z = nx*ty - ny*tx
+                );
+                mesh.bitangents.values[k] = crossProduct * handedness;
             }
-            
-            // Always add mesh (even if invalid) to maintain index consistency
-            // If invalid, we'll leave it empty
-            auto [meshIndex, mesh] = ctx.usd->addMesh();
-            ctx.meshes[i][j] = meshIndex;
-            
-            // Skip loading data if validation failed - leave mesh empty
-            if (skipLoadingData) {
-                continue;
-            }
-            mesh.displayName = gmesh.name;
-            // When we have multiple GLTF primitives that we turn into meshes, we create names that
-            // are derived from the primitive index instead of just duplicating the name.
-            if (gmesh.primitives.size() > 1) {
-                mesh.displayName = mesh.displayName + "_primitive" + std::to_string(j);
-            }
+            mesh.bitangents.interpolation = UsdGeomTokens->vertex;
+        } else if (ctx.options->computeBitangents && mesh.normals.values.size() > 0) {
+            TF_WARN("Tangent and normal vertex counts don't match (%zu tangents, %zu normals). "
+                   "Skipping bitangent computation.",
+                   mesh.tangents.values.size(),
+                   mesh.normals.values.size());
+        }
+    }
 
-            // POSITION is required in GLTF
-            mesh.points =
-              PXR_NS::VtArray<PXR_NS::GfVec3f>(getAccessorElementCount(*ctx.gltf, positionsIndex));
-            readAccessorDataToFloat(
-              *ctx.gltf, positionsIndex, reinterpret_cast<float*>(mesh.points.data()));
-
-            // NORMAL is optional - only read if present
-            if (normalsIndex >= 0) {
-                mesh.normals.values =
-                  PXR_NS::VtArray<PXR_NS::GfVec3f>(getAccessorElementCount(*ctx.gltf, normalsIndex));
-                readAccessorDataToFloat(
-                  *ctx.gltf, normalsIndex, reinterpret_cast<float*>(mesh.normals.values.data()));
-                mesh.normals.interpolation = UsdGeomTokens->vertex;
-            }
+    // TEXCOORD_0 is optional - only read if present
+    if (uvsIndex >= 0) {
+        mesh.uvs.values =
+          PXR_NS::VtArray<PXR_NS::GfVec2f>(getAccessorElementCount(*ctx.gltf, uvsIndex));
+        // Flip V coordinates for glTF files to match USD convention
+        readAccessorTexCoords(*ctx.gltf, uvsIndex, mesh.uvs.values.data());
+        mesh.uvs.interpolation = UsdGeomTokens->vertex;
+    }
 
-            // TANGENT is optional - only read if present
-            if (tangentsIndex >= 0) {
-                mesh.tangents.values =
-                  PXR_NS::VtArray<PXR_NS::GfVec4f>(getAccessorElementCount(*ctx.gltf, tangentsIndex));
-                readAccessorDataToFloat(
-                  *ctx.gltf, tangentsIndex, reinterpret_cast<float*>(mesh.tangents.values.data()));
-                mesh.tangents.interpolation = UsdGeomTokens->vertex;
-
-                // GLTF tangent format: (x, y, z, w) where w is handedness (+1 or -1)
-                // Binormal = cross(normal, tangent.xyz) * tangent.w
-                // Only compute bitangents if explicitly requested
-                if (ctx.options->computeBitangents && mesh.normals.values.size() == mesh.tangents.values.size()) {
-                    mesh.bitangents.values.resize(mesh.tangents.values.size());
-                    for (size_t k = 0; k < mesh.tangents.values.size(); k++) {
-                        const PXR_NS::GfVec3f& normal = mesh.normals.values[k];
-                        const PXR_NS::GfVec4f& tangent = mesh.tangents.values[k];
-                        PXR_NS::GfVec3f tangentXYZ(tangent[0], tangent[1], tangent[2]);
-                        float handedness = tangent[3];
-                        
-                        if (std::abs(handedness) < 0.5f) {
-                            TF_WARN("Invalid handedness value %f in tangent data, assuming +1", handedness);
-                            handedness = 1.0f;
-                        } else {
-                            handedness = handedness >= 0.0f ? 1.0f : -1.0f;
-                        }
-                        
-                        // Compute bitangent using cross product: normal × tangentXYZ
-                        PXR_NS::GfVec3f crossProduct(
-                            normal[1] * tangentXYZ[2] - normal[2] * tangentXYZ[1],  // x = ny*tz - nz*ty
-                            normal[2] * tangentXYZ[0] - normal[0] * tangentXYZ[2],  // y = nz*tx - nx*tz
-                            normal[0] * tangentXYZ[1] - normal[1] * tangentXYZ[0]   // z = nx*ty - ny*tx
-                        );
-                        mesh.bitangents.values[k] = crossProduct * handedness;
-                    }
-                    mesh.bitangents.interpolation = UsdGeomTokens->vertex;
-                } else if (ctx.options->computeBitangents && mesh.normals.values.size() > 0) {
-                    TF_WARN("Tangent and normal vertex counts don't match (%zu tangents, %zu normals). "
-                           "Skipping bitangent computation.",
-                           mesh.tangents.values.size(),
-                           mesh.normals.values.size());
-                }
+    // if there is one uv set, check for more
+    if (uvsIndex >= 0 && mesh.uvs.values.size()) {
+        // this is an infinite loop but will exit when TEXCOORD_n is not found
+        for (int n = 1; true; n++) {
+            int uvsIndex =
+              getPrimitiveAttribute(primitive, "TEXCOORD_" + std::to_string(n));
+            if (uvsIndex < 0)
+                break;
+
+            // add a new primvar for the additional UV set
+            mesh.extraUVSets.push_back(Primvar<PXR_NS::GfVec2f>());
+            Primvar<PXR_NS::GfVec2f>& uvs = mesh.extraUVSets[n - 1];
+            uvs.values = PXR_NS::VtArray<PXR_NS::GfVec2f>(
+              getAccessorElementCount(*ctx.gltf, uvsIndex));
+            // Flip V coordinates for additional UV sets as well
+            readAccessorTexCoords(*ctx.gltf, uvsIndex, uvs.values.data());
+            uvs.interpolation = UsdGeomTokens->vertex;
+        }
+    }
+
+    switch (primitive.mode) {
+        case TINYGLTF_MODE_TRIANGLES:
+            mesh.indices = std::move(indices);
+
+            if (mesh.indices.size() < 3) {
+                TF_WARN("GLTF TRIANGLE primitive has fewer than 3 indices\n");
+            }
+            if (mesh.indices.size() % 3 != 0) {
+                TF_WARN("GLTF TRIANGLE primitive has a number of indices not divisible "
+                        "by 3\n");
             }
+            
+            break;
+        case TINYGLTF_MODE_TRIANGLE_STRIP: {
+            const PXR_NS::VtArray<int>& stripIndices = indices;
 
-            // TEXCOORD_0 is optional - only read if present
-            if (uvsIndex >= 0) {
-                mesh.uvs.values =
-                  PXR_NS::VtArray<PXR_NS::GfVec2f>(getAccessorElementCount(*ctx.gltf, uvsIndex));
-                readAccessorDataToFloat(
-                  *ctx.gltf, uvsIndex, reinterpret_cast<float*>(mesh.uvs.values.data()));
-                // Flip V coordinates for glTF files to match USD convention
-                for (auto& uv : mesh.uvs.values) {
-                    uv[1] = 1.0f - uv[1];
+            if (stripIndices.size() < 3) {
+                TF_WARN("GLTF TRIANGLE_STRIP primitive has fewer than 3 indices\n");
+            } else {
+                mesh.indices.resize(3 * (stripIndices.size() - 2));
+                for (size_t i = 0; i < stripIndices.size() - 2; i++) {
+                    mesh.indices[3 * i] = stripIndices[i];
+                    mesh.indices[3 * i + 1] = stripIndices[i + 1 + (i % 2)];
+                    mesh.indices[3 * i + 2] = stripIndices[i + 2 - (i % 2)];
                 }
-                mesh.uvs.interpolation = UsdGeomTokens->vertex;
             }
 
-            // if there is one uv set, check for more
-            if (uvsIndex >= 0 && mesh.uvs.values.size()) {
-                // this is an infinite loop but will exit when TEXCOORD_n is not found
-                for (int n = 1; true; n++) {
-                    int uvsIndex =
-                      getPrimitiveAttribute(primitive, "TEXCOORD_" + std::to_string(n));
-                    if (uvsIndex < 0)
-                        break;
-
-                    // add a new primvar for the additional UV set
-                    mesh.extraUVSets.push_back(Primvar<PXR_NS::GfVec2f>());
-                    Primvar<PXR_NS::GfVec2f>& uvs = mesh.extraUVSets[n - 1];
-                    uvs.values = PXR_NS::VtArray<PXR_NS::GfVec2f>(
-                      getAccessorElementCount(*ctx.gltf, uvsIndex));
-                    readAccessorDataToFloat(
-                      *ctx.gltf, uvsIndex, reinterpret_cast<float*>(uvs.values.data()));
-                    // Flip V coordinates for additional UV sets as well
-                    for (auto& uv : uvs.values) {
-                        uv[1] = 1.0f - uv[1];
-                    }
-                    uvs.interpolation = UsdGeomTokens->vertex;
+            break;
+        }
+        case TINYGLTF_MODE_TRIANGLE_FAN: {
+            const PXR_NS::VtArray<int>& fanIndices = indices;
+
+            if (fanIndices.size() < 3) {
+                TF_WARN("GLTF TRIANGLE_FAN primitive has fewer than 3 indices\n");
+            } else {
+                mesh.indices.resize(3 * (fanIndices.size() - 2));
+                for (size_t i = 0; i < fanIndices.size() - 2; i++) {
+                    mesh.indices[3 * i] = fanIndices[i + 1];
+                    mesh.indices[3 * i + 1] = fanIndices[i + 2];
+                    mesh.indices[3 * i + 2] = fanIndices[0];
                 }
             }
 
-            switch (primitive.mode) {
-                case TINYGLTF_MODE_TRIANGLES:
-                    getIndices(*ctx.gltf, indicesIndex, mesh.points.size(), mesh.indices);
-
-                    if (mesh.indices.size() < 3) {
-                        TF_WARN("GLTF TRIANGLE primitive has fewer than 3 indices\n");
-                    }
-                    if (mesh.indices.size() % 3 != 0) {
-                        TF_WARN("GLTF TRIANGLE primitive has a number of indices not divisible "
-                                "by 3\n");
-                    }
-                    
-                    break;
-                case TINYGLTF_MODE_TRIANGLE_STRIP: {
-                    PXR_NS::VtArray<int> stripIndices;
-                    getIndices(*ctx.gltf, indicesIndex, mesh.points.size(), stripIndices);
+            break;
+        }
+        case TINYGLTF_MODE_POINTS:
+        case TINYGLTF_MODE_LINE:
+        case TINYGLTF_MODE_LINE_LOOP:
+        case TINYGLTF_MODE_LINE_STRIP:
+        default:
+            mesh.indices = std::move(indices);
 
-                    if (stripIndices.size() < 3) {
-                        TF_WARN("GLTF TRIANGLE_STRIP primitive has fewer than 3 indices\n");
-                    } else {
-                        mesh.indices.resize(3 * (stripIndices.size() - 2));
-                        for (size_t i = 0; i < stripIndices.size() - 2; i++) {
-                            mesh.indices[3 * i] = stripIndices[i];
-                            mesh.indices[3 * i + 1] = stripIndices[i + 1 + (i % 2)];
-                            mesh.indices[3 * i + 2] = stripIndices[i + 2 - (i % 2)];
-                        }
-                    }
+            TF_WARN("Encountered GLTF primitive with unsupported mode %d\n",
+                    primitive.mode);
 
-                    break;
-                }
-                case TINYGLTF_MODE_TRIANGLE_FAN: {
-                    PXR_NS::VtArray<int> fanIndices;
-                    getIndices(*ctx.gltf, indicesIndex, mesh.points.size(), fanIndices);
+            break;
+    }
+    mesh.faces = PXR_NS::VtArray<int>(mesh.indices.size() / 3, 3);
 
-                    if (fanIndices.size() < 3) {
-                        TF_WARN("GLTF TRIANGLE_FAN primitive has fewer than 3 indices\n");
-                    } else {
-                        mesh.indices.resize(3 * (fanIndices.size() - 2));
-                        for (size_t i = 0; i < fanIndices.size() - 2; i++) {
-                            mesh.indices[3 * i] = fanIndices[i + 1];
-                            mesh.indices[3 * i + 1] = fanIndices[i + 2];
-                            mesh.indices[3 * i + 2] = fanIndices[0];
-                        }
-                    }
+    importMeshJointWeights(*ctx.gltf, primitive, mesh);
 
-                    break;
-                }
-                case TINYGLTF_MODE_POINTS:
-                case TINYGLTF_MODE_LINE:
-                case TINYGLTF_MODE_LINE_LOOP:
-                case TINYGLTF_MODE_LINE_STRIP:
-                default:
-                    getIndices(*ctx.gltf, indicesIndex, mesh.points.size(), mesh.indices);
+    VtVec3fArray color;
+    VtFloatArray opacity;
+    readColor(*ctx.gltf, primitive, color, opacity);
+    if (color.size()) {
+        auto [colorIndex, colorPV] = ctx.usd->addColorSet(meshIndex);
+        colorPV.values = color;
+        colorPV.interpolation = UsdGeomTokens->vertex;
+    }
+    if (opacity.size()) {
+        auto [opacityIndex, opacityPV] = ctx.usd->addOpacitySet(meshIndex);
+        opacityPV.values = opacity;
+        opacityPV.interpolation = UsdGeomTokens->vertex;
+    }
+    if (primitive.material >= 0) {
+        if (ctx.gltf->materials.size() > primitive.material) {
+            mesh.material = primitive.material;
+            mesh.doubleSided = ctx.gltf->materials[primitive.material].doubleSided;
+        } else {
+            TF_WARN("Encountered GLTF primitive with an out of bounds material index %d\n",
+                    primitive.material);
+        }
+    }
+}
 
-                    TF_WARN("Encountered GLTF primitive with unsupported mode %d\n",
-                            primitive.mode);
+void
+importMeshes(ImportGltfContext& ctx)
+{
+    ctx.meshes.resize(ctx.gltf->meshes.size());
+    ctx.meshUseCount.resize(ctx.gltf->meshes.size(), 0);
 
-                    break;
-            }
-            mesh.faces = PXR_NS::VtArray<int>(mesh.indices.size() / 3, 3);
+    // A serial pass reserves a mesh for every primitive (even if it turns out to be invalid), in
+    // the order of the glTF meshes and their primitives, so that the meshes do not depend on the
+    // order in which the primitives are decoded
+    std::vector<std::pair<size_t, size_t>> primitives;
+    for (size_t i = 0; i < ctx.gltf->meshes.size(); i++) {
+        const tinygltf::Mesh& gmesh = ctx.gltf->meshes[i];
+        ctx.meshes[i].resize(gmesh.primitives.size());
+        for (size_t j = 0; j < gmesh.primitives.size(); j++) {
+            ctx.meshes[i][j] = ctx.usd->addMesh().first;
+            primitives.push_back({ i, j });
+        }
+    }
 
-            importMeshJointWeights(*ctx.gltf, primitive, mesh);
+    // TODO: Combine primitives into a single large mesh if possible. When different
+    // primitives have different materials, use a mesh subset to store this information.
+    // Be aware of properly combining UV subsets
 
-            VtVec3fArray color;
-            VtFloatArray opacity;
-            readColor(*ctx.gltf, primitive, color, opacity);
-            if (color.size()) {
-                auto [colorIndex, colorPV] = ctx.usd->addColorSet(meshIndex);
-                colorPV.values = color;
-                colorPV.interpolation = UsdGeomTokens->vertex;
-            }
-            if (opacity.size()) {
-                auto [opacityIndex, opacityPV] = ctx.usd->addOpacitySet(meshIndex);
-                opacityPV.values = opacity;
-                opacityPV.interpolation = UsdGeomTokens->vertex;
-            }
-            if (primitive.material >= 0) {
-                if (ctx.gltf->materials.size() > primitive.material) {
-                    mesh.material = primitive.material;
-                    mesh.doubleSided = ctx.gltf->materials[primitive.material].doubleSided;
-                } else {
-                    TF_WARN("Encountered GLTF primitive with an out of bounds material index %d\n",
-                            primitive.material);
-                }
-            }
+    // Then the primitives are decoded in parallel, each into its own mesh
+    WorkParallelForN(primitives.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            const auto [i, j] = primitives[k];
+            importPrimitive(ctx, ctx.gltf->meshes[i], j, ctx.meshes[i][j]);
         }
-    }
+    });
 }
 
 // Traverses the glTF nodes to construct names appropriate for UsdSkel API consumption 
@@ -2526,6 +2534,75 @@ importNgpExtension(const tinygltf::Value& ngp, NgpData& ngpData)
       GfMatrix4d(GfRotation(GfVec3d(1.0, 0.0, 0.0), -90.0), GfVec3d(0.0, 0.0, 0.0));
 }
 
+// Imports the instance transforms of EXT_mesh_gpu_instancing as a point instancer that has the
+// meshes of the node as its single prototype. Returns false if the node does not use the extension
+// or the extension is invalid, in which case the meshes are placed on the node as usual.
+bool
+importGpuInstancing(ImportGltfContext& ctx, const tinygltf::Node& node, Node& n)
+{
+    const auto ext = node.extensions.find("EXT_mesh_gpu_instancing");
+    if (ext == node.extensions.end()) {
+        return false;
+    }
+    const tinygltf::Value& attributes = ext->second.Get("attributes");
+    size_t instanceCount = 0;
+    bool valid = true;
+    auto getAttribute = [&](const char* name, int type) {
+        const tinygltf::Value& value = attributes.Get(name);
+        if (!value.IsNumber()) {
+            return -1;
+        }
+        const int accessorIndex = value.GetNumberAsInt();
+        if (accessorIndex < 0 || static_cast<size_t>(accessorIndex) >= ctx.gltf->accessors.size() ||
+            ctx.gltf->accessors[accessorIndex].type != type) {
+            valid = false;
+            return -1;
+        }
+        const size_t count = ctx.gltf->accessors[accessorIndex].count;
+        valid &= instanceCount == 0 || instanceCount == count;
+        instanceCount = count;
+        return accessorIndex;
+    };
+    const int translations = getAttribute("TRANSLATION", TINYGLTF_TYPE_VEC3);
+    const int rotations = getAttribute("ROTATION", TINYGLTF_TYPE_VEC4);
+    const int scales = getAttribute("SCALE", TINYGLTF_TYPE_VEC3);
+    if (!valid || instanceCount == 0) {
+        TF_WARN("Node '%s' has invalid EXT_mesh_gpu_instancing attributes", node.name.c_str());
+        return false;
+    }
+
+    auto [instancerIndex, instancer] = ctx.usd->addPointInstancer();
+    n.pointInstancer = instancerIndex;
+    instancer.name = "Instances";
+    instancer.prototypes.push_back(ctx.meshes[node.mesh]);
+    instancer.protoIndices.assign(instanceCount, 0);
+    instancer.positions.resize(instanceCount);
+    if (translations >= 0) {
+        readAccessorDataToFloat(
+          *ctx.gltf, translations, reinterpret_cast<float*>(instancer.positions.data()));
+    }
+    if (rotations >= 0) {
+        std::vector<GfVec4f> values(instanceCount);
+        readAccessorDataToFloat(*ctx.gltf, rotations, reinterpret_cast<float*>(values.data()));
+        instancer.orientations.resize(instanceCount);
+        for (size_t i = 0; i < instanceCount; i++) {
+            // glTF quaternions are stored as (x, y, z, w)
+            const GfVec4f& q = values[i];
+            instancer.orientations[i] = GfQuath(GfQuatf(q[3], q[0], q[1], q[2]).GetNormalized());
+        }
+    }
+    if (scales >= 0) {
+        instancer.scales.resize(instanceCount);
+        readAccessorDataToFloat(
+          *ctx.gltf, scales, reinterpret_cast<float*>(instancer.scales.data()));
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_GLTF,
+                 "glTF::read EXT_mesh_gpu_instancing: node '%s' with %zu instances\n",
+                 node.name.c_str(),
+                 instanceCount);
+    return true;
+}
+
 // We traverse the glTF nodes recursively from root to children and assign each node a usd index
 // We maintain a mapping from the gltf node index to the usd node index in `nodeMap` for reference.
 int _traverseNodes(ImportGltfContext& ctx, std::vector<int>& skinnedNodes, int& curUsdIndex, 
@@ -2660,7 +2737,7 @@ int _traverseNodes(ImportGltfContext& ctx, std::vector<int>& skinnedNodes, int&
                 // Defer setting up relationships for skinned nodes until all nodes have been
                 // traversed
                 skinnedNodes.push_back(nodeIndex);
-            } else {
+            } else if (!importGpuInstancing(ctx, node, n)) {
                 n.staticMeshes = ctx.meshes[node.mesh];
             }
         }
@@ -2837,12 +2914,14 @@ static const std::set<std::string> supportedExtension = {
     "KHR_materials_unlit",
     // "KHR_materials_variants",
     "KHR_materials_volume",
-    // "KHR_mesh_quantization",
+    "KHR_mesh_quantization",
     // "KHR_texture_basisu",
     "KHR_texture_transform",
     // "KHR_xmp_json_ld",
-    // "EXT_mesh_gpu_instancing",
-    // "EXT_meshopt_compression",
+    "EXT_mesh_gpu_instancing",
+#ifdef USDGLTF_ENABLE_MESHOPT
+    "EXT_meshopt_compression",
+#endif
     "EXT_texture_webp",
 
     // Vendor extensions
@@ -9,16 +9,210 @@ the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTA
 OF ANY KIND, either express or implied. See the License for the specific language
 governing permissions and limitations under the License.
 */
+#include "gltf.h"
 #include <gtest/gtest.h>
+#include <cstring>
+#include <fstream>
+#include <pxr/base/gf/rotation.h>
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/resolver.h>
 #include <pxr/usd/sdf/assetPath.h>
 #include <pxr/usd/usd/attribute.h>
 #include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/metrics.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
+#include <pxr/usd/usdGeom/primvarsAPI.h>
+#include <pxr/usd/usdGeom/scope.h>
+#include <pxr/usd/usdGeom/xform.h>
+#include <pxr/usd/usdGeom/xformCache.h>
+#include <sstream>
+#include <vector>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
+namespace {
+struct FaceVertex
+{
+    GfVec3f point;
+    GfVec3f normal;
+    GfVec2f uv;
+};
+
+// Creates a Y-up stage in meters, so that the glTF export does not add a correction node
+UsdStageRefPtr
+createStage()
+{
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomSetStageUpAxis(stage, UsdGeomTokens->y);
+    UsdGeomSetStageMetersPerUnit(stage, 1.0);
+    UsdGeomXform root = UsdGeomXform::Define(stage, SdfPath("/Root"));
+    stage->SetDefaultPrim(root.GetPrim());
+    return stage;
+}
+
+// Defines a bumpy grid of quads at an offset, with vertex normals and texture coordinates
+UsdGeomMesh
+defineGrid(const UsdStageRefPtr& stage, const SdfPath& path, int size, const GfVec3f& offset)
+{
+    VtVec3fArray points;
+    VtVec3fArray normals;
+    VtVec2fArray uvs;
+    for (int y = 0; y <= size; y++) {
+        for (int x = 0; x <= size; x++) {
+            const float height = 0.1f * ((x * y) % 3);
+            points.push_back(offset + GfVec3f(0.5f * x, height, 0.5f * y));
+            normals.push_back(GfVec3f(0.1f * x - 0.25f, 1.0f, 0.05f * y).GetNormalized());
+            uvs.push_back(GfVec2f(x, y) / static_cast<float>(size));
+        }
+    }
+    VtIntArray faceVertexCounts(size * size, 4);
+    VtIntArray faceVertexIndices;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const int corner = y * (size + 1) + x;
+            for (int index : { corner, corner + size + 1, corner + size + 2, corner + 1 }) {
+                faceVertexIndices.push_back(index);
+            }
+        }
+    }
+
+    UsdGeomMesh mesh = UsdGeomMesh::Define(stage, path);
+    mesh.CreateSubdivisionSchemeAttr(VtValue(UsdGeomTokens->none));
+    mesh.CreatePointsAttr(VtValue(points));
+    mesh.CreateFaceVertexCountsAttr(VtValue(faceVertexCounts));
+    mesh.CreateFaceVertexIndicesAttr(VtValue(faceVertexIndices));
+    mesh.CreateNormalsAttr(VtValue(normals));
+    mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
+    UsdGeomPrimvarsAPI(mesh)
+      .CreatePrimvar(TfToken("st"), SdfValueTypeNames->TexCoord2fArray, UsdGeomTokens->vertex)
+      .Set(uvs);
+    return mesh;
+}
+
+// Returns the world space point, normal and texture coordinate of every face vertex of every mesh
+// of the stage, which does not depend on how the meshes are indexed or split
+std::vector<FaceVertex>
+readFaceVertices(const UsdStageRefPtr& stage)
+{
+    std::vector<FaceVertex> faceVertices;
+    UsdGeomXformCache xformCache;
+    for (const UsdPrim& prim : stage->Traverse()) {
+        UsdGeomMesh mesh(prim);
+        if (!mesh) {
+            continue;
+        }
+        const GfMatrix4d transform = xformCache.GetLocalToWorldTransform(prim);
+        UsdGeomPrimvarsAPI primvarsAPI(prim);
+        VtVec3fArray points;
+        VtIntArray faceVertexIndices;
+        mesh.GetPointsAttr().Get(&points);
+        mesh.GetFaceVertexIndicesAttr().Get(&faceVertexIndices);
+
+        VtVec3fArray normals;
+        TfToken normalsInterpolation;
+        const UsdGeomPrimvar normalsPrimvar = primvarsAPI.GetPrimvar(UsdGeomTokens->normals);
+        if (normalsPrimvar && normalsPrimvar.ComputeFlattened(&normals)) {
+            normalsInterpolation = normalsPrimvar.GetInterpolation();
+        } else {
+            mesh.GetNormalsAttr().Get(&normals);
+            normalsInterpolation = mesh.GetNormalsInterpolation();
+        }
+        VtVec2fArray uvs;
+        TfToken uvsInterpolation;
+        const UsdGeomPrimvar uvsPrimvar = primvarsAPI.GetPrimvar(TfToken("st"));
+        if (uvsPrimvar && uvsPrimvar.ComputeFlattened(&uvs)) {
+            uvsInterpolation = uvsPrimvar.GetInterpolation();
+        }
+
+        for (size_t i = 0; i < faceVertexIndices.size(); i++) {
+            const size_t vertex = faceVertexIndices[i];
+            const size_t normal = normalsInterpolation == UsdGeomTokens->faceVarying ? i : vertex;
+            const size_t uv = uvsInterpolation == UsdGeomTokens->faceVarying ? i : vertex;
+            FaceVertex faceVertex;
+            faceVertex.point = GfVec3f(transform.Transform(GfVec3d(points[vertex])));
+            faceVertex.normal = normal < normals.size()
+                                  ? GfVec3f(transform.TransformDir(GfVec3d(normals[normal])))
+                                  : GfVec3f(0.0f);
+            faceVertex.normal.Normalize();
+            faceVertex.uv = uv < uvs.size() ? uvs[uv] : GfVec2f(0.0f);
+            faceVertices.push_back(faceVertex);
+        }
+    }
+    return faceVertices;
+}
+
+// Matches every face vertex of the result to the nearest source face vertex and checks that they
+// agree within the given tolerances
+void
+compareFaceVertices(const std::vector<FaceVertex>& source,
+                    const std::vector<FaceVertex>& result,
+                    float pointTolerance,
+                    float normalTolerance,
+                    float uvTolerance)
+{
+    ASSERT_FALSE(source.empty());
+    for (const FaceVertex& faceVertex : result) {
+        const FaceVertex* nearest = &source[0];
+        for (const FaceVertex& candidate : source) {
+            if ((candidate.point - faceVertex.point).GetLengthSq() <
+                (nearest->point - faceVertex.point).GetLengthSq()) {
+                nearest = &candidate;
+            }
+        }
+        ASSERT_LT((nearest->point - faceVertex.point).GetLength(), pointTolerance);
+        ASSERT_LT((nearest->normal - faceVertex.normal).GetLength(), normalTolerance);
+        ASSERT_LT((nearest->uv - faceVertex.uv).GetLength(), uvTolerance);
+    }
+}
+
+// Returns the world space transforms of the instances of the first point instancer of the stage
+VtMatrix4dArray
+computeInstanceTransforms(const UsdStageRefPtr& stage)
+{
+    VtMatrix4dArray transforms;
+    UsdGeomXformCache xformCache;
+    for (const UsdPrim& prim : stage->Traverse()) {
+        UsdGeomPointInstancer instancer(prim);
+        if (!instancer) {
+            continue;
+        }
+        const UsdTimeCode time = UsdTimeCode::EarliestTime();
+        instancer.ComputeInstanceTransformsAtTime(&transforms, time, time);
+        const GfMatrix4d worldTransform = xformCache.GetLocalToWorldTransform(prim);
+        for (GfMatrix4d& transform : transforms) {
+            transform *= worldTransform;
+        }
+        break;
+    }
+    return transforms;
+}
+
+std::string
+readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Returns the JSON chunk of a GLB file, which directly follows the 12 byte header
+std::string
+readGlbJson(const std::string& filename)
+{
+    const std::string glb = readFile(filename);
+    uint32_t jsonLength = 0;
+    if (glb.size() < 20 || glb.compare(0, 4, "glTF") != 0) {
+        return std::string();
+    }
+    std::memcpy(&jsonLength, glb.data() + 12, sizeof(jsonLength));
+    return glb.substr(20, jsonLength);
+}
+}
+
 TEST(GlTFSanityTests, LoadCube)
 {
     // Load an FBX
@@ -27,3 +221,184 @@ TEST(GlTFSanityTests, LoadCube)
     UsdPrim mesh = stage->GetPrimAtPath(SdfPath("/SanityCube/Cube"));
     ASSERT_TRUE(mesh);
 }
+
+TEST(GlTFSanityTests, QuantizedRoundTrip)
+{
+    // The grid is far from the origin, so that positions are only precise enough when they are
+    // dequantized by the node transform that the export adds
+    const int gridSize = 5;
+    UsdStageRefPtr stage = createStage();
+    defineGrid(stage, SdfPath("/Root/Grid"), gridSize, GfVec3f(100.0f, 50.0f, -20.0f));
+    ASSERT_TRUE(stage->Export("QuantizedGrid.gltf", false, { { "quantize", "true" } }));
+    const std::string json = readFile("QuantizedGrid.gltf");
+    EXPECT_NE(json.find("KHR_mesh_quantization"), std::string::npos);
+    // The buffers are streamed to a single file next to the JSON
+    EXPECT_NE(json.find("\"QuantizedGrid.bin\""), std::string::npos);
+
+    UsdStageRefPtr quantized = UsdStage::Open("QuantizedGrid.gltf");
+    ASSERT_TRUE(quantized);
+    const std::vector<FaceVertex> source = readFaceVertices(stage);
+    const std::vector<FaceVertex> result = readFaceVertices(quantized);
+    // The quads are triangulated
+    ASSERT_EQ(result.size(), static_cast<size_t>(6 * gridSize * gridSize));
+    // Positions are 16 bit, normals 8 bit and texture coordinates 16 bit normalized integers
+    compareFaceVertices(source, result, 1e-3f, 0.02f, 1e-4f);
+}
+
+#ifdef USD_FILEFORMATS_ENABLE_MESHOPT
+TEST(GlTFSanityTests, MeshoptRoundTrip)
+{
+    const int gridSize = 5;
+    UsdStageRefPtr stage = createStage();
+    defineGrid(stage, SdfPath("/Root/Grid"), gridSize, GfVec3f(1.0f, 2.0f, 3.0f));
+    ASSERT_TRUE(stage->Export("MeshoptGrid.glb", false, { { "meshopt", "true" } }));
+    // The uncompressed ranges of the bufferViews are in a fallback buffer without data
+    const std::string json = readGlbJson("MeshoptGrid.glb");
+    EXPECT_NE(json.find("EXT_meshopt_compression"), std::string::npos);
+    EXPECT_NE(json.find("\"fallback\""), std::string::npos);
+    // The compressed ranges are laid out in the binary chunk, with integer sizes and offsets
+    const nlohmann::json gltf = nlohmann::json::parse(json);
+    size_t numCompressed = 0;
+    for (const nlohmann::json& bufferView : gltf["bufferViews"]) {
+        if (!bufferView.contains("extensions")) {
+            continue;
+        }
+        const nlohmann::json& ext = bufferView["extensions"]["EXT_meshopt_compression"];
+        EXPECT_EQ(ext["buffer"], 0);
+        EXPECT_TRUE(ext["byteOffset"].is_number_integer());
+        EXPECT_TRUE(ext["byteLength"].is_number_integer());
+        EXPECT_LE(ext["byteOffset"].get<size_t>() + ext["byteLength"].get<size_t>(),
+                  gltf["buffers"][0]["byteLength"].get<size_t>());
+        numCompressed++;
+    }
+    EXPECT_GT(numCompressed, 0u);
+
+    UsdStageRefPtr decoded = UsdStage::Open("MeshoptGrid.glb");
+    ASSERT_TRUE(decoded);
+    const std::vector<FaceVertex> source = readFaceVertices(stage);
+    const std::vector<FaceVertex> result = readFaceVertices(decoded);
+    ASSERT_EQ(result.size(), static_cast<size_t>(6 * gridSize * gridSize));
+    // The vertices are reordered for the vertex cache, but the encoding itself is lossless
+    compareFaceVertices(source, result, 1e-4f, 1e-4f, 1e-4f);
+
+    // The fallback buffer is added to the JSON of a gltf file, without a file of its own
+    ASSERT_TRUE(stage->Export("MeshoptGrid.gltf", false, { { "meshopt", "true" } }));
+    EXPECT_NE(readFile("MeshoptGrid.gltf").find("\"fallback\""), std::string::npos);
+    UsdStageRefPtr decodedGltf = UsdStage::Open("MeshoptGrid.gltf");
+    ASSERT_TRUE(decodedGltf);
+    compareFaceVertices(source, readFaceVertices(decodedGltf), 1e-4f, 1e-4f, 1e-4f);
+}
+#endif
+
+TEST(GlTFSanityTests, MeshoptCompressionLargeOffset)
+{
+    // Once the buffers are laid out, compressed data can start past 4 GB, which must not wrap like
+    // the int values of tinygltf
+    const size_t offset = size_t(3) << 30;
+    const size_t byteLength = (size_t(1) << 31) + 12;
+    const size_t count = (size_t(1) << 32) + 1;
+    tinygltf::Value ext =
+      adobe::usd::meshoptCompressionValue(5, 16, byteLength, 12, count, "ATTRIBUTES");
+    adobe::usd::rebaseMeshoptCompression(ext, 0, offset);
+    adobe::usd::rebaseMeshoptCompression(ext, 0, offset);
+    EXPECT_EQ(ext.Get("buffer").GetNumberAsInt(), 0);
+    EXPECT_EQ(static_cast<size_t>(ext.Get("byteOffset").GetNumberAsDouble()), 2 * offset + 16);
+    EXPECT_EQ(static_cast<size_t>(ext.Get("byteLength").GetNumberAsDouble()), byteLength);
+    EXPECT_EQ(static_cast<size_t>(ext.Get("byteStride").GetNumberAsDouble()), 12u);
+    EXPECT_EQ(static_cast<size_t>(ext.Get("count").GetNumberAsDouble()), count);
+    EXPECT_EQ(ext.Get("mode").Get<std::string>(), "ATTRIBUTES");
+}
+
+TEST(GlTFSanityTests, PointInstancerRoundTrip)
+{
+    UsdStageRefPtr stage = createStage();
+    UsdGeomPointInstancer instancer =
+      UsdGeomPointInstancer::Define(stage, SdfPath("/Root/Instancer"));
+    UsdGeomScope::Define(stage, SdfPath("/Root/Instancer/Prototypes"));
+    defineGrid(stage, SdfPath("/Root/Instancer/Prototypes/Grid"), 2, GfVec3f(0.0f));
+    instancer.CreatePrototypesRel().AddTarget(SdfPath("/Root/Instancer/Prototypes/Grid"));
+    const VtVec3fArray positions = {
+        GfVec3f(0.0f, 0.0f, 0.0f),
+        GfVec3f(2.0f, 0.0f, 0.0f),
+        GfVec3f(0.0f, 3.0f, 1.0f),
+        GfVec3f(-1.0f, 1.0f, -2.0f),
+    };
+    const VtQuathArray orientations = {
+        GfQuath::GetIdentity(),
+        GfQuath(GfRotation(GfVec3d(0.0, 1.0, 0.0), 90.0).GetQuat()),
+        GfQuath(GfRotation(GfVec3d(1.0, 0.0, 0.0), 45.0).GetQuat()),
+        GfQuath(GfRotation(GfVec3d(1.0, 1.0, 1.0), 120.0).GetQuat()),
+    };
+    const VtVec3fArray scales = {
+        GfVec3f(1.0f, 1.0f, 1.0f),
+        GfVec3f(0.5f, 0.5f, 0.5f),
+        GfVec3f(1.0f, 2.0f, 1.0f),
+        GfVec3f(2.0f, 1.0f, 0.5f),
+    };
+    instancer.CreateProtoIndicesAttr(VtValue(VtIntArray(positions.size(), 0)));
+    instancer.CreatePositionsAttr(VtValue(positions));
+    instancer.CreateOrientationsAttr(VtValue(orientations));
+    instancer.CreateScalesAttr(VtValue(scales));
+    // The extension is required when it is used, hence it is opt in
+    ASSERT_TRUE(stage->Export("ExpandedGrid.glb", false));
+    EXPECT_EQ(readGlbJson("ExpandedGrid.glb").find("EXT_mesh_gpu_instancing"), std::string::npos);
+    ASSERT_TRUE(stage->Export("InstancedGrid.glb", false, { { "gpuInstancing", "true" } }));
+    EXPECT_NE(readGlbJson("InstancedGrid.glb").find("EXT_mesh_gpu_instancing"),
+              std::string::npos);
+
+    UsdStageRefPtr instanced = UsdStage::Open("InstancedGrid.glb");
+    ASSERT_TRUE(instanced);
+    const VtMatrix4dArray source = computeInstanceTransforms(stage);
+    const VtMatrix4dArray result = computeInstanceTransforms(instanced);
+    ASSERT_EQ(source.size(), positions.size());
+    ASSERT_EQ(result.size(), source.size());
+    // The orientations are half precision quaternions
+    for (size_t i = 0; i < source.size(); i++) {
+        ASSERT_TRUE(GfIsClose(source[i], result[i], 1e-2));
+    }
+}
+
+TEST(GlTFSanityTests, MultipleMeshesGlbRoundTrip)
+{
+    // Grids of different sizes, whose quantized buffers are not multiples of 4 bytes long, so
+    // that the buffers are padded when they are laid out in the BIN chunk
+    UsdStageRefPtr stage = createStage();
+    size_t numFaceVertices = 0;
+    for (int i = 0; i < 3; i++) {
+        const int gridSize = 3 + i;
+        defineGrid(stage,
+                   SdfPath("/Root/Grid" + std::to_string(i)),
+                   gridSize,
+                   GfVec3f(10.0f * i, -5.0f * i, 2.0f));
+        numFaceVertices += 6 * gridSize * gridSize;
+    }
+    ASSERT_TRUE(stage->Export("MultipleGrids.glb", false, { { "quantize", "true" } }));
+
+    // The header holds the total length, followed by the JSON and BIN chunks, which are each
+    // padded to a multiple of 4 bytes
+    const std::string glb = readFile("MultipleGrids.glb");
+    ASSERT_GE(glb.size(), 28u);
+    uint32_t header[3];
+    std::memcpy(header, glb.data(), sizeof(header));
+    ASSERT_EQ(glb.compare(0, 4, "glTF"), 0);
+    ASSERT_EQ(header[1], 2u);
+    ASSERT_EQ(header[2], glb.size());
+    uint32_t jsonLength = 0;
+    std::memcpy(&jsonLength, glb.data() + 12, sizeof(jsonLength));
+    ASSERT_EQ(jsonLength % 4, 0u);
+    const size_t binOffset = 20 + static_cast<size_t>(jsonLength);
+    ASSERT_LE(binOffset + 8, glb.size());
+    uint32_t binLength = 0;
+    std::memcpy(&binLength, glb.data() + binOffset, sizeof(binLength));
+    ASSERT_EQ(glb.compare(binOffset + 4, 4, std::string("BIN\0", 4)), 0);
+    ASSERT_EQ(binLength % 4, 0u);
+    ASSERT_EQ(binOffset + 8 + binLength, glb.size());
+
+    UsdStageRefPtr reimported = UsdStage::Open("MultipleGrids.glb");
+    ASSERT_TRUE(reimported);
+    const std::vector<FaceVertex> source = readFaceVertices(stage);
+    const std::vector<FaceVertex> result = readFaceVertices(reimported);
+    ASSERT_EQ(result.size(), numFaceVertices);
+    // Wrong bufferView offsets would read the data of another grid, or of another attribute
+    compareFaceVertices(source, result, 1e-3f, 0.02f, 1e-4f);
+}
@@ -33,6 +33,7 @@ using namespace adobe::usd;
 const TfToken UsdObjFileFormat::assetsPathToken("objAssetsPath", TfToken::Immortal);
 const TfToken UsdObjFileFormat::phongToken("objPhong", TfToken::Immortal);
 const TfToken UsdObjFileFormat::originalColorSpaceToken("objOriginalColorSpace", TfToken::Immortal);
+const TfToken UsdObjFileFormat::maxFacesPerMeshToken("objMaxFacesPerMesh", TfToken::Immortal);
 
 TF_DEFINE_PUBLIC_TOKENS(UsdObjFileFormatTokens, USDOBJ_FILE_FORMAT_TOKENS);
 TF_REGISTRY_FUNCTION(TfType)
@@ -68,6 +69,7 @@ UsdObjFileFormat::InitData(const FileFormatArguments& args) const
 
     argReadBool(args, phongToken.GetString(), pd->phong, DEBUG_TAG);
     argReadString(args, originalColorSpaceToken.GetString(), pd->originalColorSpace, DEBUG_TAG);
+    argReadInt(args, maxFacesPerMeshToken.GetString(), pd->maxFacesPerMesh, DEBUG_TAG);
     return pd;
 }
 void
@@ -79,6 +81,7 @@ UsdObjFileFormat::ComposeFieldsForFileFormatArguments(const std::string& assetPa
     argComposeString(context, args, assetsPathToken, DEBUG_TAG);
     argComposeBool(context, args, phongToken, DEBUG_TAG);
     argComposeString(context, args, originalColorSpaceToken, DEBUG_TAG);
+    argComposeInt(context, args, maxFacesPerMeshToken, DEBUG_TAG);
 }
 
 bool
@@ -120,6 +123,9 @@ UsdObjFileFormat::Read(SdfLayer* layer, const std::string& resolvedPath, bool me
     GUARD(
       readObj(obj, resolvedPath, readImages), "Error reading OBJ from %s\n", resolvedPath.c_str());
     GUARD(importObj(options, obj, usd), "Error translating OBJ to USD\n");
+    if (data->maxFacesPerMesh > 0) {
+        partitionMeshes(usd, data->maxFacesPerMesh);
+    }
     GUARD(writeLayer(
             layerOptions, usd, layer, layerData, fileType, DEBUG_TAG, SdfFileFormat::_SetLayerData),
           "Error writing to the USD layer\n");
@@ -153,6 +159,9 @@ UsdObjFileFormat::ReadFromString(SdfLayer* layer, const std::string& input) cons
     options.importPhong = data->phong;
     GUARD(readObj(obj, input.c_str(), input.size()), "Error reading OBJ from string\n");
     GUARD(importObj(options, obj, usd), "Error translating OBJ to USD\n");
+    if (data->maxFacesPerMesh > 0) {
+        partitionMeshes(usd, data->maxFacesPerMesh);
+    }
     GUARD(writeLayer(
             layerOptions, usd, layer, layerData, "obj", DEBUG_TAG, SdfFileFormat::_SetLayerData),
           "Error writing to the USD stage\n");
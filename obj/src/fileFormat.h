@@ -35,6 +35,7 @@ class ObjData : public FileFormatDataBase
 {
   public:
     bool phong = false;
+    int maxFacesPerMesh = 0;
     TfToken originalColorSpace;
     static ObjDataRefPtr InitData(const SdfFileFormat::FileFormatArguments& args);
 };
@@ -92,6 +93,7 @@ class USDOBJ_API UsdObjFileFormat
     static const TfToken assetsPathToken;
     static const TfToken phongToken;
     static const TfToken originalColorSpaceToken;
+    static const TfToken maxFacesPerMeshToken;
 
     bool ReadFromStream(SdfLayer* layer,
                         std::istream& input,
@@ -17,12 +17,11 @@ governing permissions and limitations under the License.
 #include "plyImport.h"
 
 #include <fileformatutils/common.h>
+#include <fileformatutils/geometry.h>
 #include <fileformatutils/layerRead.h>
 #include <fileformatutils/layerWriteSdfData.h>
 #include <fileformatutils/usdData.h>
 
-#include <happly.h>
-
 #include <pxr/base/tf/fileUtils.h>
 #include <pxr/usd/usd/usdaFileFormat.h>
 
@@ -30,7 +29,6 @@ governing permissions and limitations under the License.
 #include <fstream>
 
 using namespace adobe::usd;
-using namespace happly;
 
 PXR_NAMESPACE_OPEN_SCOPE
 
@@ -71,6 +69,29 @@ UsdPlyFileFormat::InitData(const FileFormatArguments& args) const
                       UsdPlyFileFormatTokens->pointsGsplatClippingBox.GetText(),
                       pd->gsplatsClippingBox,
                       DEBUG_TAG);
+    argReadBool(args,
+                UsdPlyFileFormatTokens->gsplatsHalfPrecision.GetText(),
+                pd->gsplatsHalfPrecision,
+                DEBUG_TAG);
+    argReadFloat(
+      args, UsdPlyFileFormatTokens->gsplatsMinOpacity.GetText(), pd->gsplatsMinOpacity, DEBUG_TAG);
+    argReadFloat(
+      args, UsdPlyFileFormatTokens->gsplatsMinScale.GetText(), pd->gsplatsMinScale, DEBUG_TAG);
+    argReadBool(
+      args, UsdPlyFileFormatTokens->gsplatsPackedSH.GetText(), pd->gsplatsPackedSH, DEBUG_TAG);
+    argReadFloat(
+      args, UsdPlyFileFormatTokens->gsplatsMaxScale.GetText(), pd->gsplatsMaxScale, DEBUG_TAG);
+    argReadBool(args,
+                UsdPlyFileFormatTokens->gsplatsCullToClippingBox.GetText(),
+                pd->gsplatsCullToClippingBox,
+                DEBUG_TAG);
+    argReadInt(args, UsdPlyFileFormatTokens->maxSHDegree.GetText(), pd->maxSHDegree, DEBUG_TAG);
+    argReadBool(args, UsdPlyFileFormatTokens->mortonOrder.GetText(), pd->mortonOrder, DEBUG_TAG);
+    argReadInt(
+      args, UsdPlyFileFormatTokens->maxFacesPerMesh.GetText(), pd->maxFacesPerMesh, DEBUG_TAG);
+    argReadInt(args, UsdPlyFileFormatTokens->pointLevels.GetText(), pd->pointLevels, DEBUG_TAG);
+    argReadInt(args, UsdPlyFileFormatTokens->pointLevel.GetText(), pd->pointLevel, DEBUG_TAG);
+    argReadBool(args, UsdPlyFileFormatTokens->triangulate.GetText(), pd->triangulate, DEBUG_TAG);
     return pd;
 }
 
@@ -84,6 +105,18 @@ UsdPlyFileFormat::ComposeFieldsForFileFormatArguments(const std::string& assetPa
     argComposeFloat(context, args, UsdPlyFileFormatTokens->pointWidth, DEBUG_TAG);
     argComposeBool(context, args, UsdPlyFileFormatTokens->withUpAxisCorrection, DEBUG_TAG);
     argComposeFloatArray(context, args, UsdPlyFileFormatTokens->pointsGsplatClippingBox, DEBUG_TAG);
+    argComposeBool(context, args, UsdPlyFileFormatTokens->gsplatsHalfPrecision, DEBUG_TAG);
+    argComposeFloat(context, args, UsdPlyFileFormatTokens->gsplatsMinOpacity, DEBUG_TAG);
+    argComposeFloat(context, args, UsdPlyFileFormatTokens->gsplatsMinScale, DEBUG_TAG);
+    argComposeBool(context, args, UsdPlyFileFormatTokens->gsplatsPackedSH, DEBUG_TAG);
+    argComposeFloat(context, args, UsdPlyFileFormatTokens->gsplatsMaxScale, DEBUG_TAG);
+    argComposeBool(context, args, UsdPlyFileFormatTokens->gsplatsCullToClippingBox, DEBUG_TAG);
+    argComposeInt(context, args, UsdPlyFileFormatTokens->maxSHDegree, DEBUG_TAG);
+    argComposeBool(context, args, UsdPlyFileFormatTokens->mortonOrder, DEBUG_TAG);
+    argComposeInt(context, args, UsdPlyFileFormatTokens->maxFacesPerMesh, DEBUG_TAG);
+    argComposeInt(context, args, UsdPlyFileFormatTokens->pointLevels, DEBUG_TAG);
+    argComposeInt(context, args, UsdPlyFileFormatTokens->pointLevel, DEBUG_TAG);
+    argComposeBool(context, args, UsdPlyFileFormatTokens->triangulate, DEBUG_TAG);
 }
 
 bool
@@ -119,19 +152,34 @@ UsdPlyFileFormat::Read(SdfLayer* layer, const std::string& resolvedPath, bool me
         options.pointWidth = data->pointWidth;
         options.importWithUpAxisCorrection = data->withUpAxisCorrection;
         options.importGsplatClippingBox = data->gsplatsClippingBox;
+        options.gsplatPrune.minOpacity = data->gsplatsMinOpacity;
+        options.gsplatPrune.minScale = data->gsplatsMinScale;
+        options.gsplatPrune.maxScale = data->gsplatsMaxScale;
+        options.gsplatPrune.cullToClippingBox = data->gsplatsCullToClippingBox;
+        options.maxSHDegree = data->maxSHDegree;
+        options.halfPrecisionGsplats = data->gsplatsHalfPrecision;
+        options.triangulate = data->triangulate;
         WriteLayerOptions layerOptions(*data);
+        layerOptions.packedGsplatSHCoeffs = data->gsplatsPackedSH;
 
-        // Since the resolved path may contain non-ascii characters, we convert the string
-        // path to a filesystem path and then use it to create an ifstream we can then pass to
-        // the PLYData constructor.
-        const auto filePath = std::filesystem::u8path(resolvedPath);
-        std::ifstream inStream(filePath, std::ios::binary);
-        if (!inStream.is_open()) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Failed to open %s\n", resolvedPath.c_str());
-        }
-        PLYData ply(inStream);
+        // The reader memory maps the file and handles non-ascii characters in the resolved path
+        PlyReader ply;
+        GUARD(ply.open(resolvedPath), "Error reading PLY from %s\n", resolvedPath.c_str());
 
         GUARD(importPly(options, ply, usd), "Error translating PLY to USD\n");
+        if (data->maxFacesPerMesh > 0) {
+            partitionMeshes(usd, data->maxFacesPerMesh);
+        }
+        if (data->mortonOrder) {
+            sortPointCloudsByMortonCode(usd);
+        }
+        if (data->pointLevels > 1) {
+            // Each level is loaded from this file read for that level only
+            const std::string levelArg = UsdPlyFileFormatTokens->pointLevel.GetString();
+            buildPointCloudLevels(usd, data->pointLevels, data->pointLevel, [&](size_t level) {
+                return argLayerAssetPath(*layer, levelArg, std::to_string(level));
+            });
+        }
         GUARD(
           writeLayer(
             layerOptions, usd, layer, layerData, fileType, DEBUG_TAG, SdfFileFormat::_SetLayerData),
@@ -147,15 +195,49 @@ UsdPlyFileFormat::Read(SdfLayer* layer, const std::string& resolvedPath, bool me
 bool
 UsdPlyFileFormat::ReadFromString(SdfLayer* layer, const std::string& input) const
 {
-    // Ply ply;
-    // UsdData usd;
-    // GUARD(readPly(ply, input.c_str(), input.size()), "Error reading PLY from string\n");
-    // ImportPlyOptions options;
-    // GUARD(importPly(options, ply, usd), "Error translating PLY to USD\n");
-    // SdfLayerRefPtr newLayer = SdfLayer::CreateAnonymous(".usda");
-    // WriteLayerOptions layerOptions;
-    // GUARD(writeLayer(layerOptions, usd, newLayer), "Error writing to the USD stage\n",
-    // DEBUG_TAG); layer->TransferContent(newLayer);
+    TfStopwatch w;
+    w.Start();
+    SdfAbstractDataRefPtr layerData = InitData(layer->GetFileFormatArguments());
+    PlyDataConstPtr data = TfDynamic_cast<const PlyDataConstPtr>(layerData);
+    UsdData usd;
+    try {
+        ImportPlyOptions options;
+        options.importAsPoints = data->points;
+        options.pointWidth = data->pointWidth;
+        options.importWithUpAxisCorrection = data->withUpAxisCorrection;
+        options.importGsplatClippingBox = data->gsplatsClippingBox;
+        options.gsplatPrune.minOpacity = data->gsplatsMinOpacity;
+        options.gsplatPrune.minScale = data->gsplatsMinScale;
+        options.gsplatPrune.maxScale = data->gsplatsMaxScale;
+        options.gsplatPrune.cullToClippingBox = data->gsplatsCullToClippingBox;
+        options.maxSHDegree = data->maxSHDegree;
+        options.halfPrecisionGsplats = data->gsplatsHalfPrecision;
+        options.triangulate = data->triangulate;
+        WriteLayerOptions layerOptions(*data);
+        layerOptions.packedGsplatSHCoeffs = data->gsplatsPackedSH;
+        // The reader decodes straight from the string, which outlives it
+        PlyReader ply;
+        GUARD(ply.open(input.data(), input.size()), "Error reading PLY from string\n");
+        GUARD(importPly(options, ply, usd), "Error translating PLY to USD\n");
+        if (data->maxFacesPerMesh > 0) {
+            partitionMeshes(usd, data->maxFacesPerMesh);
+        }
+        if (data->mortonOrder) {
+            sortPointCloudsByMortonCode(usd);
+        }
+        if (data->pointLevels > 1) {
+            // Without a file to load the levels from, they are authored as internal payloads
+            buildPointCloudLevels(usd, data->pointLevels, data->pointLevel);
+        }
+        GUARD(
+          writeLayer(
+            layerOptions, usd, layer, layerData, "ply", DEBUG_TAG, SdfFileFormat::_SetLayerData),
+          "Error writing to the USD stage\n");
+    } catch (std::exception& e) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Failed to read from string: %s\n", e.what());
+    }
+    w.Stop();
+    TF_DEBUG_MSG(FILE_FORMAT_PLY, "Total time: %ld\n", static_cast<long int>(w.GetMilliseconds()));
     return true;
 }
 
@@ -168,7 +250,12 @@ UsdPlyFileFormat::WriteToFile(const SdfLayer& layer,
     TfStopwatch w;
     w.Start();
     UsdData usd;
-    PLYData ply;
+    ExportPlyOptions exportOptions;
+    argReadBool(args, "ascii", exportOptions.ascii, DEBUG_TAG);
+    argReadBool(args, "compressed", exportOptions.compressed, DEBUG_TAG);
+    argReadInt(args, "maxSHDegree", exportOptions.maxSHDegree, DEBUG_TAG);
+    bool mortonOrder = false;
+    argReadBool(args, "mortonOrder", mortonOrder, DEBUG_TAG);
     ReadLayerOptions layerOptions;
     layerOptions.flatten = true;
     // PLY doesn't support invisible primitives, so we filter them out here
@@ -176,15 +263,32 @@ UsdPlyFileFormat::WriteToFile(const SdfLayer& layer,
     SdfAbstractDataRefPtr layerData = InitData(layer.GetFileFormatArguments());
     PlyDataConstPtr data = TfDynamic_cast<const PlyDataConstPtr>(layerData);
     GUARD(readLayer(layerOptions, layer, usd, DEBUG_TAG), "Error reading USD\n");
-    GUARD(exportPly(usd, ply), "Error translating USD to PLY\n");
-    try {
-        // TODO: pass file format argument to select binary/ascii
-        const std::string parentPath = TfGetPathName(filename);
-        TfMakeDirs(parentPath, -1, true);
-        ply.write(filename, happly::DataFormat::Binary);
-    } catch (std::exception& e) {
-        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Error writing PLY to %s: %s\n", filename.c_str(), e.what());
+    if (mortonOrder) {
+        sortPointCloudsByMortonCode(usd);
+    }
+    const std::string parentPath = TfGetPathName(filename);
+    TfMakeDirs(parentPath, -1, true);
+    // The export is streamed to a temporary file next to the destination, so that memory stays
+    // bounded by a single mesh, and only replaces the destination once it succeeded. A failed
+    // export thus leaves no truncated file behind.
+    const std::filesystem::path path = std::filesystem::u8path(filename);
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    std::ofstream out(tempPath, std::ios::binary);
+    GUARD(out.is_open(), "Error opening %s for writing\n", filename.c_str());
+    bool exported = exportPly(exportOptions, usd, out);
+    out.close();
+    exported = exported && !out.fail();
+    std::error_code error;
+    if (exported) {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    if (!exported || error) {
+        std::error_code removeError;
+        std::filesystem::remove(tempPath, removeError);
     }
+    GUARD(exported, "Error translating USD to PLY\n");
+    GUARD(!error, "Error writing PLY to %s: %s\n", filename.c_str(), error.message().c_str());
     w.Stop();
     TF_DEBUG_MSG(FILE_FORMAT_PLY, "Total time: %ld\n", static_cast<long int>(w.GetMilliseconds()));
     return true;
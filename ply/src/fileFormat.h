@@ -29,7 +29,19 @@ PXR_NAMESPACE_OPEN_SCOPE
     ((points, "plyPoints")) \
     ((pointWidth, "plyPointWidth")) \
     ((withUpAxisCorrection, "plyWithUpAxisCorrection")) \
-    ((pointsGsplatClippingBox, "plyGsplatsClippingBox"))
+    ((pointsGsplatClippingBox, "plyGsplatsClippingBox")) \
+    ((gsplatsHalfPrecision, "plyGsplatsHalfPrecision")) \
+    ((gsplatsMinOpacity, "plyGsplatsMinOpacity")) \
+    ((gsplatsMinScale, "plyGsplatsMinScale")) \
+    ((gsplatsPackedSH, "plyGsplatsPackedSH")) \
+    ((gsplatsMaxScale, "plyGsplatsMaxScale")) \
+    ((gsplatsCullToClippingBox, "plyGsplatsCullToClippingBox")) \
+    ((maxSHDegree, "plyMaxSHDegree")) \
+    ((mortonOrder, "plyMortonOrder")) \
+    ((maxFacesPerMesh, "plyMaxFacesPerMesh")) \
+    ((pointLevels, "plyPointLevels")) \
+    ((pointLevel, "plyPointLevel")) \
+    ((triangulate, "plyTriangulate"))
 // clang-format on
 TF_DECLARE_PUBLIC_TOKENS(UsdPlyFileFormatTokens, USDPLY_FILE_FORMAT_TOKENS);
 TF_DECLARE_WEAK_AND_REF_PTRS(PlyData);
@@ -43,7 +55,19 @@ class PlyData : public FileFormatDataBase
     bool points = false;
     bool withUpAxisCorrection = true;
     PXR_NS::VtFloatArray gsplatsClippingBox = { -2, -2, -2, 2, 2, 2 };
+    bool gsplatsHalfPrecision = false;
+    float gsplatsMinOpacity = 0.0f;
+    float gsplatsMinScale = 0.0f;
+    bool gsplatsPackedSH = false;
+    float gsplatsMaxScale = 0.0f;
+    bool gsplatsCullToClippingBox = false;
+    int maxSHDegree = 3;
+    bool mortonOrder = false;
     float pointWidth = 0.01f;
+    int maxFacesPerMesh = 0;
+    int pointLevels = 0;
+    int pointLevel = -1;
+    bool triangulate = false;
     static PlyDataRefPtr InitData(const SdfFileFormat::FileFormatArguments& args);
 };
 
@@ -0,0 +1,143 @@
+/*
+Copyright 2025 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Quantization of Gaussian splats in the "compressed PLY" layout, as written by PlayCanvas'
+// SuperSplat. Splats are grouped into chunks of consecutive splats, and each chunk stores the
+// bounds of the positions, log scales and colors of its splats. Relative to these bounds the
+// positions and scales are quantized with 11, 10 and 11 bits, the colors and opacity with 8 bits
+// each and the rotations with the three smallest components in 10 bits each, which packs a splat
+// into four 32 bit words. Higher order SH coefficients are quantized to 8 bits in a separate
+// element.
+
+namespace adobe::usd {
+
+/// Number of consecutive splats that share the bounds of a chunk
+constexpr size_t compressedPlyChunkSize = 256;
+
+/// Number of float properties of a chunk: the min and max of the positions, log scales and colors
+constexpr size_t compressedPlyChunkProperties = 18;
+
+// Bounds of the log scales of compressed splats, which avoids that degenerate splats widen the
+// quantization range of a whole chunk
+constexpr float compressedPlyMinLogScale = -20.0f;
+constexpr float compressedPlyMaxLogScale = 20.0f;
+
+inline float
+unpackUnorm(std::uint32_t value, int bits)
+{
+    const std::uint32_t maxValue = (1u << bits) - 1;
+    return static_cast<float>(value & maxValue) / static_cast<float>(maxValue);
+}
+
+inline std::uint32_t
+packUnorm(float value, int bits)
+{
+    const float maxValue = static_cast<float>((1u << bits) - 1);
+    // Written so that NaNs end up at 0
+    const float v = std::floor(value * maxValue + 0.5f);
+    return static_cast<std::uint32_t>(v > 0.0f ? std::min(v, maxValue) : 0.0f);
+}
+
+inline void
+unpack111011(std::uint32_t value, float* out)
+{
+    out[0] = unpackUnorm(value >> 21, 11);
+    out[1] = unpackUnorm(value >> 11, 10);
+    out[2] = unpackUnorm(value, 11);
+}
+
+inline std::uint32_t
+pack111011(float x, float y, float z)
+{
+    return (packUnorm(x, 11) << 21) | (packUnorm(y, 10) << 11) | packUnorm(z, 11);
+}
+
+inline void
+unpack8888(std::uint32_t value, float* out)
+{
+    out[0] = unpackUnorm(value >> 24, 8);
+    out[1] = unpackUnorm(value >> 16, 8);
+    out[2] = unpackUnorm(value >> 8, 8);
+    out[3] = unpackUnorm(value, 8);
+}
+
+inline std::uint32_t
+pack8888(float x, float y, float z, float w)
+{
+    return (packUnorm(x, 8) << 24) | (packUnorm(y, 8) << 16) | (packUnorm(z, 8) << 8) |
+           packUnorm(w, 8);
+}
+
+// The components of a unit quaternion other than the largest one are within +-1/sqrt(2)
+constexpr float compressedPlyRotationScale = 0.70710678f;
+
+/// Unpack a unit quaternion with the components in the order of the `rot_0` to `rot_3` properties,
+/// i.e. (real, i, j, k). The index of the largest component is stored in the 2 top bits and the
+/// largest component is reconstructed from the others, which are stored in 10 bits each.
+inline void
+unpackRotation(std::uint32_t value, float* q)
+{
+    const float a = (unpackUnorm(value >> 20, 10) - 0.5f) / compressedPlyRotationScale;
+    const float b = (unpackUnorm(value >> 10, 10) - 0.5f) / compressedPlyRotationScale;
+    const float c = (unpackUnorm(value, 10) - 0.5f) / compressedPlyRotationScale;
+    const float m = std::sqrt(std::max(0.0f, 1.0f - (a * a + b * b + c * c)));
+    const std::uint32_t largest = value >> 30;
+    const float others[3] = { a, b, c };
+    for (std::uint32_t i = 0, k = 0; i < 4; i++) {
+        q[i] = i == largest ? m : others[k++];
+    }
+}
+
+/// Pack a unit quaternion with the components in the order of `unpackRotation`.
+inline std::uint32_t
+packRotation(const float* q)
+{
+    std::uint32_t largest = 0;
+    for (std::uint32_t i = 1; i < 4; i++) {
+        if (std::abs(q[i]) > std::abs(q[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q are the same rotation, so the largest component can be made positive
+    const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+    std::uint32_t result = largest;
+    for (std::uint32_t i = 0; i < 4; i++) {
+        if (i != largest) {
+            result = (result << 10) | packUnorm(q[i] * sign * compressedPlyRotationScale + 0.5f, 10);
+        }
+    }
+    return result;
+}
+
+/// Decode a higher order SH coefficient from its 8 bit value, which is within [-4, 4]. Like in
+/// PlayCanvas, 0 and 255 map to the ends of the range.
+inline float
+unpackSHCoeff(float value)
+{
+    const float n = value == 0.0f ? 0.0f : value == 255.0f ? 1.0f : (value + 0.5f) / 256.0f;
+    return (n - 0.5f) * 8.0f;
+}
+
+/// Quantize a higher order SH coefficient to its 8 bit value, returned as a float.
+inline float
+packSHCoeff(float value)
+{
+    const float v = std::floor((value / 8.0f + 0.5f) * 256.0f);
+    return v > 0.0f ? std::min(v, 255.0f) : 0.0f;
+}
+
+}
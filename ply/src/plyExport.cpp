@@ -11,6 +11,8 @@ governing permissions and limitations under the License.
 */
 #include "plyExport.h"
 #include "debugCodes.h"
+#include "plyCompressed.h"
+#include "plyWriter.h"
 #include <fileformatutils/common.h>
 #include <fileformatutils/geometry.h>
 #include <fileformatutils/gsplatHelper.h>
@@ -18,6 +20,8 @@ governing permissions and limitations under the License.
 #include <fileformatutils/transforms.h>
 #include <numeric>
 #include <pxr/base/tf/token.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/base/work/sort.h>
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/defaultResolver.h>
 #include <pxr/usd/ar/resolverContextBinder.h>
@@ -71,9 +75,9 @@ meshesRequireExpansion(std::vector<Mesh>& meshes)
     return false;
 }
 
-struct PlyTotalMesh
+/// Vertex data of a single mesh instance, transformed to world space
+struct PlyMeshData
 {
-    std::vector<std::vector<int32_t>> indices;
     VtVec3fArray points;
     VtVec3fArray normals;
     VtVec2fArray uvs;
@@ -85,16 +89,22 @@ struct PlyTotalMesh
     VtFloatArray widths2;
     VtQuatfArray rotations;
     std::vector<VtFloatArray> shCoeffs;
+};
 
-    bool asGsplats = false;
+/// A mesh and the transforms of the node that instantiates it
+struct PlyMeshInstance
+{
+    const Mesh* mesh = nullptr;
+    GfMatrix4d modelMatrix;
+    GfMatrix4d normalMatrix;
 };
 
 void
-aggregateMeshInstance(PlyTotalMesh& totalMesh,
+transformMeshInstance(PlyMeshData& meshData,
                       const Mesh& mesh,
                       const GfMatrix4d& modelMatrix,
                       const GfMatrix4d& normalMatrix,
-                      bool shouldExpand,
+                      bool asGsplats,
                       bool subMeshHasNormals,
                       bool subMeshHasUvs,
                       bool subMeshHasColor,
@@ -102,23 +112,15 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
 {
     size_t currentMeshPointsSize = mesh.points.size();
 
-    size_t indicesOffset = totalMesh.indices.size();
-    size_t pointsOffset = totalMesh.points.size();
-    size_t normalsOffset = totalMesh.normals.size();
-    size_t uvsOffset = totalMesh.uvs.size();
-    size_t colorOffset = totalMesh.color.size();
-    size_t opacityOffset = totalMesh.opacity.size();
-
-    totalMesh.indices.resize(indicesOffset + mesh.faces.size());
-    totalMesh.points.resize(pointsOffset + currentMeshPointsSize);
+    meshData.points.resize(currentMeshPointsSize);
 
     if (subMeshHasOpacity) {
-        totalMesh.opacity.resize(opacityOffset + currentMeshPointsSize);
+        meshData.opacity.resize(currentMeshPointsSize);
         if (mesh.opacities.size()) {
             // need to check if the information is per vertex or per face
             if (mesh.opacities[0].values.size() == currentMeshPointsSize) {
                 for (size_t i = 0; i < currentMeshPointsSize; i++) {
-                    totalMesh.opacity[opacityOffset + i] = mesh.opacities[0].values[i];
+                    meshData.opacity[i] = mesh.opacities[0].values[i];
                 }
             } else if (mesh.opacities[0].values.size() == mesh.faces.size()) {
                 // in a case which we have colors or opacity per face, we need to add per vertex
@@ -126,7 +128,7 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                 for (size_t i = 0, k = 0; i < mesh.faces.size(); i++) {
                     const float opacityValue = mesh.opacities[0].values[i];
                     for (int j = 0; j < mesh.faces[i]; j++) {
-                        totalMesh.opacity[mesh.indices[k + j]] = opacityValue;
+                        meshData.opacity[mesh.indices[k + j]] = opacityValue;
                     }
                     k += mesh.faces[i];
                 }
@@ -134,17 +136,17 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                 TF_WARN("Mesh has opacity property which is not per vertex nor per face.");
             }
         } else {
-            std::fill(totalMesh.opacity.begin() + opacityOffset, totalMesh.opacity.end(), 1.0f);
+            std::fill(meshData.opacity.begin(), meshData.opacity.end(), 1.0f);
         }
     }
 
     if (subMeshHasColor) {
-        totalMesh.color.resize(colorOffset + currentMeshPointsSize);
+        meshData.color.resize(currentMeshPointsSize);
         if (mesh.colors.size()) {
             // need to check if the information is per vertex or per face
             if (mesh.colors[0].values.size() == currentMeshPointsSize) {
                 for (size_t i = 0; i < currentMeshPointsSize; i++) {
-                    totalMesh.color[colorOffset + i] = mesh.colors[0].values[i];
+                    meshData.color[i] = mesh.colors[0].values[i];
                 }
             } else if (mesh.colors[0].values.size() == mesh.faces.size()) {
                 // in a case which we have colors or opacity per face, we need to add per vertex
@@ -152,7 +154,7 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                 for (size_t i = 0, k = 0; i < mesh.faces.size(); i++) {
                     GfVec3f colorValue = mesh.colors[0].values[i];
                     for (int j = 0; j < mesh.faces[i]; j++) {
-                        totalMesh.color[mesh.indices[k + j]] = colorValue;
+                        meshData.color[mesh.indices[k + j]] = colorValue;
                     }
                     k += mesh.faces[i];
                 }
@@ -160,33 +162,20 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                 TF_WARN("Mesh has color property which is not per vertex nor per face.");
             }
         } else {
-            std::fill(
-              totalMesh.color.begin() + colorOffset, totalMesh.color.end(), GfVec3f(1.0, 1.0, 1.0));
+            std::fill(meshData.color.begin(), meshData.color.end(), GfVec3f(1.0, 1.0, 1.0));
         }
     }
 
-    // Special aggregation for indices. They are stored in a vector of vector order.
-    for (size_t i = 0, k = 0; i < mesh.faces.size(); i++) {
-        int faceCount = mesh.faces[i];
-        totalMesh.indices[indicesOffset + i].resize(faceCount);
-        if (shouldExpand) { // These are dummy indices
-            for (int j = 0; j < faceCount; j++) {
-                totalMesh.indices[indicesOffset + i][j] = k + j + pointsOffset;
-            }
-        } else {
-            for (int j = 0; j < faceCount; j++) {
-                totalMesh.indices[indicesOffset + i][j] = mesh.indices[k + j] + pointsOffset;
-            }
+    const GfVec3f* meshPoints = mesh.points.cdata();
+    GfVec3f* points = meshData.points.data();
+    WorkParallelForN(currentMeshPointsSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            points[i] = GfVec3f(modelMatrix.Transform(meshPoints[i]));
         }
-        k += faceCount;
-    }
-
-    for (size_t i = 0; i < currentMeshPointsSize; i++) {
-        totalMesh.points[pointsOffset + i] = GfVec3f(modelMatrix.Transform(mesh.points[i]));
-    }
+    });
 
     if (subMeshHasNormals) {
-        totalMesh.normals.resize(normalsOffset + currentMeshPointsSize);
+        meshData.normals.resize(currentMeshPointsSize);
 
         bool generateNormalsFromFaces = false;
         if (mesh.normals.values.size()) {
@@ -195,7 +184,7 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                 for (size_t i = 0; i < currentMeshPointsSize; i++) {
                     GfVec3f normal(normalMatrix.TransformDir(mesh.normals.values[i]));
                     normal.Normalize();
-                    totalMesh.normals[normalsOffset + i] = normal;
+                    meshData.normals[i] = normal;
                 }
             } else {
                 // This is an unexpected situation. The number of normals should be made the same
@@ -220,12 +209,12 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                     GfVec3f xfNormal(normalMatrix.TransformDir(normal));
                     xfNormal.Normalize();
                     for (size_t j = 0; j < nverts; j++) {
-                        totalMesh.normals[normalsOffset + k + j] = xfNormal;
+                        meshData.normals[k + j] = xfNormal;
                     }
                 } else {
                     // The faces is degenerate, so we just assign a default value
                     for (size_t j = 0; j < nverts; j++) {
-                        totalMesh.normals[normalsOffset + k + j] = GfVec3f(0, 0, 1);
+                        meshData.normals[k + j] = GfVec3f(0, 0, 1);
                     }
                 }
                 k += nverts;
@@ -234,14 +223,14 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
     }
 
     if (subMeshHasUvs) {
-        totalMesh.uvs.resize(uvsOffset + currentMeshPointsSize);
+        meshData.uvs.resize(currentMeshPointsSize);
 
         bool filled = false;
         if (mesh.uvs.values.size()) {
             // Need to check that currentMeshPointsSize is the same as the number of UVs
             if (currentMeshPointsSize == mesh.uvs.values.size()) {
                 for (size_t i = 0; i < currentMeshPointsSize; i++) {
-                    totalMesh.uvs[uvsOffset + i] = mesh.uvs.values[i];
+                    meshData.uvs[i] = mesh.uvs.values[i];
                 }
                 filled = true;
             } else {
@@ -252,13 +241,13 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
         }
         if (!filled) {
             for (size_t i = 0; i < currentMeshPointsSize; i++) {
-                totalMesh.uvs[uvsOffset + i] = GfVec2f(0, 0);
+                meshData.uvs[i] = GfVec2f(0, 0);
             }
         }
     }
 
-    if (totalMesh.asGsplats) {
-        // Aggregate Gsplat attributes
+    if (asGsplats) {
+        // Transform Gsplat attributes
         GfMatrix4f modelMatrixFloat(modelMatrix);
 
         // An individual splat cannot be sheared and thus we extract a uniform scaling factor.
@@ -269,59 +258,23 @@ aggregateMeshInstance(PlyTotalMesh& totalMesh,
                          mesh.pointExtraWidths,
                          currentMeshPointsSize,
                          modelScaling,
-                         totalMesh.widths,
-                         totalMesh.widths1,
-                         totalMesh.widths2);
+                         meshData.widths,
+                         meshData.widths1,
+                         meshData.widths2);
         rotatePointRotations(
-          mesh.pointRotations, modelRotation, currentMeshPointsSize, totalMesh.rotations);
+          mesh.pointRotations, modelRotation, currentMeshPointsSize, meshData.rotations);
         rotatePointSphericalHarmonics(
-          mesh.pointSHCoeffs, modelRotation, currentMeshPointsSize, totalMesh.shCoeffs);
+          mesh.pointSHCoeffs, modelRotation, currentMeshPointsSize, meshData.shCoeffs);
     }
 
     TF_DEBUG_MSG(FILE_FORMAT_PLY,
-                 "ply::export aggregated mesh %s { faces: %lu, vIdx: %lu, v: %lu }\n",
+                 "ply::export transformed mesh %s { faces: %lu, vIdx: %lu, v: %lu }\n",
                  mesh.name.c_str(),
                  mesh.faces.size(),
                  mesh.indices.size(),
                  currentMeshPointsSize);
 }
 
-void
-traverseNodesAndFindGsplats(UsdData& usd, PlyTotalMesh& totalMesh, int nodeIndex)
-{
-    const Node& node = usd.nodes[nodeIndex];
-    for (int meshIndex : node.staticMeshes) {
-        Mesh& mesh = usd.meshes[meshIndex];
-        if (mesh.asGsplats) {
-            totalMesh.asGsplats = true;
-            return;
-        }
-    }
-
-    for (size_t i = 0; i < node.children.size(); i++) {
-        traverseNodesAndFindGsplats(usd, totalMesh, node.children[i]);
-        if (!totalMesh.asGsplats)
-            return;
-    }
-}
-
-std::size_t
-traverseNodesAndFindMaxNumSHCoeffs(UsdData& usd, int nodeIndex)
-{
-    const Node& node = usd.nodes[nodeIndex];
-    std::size_t maxNumSHCoeffs = 0;
-    for (int meshIndex : node.staticMeshes) {
-        Mesh& mesh = usd.meshes[meshIndex];
-        if (mesh.asGsplats)
-            maxNumSHCoeffs = std::max(maxNumSHCoeffs, mesh.pointSHCoeffs.size());
-    }
-
-    for (size_t i = 0; i < node.children.size(); i++) {
-        maxNumSHCoeffs = std::max(maxNumSHCoeffs, traverseNodesAndFindMaxNumSHCoeffs(usd, node.children[i]));
-    }
-    return maxNumSHCoeffs;
-}
-
 void
 aggregateMeshDataRequirements(std::vector<Mesh>& meshes,
                               bool& subMeshHasNormals,
@@ -338,57 +291,25 @@ aggregateMeshDataRequirements(std::vector<Mesh>& meshes,
 }
 
 void
-traverseNodesAndAggregateMeshes(UsdData& usd,
-                                PlyTotalMesh& totalMesh,
-                                const GfMatrix4d& correctionTransform,
-                                bool shouldExpand,
-                                int nodeIndex,
-                                bool subMeshHasNormals,
-                                bool subMeshHasUvs,
-                                bool subMeshHasOpacity,
-                                bool subMeshHasColor)
+traverseNodesAndCollectInstances(UsdData& usd,
+                                 std::vector<PlyMeshInstance>& instances,
+                                 const GfMatrix4d& correctionTransform,
+                                 int nodeIndex)
 {
     const Node& node = usd.nodes[nodeIndex];
     GfMatrix4d modelMatrix = node.worldTransform * correctionTransform;
     GfMatrix4d normalMatrix = modelMatrix.GetInverse().GetTranspose();
 
     for (int meshIndex : node.staticMeshes) {
-        Mesh& mesh = usd.meshes[meshIndex];
-        aggregateMeshInstance(totalMesh,
-                              mesh,
-                              modelMatrix,
-                              normalMatrix,
-                              shouldExpand,
-                              subMeshHasNormals,
-                              subMeshHasUvs,
-                              subMeshHasColor,
-                              subMeshHasOpacity);
+        instances.push_back({ &usd.meshes[meshIndex], modelMatrix, normalMatrix });
     }
-
     for (const auto& [skeletonIndex, meshIndices] : node.skinnedMeshes) {
         for (int meshIndex : meshIndices) {
-            Mesh& mesh = usd.meshes[meshIndex];
-            aggregateMeshInstance(totalMesh,
-                                  mesh,
-                                  modelMatrix,
-                                  normalMatrix,
-                                  shouldExpand,
-                                  subMeshHasNormals,
-                                  subMeshHasUvs,
-                                  subMeshHasColor,
-                                  subMeshHasOpacity);
+            instances.push_back({ &usd.meshes[meshIndex], modelMatrix, normalMatrix });
         }
     }
     for (size_t i = 0; i < node.children.size(); i++) {
-        traverseNodesAndAggregateMeshes(usd,
-                                        totalMesh,
-                                        correctionTransform,
-                                        shouldExpand,
-                                        node.children[i],
-                                        subMeshHasNormals,
-                                        subMeshHasUvs,
-                                        subMeshHasColor,
-                                        subMeshHasOpacity);
+        traverseNodesAndCollectInstances(usd, instances, correctionTransform, node.children[i]);
     }
 }
 
@@ -411,13 +332,294 @@ encodeGsplatWidth(float width)
     return log(clamped_half_width);
 }
 
+// Encode the Gsplat attributes of a mesh instance in place into their PLY representation. The
+// rotations are interleaved as (real, i, j, k) into `rotations`.
+void
+encodeGsplats(PlyMeshData& meshData, VtFloatArray& rotations)
+{
+    // Zeroth coefficient of SH, inversed as 2sqrt(pi)
+    constexpr float invShC0 = 3.5449077018f;
+    const size_t numPoints = meshData.points.size();
+    GfVec3f* color = meshData.color.empty() ? nullptr : meshData.color.data();
+    float* opacity = meshData.opacity.empty() ? nullptr : meshData.opacity.data();
+    float* widths[3] = { meshData.widths.data(), meshData.widths1.data(), meshData.widths2.data() };
+    const GfQuatf* quats = meshData.rotations.cdata();
+    rotations.resize(numPoints * 4);
+    float* rot = rotations.data();
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (color) {
+                color[i] = (color[i] - GfVec3f(0.5f)) * invShC0;
+            }
+            if (opacity) {
+                opacity[i] = encodeGsplatOpacity(opacity[i]);
+            }
+            for (float* w : widths) {
+                w[i] = encodeGsplatWidth(w[i]);
+            }
+            rot[i * 4 + 0] = quats[i].GetReal();
+            rot[i * 4 + 1] = quats[i].GetImaginary()[0];
+            rot[i * 4 + 2] = quats[i].GetImaginary()[1];
+            rot[i * 4 + 3] = quats[i].GetImaginary()[2];
+        }
+    });
+}
+
+void
+addSources(std::vector<PlySource>& sources, const float* src, size_t count, bool normalize = false)
+{
+    for (size_t i = 0; i < count; i++) {
+        sources.push_back({ src + i, count, normalize });
+    }
+}
+
+/// Pointers to the aggregated Gaussian splat arrays, which mesh instances fill in parallel. They
+/// are taken once before the parallel writes, which then don't go through the copy-on-write checks
+/// of VtArray.
+struct PlyGsplatSlices
+{
+    GfVec3f* points = nullptr;
+    GfVec3f* color = nullptr;
+    float* opacity = nullptr;
+    float* widths[3] = {};
+    GfQuatf* rotations = nullptr;
+    std::vector<float*> shCoeffs;
+};
+
+// Transform the splats of a mesh instance into the aggregated arrays, starting at the offset of
+// the instance. Colors and opacities are always written and default to opaque white.
+void
+aggregateGsplatInstance(const PlyMeshInstance& instance, size_t offset, const PlyGsplatSlices& out)
+{
+    const Mesh& mesh = *instance.mesh;
+    const size_t numPoints = mesh.points.size();
+    const GfVec3f* meshPoints = mesh.points.cdata();
+    GfVec3f* points = out.points + offset;
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            points[i] = GfVec3f(instance.modelMatrix.Transform(meshPoints[i]));
+        }
+    });
+
+    const size_t numColors =
+      mesh.colors.empty() ? 0 : std::min(numPoints, mesh.colors[0].values.size());
+    GfVec3f* color = out.color + offset;
+    if (numColors) {
+        std::copy_n(mesh.colors[0].values.cdata(), numColors, color);
+    }
+    std::fill(color + numColors, color + numPoints, GfVec3f(1.0f));
+    const size_t numOpacities =
+      mesh.opacities.empty() ? 0 : std::min(numPoints, mesh.opacities[0].values.size());
+    float* opacity = out.opacity + offset;
+    if (numOpacities) {
+        std::copy_n(mesh.opacities[0].values.cdata(), numOpacities, opacity);
+    }
+    std::fill(opacity + numOpacities, opacity + numPoints, 1.0f);
+
+    GfMatrix4f modelMatrixFloat(instance.modelMatrix);
+    const float modelScaling = std::cbrt(std::abs(modelMatrixFloat.GetDeterminant()));
+    const GfQuatf modelRotation = modelMatrixFloat.ExtractRotationQuat().GetNormalized();
+    scalePointWidths(mesh.pointWidths,
+                     mesh.pointExtraWidths,
+                     numPoints,
+                     modelScaling,
+                     out.widths[0] + offset,
+                     out.widths[1] + offset,
+                     out.widths[2] + offset);
+    rotatePointRotations(mesh.pointRotations, modelRotation, numPoints, out.rotations + offset);
+    std::vector<float*> shCoeffs(out.shCoeffs.size());
+    for (size_t k = 0; k < shCoeffs.size(); k++) {
+        shCoeffs[k] = out.shCoeffs[k] + offset;
+    }
+    rotatePointSphericalHarmonics(mesh.pointSHCoeffs, modelRotation, numPoints, shCoeffs);
+}
+
+// Write all mesh instances as Gaussian splats in the compressed PLY layout. The chunk bounds depend
+// on all splats of a chunk, so the instances are aggregated first and the splats are then written
+// in Morton order, which keeps the chunks spatially coherent and their bounds tight.
+bool
+writeCompressedGsplats(PlyWriter& writer,
+                       const std::vector<PlyMeshInstance>& instances,
+                       size_t numSHCoeffs)
+{
+    // The sizing pass assigns each instance its slice of the aggregated arrays, which the
+    // instances then fill in parallel
+    std::vector<size_t> offsets(instances.size());
+    size_t numSplats = 0;
+    for (size_t i = 0; i < instances.size(); i++) {
+        offsets[i] = numSplats;
+        numSplats += instances[i].mesh->points.size();
+    }
+    PlyMeshData splats;
+    PlyGsplatSlices slices;
+    splats.points.resize(numSplats);
+    splats.color.resize(numSplats);
+    splats.opacity.resize(numSplats);
+    splats.widths.resize(numSplats);
+    splats.widths1.resize(numSplats);
+    splats.widths2.resize(numSplats);
+    splats.rotations.resize(numSplats);
+    splats.shCoeffs.resize(numSHCoeffs);
+    slices.points = splats.points.data();
+    slices.color = splats.color.data();
+    slices.opacity = splats.opacity.data();
+    slices.widths[0] = splats.widths.data();
+    slices.widths[1] = splats.widths1.data();
+    slices.widths[2] = splats.widths2.data();
+    slices.rotations = splats.rotations.data();
+    for (VtFloatArray& shCoeff : splats.shCoeffs) {
+        shCoeff.resize(numSplats);
+        slices.shCoeffs.push_back(shCoeff.data());
+    }
+    WorkParallelForN(instances.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            aggregateGsplatInstance(instances[i], offsets[i], slices);
+        }
+    });
+
+    std::vector<uint64_t> codes;
+    computeMortonCodes(splats.points, computeExtent(splats.points), codes);
+    std::vector<std::pair<uint64_t, size_t>> order(numSplats);
+    WorkParallelForN(numSplats, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            order[i] = { codes[i], i };
+        }
+    });
+    WorkParallelSort(&order);
+
+    // Each chunk stores the bounds of the positions, log scales and colors of its splats, and the
+    // splats are quantized relative to them
+    const size_t numChunks = (numSplats + compressedPlyChunkSize - 1) / compressedPlyChunkSize;
+    constexpr size_t packedRowSize = 4 * sizeof(std::uint32_t);
+    std::vector<float> bounds(numChunks * compressedPlyChunkProperties);
+    std::vector<char> packed(numSplats * packedRowSize);
+    std::vector<float> shCoeffs(numSplats * numSHCoeffs);
+    const bool swap = writer.getFormat() != nativeBinaryFormat();
+    const GfVec3f* points = splats.points.cdata();
+    const GfVec3f* colors = splats.color.cdata();
+    const float* opacities = splats.opacity.cdata();
+    const float* widths[3] = { splats.widths.cdata(),
+                               splats.widths1.cdata(),
+                               splats.widths2.cdata() };
+    const GfQuatf* rotations = splats.rotations.cdata();
+    std::vector<const float*> shSrc;
+    for (const VtFloatArray& shCoeff : splats.shCoeffs) {
+        shSrc.push_back(shCoeff.cdata());
+    }
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        std::vector<float> values;
+        for (size_t c = begin; c < end; c++) {
+            const size_t first = c * compressedPlyChunkSize;
+            const size_t last = std::min(first + compressedPlyChunkSize, numSplats);
+
+            // The position, log scale and color of each splat of the chunk
+            values.resize((last - first) * 9);
+            float* b = bounds.data() + c * compressedPlyChunkProperties;
+            float minValues[9];
+            float maxValues[9];
+            std::fill_n(minValues, 9, std::numeric_limits<float>::max());
+            std::fill_n(maxValues, 9, std::numeric_limits<float>::lowest());
+            for (size_t j = first; j < last; j++) {
+                const size_t i = order[j].second;
+                float* v = values.data() + (j - first) * 9;
+                for (size_t k = 0; k < 3; k++) {
+                    v[k] = points[i][k];
+                    v[3 + k] = std::clamp(encodeGsplatWidth(widths[k][i]),
+                                          compressedPlyMinLogScale,
+                                          compressedPlyMaxLogScale);
+                    v[6 + k] = colors[i][k];
+                }
+                for (size_t k = 0; k < 9; k++) {
+                    // Written so that NaNs are ignored
+                    minValues[k] = v[k] < minValues[k] ? v[k] : minValues[k];
+                    maxValues[k] = v[k] > maxValues[k] ? v[k] : maxValues[k];
+                }
+            }
+            // The chunk properties are the min and max of the positions, then of the log scales
+            // and then of the colors
+            for (size_t k = 0; k < 9; k++) {
+                const size_t group = k / 3;
+                b[group * 6 + k % 3] = minValues[k];
+                b[group * 6 + 3 + k % 3] = maxValues[k];
+            }
+
+            auto unit = [&](const float* v, size_t k) {
+                const float range = maxValues[k] - minValues[k];
+                return range > 0.0f ? (v[k] - minValues[k]) / range : 0.0f;
+            };
+            for (size_t j = first; j < last; j++) {
+                const size_t i = order[j].second;
+                const float* v = values.data() + (j - first) * 9;
+                const GfQuatf rotation = rotations[i].GetNormalized();
+                const float q[4] = { rotation.GetReal(),
+                                     rotation.GetImaginary()[0],
+                                     rotation.GetImaginary()[1],
+                                     rotation.GetImaginary()[2] };
+                const std::uint32_t words[4] = {
+                    pack111011(unit(v, 0), unit(v, 1), unit(v, 2)),
+                    packRotation(q),
+                    pack111011(unit(v, 3), unit(v, 4), unit(v, 5)),
+                    pack8888(unit(v, 6), unit(v, 7), unit(v, 8), opacities[i]),
+                };
+                char* row = packed.data() + j * packedRowSize;
+                for (size_t k = 0; k < 4; k++) {
+                    if (swap) {
+                        storeScalar<std::uint32_t, true>(row + k * sizeof(std::uint32_t), words[k]);
+                    } else {
+                        storeScalar<std::uint32_t, false>(row + k * sizeof(std::uint32_t), words[k]);
+                    }
+                }
+                for (size_t k = 0; k < numSHCoeffs; k++) {
+                    shCoeffs[j * numSHCoeffs + k] = packSHCoeff(shSrc[k][i]);
+                }
+            }
+        }
+    });
+
+    static const char* chunkPropertyNames[compressedPlyChunkProperties] = {
+        "min_x",       "min_y",       "min_z",       "max_x",       "max_y",       "max_z",
+        "min_scale_x", "min_scale_y", "min_scale_z", "max_scale_x", "max_scale_y", "max_scale_z",
+        "min_r",       "min_g",       "min_b",       "max_r",       "max_g",       "max_b"
+    };
+    writer.addElement("chunk", numChunks);
+    for (const char* name : chunkPropertyNames) {
+        writer.addProperty(name, PlyType::Float32);
+    }
+    writer.addElement("vertex", numSplats);
+    writer.addProperty("packed_position", PlyType::UInt32);
+    writer.addProperty("packed_rotation", PlyType::UInt32);
+    writer.addProperty("packed_scale", PlyType::UInt32);
+    writer.addProperty("packed_color", PlyType::UInt32);
+    if (numSHCoeffs) {
+        writer.addElement("sh", numSplats);
+        for (size_t k = 0; k < numSHCoeffs; k++) {
+            writer.addProperty("f_rest_" + std::to_string(k), PlyType::UInt8);
+        }
+    }
+    GUARD(writer.writeHeader(), "Error writing PLY header\n");
+
+    std::vector<PlySource> sources;
+    addSources(sources, bounds.data(), compressedPlyChunkProperties);
+    GUARD(writer.writeRows(numChunks, sources), "Error writing PLY chunks\n");
+    GUARD(writer.writeRawRows(numSplats, packed.data()), "Error writing PLY vertices\n");
+    if (numSHCoeffs) {
+        sources.clear();
+        addSources(sources, shCoeffs.data(), numSHCoeffs);
+        GUARD(writer.writeRows(numSplats, sources), "Error writing PLY SH coefficients\n");
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_PLY,
+                 "ply::export compressed %zu splats into %zu chunks\n",
+                 numSplats,
+                 numChunks);
+    return writer.finish();
+}
+
 bool
-exportPly(UsdData& usd, happly::PLYData& ply)
+exportPly(const ExportPlyOptions& options, UsdData& usd, std::ostream& out)
 {
     if (usd.meshes.size() <= 0) {
         TF_DEBUG_MSG(FILE_FORMAT_PLY,
                      "ply::export no instances of UsdGeomMesh, nothing will be exported\n");
-        return true;
     }
 
     // Unfortunately there lacks documentation on how to set indices for uvs and normals.
@@ -491,29 +693,39 @@ exportPly(UsdData& usd, happly::PLYData& ply)
         }
     }
 
-    // Because Ply does not support multiple individual meshes, we need to aggregate all meshes into
-    // a single mesh and apply their local to world transforms, together with the system's
-    // correction transform.
-    PlyTotalMesh totalMesh;
-    GfMatrix4d correctionTransform;
-    // First check if the Ply should be a Gsplat. It is considered as a Gsplat as long as one
-    // sub-point-cloud is a Gsplat since a Gsplat is an extension of a regular point cloud.
-    for (size_t i = 0; i < usd.rootNodes.size(); i++) {
-        traverseNodesAndFindGsplats(usd, totalMesh, usd.rootNodes[i]);
-        if (totalMesh.asGsplats)
-            break;
-    }
 
-    std::size_t numGsplatsSHCoeffs = 0;
+    // Because Ply does not support multiple individual meshes, all mesh instances are written into
+    // a single mesh with their local to world transforms applied, together with the system's
+    // correction transform. The header is computed upfront, so that the instances can then be
+    // transformed and streamed one by one, which bounds the memory to that of a single instance.
+    const GfMatrix4d correctionTransform =
+      getTransformToMetersPositiveY(usd.metersPerUnit, usd.upAxis);
+    std::vector<PlyMeshInstance> instances;
     for (size_t i = 0; i < usd.rootNodes.size(); i++) {
-        numGsplatsSHCoeffs =
-          std::max(numGsplatsSHCoeffs, traverseNodesAndFindMaxNumSHCoeffs(usd, usd.rootNodes[i]));
+        traverseNodesAndCollectInstances(usd, instances, correctionTransform, usd.rootNodes[i]);
     }
-    if (totalMesh.asGsplats) {
-        totalMesh.shCoeffs.resize(numGsplatsSHCoeffs);
-        ply.comments.push_back("Gaussian Splats with Y-axis up");
+
+    // The Ply is considered as a Gsplat as long as one sub-point-cloud is a Gsplat since a Gsplat
+    // is an extension of a regular point cloud.
+    bool asGsplats = false;
+    size_t numGsplatsSHCoeffs = 0;
+    size_t numPoints = 0;
+    size_t numFaces = 0;
+    int maxFaceSize = 0;
+    for (const PlyMeshInstance& instance : instances) {
+        const Mesh& mesh = *instance.mesh;
+        if (mesh.asGsplats) {
+            asGsplats = true;
+            numGsplatsSHCoeffs = std::max(numGsplatsSHCoeffs, mesh.pointSHCoeffs.size());
+        }
+        numPoints += mesh.points.size();
+        numFaces += mesh.faces.size();
+        for (int faceSize : mesh.faces) {
+            maxFaceSize = std::max(maxFaceSize, faceSize);
+        }
     }
-    correctionTransform = getTransformToMetersPositiveY(usd.metersPerUnit, usd.upAxis);
+    // The higher bands are dropped when the SH coefficients are rotated into the output
+    numGsplatsSHCoeffs = truncatedSHCoeffCount(numGsplatsSHCoeffs, options.maxSHDegree);
 
     bool subMeshHasNormals = false;
     bool subMeshHasUvs = false;
@@ -522,179 +734,142 @@ exportPly(UsdData& usd, happly::PLYData& ply)
     aggregateMeshDataRequirements(
       usd.meshes, subMeshHasNormals, subMeshHasUvs, subMeshHasOpacity, subMeshHasColor);
 
-    for (size_t i = 0; i < usd.rootNodes.size(); i++) {
-        traverseNodesAndAggregateMeshes(usd,
-                                        totalMesh,
-                                        correctionTransform,
-                                        shouldExpand,
-                                        usd.rootNodes[i],
-                                        subMeshHasNormals,
-                                        subMeshHasUvs,
-                                        subMeshHasOpacity,
-                                        subMeshHasColor);
-    }
-
     TF_DEBUG_MSG(FILE_FORMAT_PLY,
-                 "totalMesh: points=%d indices=%d normals=%d uvs=%d\n",
-                 totalMesh.points.size(),
-                 totalMesh.indices.size(),
-                 totalMesh.normals.size(),
-                 totalMesh.uvs.size());
-
-    if (totalMesh.points.size()) {
-        std::string faceName = "face";
-        std::string vertexName = "vertex";
-        if (totalMesh.indices.size()) {
-            ply.addElement(faceName, totalMesh.indices.size());
-            ply.getElement(faceName).addListProperty<int32_t>("vertex_indices", totalMesh.indices);
-        }
-        if (totalMesh.points.size()) {
-            std::vector<float> positionsX(totalMesh.points.size());
-            std::vector<float> positionsY(totalMesh.points.size());
-            std::vector<float> positionsZ(totalMesh.points.size());
-            for (size_t i = 0; i < totalMesh.points.size(); i++) {
-                positionsX[i] = totalMesh.points[i][0];
-                positionsY[i] = totalMesh.points[i][1];
-                positionsZ[i] = totalMesh.points[i][2];
-            }
-            ply.addElement(vertexName, totalMesh.points.size());
-            happly::Element& vertexElement = ply.getElement(vertexName);
-            vertexElement.addProperty<float>("x", positionsX);
-            vertexElement.addProperty<float>("y", positionsY);
-            vertexElement.addProperty<float>("z", positionsZ);
+                 "ply::export instances=%zu points=%zu faces=%zu\n",
+                 instances.size(),
+                 numPoints,
+                 numFaces);
+
+    if (options.compressed && !asGsplats) {
+        TF_WARN("Only Gaussian splats can be exported as compressed PLY");
+    }
+    // The compressed layout holds packed words and is always binary
+    const bool compressed = options.compressed && asGsplats;
+    PlyWriter writer(out,
+                     options.ascii && !compressed ? PlyFormat::Ascii
+                                                  : PlyFormat::BinaryLittleEndian);
+    if (asGsplats) {
+        writer.addComment("Gaussian Splats with Y-axis up");
+    }
+    if (compressed) {
+        return writeCompressedGsplats(writer, instances, numGsplatsSHCoeffs);
+    }
+    if (numPoints) {
+        writer.addElement("vertex", numPoints);
+        writer.addProperty("x", PlyType::Float32);
+        writer.addProperty("y", PlyType::Float32);
+        writer.addProperty("z", PlyType::Float32);
+        if (subMeshHasNormals) {
+            writer.addProperty("nx", PlyType::Float32);
+            writer.addProperty("ny", PlyType::Float32);
+            writer.addProperty("nz", PlyType::Float32);
         }
-        if (totalMesh.normals.size()) {
-            std::vector<float> nx(totalMesh.normals.size());
-            std::vector<float> ny(totalMesh.normals.size());
-            std::vector<float> nz(totalMesh.normals.size());
-            for (size_t i = 0; i < totalMesh.normals.size(); i++) {
-                nx[i] = totalMesh.normals[i][0];
-                ny[i] = totalMesh.normals[i][1];
-                nz[i] = totalMesh.normals[i][2];
-            }
-            happly::Element& vertexElement = ply.getElement(vertexName);
-            vertexElement.addProperty<float>("nx", nx);
-            vertexElement.addProperty<float>("ny", ny);
-            vertexElement.addProperty<float>("nz", nz);
+        if (subMeshHasUvs) {
+            writer.addProperty("texture_u", PlyType::Float32);
+            writer.addProperty("texture_v", PlyType::Float32);
         }
-        if (totalMesh.uvs.size()) {
-            std::vector<float> u(totalMesh.uvs.size());
-            std::vector<float> v(totalMesh.uvs.size());
-            for (size_t i = 0; i < totalMesh.uvs.size(); i++) {
-                u[i] = totalMesh.uvs[i][0];
-                v[i] = totalMesh.uvs[i][1];
+        if (asGsplats) {
+            if (subMeshHasColor) {
+                writer.addProperty("f_dc_0", PlyType::Float32);
+                writer.addProperty("f_dc_1", PlyType::Float32);
+                writer.addProperty("f_dc_2", PlyType::Float32);
             }
-            happly::Element& vertexElement = ply.getElement(vertexName);
-            vertexElement.addProperty<float>("texture_u", u);
-            vertexElement.addProperty<float>("texture_v", v);
-        }
-        if (totalMesh.asGsplats) {
-            // Gsplat attributes.
-            // Zeroth coefficient of SH, inversed as 2sqrt(pi)
-            constexpr float invShC0 = 3.5449077018f;
-            if (totalMesh.color.size()) {
-                std::vector<float> r(totalMesh.color.size());
-                std::vector<float> g(totalMesh.color.size());
-                std::vector<float> b(totalMesh.color.size());
-                for (size_t i = 0; i < totalMesh.color.size(); i++) {
-                    r[i] = (totalMesh.color[i][0] - 0.5f) * invShC0;
-                    g[i] = (totalMesh.color[i][1] - 0.5f) * invShC0;
-                    b[i] = (totalMesh.color[i][2] - 0.5f) * invShC0;
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<float>("f_dc_0", r);
-                vertexElement.addProperty<float>("f_dc_1", g);
-                vertexElement.addProperty<float>("f_dc_2", b);
+            if (subMeshHasOpacity) {
+                writer.addProperty("opacity", PlyType::Float32);
             }
-            if (totalMesh.opacity.size()) {
-                std::vector<float> a(totalMesh.opacity.size());
-                for (size_t i = 0; i < totalMesh.opacity.size(); i++) {
-                    a[i] = encodeGsplatOpacity(totalMesh.opacity[i]);
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<float>("opacity", a);
+            writer.addProperty("scale_0", PlyType::Float32);
+            writer.addProperty("scale_1", PlyType::Float32);
+            writer.addProperty("scale_2", PlyType::Float32);
+            writer.addProperty("rot_0", PlyType::Float32);
+            writer.addProperty("rot_1", PlyType::Float32);
+            writer.addProperty("rot_2", PlyType::Float32);
+            writer.addProperty("rot_3", PlyType::Float32);
+            for (size_t shIndex = 0; shIndex < numGsplatsSHCoeffs; ++shIndex) {
+                writer.addProperty("f_rest_" + std::to_string(shIndex), PlyType::Float32);
             }
-            if (totalMesh.widths.size()) {
-                std::vector<float> scale0(totalMesh.widths.size());
-                for (size_t i = 0; i < totalMesh.widths.size(); i++) {
-                    scale0[i] = encodeGsplatWidth(totalMesh.widths[i]);
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<float>("scale_0", scale0);
+        } else {
+            // Mesh or regular point cloud.
+            if (subMeshHasColor) {
+                writer.addProperty("red", PlyType::UInt8);
+                writer.addProperty("green", PlyType::UInt8);
+                writer.addProperty("blue", PlyType::UInt8);
             }
-            if (totalMesh.widths1.size()) {
-                std::vector<float> scale1(totalMesh.widths1.size());
-                for (size_t i = 0; i < totalMesh.widths1.size(); i++) {
-                    scale1[i] = encodeGsplatWidth(totalMesh.widths1[i]);
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<float>("scale_1", scale1);
+            if (subMeshHasOpacity) {
+                writer.addProperty("alpha", PlyType::UInt8);
             }
-            if (totalMesh.widths2.size()) {
-                std::vector<float> scale2(totalMesh.widths2.size());
-                for (size_t i = 0; i < totalMesh.widths2.size(); i++) {
-                    scale2[i] = encodeGsplatWidth(totalMesh.widths2[i]);
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<float>("scale_2", scale2);
+        }
+        if (numFaces) {
+            writer.addElement("face", numFaces);
+            writer.addListProperty("vertex_indices",
+                                   maxFaceSize <= 255 ? PlyType::UInt8 : PlyType::UInt32,
+                                   PlyType::Int32);
+        }
+    }
+    GUARD(writer.writeHeader(), "Error writing PLY header\n");
+
+    for (const PlyMeshInstance& instance : instances) {
+        PlyMeshData meshData;
+        if (asGsplats) {
+            meshData.shCoeffs.resize(numGsplatsSHCoeffs);
+        }
+        transformMeshInstance(meshData,
+                              *instance.mesh,
+                              instance.modelMatrix,
+                              instance.normalMatrix,
+                              asGsplats,
+                              subMeshHasNormals,
+                              subMeshHasUvs,
+                              subMeshHasColor,
+                              subMeshHasOpacity);
+
+        std::vector<PlySource> sources;
+        addSources(sources, reinterpret_cast<const float*>(meshData.points.cdata()), 3);
+        if (subMeshHasNormals) {
+            addSources(sources, reinterpret_cast<const float*>(meshData.normals.cdata()), 3);
+        }
+        if (subMeshHasUvs) {
+            addSources(sources, reinterpret_cast<const float*>(meshData.uvs.cdata()), 2);
+        }
+        VtFloatArray rotations;
+        if (asGsplats) {
+            encodeGsplats(meshData, rotations);
+            if (subMeshHasColor) {
+                addSources(sources, reinterpret_cast<const float*>(meshData.color.cdata()), 3);
             }
-            if (totalMesh.rotations.size()) {
-                std::vector<float> rot0(totalMesh.rotations.size());
-                std::vector<float> rot1(totalMesh.rotations.size());
-                std::vector<float> rot2(totalMesh.rotations.size());
-                std::vector<float> rot3(totalMesh.rotations.size());
-                for (size_t i = 0; i < totalMesh.rotations.size(); i++) {
-                    rot0[i] = totalMesh.rotations[i].GetReal();
-                    rot1[i] = totalMesh.rotations[i].GetImaginary()[0];
-                    rot2[i] = totalMesh.rotations[i].GetImaginary()[1];
-                    rot3[i] = totalMesh.rotations[i].GetImaginary()[2];
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<float>("rot_0", rot0);
-                vertexElement.addProperty<float>("rot_1", rot1);
-                vertexElement.addProperty<float>("rot_2", rot2);
-                vertexElement.addProperty<float>("rot_3", rot3);
+            if (subMeshHasOpacity) {
+                addSources(sources, meshData.opacity.cdata(), 1);
             }
-            for (size_t shIndex = 0; shIndex < totalMesh.shCoeffs.size(); ++shIndex) {
-                std::vector<float> shCoeff(totalMesh.shCoeffs[shIndex].size());
-                for (size_t i = 0; i < totalMesh.shCoeffs[shIndex].size(); i++) {
-                    shCoeff[i] = totalMesh.shCoeffs[shIndex][i];
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                const std::string propName = std::string("f_rest_") + std::to_string(shIndex);
-                vertexElement.addProperty<float>(propName, shCoeff);
+            addSources(sources, meshData.widths.cdata(), 1);
+            addSources(sources, meshData.widths1.cdata(), 1);
+            addSources(sources, meshData.widths2.cdata(), 1);
+            addSources(sources, rotations.cdata(), 4);
+            for (const VtFloatArray& shCoeff : meshData.shCoeffs) {
+                addSources(sources, shCoeff.cdata(), 1);
             }
         } else {
-            // Mesh or regular point cloud.
-            if (totalMesh.color.size()) {
-                std::vector<uint8_t> r(totalMesh.color.size());
-                std::vector<uint8_t> g(totalMesh.color.size());
-                std::vector<uint8_t> b(totalMesh.color.size());
-                for (size_t i = 0; i < totalMesh.color.size(); i++) {
-                    r[i] = static_cast<uint8_t>(
-                      std::clamp(totalMesh.color[i][0] * 255.0f, 0.0f, 255.0f));
-                    g[i] = static_cast<uint8_t>(
-                      std::clamp(totalMesh.color[i][1] * 255.0f, 0.0f, 255.0f));
-                    b[i] = static_cast<uint8_t>(
-                      std::clamp(totalMesh.color[i][2] * 255.0f, 0.0f, 255.0f));
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<uint8_t>("red", r);
-                vertexElement.addProperty<uint8_t>("green", g);
-                vertexElement.addProperty<uint8_t>("blue", b);
+            if (subMeshHasColor) {
+                addSources(sources, reinterpret_cast<const float*>(meshData.color.cdata()), 3, true);
             }
-            if (totalMesh.opacity.size()) {
-                std::vector<uint8_t> a(totalMesh.opacity.size());
-                for (size_t i = 0; i < totalMesh.opacity.size(); i++) {
-                    a[i] =
-                      static_cast<uint8_t>(std::clamp(totalMesh.opacity[i] * 255.0f, 0.0f, 255.0f));
-                }
-                happly::Element& vertexElement = ply.getElement(vertexName);
-                vertexElement.addProperty<uint8_t>("alpha", a);
+            if (subMeshHasOpacity) {
+                addSources(sources, meshData.opacity.cdata(), 1, true);
             }
         }
+        GUARD(writer.writeRows(meshData.points.size(), sources), "Error writing PLY vertices\n");
+    }
+
+    // The faces follow the vertices, with the indices offset to the vertices of their instance
+    int pointsOffset = 0;
+    for (const PlyMeshInstance& instance : instances) {
+        const Mesh& mesh = *instance.mesh;
+        // When expanded, the vertices are in face order and the indices are consecutive
+        GUARD(writer.writeListRows(mesh.faces.size(),
+                                   mesh.faces.cdata(),
+                                   shouldExpand ? nullptr : mesh.indices.cdata(),
+                                   pointsOffset),
+              "Error writing PLY faces\n");
+        pointsOffset += static_cast<int>(mesh.points.size());
     }
-    return true;
+    return writer.finish();
 }
 
 }
@@ -10,14 +10,25 @@ OF ANY KIND, either express or implied. See the License for the specific languag
 governing permissions and limitations under the License.
 */
 #pragma once
-#include <happly.h>
 #include <fileformatutils/usdData.h>
+#include <iosfwd>
 
 namespace adobe::usd {
 
 /// \ingroup usdply
-/// \brief Export USD data to a ply model.
+/// \brief Options for exporting USD data to a ply model.
+struct ExportPlyOptions
+{
+    bool ascii = false;
+    // Write Gaussian splats in the chunk quantized "compressed PLY" layout
+    bool compressed = false;
+    // Write the higher order SH coefficients of Gaussian splats only up to this degree
+    int maxSHDegree = 3;
+};
+
+/// \ingroup usdply
+/// \brief Export USD data to a ply model, streamed mesh by mesh to the output stream.
 bool
-exportPly(UsdData& data, happly::PLYData& ply);
+exportPly(const ExportPlyOptions& options, UsdData& data, std::ostream& out);
 
 }
\ No newline at end of file
@@ -11,16 +11,18 @@ governing permissions and limitations under the License.
 */
 #include "plyImport.h"
 #include "debugCodes.h"
+#include "plyCompressed.h"
 #include <algorithm>
 #include <array>
-#include <happly.h>
 #include <fileformatutils/common.h>
 #include <fileformatutils/geometry.h>
+#include <fileformatutils/gsplatHelper.h>
 #include <fileformatutils/images.h>
 #include <fileformatutils/neuralAssetsHelper.h>
 #include <limits>
 #include <pxr/base/gf/range3f.h>
 #include <pxr/base/vt/array.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/sdf/path.h>
@@ -37,417 +39,223 @@ governing permissions and limitations under the License.
 #include <string>
 
 using namespace PXR_NS;
-using namespace happly;
 
 namespace adobe::usd {
 namespace {
-template<typename T>
-std::vector<T>*
-getPropertyDataPtr(happly::Element& element, const std::string& target)
-{
-    happly::TypedProperty<T>* property =
-      dynamic_cast<happly::TypedProperty<T>*>(element.getPropertyPtr(target).get());
-    if (property) {
-        return &(property->data);
-    }
-    throw std::runtime_error("PLY import: element " + element.name + " does not have property " +
-                             target + " with the specific type.");
-}
 
-struct FloatOrHalfLoader
+// Returns the indices of the properties, or an empty vector if any of them is missing
+std::vector<int>
+findProperties(const PlyElement& element, const std::vector<std::string>& names)
 {
-    std::vector<float>* getPropertyDataPtr(happly::Element& element, const std::string& target)
-    {
-        happly::TypedProperty<float>* property =
-          dynamic_cast<happly::TypedProperty<float>*>(element.getPropertyPtr(target).get());
-        if (property) {
-            dataPtr = &(property->data);
-            return dataPtr;
-        }
-
-        happly::TypedProperty<std::uint16_t>* halfProperty =
-          dynamic_cast<happly::TypedProperty<std::uint16_t>*>(element.getPropertyPtr(target).get());
-        if (halfProperty) {
-            scratchData.resize(halfProperty->data.size());
-            float16ToFloat32(
-              halfProperty->data.data(), scratchData.data(), halfProperty->data.size());
-            return &scratchData;
+    std::vector<int> indices;
+    indices.reserve(names.size());
+    for (const std::string& name : names) {
+        const int index = element.findProperty(name);
+        if (index < 0) {
+            return {};
         }
-
-        throw std::runtime_error("PLY import: element " + element.name +
-                                 " does not have property " + target + " with the specific type.");
+        indices.push_back(index);
     }
+    return indices;
+}
 
-    std::vector<float>* getPropertyDataPtr()
-    {
-        if (dataPtr)
-            return dataPtr;
-        else if (scratchData.size())
-            return &scratchData;
-        throw std::runtime_error("PLY import: no property data pointer set.");
+// Add targets that decode the properties into the interleaved components of an array
+void
+addTargets(std::vector<PlyTarget>& targets,
+           const std::vector<int>& properties,
+           float* dst,
+           bool normalize = false)
+{
+    const size_t stride = properties.size();
+    for (size_t i = 0; i < properties.size(); i++) {
+        targets.push_back({ properties[i], dst + i, stride, normalize });
     }
+}
 
-    FloatOrHalfLoader() = default;
-    FloatOrHalfLoader(happly::Element& element, const std::string& target)
-    {
-        this->getPropertyDataPtr(element, target);
+// Keep the properties of the higher order SH coefficients of the bands up to the maximum degree,
+// so that the higher bands are never decoded
+void
+truncateSHProperties(std::vector<int>& properties, int maxSHDegree)
+{
+    std::vector<int> truncated;
+    for (size_t index : truncatedSHCoeffIndices(properties.size(), maxSHDegree)) {
+        truncated.push_back(properties[index]);
     }
+    properties = std::move(truncated);
+}
 
-  private:
-    std::vector<float> scratchData;
-    std::vector<float>* dataPtr = nullptr;
-};
-} // namespace
-
+// Decode Gaussian splats in the compressed PLY layout, i.e. a "chunk" element with quantization
+// bounds and a "vertex" element with packed words, in parallel over the chunks
 bool
-importPly(const ImportPlyOptions& options, PLYData& ply, UsdData& usd)
+decodeCompressedGsplats(const PlyReader& ply,
+                        const PlyElement& chunks,
+                        const PlyElement& vertices,
+                        int maxSHDegree,
+                        UsdData& usd,
+                        int meshIndex)
 {
-    // It would be nice to print the ply data format and version but they are private.
-    for (const std::string& comment : ply.comments) {
-        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Comment: %s\n", comment.c_str());
+    const size_t numSplats = vertices.count;
+    if (numSplats > chunks.count * compressedPlyChunkSize) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Not enough chunks for the compressed splats\n");
+        return false;
     }
 
-    std::vector<float>* positionsX = nullptr;
-    std::vector<float>* positionsY = nullptr;
-    std::vector<float>* positionsZ = nullptr;
-    std::vector<float>* nx = nullptr;
-    std::vector<float>* ny = nullptr;
-    std::vector<float>* nz = nullptr;
-    std::vector<float>* u = nullptr;
-    std::vector<float>* v = nullptr;
-    std::vector<unsigned char>* r = nullptr;
-    std::vector<unsigned char>* g = nullptr;
-    std::vector<unsigned char>* b = nullptr;
-    std::vector<unsigned char>* a = nullptr;
-
-    FloatOrHalfLoader positionXLoader;
-    FloatOrHalfLoader positionYLoader;
-    FloatOrHalfLoader positionZLoader;
-    FloatOrHalfLoader nxLoader;
-    FloatOrHalfLoader nyLoader;
-    FloatOrHalfLoader nzLoader;
-    FloatOrHalfLoader uLoader;
-    FloatOrHalfLoader vLoader;
-
-    // These properties are used by Gaussian splats
-    std::vector<float>* gsColorCoeff0 = nullptr;
-    std::vector<float>* gsColorCoeff1 = nullptr;
-    std::vector<float>* gsColorCoeff2 = nullptr;
-    std::vector<float>* gsOpacity = nullptr;
-    std::vector<float>* gsScale0 = nullptr;
-    std::vector<float>* gsScale1 = nullptr;
-    std::vector<float>* gsScale2 = nullptr;
-    std::vector<float>* gsRotation0 = nullptr;
-    std::vector<float>* gsRotation1 = nullptr;
-    std::vector<float>* gsRotation2 = nullptr;
-    std::vector<float>* gsRotation3 = nullptr;
-
-    FloatOrHalfLoader gsColorCoeff0Loader;
-    FloatOrHalfLoader gsColorCoeff1Loader;
-    FloatOrHalfLoader gsColorCoeff2Loader;
-    FloatOrHalfLoader gsOpacityLoader;
-    FloatOrHalfLoader gsScale0Loader;
-    FloatOrHalfLoader gsScale1Loader;
-    FloatOrHalfLoader gsScale2Loader;
-    FloatOrHalfLoader gsRotation0Loader;
-    FloatOrHalfLoader gsRotation1Loader;
-    FloatOrHalfLoader gsRotation2Loader;
-    FloatOrHalfLoader gsRotation3Loader;
-    std::vector<FloatOrHalfLoader> gsSHCoeffsLoaders;
-
-    auto [meshIndex, mesh] = usd.addMesh();
-    mesh.asPoints = options.importAsPoints || !ply.hasElement("face");
-    // Will check later. An asset is a Gsplat only if it contains points and has all the Gsplat-related fields.
-    mesh.asGsplats = mesh.asPoints;
-
-    int numHighOrderSHCoeffs = 0;
-    try {
-        Element& element = ply.getElement("vertex");
-        // happly provides plyIn.getVertexPositions(), but it uses double, so avoid it to avoid
-        // extra work.
-        try {
-            positionsX = positionXLoader.getPropertyDataPtr(element, "x");
-            positionsY = positionYLoader.getPropertyDataPtr(element, "y");
-            positionsZ = positionZLoader.getPropertyDataPtr(element, "z");
-        } catch (std::exception& e) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid position data: %s\n", e.what());
-            return false;
-        }
-        try {
-            nx = nxLoader.getPropertyDataPtr(element, "nx");
-            ny = nyLoader.getPropertyDataPtr(element, "ny");
-            nz = nzLoader.getPropertyDataPtr(element, "nz");
-        } catch (std::exception& e) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid normal data: %s\n", e.what());
-        }
-        try {
-            u = uLoader.getPropertyDataPtr(element, "texture_u");
-            v = vLoader.getPropertyDataPtr(element, "texture_v");
-        } catch (std::exception& e) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid uv data: %s\n", e.what());
-        }
-        try {
-            r = getPropertyDataPtr<unsigned char>(element, "red");
-            g = getPropertyDataPtr<unsigned char>(element, "green");
-            b = getPropertyDataPtr<unsigned char>(element, "blue");
-        } catch (std::exception& e) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid color data: %s\n", e.what());
-        }
-        try {
-            a = getPropertyDataPtr<unsigned char>(element, "alpha");
-        } catch (std::exception& e) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid alpha color data: %s\n", e.what());
-        }
-        if (element.hasProperty("f_dc_0") && element.hasProperty("f_dc_1") &&
-            element.hasProperty("f_dc_2")) {
-            try {
-                gsColorCoeff0 = gsColorCoeff0Loader.getPropertyDataPtr(element, "f_dc_0");
-                gsColorCoeff1 = gsColorCoeff1Loader.getPropertyDataPtr(element, "f_dc_1");
-                gsColorCoeff2 = gsColorCoeff2Loader.getPropertyDataPtr(element, "f_dc_2");
-            } catch (std::exception& e) {
-                TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid Gaussian splatting color data: %s\n", e.what());
-                mesh.asGsplats = false;
-            }
-        } else {
-            mesh.asGsplats = false;
-        }
-        if (mesh.asGsplats && element.hasProperty("scale_0") && element.hasProperty("scale_1") &&
-            element.hasProperty("scale_2")) {
-            try {
-                gsScale0 = gsScale0Loader.getPropertyDataPtr(element, "scale_0");
-                gsScale1 = gsScale1Loader.getPropertyDataPtr(element, "scale_1");
-                gsScale2 = gsScale2Loader.getPropertyDataPtr(element, "scale_2");
-            } catch (std::exception& e) {
-                TF_DEBUG_MSG(
-                  FILE_FORMAT_PLY, "Invalid Gaussian splatting scaling data: %s\n", e.what());
-                mesh.asGsplats = false;
-            }
-        } else {
-            mesh.asGsplats = false;
-        }
-        if (mesh.asGsplats && element.hasProperty("rot_0") && element.hasProperty("rot_1") &&
-            element.hasProperty("rot_2") && element.hasProperty("rot_3")) {
-            try {
-                gsRotation0 = gsRotation0Loader.getPropertyDataPtr(element, "rot_0");
-                gsRotation1 = gsRotation1Loader.getPropertyDataPtr(element, "rot_1");
-                gsRotation2 = gsRotation2Loader.getPropertyDataPtr(element, "rot_2");
-                gsRotation3 = gsRotation3Loader.getPropertyDataPtr(element, "rot_3");
-            } catch (std::exception& e) {
-                TF_DEBUG_MSG(
-                  FILE_FORMAT_PLY, "Invalid Gaussian splatting rotation data: %s\n", e.what());
-                mesh.asGsplats = false;
-            }
-        } else {
-            mesh.asGsplats = false;
-        }
-        if (mesh.asGsplats && element.hasProperty("opacity"))
-        {
-            try {
-                gsOpacity = gsOpacityLoader.getPropertyDataPtr(element, "opacity");
-            } catch (std::exception& e) {
-                TF_DEBUG_MSG(
-                  FILE_FORMAT_PLY, "Invalid Gaussian splatting opacity data: %s\n", e.what());
-                mesh.asGsplats = false;
-            }
-        } else {
-            mesh.asGsplats = false;
-        }
-
-        if (mesh.asGsplats) {
-            // Higher order SH coefficients are optional. We first detect how many coefficients
-            // are present, and then load them.
-            int numSHBands = 0;
-            while (true) {
-                const int numSHBandsNext = numSHBands + 1;
-                // The total required number of coefficients for a single channel of current band is
-                // band * (band + 2), then multiplied by 3 for RGB channels.
-                const int nextBandMaxNumSH = numSHBandsNext * (numSHBandsNext + 2) * 3;
-                const std::string propName =
-                  std::string("f_rest_") + std::to_string(nextBandMaxNumSH - 1);
-                if (!element.hasProperty(propName)) {
-                    break;
-                }
-                numSHBands = numSHBandsNext;
-                numHighOrderSHCoeffs = nextBandMaxNumSH;
-            }
-
-            try {
-                gsSHCoeffsLoaders.reserve(numHighOrderSHCoeffs);
-                for (int i = 0; i < numHighOrderSHCoeffs; ++i) {
-                    const std::string propName = std::string("f_rest_") + std::to_string(i);
-                    if (!element.hasProperty(propName)) {
-                        TF_DEBUG_MSG(FILE_FORMAT_PLY,
-                                     "Missing Gaussian splatting SH coefficient property %s\n",
-                                     propName.c_str());
-                        numHighOrderSHCoeffs = 0;
-                        gsSHCoeffsLoaders.clear();
-                        break;
-                    }
-                    gsSHCoeffsLoaders.emplace_back(element, propName);
-                }
-            } catch (std::exception& e) {
-                TF_DEBUG_MSG(FILE_FORMAT_PLY,
-                             "Invalid Gaussian splatting SH coefficients data: %s\n",
-                             e.what());
-                numHighOrderSHCoeffs = 0;
-                gsSHCoeffsLoaders.clear();
-            }
-        }
-    } catch (std::exception& e) {
-        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Could not find vertex element %s\n", e.what());
-        mesh.asGsplats = false;
+    // The color bounds are missing in files of older versions, which store the colors directly
+    const std::vector<int> boundProperties = findProperties(
+      chunks,
+      { "min_x",       "min_y",       "min_z",       "max_x",       "max_y",       "max_z",
+        "min_scale_x", "min_scale_y", "min_scale_z", "max_scale_x", "max_scale_y", "max_scale_z" });
+    const std::vector<int> colorBoundProperties =
+      findProperties(chunks, { "min_r", "min_g", "min_b", "max_r", "max_g", "max_b" });
+    if (boundProperties.empty()) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid compressed chunk data\n");
+        return false;
     }
-
-    TF_DEBUG_MSG(FILE_FORMAT_PLY,
-                 "Importing as points: %s, width: %f\n",
-                 mesh.asPoints ? "true" : "false",
-                 options.pointWidth);
-
-    mesh.points.resize(positionsX->size());
-    for (size_t i = 0; i < mesh.points.size(); i++) {
-        mesh.points[i][0] = (*positionsX)[i];
-        mesh.points[i][1] = (*positionsY)[i];
-        mesh.points[i][2] = (*positionsZ)[i];
+    std::vector<float> bounds(chunks.count * compressedPlyChunkProperties);
+    std::vector<PlyTarget> targets;
+    addTargets(targets, boundProperties, bounds.data());
+    for (PlyTarget& target : targets) {
+        target.stride = compressedPlyChunkProperties;
     }
-
-    if (nx && nx->size()) {
-        mesh.normals.values.resize(nx->size());
-        for (size_t i = 0; i < mesh.normals.values.size(); i++) {
-            mesh.normals.values[i][0] = (*nx)[i];
-            mesh.normals.values[i][1] = (*ny)[i];
-            mesh.normals.values[i][2] = (*nz)[i];
+    if (colorBoundProperties.empty()) {
+        for (size_t c = 0; c < chunks.count; c++) {
+            std::fill_n(bounds.data() + c * compressedPlyChunkProperties + 12, 3, 0.0f);
+            std::fill_n(bounds.data() + c * compressedPlyChunkProperties + 15, 3, 1.0f);
         }
-        mesh.normals.interpolation = UsdGeomTokens->vertex;
-    }
-
-    if (u && u->size()) {
-        mesh.uvs.values.resize(u->size());
-        for (size_t i = 0; i < mesh.uvs.values.size(); i++) {
-            mesh.uvs.values[i][0] = (*u)[i];
-            mesh.uvs.values[i][1] = (*v)[i];
+    } else {
+        for (size_t i = 0; i < colorBoundProperties.size(); i++) {
+            targets.push_back(
+              { colorBoundProperties[i], bounds.data() + 12 + i, compressedPlyChunkProperties });
         }
-        mesh.uvs.interpolation = UsdGeomTokens->vertex;
     }
-
-    // Prioritize Gsplat loading, if there're properties for colors.
-    // Both the Gsplat and regular point cloud have definitions to color,
-    // but with different names and conversions.
-    if (mesh.asGsplats && gsColorCoeff0->size()) {
-        auto [colorIndex, colors] = usd.addColorSet(meshIndex);
-        colors.interpolation = UsdGeomTokens->vertex;
-        colors.values.resize(gsColorCoeff0->size());
-
-        // The 0th-order coefficient of spherical harmonics, which
-        // is 1/sqrt(4*pi).
-        constexpr float shC0 = 0.28209479177387814f;
-        for (size_t i = 0; i < colors.values.size(); i++) {
-            colors.values[i][0] = (*gsColorCoeff0)[i] * shC0 + 0.5f;
-            colors.values[i][1] = (*gsColorCoeff1)[i] * shC0 + 0.5f;
-            colors.values[i][2] = (*gsColorCoeff2)[i] * shC0 + 0.5f;
-        }
-    } else if (r && r->size()) {
-        auto [colorIndex, colors] = usd.addColorSet(meshIndex);
-        colors.interpolation = UsdGeomTokens->vertex;
-        colors.values.resize(r->size());
-        for (size_t i = 0; i < colors.values.size(); i++) {
-            colors.values[i][0] = static_cast<float>((*r)[i]) / 255.0f;
-            colors.values[i][1] = static_cast<float>((*g)[i]) / 255.0f;
-            colors.values[i][2] = static_cast<float>((*b)[i]) / 255.0f;
-        }
+    if (!ply.readProperties(chunks, targets)) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid compressed chunk data\n");
+        return false;
     }
 
-    // Prioritize Gsplat loading, if there're properties for opacity.
-    // Both the Gsplat and regular point cloud have definitions to opacity,
-    // but with different names and conversions.
-    if (mesh.asGsplats && gsOpacity->size()) {
-        auto [opacityIndex, opacity] = usd.addOpacitySet(meshIndex);
-        opacity.interpolation = UsdGeomTokens->vertex;
-        opacity.values.resize(gsOpacity->size());
-        for (size_t i = 0; i < opacity.values.size(); i++) {
-            // when nan opacity is detected, set opacity to 0
-            float op = (*gsOpacity)[i];
-            opacity.values[i] = std::isfinite(op) ? 1.0f / (1.0f + std::exp(-op)) : 0.0f;
-        }
-    } else if (a && a->size()) {
-        auto [opacityIndex, opacity] = usd.addOpacitySet(meshIndex);
-        opacity.interpolation = UsdGeomTokens->vertex;
-        opacity.values.resize(a->size());
-        for (size_t i = 0; i < opacity.values.size(); i++) {
-            opacity.values[i] = static_cast<float>((*a)[i]) / 255.0f;
-        }
+    // The packed words are decoded straight from the rows, since they do not fit in floats
+    const std::vector<int> packedProperties = findProperties(
+      vertices, { "packed_position", "packed_rotation", "packed_scale", "packed_color" });
+    bool validPacked = !packedProperties.empty() && ply.getFormat() != PlyFormat::Ascii &&
+                       vertices.rowSize > 0 && vertices.begin;
+    for (int property : packedProperties) {
+        const PlyType type = vertices.properties[property].type;
+        validPacked = validPacked && (type == PlyType::UInt32 || type == PlyType::Int32);
+    }
+    if (!validPacked) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid compressed vertex data\n");
+        return false;
     }
 
-    // Prioritize Gsplat loading, if there're properties for point width.
-    // Otherwise we use a constant value from option.
-    if (mesh.asPoints) {
-        if (mesh.asGsplats && gsScale0->size()) {
-            mesh.pointWidths.resize(gsScale0->size());
-            for (size_t i = 0; i < mesh.pointWidths.size(); i++) {
-                mesh.pointWidths[i] = std::exp((*gsScale0)[i]) * 2.0f;
-            }
-
-            auto [width1Index, widths1] = usd.addExtraPointWidthSet(meshIndex);
-            widths1.interpolation = UsdGeomTokens->vertex;
-            widths1.values.resize(gsScale1->size());
-            for (size_t i = 0; i < widths1.values.size(); i++) {
-                widths1.values[i] = std::exp((*gsScale1)[i]) * 2.0f;
-            }
-
-            auto [width2Index, widths2] = usd.addExtraPointWidthSet(meshIndex);
-            widths2.interpolation = UsdGeomTokens->vertex;
-            widths2.values.resize(gsScale2->size());
-            for (size_t i = 0; i < widths2.values.size(); i++) {
-                widths2.values[i] = std::exp((*gsScale2)[i]) * 2.0f;
-            }
-        } else {
-            mesh.pointWidths.resize(mesh.points.size());
-            for (size_t i = 0; i < mesh.pointWidths.size(); i++) {
-                mesh.pointWidths[i] = options.pointWidth;
+    // The higher order SH coefficients are optional, and their number sets the degree
+    const PlyElement* shElement = ply.getElement("sh");
+    std::vector<int> shProperties;
+    if (shElement && shElement->count == numSplats) {
+        for (size_t degree = 3; degree > 0 && shProperties.empty(); degree--) {
+            std::vector<std::string> names;
+            for (size_t i = 0; i < numNonZeroSHBandsFromDegree(degree) * 3; i++) {
+                names.push_back("f_rest_" + std::to_string(i));
             }
+            shProperties = findProperties(*shElement, names);
         }
+        truncateSHProperties(shProperties, maxSHDegree);
     }
 
-    if (!mesh.asPoints) {
-        try {
-            std::vector<std::vector<size_t>> indices = ply.getFaceIndices<size_t>();
-            mesh.faces.resize(indices.size());
-            for (size_t i = 0; i < indices.size(); i++) {
-                mesh.faces[i] = indices[i].size();
-                for (size_t j = 0; j < indices[i].size(); j++) {
-                    mesh.indices.push_back(indices[i][j]);
+    // Add all the primvar sets first, since adding sets can move the previous ones
+    const int colorIndex = usd.addColorSet(meshIndex).first;
+    const int opacityIndex = usd.addOpacitySet(meshIndex).first;
+    const int widths1Index = usd.addExtraPointWidthSet(meshIndex).first;
+    const int widths2Index = usd.addExtraPointWidthSet(meshIndex).first;
+    std::vector<int> shCoeffIndices;
+    for (size_t i = 0; i < shProperties.size(); i++) {
+        shCoeffIndices.push_back(usd.addPointSHCoeffSet(meshIndex).first);
+    }
+
+    Mesh& mesh = usd.meshes[meshIndex];
+    auto preparePrimvar = [numSplats](auto& primvar) {
+        primvar.interpolation = UsdGeomTokens->vertex;
+        primvar.values.resize(numSplats);
+        return primvar.values.data();
+    };
+    mesh.points.resize(numSplats);
+    mesh.pointWidths.resize(numSplats);
+    GfVec3f* points = mesh.points.data();
+    GfVec3f* colors = preparePrimvar(mesh.colors[colorIndex]);
+    float* opacities = preparePrimvar(mesh.opacities[opacityIndex]);
+    float* widths[3] = { mesh.pointWidths.data(),
+                         preparePrimvar(mesh.pointExtraWidths[widths1Index]),
+                         preparePrimvar(mesh.pointExtraWidths[widths2Index]) };
+    GfQuatf* rotations = preparePrimvar(mesh.pointRotations);
+
+    const bool swap = ply.getFormat() != nativeBinaryFormat();
+    const size_t numChunks = (numSplats + compressedPlyChunkSize - 1) / compressedPlyChunkSize;
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            const float* b = bounds.data() + c * compressedPlyChunkProperties;
+            const size_t first = c * compressedPlyChunkSize;
+            const size_t last = std::min(first + compressedPlyChunkSize, numSplats);
+            for (size_t i = first; i < last; i++) {
+                const char* row = vertices.begin + i * vertices.rowSize;
+                std::uint32_t words[4];
+                for (size_t k = 0; k < 4; k++) {
+                    const char* p = row + vertices.properties[packedProperties[k]].offset;
+                    words[k] = swap ? loadScalar<std::uint32_t, true>(p)
+                                    : loadScalar<std::uint32_t, false>(p);
+                }
+                float t[4];
+                unpack111011(words[0], t);
+                for (size_t k = 0; k < 3; k++) {
+                    points[i][k] = b[k] + (b[3 + k] - b[k]) * t[k];
+                }
+                float q[4];
+                unpackRotation(words[1], q);
+                rotations[i] = GfQuatf(q[0], q[1], q[2], q[3]).GetNormalized();
+                unpack111011(words[2], t);
+                for (size_t k = 0; k < 3; k++) {
+                    widths[k][i] = std::exp(b[6 + k] + (b[9 + k] - b[6 + k]) * t[k]) * 2.0f;
                 }
+                unpack8888(words[3], t);
+                for (size_t k = 0; k < 3; k++) {
+                    colors[i][k] = b[12 + k] + (b[15 + k] - b[12 + k]) * t[k];
+                }
+                opacities[i] = t[3];
             }
-        } catch (std::exception& e) {
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid index data: %s\n", e.what());
-            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Creating triangulation indices\n");
-            createTriangulationIndices(mesh);
         }
-    }
+    });
 
-    // Load other Gsplat-specific attributes.
-    if (mesh.asGsplats) {
-        mesh.pointRotations.interpolation = UsdGeomTokens->vertex;
-        mesh.pointRotations.values.resize(gsRotation0->size());
-        for (size_t i = 0; i < mesh.pointRotations.values.size(); i++) {
-            mesh.pointRotations.values[i].SetReal((*gsRotation0)[i]);
-            mesh.pointRotations.values[i].SetImaginary(
-              (*gsRotation1)[i], (*gsRotation2)[i], (*gsRotation3)[i]);
-            mesh.pointRotations.values[i] = mesh.pointRotations.values[i].GetNormalized();
+    if (!shProperties.empty()) {
+        targets.clear();
+        for (size_t i = 0; i < shProperties.size(); i++) {
+            targets.push_back(
+              { shProperties[i], preparePrimvar(mesh.pointSHCoeffs[shCoeffIndices[i]]), 1 });
         }
-
-        if (numHighOrderSHCoeffs > 0) {
-            for (std::size_t shIndex = 0; shIndex < numHighOrderSHCoeffs; ++shIndex) {
-                auto [shCoeffIndex, shCoeffs] = usd.addPointSHCoeffSet(meshIndex);
-                shCoeffs.interpolation = UsdGeomTokens->vertex;
-                const auto& gsSHCoeffs = *(gsSHCoeffsLoaders[shIndex].getPropertyDataPtr());
-                shCoeffs.values.resize(gsSHCoeffs.size());
-                for (size_t i = 0; i < shCoeffs.values.size(); i++) {
-                    shCoeffs.values[i] = gsSHCoeffs[i];
+        if (!ply.readProperties(*shElement, targets)) {
+            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid compressed SH data\n");
+            return false;
+        }
+        WorkParallelForN(numSplats, [&](size_t begin, size_t end) {
+            for (const PlyTarget& target : targets) {
+                for (size_t i = begin; i < end; i++) {
+                    target.dst[i] = unpackSHCoeff(target.dst[i]);
                 }
             }
-        }
+        });
     }
+    mesh.extent = computeExtent(mesh.points);
 
+    TF_DEBUG_MSG(FILE_FORMAT_PLY,
+                 "Decoded %zu compressed splats in %zu chunks with %zu SH coefficients\n",
+                 numSplats,
+                 numChunks,
+                 shProperties.size());
+    return true;
+}
+
+// Add the node of the imported mesh, and set up the up axis and the Gsplat clipping box
+bool
+finalizeImport(const ImportPlyOptions& options, const PlyReader& ply, UsdData& usd, int meshIndex)
+{
+    Mesh& mesh = usd.meshes[meshIndex];
     auto [nodeIndex, node] = usd.addNode(-1);
     node.staticMeshes.push_back(meshIndex);
 
@@ -464,7 +272,7 @@ importPly(const ImportPlyOptions& options, PLYData& ply, UsdData& usd)
             std::regex("\\bRhinoceros\\b")
         };
 
-        for (const std::string& comment : ply.comments) 
+        for (const std::string& comment : ply.getComments()) 
         {
             if (!useZup) {
                 for (const std::regex& pattern : zUpTokens) {
@@ -484,17 +292,9 @@ importPly(const ImportPlyOptions& options, PLYData& ply, UsdData& usd)
 
     if (mesh.asGsplats && options.importGsplatClippingBox.size() >= 6) 
     {
-        PXR_NS::GfVec3f minPos(std::numeric_limits<float>::max());
-        PXR_NS::GfVec3f maxPos(-std::numeric_limits<float>::max());
-        for (size_t i = 0; i < mesh.points.size(); i++) {
-            minPos[0] = std::min(mesh.points[i][0], minPos[0]);
-            minPos[1] = std::min(mesh.points[i][1], minPos[1]);
-            minPos[2] = std::min(mesh.points[i][2], minPos[2]);
-            maxPos[0] = std::max(mesh.points[i][0], maxPos[0]);
-            maxPos[1] = std::max(mesh.points[i][1], maxPos[1]);
-            maxPos[2] = std::max(mesh.points[i][2], maxPos[2]);
-        }
-        if (maxPos[0] < minPos[0] || maxPos[1] < minPos[1] || maxPos[2] < minPos[2]) {
+        const GfVec3f& minPos = mesh.extent.GetMin();
+        const GfVec3f& maxPos = mesh.extent.GetMax();
+        if (mesh.extent.IsEmpty()) {
             TF_DEBUG_MSG(FILE_FORMAT_PLY,
                          "Invalid bounding box: (%f, %f, %f) - (%f, %f, %f)\n",
                          minPos[0],
@@ -521,7 +321,222 @@ importPly(const ImportPlyOptions& options, PLYData& ply, UsdData& usd)
                           std::min(options.importGsplatClippingBox[5], maxPos[2]));
         mesh.clippingBox.interpolation = UsdGeomTokens->constant;
     }
+
+    if (mesh.asGsplats && options.gsplatPrune.enabled()) {
+        const size_t numPoints = mesh.points.size();
+        const size_t numPruned = pruneGsplats(mesh, options.gsplatPrune);
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Pruned %zu of %zu splats\n", numPruned, numPoints);
+    }
+    if (mesh.asGsplats && options.halfPrecisionGsplats) {
+        convertGsplatsToHalf(mesh);
+    }
     return true;
 }
+} // namespace
+
+bool
+importPly(const ImportPlyOptions& options, const PlyReader& ply, UsdData& usd)
+{
+    for (const std::string& comment : ply.getComments()) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Comment: %s\n", comment.c_str());
+    }
+
+    const PlyElement* vertices = ply.getElement("vertex");
+    if (!vertices) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Could not find vertex element\n");
+        return false;
+    }
+    // The count of a truncated element isn't backed by data and must not size any allocation
+    if (vertices->count > 0 && !vertices->begin) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Missing vertex data\n");
+        return false;
+    }
+
+    // Compressed Gaussian splats have quantization chunks and packed vertices instead of positions
+    const PlyElement* chunks = ply.getElement("chunk");
+    if (chunks && vertices->findProperty("packed_position") >= 0) {
+        auto [meshIndex, mesh] = usd.addMesh();
+        mesh.asPoints = true;
+        mesh.asGsplats = true;
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Importing compressed Gaussian splats\n");
+        if (!decodeCompressedGsplats(
+              ply, *chunks, *vertices, options.maxSHDegree, usd, meshIndex)) {
+            return false;
+        }
+        return finalizeImport(options, ply, usd, meshIndex);
+    }
+
+    const size_t numVertices = vertices->count;
+    const std::vector<int> positionProperties = findProperties(*vertices, { "x", "y", "z" });
+    if (positionProperties.empty()) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid position data\n");
+        return false;
+    }
+    const std::vector<int> normalProperties = findProperties(*vertices, { "nx", "ny", "nz" });
+    const std::vector<int> uvProperties = findProperties(*vertices, { "texture_u", "texture_v" });
+    const std::vector<int> colorProperties =
+      findProperties(*vertices, { "red", "green", "blue" });
+    const std::vector<int> alphaProperties = findProperties(*vertices, { "alpha" });
+
+    // These properties are used by Gaussian splats
+    const std::vector<int> gsColorProperties =
+      findProperties(*vertices, { "f_dc_0", "f_dc_1", "f_dc_2" });
+    const std::vector<int> gsOpacityProperties = findProperties(*vertices, { "opacity" });
+    const std::vector<int> gsScaleProperties =
+      findProperties(*vertices, { "scale_0", "scale_1", "scale_2" });
+    const std::vector<int> gsRotationProperties =
+      findProperties(*vertices, { "rot_0", "rot_1", "rot_2", "rot_3" });
+
+    auto [meshIndex, mesh] = usd.addMesh();
+    mesh.asPoints = options.importAsPoints || !ply.getElement("face");
+    // An asset is a Gsplat only if it contains points and has all the Gsplat-related fields.
+    mesh.asGsplats = mesh.asPoints && !gsColorProperties.empty() &&
+                     !gsOpacityProperties.empty() && !gsScaleProperties.empty() &&
+                     !gsRotationProperties.empty();
+
+    std::vector<int> gsSHCoeffProperties;
+    if (mesh.asGsplats) {
+        // Higher order SH coefficients are optional. We first detect how many coefficients
+        // are present, and then load them.
+        int numSHBands = 0;
+        int numHighOrderSHCoeffs = 0;
+        while (true) {
+            const int numSHBandsNext = numSHBands + 1;
+            // The total required number of coefficients for a single channel of current band is
+            // band * (band + 2), then multiplied by 3 for RGB channels.
+            const int nextBandMaxNumSH = numSHBandsNext * (numSHBandsNext + 2) * 3;
+            const std::string propName =
+              std::string("f_rest_") + std::to_string(nextBandMaxNumSH - 1);
+            if (vertices->findProperty(propName) < 0) {
+                break;
+            }
+            numSHBands = numSHBandsNext;
+            numHighOrderSHCoeffs = nextBandMaxNumSH;
+        }
+        for (int i = 0; i < numHighOrderSHCoeffs; ++i) {
+            const std::string propName = std::string("f_rest_") + std::to_string(i);
+            const int property = vertices->findProperty(propName);
+            if (property < 0) {
+                TF_DEBUG_MSG(FILE_FORMAT_PLY,
+                             "Missing Gaussian splatting SH coefficient property %s\n",
+                             propName.c_str());
+                gsSHCoeffProperties.clear();
+                break;
+            }
+            gsSHCoeffProperties.push_back(property);
+        }
+        truncateSHProperties(gsSHCoeffProperties, options.maxSHDegree);
+    }
+
+    TF_DEBUG_MSG(FILE_FORMAT_PLY,
+                 "Importing as points: %s, width: %f\n",
+                 mesh.asPoints ? "true" : "false",
+                 options.pointWidth);
+
+    // All properties are decoded in a single pass over the vertex rows, straight into the final
+    // arrays where possible. Gaussian splat properties that need a conversion are decoded into an
+    // interleaved scratch array first, and then converted by decodeGsplats.
+    std::vector<PlyTarget> targets;
+    mesh.points.resize(numVertices);
+    addTargets(targets, positionProperties, reinterpret_cast<float*>(mesh.points.data()));
+
+    if (!normalProperties.empty()) {
+        mesh.normals.values.resize(numVertices);
+        mesh.normals.interpolation = UsdGeomTokens->vertex;
+        addTargets(targets, normalProperties, reinterpret_cast<float*>(mesh.normals.values.data()));
+    }
+
+    if (!uvProperties.empty()) {
+        mesh.uvs.values.resize(numVertices);
+        mesh.uvs.interpolation = UsdGeomTokens->vertex;
+        addTargets(targets, uvProperties, reinterpret_cast<float*>(mesh.uvs.values.data()));
+    }
+
+    // Prioritize Gsplat loading, if there're properties for colors, opacity and point width.
+    // Both the Gsplat and regular point cloud have definitions to colors and opacity,
+    // but with different names and conversions. Otherwise we use a constant point width from
+    // option.
+    std::vector<float> gsRawValues;
+    std::vector<int> gsRawProperties;
+    if (mesh.asGsplats) {
+        for (const std::vector<int>* properties :
+             { &gsColorProperties, &gsOpacityProperties, &gsScaleProperties, &gsRotationProperties }) {
+            gsRawProperties.insert(gsRawProperties.end(), properties->begin(), properties->end());
+        }
+        gsRawValues.resize(numVertices * gsRawProperties.size());
+        addTargets(targets, gsRawProperties, gsRawValues.data());
+
+        // The higher order SH coefficients need no conversion
+        for (int property : gsSHCoeffProperties) {
+            auto [shCoeffIndex, shCoeffs] = usd.addPointSHCoeffSet(meshIndex);
+            shCoeffs.interpolation = UsdGeomTokens->vertex;
+            shCoeffs.values.resize(numVertices);
+            targets.push_back({ property, shCoeffs.values.data(), 1, false });
+        }
+    } else {
+        if (!colorProperties.empty()) {
+            auto [colorIndex, colors] = usd.addColorSet(meshIndex);
+            colors.interpolation = UsdGeomTokens->vertex;
+            colors.values.resize(numVertices);
+            addTargets(targets, colorProperties, reinterpret_cast<float*>(colors.values.data()), true);
+        }
+        if (!alphaProperties.empty()) {
+            auto [opacityIndex, opacity] = usd.addOpacitySet(meshIndex);
+            opacity.interpolation = UsdGeomTokens->vertex;
+            opacity.values.resize(numVertices);
+            addTargets(targets, alphaProperties, opacity.values.data(), true);
+        }
+        if (mesh.asPoints) {
+            mesh.pointWidths.assign(numVertices, options.pointWidth);
+        }
+    }
+
+    if (!ply.readProperties(*vertices, targets)) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid vertex data\n");
+        return false;
+    }
+    mesh.extent = computeExtent(mesh.points);
+
+    if (mesh.asGsplats) {
+        // The raw values are interleaved in the order of the color, opacity, scale and rotation
+        // properties
+        const float* rawValues = gsRawValues.data();
+        const size_t stride = gsRawProperties.size();
+        GsplatRawAttributes raw;
+        raw.colors = { rawValues, rawValues + 1, rawValues + 2 };
+        raw.colorStride = stride;
+        raw.opacities = rawValues + 3;
+        raw.opacityStride = stride;
+        raw.scales = { rawValues + 4, rawValues + 5, rawValues + 6 };
+        raw.scaleStride = stride;
+        raw.rotations = { rawValues + 7, rawValues + 8, rawValues + 9, rawValues + 10 };
+        raw.rotationStride = stride;
+        decodeGsplats(raw, numVertices, usd, meshIndex);
+    }
+
+    if (!mesh.asPoints) {
+        const PlyElement* faces = ply.getElement("face");
+        int indicesProperty = faces->findProperty("vertex_indices");
+        if (indicesProperty < 0) {
+            indicesProperty = faces->findProperty("vertex_index");
+        }
+        // Indices outside of the vertices would be dereferenced out of bounds downstream
+        const auto invalidIndex = [numVertices](int index) {
+            return index < 0 || static_cast<size_t>(index) >= numVertices;
+        };
+        if (indicesProperty < 0 || !faces->properties[indicesProperty].isList() ||
+            !ply.readList(
+              *faces, indicesProperty, mesh.faces, mesh.indices, options.triangulate) ||
+            std::any_of(mesh.indices.cbegin(), mesh.indices.cend(), invalidIndex)) {
+            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Invalid index data\n");
+            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Creating triangulation indices\n");
+            mesh.faces.clear();
+            mesh.indices.clear();
+            createTriangulationIndices(mesh);
+        }
+    }
+
+    return finalizeImport(options, ply, usd, meshIndex);
+}
 
 }
\ No newline at end of file
@@ -10,7 +10,8 @@ OF ANY KIND, either express or implied. See the License for the specific languag
 governing permissions and limitations under the License.
 */
 #pragma once
-#include <happly.h>
+#include "plyReader.h"
+#include <fileformatutils/gsplatHelper.h>
 #include <fileformatutils/usdData.h>
 
 namespace adobe::usd {
@@ -21,11 +22,19 @@ struct ImportPlyOptions
     bool importWithUpAxisCorrection = true;
     PXR_NS::VtFloatArray importGsplatClippingBox = { -2, -2, -2, 2, 2, 2 };
     float pointWidth = 0.01f;
+    // Fan triangulate the faces while they are read
+    bool triangulate = false;
+    // Decode the higher order SH coefficients of Gaussian splats only up to this degree
+    int maxSHDegree = 3;
+    // Drop faint, tiny, huge or clipped splats after the import
+    GsplatPruneOptions gsplatPrune;
+    // Keep the colors, opacities and SH coefficients of Gaussian splats in half precision
+    bool halfPrecisionGsplats = false;
 };
 
 /// \ingroup usdply
 /// \brief Import ply data into a USD data cache.
 bool
-importPly(const ImportPlyOptions& options, happly::PLYData& ply, UsdData& data);
+importPly(const ImportPlyOptions& options, const PlyReader& ply, UsdData& data);
 
 }
\ No newline at end of file
@@ -0,0 +1,969 @@
+/*
+Copyright 2025 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+#include "plyReader.h"
+#include "debugCodes.h"
+
+#include <fast_float/fast_float.h>
+#include <pxr/base/gf/half.h>
+#include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/work/loops.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
+
+using namespace PXR_NS;
+
+namespace adobe::usd {
+
+namespace {
+
+// Number of rows of fixed size elements that are decoded column by column, so that the rows stay
+// in the cache while the targeted properties are extracted
+constexpr size_t blockRows = 256;
+
+// Number of bytes of ascii data that are scanned for the starts of rows by one task
+constexpr size_t asciiBlockSize = 1 << 20;
+
+PlyType
+parsePlyType(const std::string& name)
+{
+    if (name == "char" || name == "int8") {
+        return PlyType::Int8;
+    } else if (name == "uchar" || name == "uint8") {
+        return PlyType::UInt8;
+    } else if (name == "short" || name == "int16") {
+        return PlyType::Int16;
+    } else if (name == "ushort" || name == "uint16") {
+        return PlyType::UInt16;
+    } else if (name == "int" || name == "int32") {
+        return PlyType::Int32;
+    } else if (name == "uint" || name == "uint32") {
+        return PlyType::UInt32;
+    } else if (name == "float" || name == "float32") {
+        return PlyType::Float32;
+    } else if (name == "double" || name == "float64") {
+        return PlyType::Float64;
+    }
+    return PlyType::Invalid;
+}
+
+template<typename T>
+float
+toFloat(T value, bool normalize)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<float>(value);
+    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+        if (normalize) {
+            return static_cast<float>(value) / 65535.0f;
+        }
+        // Without normalization 16 bit values hold half floats, e.g. in Gaussian splat files
+        GfHalf half;
+        half.setBits(value);
+        return static_cast<float>(half);
+    } else {
+        if (normalize) {
+            return std::max(static_cast<float>(value) /
+                              static_cast<float>(std::numeric_limits<T>::max()),
+                            -1.0f);
+        }
+        return static_cast<float>(value);
+    }
+}
+
+template<typename T, bool Swap>
+void
+decodeColumnTyped(const char* src,
+                  size_t rowSize,
+                  size_t rows,
+                  float* dst,
+                  size_t stride,
+                  bool normalize)
+{
+    for (size_t i = 0; i < rows; i++) {
+        dst[i * stride] = toFloat(loadScalar<T, Swap>(src + i * rowSize), normalize);
+    }
+}
+
+void
+decodeColumn(PlyType type,
+             bool swap,
+             const char* src,
+             size_t rowSize,
+             size_t rows,
+             float* dst,
+             size_t stride,
+             bool normalize)
+{
+    dispatchPlyType(type, [&](auto tag) {
+        using T = decltype(tag);
+        if (swap) {
+            decodeColumnTyped<T, true>(src, rowSize, rows, dst, stride, normalize);
+        } else {
+            decodeColumnTyped<T, false>(src, rowSize, rows, dst, stride, normalize);
+        }
+    });
+}
+
+float
+loadFloat(const char* p, PlyType type, bool swap, bool normalize)
+{
+    float value = 0.0f;
+    dispatchPlyType(type, [&](auto tag) {
+        using T = decltype(tag);
+        value = toFloat(swap ? loadScalar<T, true>(p) : loadScalar<T, false>(p), normalize);
+    });
+    return value;
+}
+
+std::int64_t
+loadInteger(const char* p, PlyType type, bool swap)
+{
+    std::int64_t value = 0;
+    dispatchPlyType(type, [&](auto tag) {
+        using T = decltype(tag);
+        value = static_cast<std::int64_t>(swap ? loadScalar<T, true>(p) : loadScalar<T, false>(p));
+    });
+    return value;
+}
+
+void
+decodeIntegers(const char* src, PlyType type, bool swap, size_t count, int* dst)
+{
+    dispatchPlyType(type, [&](auto tag) {
+        using T = decltype(tag);
+        if (swap) {
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<int>(loadScalar<T, true>(src + i * sizeof(T)));
+            }
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<int>(loadScalar<T, false>(src + i * sizeof(T)));
+            }
+        }
+    });
+}
+
+// Returns the byte size of a binary property at p or 0 if it would exceed the end of the data
+size_t
+binaryPropertySize(const char* p, const char* end, const PlyProperty& property, bool swap)
+{
+    const size_t available = static_cast<size_t>(end - p);
+    const size_t typeSize = plyTypeSize(property.type);
+    if (!property.isList()) {
+        return typeSize <= available ? typeSize : 0;
+    }
+    const size_t countSize = plyTypeSize(property.countType);
+    if (countSize > available) {
+        return 0;
+    }
+    const std::int64_t count = loadInteger(p, property.countType, swap);
+    if (count < 0) {
+        return 0;
+    }
+    const size_t size = countSize + static_cast<size_t>(count) * typeSize;
+    return size <= available ? size : 0;
+}
+
+// Walk the binary rows of a chunk of an element with variable row sizes and call
+// fn(row, propertyIndex, data, size) for each property
+template<typename F>
+bool
+walkBinaryChunk(const PlyElement& element, size_t chunk, bool swap, F&& fn)
+{
+    const char* p = element.begin + element.chunkOffsets[chunk];
+    const size_t firstRow = chunk * PlyReader::rowsPerChunk;
+    const size_t lastRow = std::min(firstRow + PlyReader::rowsPerChunk, element.count);
+    const size_t numProperties = element.properties.size();
+    for (size_t row = firstRow; row < lastRow; row++) {
+        for (size_t i = 0; i < numProperties; i++) {
+            const size_t size = binaryPropertySize(p, element.end, element.properties[i], swap);
+            if (size == 0) {
+                return false;
+            }
+            fn(row, i, p, size);
+            p += size;
+        }
+    }
+    return true;
+}
+
+inline bool
+isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Skip blank characters and empty lines
+const char*
+skipWhitespace(const char* p, const char* end)
+{
+    while (p < end && (isBlank(*p) || *p == '\n')) {
+        p++;
+    }
+    return p;
+}
+
+const char*
+findLineEnd(const char* p, const char* end)
+{
+    const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return lineEnd ? lineEnd : end;
+}
+
+// Parse the next blank separated number on the line and advance p past it
+bool
+parseAsciiNumber(const char*& p, const char* lineEnd, double& value)
+{
+    while (p < lineEnd && isBlank(*p)) {
+        p++;
+    }
+    const char* tokenEnd = p;
+    while (tokenEnd < lineEnd && !isBlank(*tokenEnd)) {
+        tokenEnd++;
+    }
+    const fast_float::from_chars_result result = fast_float::from_chars(p, tokenEnd, value);
+    if (result.ec != std::errc() || result.ptr != tokenEnd) {
+        return false;
+    }
+    p = tokenEnd;
+    return true;
+}
+
+// Skip the next blank separated tokens on the line without parsing them
+bool
+skipAsciiTokens(const char*& p, const char* lineEnd, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        while (p < lineEnd && isBlank(*p)) {
+            p++;
+        }
+        if (p >= lineEnd) {
+            return false;
+        }
+        while (p < lineEnd && !isBlank(*p)) {
+            p++;
+        }
+    }
+    return true;
+}
+
+// Advance p over the properties of an ascii row that precede the list property and its size
+bool
+seekAsciiList(const PlyElement& element,
+              int listProperty,
+              const char*& p,
+              const char* lineEnd,
+              size_t& count)
+{
+    for (int i = 0; i <= listProperty; i++) {
+        double value = 0.0;
+        // Every list value takes at least one character, which also bounds hostile list sizes
+        if (!parseAsciiNumber(p, lineEnd, value) || !(value >= 0) ||
+            value > static_cast<double>(lineEnd - p)) {
+            return false;
+        }
+        if (i == listProperty) {
+            count = static_cast<size_t>(value);
+        } else if (element.properties[i].isList() &&
+                   !skipAsciiTokens(p, lineEnd, static_cast<size_t>(value))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Number of values that a list of the given size adds to the output. Triangulated lists add the
+// indices of the count - 2 triangles of their fan and lists with fewer than 3 values are dropped.
+size_t
+listOutputSize(size_t count, bool triangulate)
+{
+    if (!triangulate) {
+        return count;
+    }
+    return count >= 3 ? 3 * (count - 2) : 0;
+}
+
+// Write the fan triangulation of a polygon around its first vertex, like fanTriangulate() in the
+// utils, and return the end of the written indices
+int*
+writeTriangleFan(const int* polygon, size_t count, int* dst)
+{
+    for (size_t j = 1; j + 1 < count; j++) {
+        *dst++ = polygon[0];
+        *dst++ = polygon[j];
+        *dst++ = polygon[j + 1];
+    }
+    return dst;
+}
+
+// Walk the lines of a chunk of rows of an ascii element and call fn(row, p, lineEnd) for each
+template<typename F>
+bool
+walkAsciiChunk(const PlyElement& element, size_t chunk, F&& fn)
+{
+    const char* p = element.begin + element.chunkOffsets[chunk];
+    const size_t firstRow = chunk * PlyReader::rowsPerChunk;
+    const size_t lastRow = std::min(firstRow + PlyReader::rowsPerChunk, element.count);
+    for (size_t row = firstRow; row < lastRow; row++) {
+        p = skipWhitespace(p, element.end);
+        const char* lineEnd = findLineEnd(p, element.end);
+        if (!fn(row, p, lineEnd)) {
+            TF_WARN("Invalid row %zu of PLY element %s\n", row, element.name.c_str());
+            return false;
+        }
+        p = lineEnd;
+    }
+    return true;
+}
+
+// Convert a parsed ascii value to T. Converting a double outside of the range of T is undefined,
+// so the value is clamped to the range first and NaN becomes 0 for integer types.
+template<typename T>
+T
+clampToType(double value)
+{
+    if constexpr (std::is_integral_v<T>) {
+        if (std::isnan(value)) {
+            return 0;
+        }
+    }
+    const double lowest = static_cast<double>(std::numeric_limits<T>::lowest());
+    const double highest = static_cast<double>(std::numeric_limits<T>::max());
+    return static_cast<T>(std::clamp(value, lowest, highest));
+}
+
+float
+asciiToFloat(double value, PlyType type, bool normalize)
+{
+    float result = 0.0f;
+    dispatchPlyType(type, [&](auto tag) {
+        using T = decltype(tag);
+        result = toFloat(clampToType<T>(value), normalize);
+    });
+    return result;
+}
+
+} // namespace
+
+int
+PlyElement::findProperty(const std::string& propertyName) const
+{
+    for (size_t i = 0; i < properties.size(); i++) {
+        if (properties[i].name == propertyName) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool
+PlyReader::open(const std::string& filename)
+{
+    FILE* file = ArchOpenFile(filename.c_str(), "rb");
+    if (!file) {
+        TF_WARN("Unable to open PLY file %s\n", filename.c_str());
+        return false;
+    }
+    std::string error;
+    _mapping = ArchMapFileReadOnly(file, &error);
+    fclose(file);
+    if (!_mapping) {
+        TF_WARN("Unable to map PLY file %s: %s\n", filename.c_str(), error.c_str());
+        return false;
+    }
+    return open(_mapping.get(), ArchGetFileMappingLength(_mapping));
+}
+
+bool
+PlyReader::open(const char* data, size_t size)
+{
+    _data = data;
+    _size = size;
+    _body = nullptr;
+    _comments.clear();
+    _elements.clear();
+    if (!_data || !_parseHeader() || !_locateElements()) {
+        return false;
+    }
+    for (const PlyElement& element : _elements) {
+        TF_DEBUG_MSG(FILE_FORMAT_PLY,
+                     "Element %s: count %zu, properties %zu, row size %zu\n",
+                     element.name.c_str(),
+                     element.count,
+                     element.properties.size(),
+                     element.rowSize);
+    }
+    return true;
+}
+
+const PlyElement*
+PlyReader::getElement(const std::string& name) const
+{
+    for (const PlyElement& element : _elements) {
+        if (element.name == name) {
+            return &element;
+        }
+    }
+    return nullptr;
+}
+
+bool
+PlyReader::_parseHeader()
+{
+    const char* pos = _data;
+    const char* end = _data + _size;
+    bool firstLine = true;
+    bool hasFormat = false;
+    while (pos < end) {
+        const char* lineEnd = findLineEnd(pos, end);
+        std::string line(pos, lineEnd);
+        pos = lineEnd < end ? lineEnd + 1 : end;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+        if (firstLine) {
+            if (keyword != "ply") {
+                TF_WARN("Invalid PLY data: missing magic number\n");
+                return false;
+            }
+            firstLine = false;
+        } else if (keyword == "format") {
+            std::string format;
+            stream >> format;
+            if (format == "ascii") {
+                _format = PlyFormat::Ascii;
+            } else if (format == "binary_little_endian") {
+                _format = PlyFormat::BinaryLittleEndian;
+            } else if (format == "binary_big_endian") {
+                _format = PlyFormat::BinaryBigEndian;
+            } else {
+                TF_WARN("Invalid PLY data: unknown format %s\n", format.c_str());
+                return false;
+            }
+            hasFormat = true;
+        } else if (keyword == "comment") {
+            // Keep the comment text without the keyword and the separating blank
+            const size_t textBegin = line.find_first_not_of(" \t", line.find("comment") + 7);
+            _comments.push_back(textBegin == std::string::npos ? std::string()
+                                                                 : line.substr(textBegin));
+        } else if (keyword == "element") {
+            PlyElement element;
+            stream >> element.name >> element.count;
+            if (stream.fail()) {
+                TF_WARN("Invalid PLY element declaration: %s\n", line.c_str());
+                return false;
+            }
+            _elements.push_back(std::move(element));
+        } else if (keyword == "property") {
+            if (_elements.empty()) {
+                TF_WARN("Invalid PLY data: property declared before any element\n");
+                return false;
+            }
+            PlyProperty property;
+            std::string type;
+            stream >> type;
+            if (type == "list") {
+                std::string countType;
+                std::string valueType;
+                stream >> countType >> valueType >> property.name;
+                property.countType = parsePlyType(countType);
+                property.type = parsePlyType(valueType);
+            } else {
+                stream >> property.name;
+                property.type = parsePlyType(type);
+            }
+            if (stream.fail() || property.type == PlyType::Invalid ||
+                (type == "list" && property.countType == PlyType::Invalid)) {
+                TF_WARN("Invalid PLY property declaration: %s\n", line.c_str());
+                return false;
+            }
+            _elements.back().properties.push_back(std::move(property));
+        } else if (keyword == "end_header") {
+            if (!hasFormat) {
+                TF_WARN("Invalid PLY data: missing format\n");
+                return false;
+            }
+            _body = pos;
+            return true;
+        } else if (!keyword.empty()) {
+            TF_DEBUG_MSG(FILE_FORMAT_PLY, "Ignoring PLY header line: %s\n", line.c_str());
+        }
+    }
+    TF_WARN("Invalid PLY data: incomplete header\n");
+    return false;
+}
+
+bool
+PlyReader::_locateElements()
+{
+    // Binary rows without list properties have a fixed size and the properties fixed offsets
+    if (_format != PlyFormat::Ascii) {
+        for (PlyElement& element : _elements) {
+            size_t offset = 0;
+            bool hasList = false;
+            for (PlyProperty& property : element.properties) {
+                property.offset = offset;
+                offset += plyTypeSize(property.type);
+                hasList |= property.isList();
+            }
+            element.rowSize = hasList ? 0 : offset;
+        }
+    }
+
+    // The number of leading elements whose rows were all found
+    size_t located = 0;
+    if (_format == PlyFormat::Ascii) {
+        located = _locateAsciiElements();
+    } else {
+        const char* pos = _body;
+        while (located < _elements.size() && _locateBinaryElement(_elements[located], pos)) {
+            located++;
+        }
+    }
+    if (located < _elements.size()) {
+        // Keep the elements that are complete, which often still allows to import the points
+        PlyElement& element = _elements[located];
+        TF_WARN("PLY data is truncated in element %s\n", element.name.c_str());
+        element.begin = nullptr;
+        element.end = nullptr;
+        element.chunkOffsets.clear();
+    }
+    return true;
+}
+
+bool
+PlyReader::_locateBinaryElement(PlyElement& element, const char*& pos) const
+{
+    const char* end = _data + _size;
+    element.begin = pos;
+    if (element.properties.empty()) {
+        element.end = pos;
+        return true;
+    }
+    // Every row takes at least one byte, which bounds the count of the header by the data size
+    if (element.count > static_cast<size_t>(end - pos)) {
+        return false;
+    }
+    if (element.rowSize > 0) {
+        if (element.count > static_cast<size_t>(end - pos) / element.rowSize) {
+            return false;
+        }
+        pos += element.count * element.rowSize;
+    } else {
+        // Variable size rows can only be found by walking over all of them. Only the list sizes
+        // are read here and the start of every chunk of rows is recorded for parallel decoding.
+        const bool swap = _format != nativeBinaryFormat();
+        element.chunkOffsets.reserve(element.count / rowsPerChunk + 1);
+        for (size_t row = 0; row < element.count; row++) {
+            if (row % rowsPerChunk == 0) {
+                element.chunkOffsets.push_back(static_cast<size_t>(pos - element.begin));
+            }
+            for (const PlyProperty& property : element.properties) {
+                const size_t size = binaryPropertySize(pos, end, property, swap);
+                if (size == 0) {
+                    return false;
+                }
+                pos += size;
+            }
+        }
+    }
+    element.end = pos;
+    return true;
+}
+
+// Each non blank line of the ascii data is a row, and the rows of the elements follow each other.
+// The data is split into blocks that are scanned in parallel, where each block handles the lines
+// that start in it. A first pass counts the rows of every block, which gives the index of the first
+// row of every block by a prefix sum. A second pass finds the rows that start the chunks of the
+// elements and the last row of every element, from which the elements are laid out.
+size_t
+PlyReader::_locateAsciiElements()
+{
+    const char* dataEnd = _data + _size;
+    const size_t bodySize = static_cast<size_t>(dataEnd - _body);
+    const size_t numBlocks = (bodySize + asciiBlockSize - 1) / asciiBlockSize;
+    auto forEachRow = [&](size_t block, const auto& fn) {
+        const char* p = _body + block * asciiBlockSize;
+        const char* blockEnd = _body + std::min(bodySize, (block + 1) * asciiBlockSize);
+        if (p > _body && p[-1] != '\n') {
+            const char* lineEnd = findLineEnd(p, dataEnd);
+            p = lineEnd < dataEnd ? lineEnd + 1 : dataEnd;
+        }
+        while (p < blockEnd) {
+            const char* row = p;
+            while (row < dataEnd && isBlank(*row)) {
+                row++;
+            }
+            const char* lineEnd = findLineEnd(row, dataEnd);
+            if (row < lineEnd && !fn(row)) {
+                return;
+            }
+            p = lineEnd < dataEnd ? lineEnd + 1 : dataEnd;
+        }
+    };
+
+    std::vector<size_t> firstRows(numBlocks + 1, 0);
+    WorkParallelForN(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            forEachRow(b, [&](const char*) {
+                firstRows[b + 1]++;
+                return true;
+            });
+        }
+    });
+    for (size_t b = 0; b < numBlocks; b++) {
+        firstRows[b + 1] += firstRows[b];
+    }
+    const size_t numRows = firstRows[numBlocks];
+
+    // The rows whose start is needed, in increasing order, which are the first row of every chunk
+    // and the last row of every element
+    std::vector<size_t> targetRows;
+    size_t located = 0;
+    for (size_t firstRow = 0; located < _elements.size(); located++) {
+        const PlyElement& element = _elements[located];
+        if (element.count > numRows - firstRow) {
+            break;
+        }
+        for (size_t row = 0; row < element.count; row += rowsPerChunk) {
+            targetRows.push_back(firstRow + row);
+        }
+        if (element.count > 0) {
+            targetRows.push_back(firstRow + element.count - 1);
+        }
+        firstRow += element.count;
+    }
+
+    std::vector<const char*> targets(targetRows.size(), nullptr);
+    WorkParallelForN(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            size_t t = std::lower_bound(targetRows.begin(), targetRows.end(), firstRows[b]) -
+                       targetRows.begin();
+            if (t == targetRows.size() || targetRows[t] >= firstRows[b + 1]) {
+                continue;
+            }
+            size_t row = firstRows[b];
+            forEachRow(b, [&](const char* p) {
+                for (; t < targetRows.size() && targetRows[t] == row; t++) {
+                    targets[t] = p;
+                }
+                row++;
+                return t < targetRows.size() && targetRows[t] < firstRows[b + 1];
+            });
+        }
+    });
+
+    const char* pos = _body;
+    size_t t = 0;
+    for (size_t i = 0; i < located; i++) {
+        PlyElement& element = _elements[i];
+        element.begin = pos;
+        element.chunkOffsets.clear();
+        if (element.count > 0) {
+            element.chunkOffsets.reserve(element.count / rowsPerChunk + 1);
+            for (size_t row = 0; row < element.count; row += rowsPerChunk) {
+                element.chunkOffsets.push_back(static_cast<size_t>(targets[t++] - element.begin));
+            }
+            const char* lineEnd = findLineEnd(targets[t++], dataEnd);
+            pos = lineEnd < dataEnd ? lineEnd + 1 : dataEnd;
+        }
+        element.end = pos;
+    }
+    return located;
+}
+
+bool
+PlyReader::readProperties(const PlyElement& element, const std::vector<PlyTarget>& targets) const
+{
+    for (const PlyTarget& target : targets) {
+        if (target.property < 0 || target.property >= static_cast<int>(element.properties.size()) ||
+            element.properties[target.property].isList() || !target.dst) {
+            TF_CODING_ERROR("Invalid target for PLY element %s", element.name.c_str());
+            return false;
+        }
+    }
+    if (element.count == 0 || targets.empty()) {
+        return true;
+    }
+    if (!element.begin) {
+        TF_WARN("Missing data for PLY element %s\n", element.name.c_str());
+        return false;
+    }
+    if (_format == PlyFormat::Ascii) {
+        return _readPropertiesAscii(element, targets);
+    }
+
+    const bool swap = _format != nativeBinaryFormat();
+    if (element.rowSize > 0) {
+        WorkParallelForN(element.count, [&](size_t begin, size_t end) {
+            for (size_t first = begin; first < end; first += blockRows) {
+                const size_t rows = std::min(blockRows, end - first);
+                const char* src = element.begin + first * element.rowSize;
+                for (const PlyTarget& target : targets) {
+                    const PlyProperty& property = element.properties[target.property];
+                    decodeColumn(property.type,
+                                 swap,
+                                 src + property.offset,
+                                 element.rowSize,
+                                 rows,
+                                 target.dst + first * target.stride,
+                                 target.stride,
+                                 target.normalize);
+                }
+            }
+        });
+        return true;
+    }
+
+    std::vector<int> targetOfProperty(element.properties.size(), -1);
+    for (size_t i = 0; i < targets.size(); i++) {
+        targetOfProperty[targets[i].property] = static_cast<int>(i);
+    }
+    std::atomic<bool> valid(true);
+    WorkParallelForN(element.chunkOffsets.size(), [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            valid = valid && walkBinaryChunk(element,
+                                             c,
+                                             swap,
+                                             [&](size_t row, size_t i, const char* p, size_t) {
+                                                 const int t = targetOfProperty[i];
+                                                 if (t >= 0) {
+                                                     const PlyTarget& target = targets[t];
+                                                     target.dst[row * target.stride] =
+                                                       loadFloat(p,
+                                                                 element.properties[i].type,
+                                                                 swap,
+                                                                 target.normalize);
+                                                 }
+                                             });
+        }
+    });
+    return valid;
+}
+
+bool
+PlyReader::readList(const PlyElement& element,
+                    int property,
+                    VtIntArray& counts,
+                    VtIntArray& values,
+                    bool triangulate) const
+{
+    if (property < 0 || property >= static_cast<int>(element.properties.size()) ||
+        !element.properties[property].isList()) {
+        TF_CODING_ERROR("Invalid list property for PLY element %s", element.name.c_str());
+        return false;
+    }
+    counts.clear();
+    values.clear();
+    if (element.count == 0) {
+        return true;
+    }
+    if (!element.begin) {
+        TF_WARN("Missing data for PLY element %s\n", element.name.c_str());
+        return false;
+    }
+    if (_format == PlyFormat::Ascii) {
+        return _readListAscii(element, property, counts, values, triangulate);
+    }
+
+    // The lists are decoded in two passes over the chunks of rows. First the list sizes are
+    // gathered, which yields the offsets of the chunks into the values via a prefix sum, and then
+    // the values are decoded in place. This avoids allocations per list. Triangulated lists are
+    // decoded to a scratch buffer of the chunk and written as triangle fans from there.
+    const bool swap = _format != nativeBinaryFormat();
+    const PlyProperty& listProperty = element.properties[property];
+    const size_t countSize = plyTypeSize(listProperty.countType);
+    const size_t valueSize = plyTypeSize(listProperty.type);
+    const size_t numChunks = element.chunkOffsets.size();
+    const size_t listIndex = static_cast<size_t>(property);
+    std::vector<size_t> chunkValueOffsets(numChunks + 1, 0);
+    if (!triangulate) {
+        counts.resize(element.count);
+    }
+    int* countsData = triangulate ? nullptr : counts.data();
+    std::atomic<bool> valid(true);
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            size_t chunkValues = 0;
+            valid = valid && walkBinaryChunk(
+                               element, c, swap, [&](size_t row, size_t i, const char*, size_t size) {
+                                   if (i == listIndex) {
+                                       const size_t count = (size - countSize) / valueSize;
+                                       if (countsData) {
+                                           countsData[row] = static_cast<int>(count);
+                                       }
+                                       chunkValues += listOutputSize(count, triangulate);
+                                   }
+                               });
+            chunkValueOffsets[c + 1] = chunkValues;
+        }
+    });
+    if (!valid) {
+        return false;
+    }
+    for (size_t c = 0; c < numChunks; c++) {
+        chunkValueOffsets[c + 1] += chunkValueOffsets[c];
+    }
+
+    values.resize(chunkValueOffsets[numChunks]);
+    if (triangulate) {
+        counts.assign(values.size() / 3, 3);
+    }
+    int* valuesData = values.data();
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        std::vector<int> polygon;
+        for (size_t c = begin; c < end; c++) {
+            int* dst = valuesData + chunkValueOffsets[c];
+            walkBinaryChunk(element, c, swap, [&](size_t, size_t i, const char* p, size_t size) {
+                if (i == listIndex) {
+                    const size_t count = (size - countSize) / valueSize;
+                    if (!triangulate) {
+                        decodeIntegers(p + countSize, listProperty.type, swap, count, dst);
+                        dst += count;
+                    } else if (count >= 3) {
+                        polygon.resize(count);
+                        decodeIntegers(
+                          p + countSize, listProperty.type, swap, count, polygon.data());
+                        dst = writeTriangleFan(polygon.data(), count, dst);
+                    }
+                }
+            });
+        }
+    });
+    return true;
+}
+
+bool
+PlyReader::_readPropertiesAscii(const PlyElement& element,
+                                const std::vector<PlyTarget>& targets) const
+{
+    std::vector<int> targetOfProperty(element.properties.size(), -1);
+    for (size_t i = 0; i < targets.size(); i++) {
+        targetOfProperty[targets[i].property] = static_cast<int>(i);
+    }
+    std::atomic<bool> valid(true);
+    WorkParallelForN(element.chunkOffsets.size(), [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end && valid; c++) {
+            valid = walkAsciiChunk(
+              element, c, [&](size_t row, const char*& p, const char* lineEnd) {
+                  for (size_t i = 0; i < element.properties.size(); i++) {
+                      const PlyProperty& property = element.properties[i];
+                      double value = 0.0;
+                      if (!parseAsciiNumber(p, lineEnd, value)) {
+                          return false;
+                      }
+                      if (property.isList()) {
+                          // Lists can't be targets, so they are skipped
+                          if (value < 0 || !skipAsciiTokens(p, lineEnd, static_cast<size_t>(value))) {
+                              return false;
+                          }
+                      } else if (targetOfProperty[i] >= 0) {
+                          const PlyTarget& target = targets[targetOfProperty[i]];
+                          target.dst[row * target.stride] =
+                            asciiToFloat(value, property.type, target.normalize);
+                      }
+                  }
+                  return true;
+              });
+        }
+    });
+    return valid;
+}
+
+bool
+PlyReader::_readListAscii(const PlyElement& element,
+                          int property,
+                          VtIntArray& counts,
+                          VtIntArray& values,
+                          bool triangulate) const
+{
+    // Like for binary data, the list sizes are gathered per chunk of rows first and the values
+    // are then parsed at the prefix summed offsets of the chunks
+    const size_t numChunks = element.chunkOffsets.size();
+    std::vector<size_t> chunkValueOffsets(numChunks + 1, 0);
+    if (!triangulate) {
+        counts.resize(element.count);
+    }
+    int* countsData = triangulate ? nullptr : counts.data();
+    std::atomic<bool> valid(true);
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end && valid; c++) {
+            size_t chunkValues = 0;
+            valid = walkAsciiChunk(
+              element, c, [&](size_t row, const char*& p, const char* lineEnd) {
+                  size_t count = 0;
+                  if (!seekAsciiList(element, property, p, lineEnd, count)) {
+                      return false;
+                  }
+                  if (countsData) {
+                      countsData[row] = static_cast<int>(count);
+                  }
+                  chunkValues += listOutputSize(count, triangulate);
+                  return true;
+              });
+            chunkValueOffsets[c + 1] = chunkValues;
+        }
+    });
+    if (!valid) {
+        return false;
+    }
+    for (size_t c = 0; c < numChunks; c++) {
+        chunkValueOffsets[c + 1] += chunkValueOffsets[c];
+    }
+
+    values.resize(chunkValueOffsets[numChunks]);
+    if (triangulate) {
+        counts.assign(values.size() / 3, 3);
+    }
+    int* valuesData = values.data();
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        std::vector<int> polygon;
+        for (size_t c = begin; c < end && valid; c++) {
+            int* dst = valuesData + chunkValueOffsets[c];
+            valid = walkAsciiChunk(
+              element, c, [&](size_t, const char*& p, const char* lineEnd) {
+                  size_t count = 0;
+                  if (!seekAsciiList(element, property, p, lineEnd, count)) {
+                      return false;
+                  }
+                  int* listValues = dst;
+                  if (triangulate) {
+                      polygon.resize(count);
+                      listValues = polygon.data();
+                  }
+                  for (size_t j = 0; j < count; j++) {
+                      double value = 0.0;
+                      if (!parseAsciiNumber(p, lineEnd, value)) {
+                          return false;
+                      }
+                      listValues[j] = clampToType<int>(value);
+                  }
+                  dst = triangulate ? writeTriangleFan(listValues, count, dst) : dst + count;
+                  return true;
+              });
+        }
+    });
+    return valid;
+}
+
+}
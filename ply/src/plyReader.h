@@ -0,0 +1,133 @@
+/*
+Copyright 2025 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+#pragma once
+#include "plyTypes.h"
+
+#include <pxr/base/arch/fileSystem.h>
+#include <pxr/base/vt/array.h>
+
+#include <string>
+#include <vector>
+
+namespace adobe::usd {
+
+/// \ingroup usdply
+/// \brief A scalar or list property of a PLY element
+struct PlyProperty
+{
+    std::string name;
+    PlyType type = PlyType::Invalid;
+    // Type of the element count of list properties. Invalid for scalar properties.
+    PlyType countType = PlyType::Invalid;
+    // Byte offset of the property in a binary row. Only valid if the element has fixed size rows.
+    size_t offset = 0;
+
+    bool isList() const { return countType != PlyType::Invalid; }
+};
+
+/// \ingroup usdply
+/// \brief A PLY element, like "vertex" or "face", and the location of its rows in the data
+struct PlyElement
+{
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+    // Byte size of a binary row, or 0 if the rows have a variable size due to list properties or
+    // because the data is ascii.
+    size_t rowSize = 0;
+    // Range of the element rows in the data
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    // Byte offsets from `begin` to the start of every `PlyReader::rowsPerChunk`-th row. Only set
+    // if the rows have variable sizes, so that they can still be decoded in parallel.
+    std::vector<size_t> chunkOffsets;
+
+    /// Returns the index of the property with the given name or -1 if there is none.
+    int findProperty(const std::string& propertyName) const;
+};
+
+/// \ingroup usdply
+/// \brief Destination for a scalar property when decoding the rows of an element. The values of
+/// consecutive rows are written `stride` floats apart, which allows to decode straight into
+/// interleaved arrays like `VtVec3fArray`.
+struct PlyTarget
+{
+    int property = -1;
+    float* dst = nullptr;
+    size_t stride = 1;
+    // Map integer values to [0, 1], respectively [-1, 1] for signed types, like 8 bit colors.
+    // Without it 16 bit unsigned values are interpreted as half floats.
+    bool normalize = false;
+};
+
+/// \ingroup usdply
+/// \brief Reader for PLY data that decodes element properties directly from the file data.
+///
+/// Files are memory mapped and only the header is parsed upfront. The rows of the elements are
+/// only decoded for the requested properties and in parallel over ranges of rows, which avoids
+/// holding copies of all properties in memory.
+class PlyReader
+{
+  public:
+    static constexpr size_t rowsPerChunk = 4096;
+
+    /// Memory map the file and parse its header.
+    bool open(const std::string& filename);
+
+    /// Parse the header of PLY data held in memory. The data is not copied and needs to outlive
+    /// the reader.
+    bool open(const char* data, size_t size);
+
+    PlyFormat getFormat() const { return _format; }
+    const std::vector<std::string>& getComments() const { return _comments; }
+    const std::vector<PlyElement>& getElements() const { return _elements; }
+
+    /// Returns the element with the given name or nullptr if there is none.
+    const PlyElement* getElement(const std::string& name) const;
+
+    /// Decode the targeted scalar properties of all rows of the element in a single pass. The
+    /// target arrays need to hold `element.count` values.
+    bool readProperties(const PlyElement& element, const std::vector<PlyTarget>& targets) const;
+
+    /// Decode a list property of all rows of the element into the list sizes and the
+    /// concatenated list values, like the face vertex counts and indices of a mesh. With
+    /// `triangulate` the lists are fan triangulated while they are decoded, so that all sizes
+    /// are 3, and lists with fewer than 3 values are dropped.
+    bool readList(const PlyElement& element,
+                  int property,
+                  PXR_NS::VtIntArray& counts,
+                  PXR_NS::VtIntArray& values,
+                  bool triangulate = false) const;
+
+  private:
+    bool _parseHeader();
+    bool _locateElements();
+    bool _locateBinaryElement(PlyElement& element, const char*& pos) const;
+    size_t _locateAsciiElements();
+    bool _readPropertiesAscii(const PlyElement& element,
+                              const std::vector<PlyTarget>& targets) const;
+    bool _readListAscii(const PlyElement& element,
+                        int property,
+                        PXR_NS::VtIntArray& counts,
+                        PXR_NS::VtIntArray& values,
+                        bool triangulate) const;
+
+    PXR_NS::ArchConstFileMapping _mapping;
+    const char* _data = nullptr;
+    size_t _size = 0;
+    const char* _body = nullptr;
+    PlyFormat _format = PlyFormat::Ascii;
+    std::vector<std::string> _comments;
+    std::vector<PlyElement> _elements;
+};
+
+}
@@ -0,0 +1,169 @@
+/*
+Copyright 2025 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Types and scalar encoding shared by the PLY reader and writer
+
+namespace adobe::usd {
+
+/// \ingroup usdply
+/// \brief Encoding of the element data that follows the PLY header
+enum class PlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian
+};
+
+/// \ingroup usdply
+/// \brief Scalar types of PLY properties
+enum class PlyType : std::uint8_t
+{
+    Invalid,
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+};
+
+/// Returns the byte size of values of the type, or 0 for invalid types.
+inline size_t
+plyTypeSize(PlyType type)
+{
+    switch (type) {
+        case PlyType::Int8:
+        case PlyType::UInt8: return 1;
+        case PlyType::Int16:
+        case PlyType::UInt16: return 2;
+        case PlyType::Int32:
+        case PlyType::UInt32:
+        case PlyType::Float32: return 4;
+        case PlyType::Float64: return 8;
+        default: return 0;
+    }
+}
+
+/// Returns the binary format that matches the byte order of the host.
+inline PlyFormat
+nativeBinaryFormat()
+{
+    const std::uint16_t value = 1;
+    std::uint8_t firstByte;
+    std::memcpy(&firstByte, &value, 1);
+    return firstByte == 1 ? PlyFormat::BinaryLittleEndian : PlyFormat::BinaryBigEndian;
+}
+
+// Call the function with a value of the C++ type that corresponds to the PLY type
+template<typename F>
+void
+dispatchPlyType(PlyType type, F&& f)
+{
+    switch (type) {
+        case PlyType::Int8: f(std::int8_t()); break;
+        case PlyType::UInt8: f(std::uint8_t()); break;
+        case PlyType::Int16: f(std::int16_t()); break;
+        case PlyType::UInt16: f(std::uint16_t()); break;
+        case PlyType::Int32: f(std::int32_t()); break;
+        case PlyType::UInt32: f(std::uint32_t()); break;
+        case PlyType::Float32: f(float()); break;
+        case PlyType::Float64: f(double()); break;
+        default: break;
+    }
+}
+
+template<size_t N>
+struct UIntOfSize;
+template<>
+struct UIntOfSize<1>
+{
+    using type = std::uint8_t;
+};
+template<>
+struct UIntOfSize<2>
+{
+    using type = std::uint16_t;
+};
+template<>
+struct UIntOfSize<4>
+{
+    using type = std::uint32_t;
+};
+template<>
+struct UIntOfSize<8>
+{
+    using type = std::uint64_t;
+};
+
+// These are written so that compilers recognize them and emit byte swap instructions, which also
+// get vectorized in loops over columns of values
+inline std::uint8_t
+byteSwap(std::uint8_t v)
+{
+    return v;
+}
+
+inline std::uint16_t
+byteSwap(std::uint16_t v)
+{
+    return static_cast<std::uint16_t>((v >> 8) | (v << 8));
+}
+
+inline std::uint32_t
+byteSwap(std::uint32_t v)
+{
+    return ((v & 0x000000ffu) << 24) | ((v & 0x0000ff00u) << 8) | ((v & 0x00ff0000u) >> 8) |
+           ((v & 0xff000000u) >> 24);
+}
+
+inline std::uint64_t
+byteSwap(std::uint64_t v)
+{
+    return (static_cast<std::uint64_t>(byteSwap(static_cast<std::uint32_t>(v))) << 32) |
+           byteSwap(static_cast<std::uint32_t>(v >> 32));
+}
+
+template<typename T, bool Swap>
+T
+loadScalar(const char* p)
+{
+    using U = typename UIntOfSize<sizeof(T)>::type;
+    U bits;
+    std::memcpy(&bits, p, sizeof(U));
+    if constexpr (Swap) {
+        bits = byteSwap(bits);
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template<typename T, bool Swap>
+void
+storeScalar(char* p, T value)
+{
+    using U = typename UIntOfSize<sizeof(T)>::type;
+    U bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    if constexpr (Swap) {
+        bits = byteSwap(bits);
+    }
+    std::memcpy(p, &bits, sizeof(U));
+}
+
+}
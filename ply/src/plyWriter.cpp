@@ -0,0 +1,425 @@
+/*
+Copyright 2025 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+#include "plyWriter.h"
+#include "debugCodes.h"
+
+#include <fmt/format.h>
+#include <pxr/base/gf/half.h>
+#include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/work/loops.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+using namespace PXR_NS;
+
+namespace adobe::usd {
+
+namespace {
+
+// Rows are encoded in parallel in pieces of this many rows, and batches of pieces are written at
+// once, which bounds the memory held by the buffers
+constexpr size_t pieceRows = 1024;
+constexpr size_t piecesPerBatch = 64;
+
+const char*
+plyTypeName(PlyType type)
+{
+    switch (type) {
+        case PlyType::Int8: return "char";
+        case PlyType::UInt8: return "uchar";
+        case PlyType::Int16: return "short";
+        case PlyType::UInt16: return "ushort";
+        case PlyType::Int32: return "int";
+        case PlyType::UInt32: return "uint";
+        case PlyType::Float32: return "float";
+        case PlyType::Float64: return "double";
+        default: return "invalid";
+    }
+}
+
+template<typename T>
+T
+fromFloat(float value, bool normalize)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(value);
+    } else {
+        if constexpr (std::is_same_v<T, std::uint16_t>) {
+            if (!normalize) {
+                return GfHalf(value).bits();
+            }
+        }
+        // Clamp in double precision, since the limits of 32 bit types are not exact in float
+        double v = normalize ? value * static_cast<double>(std::numeric_limits<T>::max()) : value;
+        v = v == v ? v : 0.0;
+        return static_cast<T>(std::clamp(v,
+                                         static_cast<double>(std::numeric_limits<T>::min()),
+                                         static_cast<double>(std::numeric_limits<T>::max())));
+    }
+}
+
+template<typename T>
+void
+formatAscii(fmt::memory_buffer& buffer, T value)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        fmt::format_to(std::back_inserter(buffer), "{}", value);
+    } else {
+        fmt::format_to(std::back_inserter(buffer), "{}", static_cast<std::int64_t>(value));
+    }
+}
+
+// Encode the rows in pieces in parallel and write the pieces in order. encodePiece(first, last,
+// buffer) appends the encoding of the rows [first, last) to the buffer.
+template<typename EncodePiece>
+bool
+writePieces(std::ostream& out, size_t numRows, const EncodePiece& encodePiece)
+{
+    const size_t numPieces = (numRows + pieceRows - 1) / pieceRows;
+    std::vector<fmt::memory_buffer> buffers(std::min(piecesPerBatch, numPieces));
+    for (size_t batchPiece = 0; batchPiece < numPieces; batchPiece += piecesPerBatch) {
+        const size_t batchPieces = std::min(piecesPerBatch, numPieces - batchPiece);
+        WorkParallelForN(batchPieces, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; p++) {
+                const size_t first = (batchPiece + p) * pieceRows;
+                buffers[p].clear();
+                encodePiece(first, std::min(first + pieceRows, numRows), buffers[p]);
+            }
+        });
+        for (size_t p = 0; p < batchPieces; p++) {
+            out.write(buffers[p].data(), static_cast<std::streamsize>(buffers[p].size()));
+        }
+    }
+    return out.good();
+}
+
+template<bool Swap>
+void
+encodeBinaryRows(const PlyElement& element,
+                 const std::vector<PlySource>& sources,
+                 size_t first,
+                 size_t last,
+                 fmt::memory_buffer& buffer)
+{
+    const size_t rowSize = element.rowSize;
+    buffer.resize((last - first) * rowSize);
+    // Encode column by column, so that the type dispatch happens once per piece
+    for (size_t i = 0; i < sources.size(); i++) {
+        const PlyProperty& property = element.properties[i];
+        const PlySource& source = sources[i];
+        char* dst = buffer.data() + property.offset;
+        dispatchPlyType(property.type, [&](auto tag) {
+            using T = decltype(tag);
+            for (size_t row = first; row < last; row++) {
+                storeScalar<T, Swap>(dst + (row - first) * rowSize,
+                                     fromFloat<T>(source.src[row * source.stride], source.normalize));
+            }
+        });
+    }
+}
+
+template<bool Swap>
+void
+encodeBinaryLists(const PlyProperty& property,
+                  const int* sizes,
+                  const int* values,
+                  int valueOffset,
+                  size_t valueStart,
+                  size_t first,
+                  size_t last,
+                  fmt::memory_buffer& buffer)
+{
+    size_t numValues = 0;
+    for (size_t row = first; row < last; row++) {
+        numValues += sizes[row];
+    }
+    const size_t countSize = plyTypeSize(property.countType);
+    const size_t valueSize = plyTypeSize(property.type);
+    buffer.resize((last - first) * countSize + numValues * valueSize);
+    char* p = buffer.data();
+    dispatchPlyType(property.countType, [&](auto countTag) {
+        using C = decltype(countTag);
+        dispatchPlyType(property.type, [&](auto valueTag) {
+            using V = decltype(valueTag);
+            size_t k = valueStart;
+            for (size_t row = first; row < last; row++) {
+                storeScalar<C, Swap>(p, static_cast<C>(sizes[row]));
+                p += sizeof(C);
+                for (int j = 0; j < sizes[row]; j++, k++) {
+                    const std::int64_t value =
+                      static_cast<std::int64_t>(values ? values[k] : static_cast<std::int64_t>(k)) +
+                      valueOffset;
+                    storeScalar<V, Swap>(p, static_cast<V>(value));
+                    p += sizeof(V);
+                }
+            }
+        });
+    });
+}
+
+} // namespace
+
+PlyWriter::PlyWriter(std::ostream& out, PlyFormat format)
+  : _out(out)
+  , _format(format)
+{}
+
+void
+PlyWriter::addComment(const std::string& comment)
+{
+    _comments.push_back(comment);
+}
+
+void
+PlyWriter::addElement(const std::string& name, size_t count)
+{
+    PlyElement element;
+    element.name = name;
+    element.count = count;
+    _elements.push_back(std::move(element));
+}
+
+void
+PlyWriter::addProperty(const std::string& name, PlyType type)
+{
+    if (_elements.empty()) {
+        TF_CODING_ERROR("PLY property %s added before any element", name.c_str());
+        return;
+    }
+    PlyElement& element = _elements.back();
+    PlyProperty property;
+    property.name = name;
+    property.type = type;
+    property.offset = element.rowSize;
+    element.rowSize += plyTypeSize(type);
+    element.properties.push_back(std::move(property));
+}
+
+void
+PlyWriter::addListProperty(const std::string& name, PlyType countType, PlyType type)
+{
+    if (_elements.empty()) {
+        TF_CODING_ERROR("PLY property %s added before any element", name.c_str());
+        return;
+    }
+    PlyProperty property;
+    property.name = name;
+    property.type = type;
+    property.countType = countType;
+    _elements.back().properties.push_back(std::move(property));
+}
+
+bool
+PlyWriter::writeHeader()
+{
+    fmt::memory_buffer header;
+    auto out = std::back_inserter(header);
+    fmt::format_to(out, "ply\n");
+    switch (_format) {
+        case PlyFormat::Ascii: fmt::format_to(out, "format ascii 1.0\n"); break;
+        case PlyFormat::BinaryLittleEndian:
+            fmt::format_to(out, "format binary_little_endian 1.0\n");
+            break;
+        case PlyFormat::BinaryBigEndian: fmt::format_to(out, "format binary_big_endian 1.0\n"); break;
+    }
+    for (const std::string& comment : _comments) {
+        fmt::format_to(out, "comment {}\n", comment);
+    }
+    for (const PlyElement& element : _elements) {
+        fmt::format_to(out, "element {} {}\n", element.name, element.count);
+        for (const PlyProperty& property : element.properties) {
+            if (property.isList()) {
+                fmt::format_to(out,
+                               "property list {} {} {}\n",
+                               plyTypeName(property.countType),
+                               plyTypeName(property.type),
+                               property.name);
+            } else {
+                fmt::format_to(out, "property {} {}\n", plyTypeName(property.type), property.name);
+            }
+        }
+    }
+    fmt::format_to(out, "end_header\n");
+    _out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    return _out.good();
+}
+
+bool
+PlyWriter::_beginRows(size_t numRows)
+{
+    while (_currentElement < _elements.size() &&
+           _rowsWritten == _elements[_currentElement].count) {
+        _currentElement++;
+        _rowsWritten = 0;
+    }
+    if (_currentElement >= _elements.size() ||
+        _rowsWritten + numRows > _elements[_currentElement].count) {
+        TF_CODING_ERROR("More PLY rows written than declared");
+        return false;
+    }
+    return true;
+}
+
+bool
+PlyWriter::writeRows(size_t numRows, const std::vector<PlySource>& sources)
+{
+    if (numRows == 0) {
+        return true;
+    }
+    if (!_beginRows(numRows)) {
+        return false;
+    }
+    const PlyElement& element = _elements[_currentElement];
+    if (sources.size() != element.properties.size()) {
+        TF_CODING_ERROR("Invalid sources for PLY element %s", element.name.c_str());
+        return false;
+    }
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (element.properties[i].isList() || !sources[i].src) {
+            TF_CODING_ERROR("Invalid sources for PLY element %s", element.name.c_str());
+            return false;
+        }
+    }
+
+    const size_t rowOffset = _rowsWritten;
+    _rowsWritten += numRows;
+    if (_format == PlyFormat::Ascii) {
+        return writePieces(_out, numRows, [&](size_t first, size_t last, fmt::memory_buffer& buffer) {
+            for (size_t row = first; row < last; row++) {
+                for (size_t i = 0; i < sources.size(); i++) {
+                    const PlySource& source = sources[i];
+                    const float value = source.src[row * source.stride];
+                    if (i > 0) {
+                        buffer.push_back(' ');
+                    }
+                    dispatchPlyType(element.properties[i].type, [&](auto tag) {
+                        using T = decltype(tag);
+                        formatAscii(buffer, fromFloat<T>(value, source.normalize));
+                    });
+                }
+                buffer.push_back('\n');
+            }
+        });
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_PLY,
+                 "Writing rows %zu to %zu of element %s\n",
+                 rowOffset,
+                 rowOffset + numRows,
+                 element.name.c_str());
+    const bool swap = _format != nativeBinaryFormat();
+    return writePieces(_out, numRows, [&](size_t first, size_t last, fmt::memory_buffer& buffer) {
+        if (swap) {
+            encodeBinaryRows<true>(element, sources, first, last, buffer);
+        } else {
+            encodeBinaryRows<false>(element, sources, first, last, buffer);
+        }
+    });
+}
+
+bool
+PlyWriter::writeListRows(size_t numRows, const int* sizes, const int* values, int valueOffset)
+{
+    if (numRows == 0) {
+        return true;
+    }
+    if (!_beginRows(numRows)) {
+        return false;
+    }
+    const PlyElement& element = _elements[_currentElement];
+    if (element.properties.size() != 1 || !element.properties[0].isList() || !sizes) {
+        TF_CODING_ERROR("Invalid list rows for PLY element %s", element.name.c_str());
+        return false;
+    }
+    const PlyProperty& property = element.properties[0];
+    _rowsWritten += numRows;
+
+    // Each piece needs to know where its values start
+    std::vector<size_t> pieceValueStarts((numRows + pieceRows - 1) / pieceRows + 1, 0);
+    for (size_t row = 0; row < numRows; row++) {
+        pieceValueStarts[row / pieceRows + 1] += sizes[row];
+    }
+    for (size_t p = 1; p < pieceValueStarts.size(); p++) {
+        pieceValueStarts[p] += pieceValueStarts[p - 1];
+    }
+
+    if (_format == PlyFormat::Ascii) {
+        return writePieces(_out, numRows, [&](size_t first, size_t last, fmt::memory_buffer& buffer) {
+            size_t k = pieceValueStarts[first / pieceRows];
+            for (size_t row = first; row < last; row++) {
+                formatAscii(buffer, sizes[row]);
+                for (int j = 0; j < sizes[row]; j++, k++) {
+                    buffer.push_back(' ');
+                    formatAscii(buffer,
+                                static_cast<std::int64_t>(values ? values[k]
+                                                                 : static_cast<std::int64_t>(k)) +
+                                  valueOffset);
+                }
+                buffer.push_back('\n');
+            }
+        });
+    }
+    const bool swap = _format != nativeBinaryFormat();
+    return writePieces(_out, numRows, [&](size_t first, size_t last, fmt::memory_buffer& buffer) {
+        const size_t valueStart = pieceValueStarts[first / pieceRows];
+        if (swap) {
+            encodeBinaryLists<true>(
+              property, sizes, values, valueOffset, valueStart, first, last, buffer);
+        } else {
+            encodeBinaryLists<false>(
+              property, sizes, values, valueOffset, valueStart, first, last, buffer);
+        }
+    });
+}
+
+bool
+PlyWriter::writeRawRows(size_t numRows, const char* data)
+{
+    if (numRows == 0) {
+        return true;
+    }
+    if (!_beginRows(numRows)) {
+        return false;
+    }
+    const PlyElement& element = _elements[_currentElement];
+    const bool hasLists = std::any_of(element.properties.begin(),
+                                      element.properties.end(),
+                                      [](const PlyProperty& property) { return property.isList(); });
+    if (_format == PlyFormat::Ascii || element.rowSize == 0 || hasLists || !data) {
+        TF_CODING_ERROR("Invalid raw rows for PLY element %s", element.name.c_str());
+        return false;
+    }
+    _rowsWritten += numRows;
+    _out.write(data, static_cast<std::streamsize>(numRows * element.rowSize));
+    return _out.good();
+}
+
+bool
+PlyWriter::finish()
+{
+    while (_currentElement < _elements.size() &&
+           _rowsWritten == _elements[_currentElement].count) {
+        _currentElement++;
+        _rowsWritten = 0;
+    }
+    if (_currentElement < _elements.size()) {
+        TF_CODING_ERROR("Missing rows of PLY element %s", _elements[_currentElement].name.c_str());
+        return false;
+    }
+    _out.flush();
+    return _out.good();
+}
+
+}
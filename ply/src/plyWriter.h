@@ -0,0 +1,83 @@
+/*
+Copyright 2025 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+#pragma once
+#include "plyReader.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace adobe::usd {
+
+/// \ingroup usdply
+/// \brief Source of a scalar property when encoding the rows of an element. The values of
+/// consecutive rows are read `stride` floats apart, which allows to encode straight from
+/// interleaved arrays like `VtVec3fArray`.
+struct PlySource
+{
+    const float* src = nullptr;
+    size_t stride = 1;
+    // Map [0, 1] to the range of integer types, like 8 bit colors. Without it 16 bit unsigned
+    // values are written as half floats, matching `PlyTarget`.
+    bool normalize = false;
+};
+
+/// \ingroup usdply
+/// \brief Writer that streams PLY data to an output stream.
+///
+/// All elements and properties are declared upfront, so that the header can be written first.
+/// The rows of the elements then follow in the order of declaration, and may be written in
+/// several calls, e.g. mesh by mesh, which avoids holding the whole data in memory. Rows are
+/// encoded in parallel into buffers that are written in order.
+class PlyWriter
+{
+  public:
+    PlyWriter(std::ostream& out, PlyFormat format);
+
+    PlyFormat getFormat() const { return _format; }
+
+    void addComment(const std::string& comment);
+    void addElement(const std::string& name, size_t count);
+    void addProperty(const std::string& name, PlyType type);
+    void addListProperty(const std::string& name, PlyType countType, PlyType type);
+
+    bool writeHeader();
+
+    /// Encode rows of the current element, which needs to have only scalar properties, with one
+    /// source per property.
+    bool writeRows(size_t numRows, const std::vector<PlySource>& sources);
+
+    /// Encode rows of the current element, which needs to have a single list property, from the
+    /// list sizes and the concatenated list values, like the face vertex counts and indices of a
+    /// mesh. The offset is added to the values. If `values` is null, consecutive values starting
+    /// at the offset are written instead.
+    bool writeListRows(size_t numRows, const int* sizes, const int* values, int valueOffset);
+
+    /// Write rows of the current element that are already encoded in its binary layout, like
+    /// packed words. Only valid for binary formats.
+    bool writeRawRows(size_t numRows, const char* data);
+
+    /// Check that all declared rows were written and flush the stream.
+    bool finish();
+
+  private:
+    bool _beginRows(size_t numRows);
+
+    std::ostream& _out;
+    PlyFormat _format;
+    std::vector<std::string> _comments;
+    std::vector<PlyElement> _elements;
+    size_t _currentElement = 0;
+    size_t _rowsWritten = 0;
+};
+
+}
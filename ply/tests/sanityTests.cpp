@@ -13,10 +13,16 @@ governing permissions and limitations under the License.
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/resolver.h>
 #include <pxr/usd/sdf/assetPath.h>
+#include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/usd/attribute.h>
 #include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
 
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
 TEST(PLYSanityTests, LoadCube)
 {
     PXR_NAMESPACE_USING_DIRECTIVE
@@ -34,3 +40,166 @@ TEST(PLYSanityTests, LoadForeignCube)
     UsdStageRefPtr stage = UsdStage::Open("貝殻ビューア Colored Cube.ply");
     ASSERT_TRUE(stage);
 }
+
+TEST(PLYSanityTests, LoadCubeFromString)
+{
+    PXR_NAMESPACE_USING_DIRECTIVE
+
+    std::ifstream file("SanityCube.ply", std::ios::binary);
+    ASSERT_TRUE(file.is_open());
+    std::stringstream content;
+    content << file.rdbuf();
+
+    // The extension of the tag selects the file format of the anonymous layer
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("SanityCube.ply");
+    ASSERT_TRUE(layer);
+    ASSERT_TRUE(layer->ImportFromString(content.str()));
+    UsdStageRefPtr stage = UsdStage::Open(layer);
+    ASSERT_TRUE(stage);
+
+    size_t numPoints = 0;
+    for (const UsdPrim& prim : stage->Traverse()) {
+        VtVec3fArray points;
+        if (prim.GetAttribute(TfToken("points")).Get(&points)) {
+            numPoints += points.size();
+        }
+    }
+    ASSERT_EQ(numPoints, 8u);
+}
+
+TEST(PLYSanityTests, ExportCubeAscii)
+{
+    PXR_NAMESPACE_USING_DIRECTIVE
+
+    UsdStageRefPtr stage = UsdStage::Open("SanityCube.ply");
+    ASSERT_TRUE(stage);
+    ASSERT_TRUE(stage->Export("SanityCubeAscii.ply", false, { { "ascii", "true" } }));
+
+    std::ifstream file("SanityCubeAscii.ply", std::ios::binary);
+    ASSERT_TRUE(file.is_open());
+    std::string magic, format;
+    std::getline(file, magic);
+    std::getline(file, format);
+    ASSERT_EQ(magic, "ply");
+    ASSERT_EQ(format, "format ascii 1.0");
+    file.close();
+
+    UsdStageRefPtr exported = UsdStage::Open("SanityCubeAscii.ply");
+    ASSERT_TRUE(exported);
+}
+
+TEST(PLYSanityTests, LoadCubeTriangulated)
+{
+    PXR_NAMESPACE_USING_DIRECTIVE
+
+    UsdStageRefPtr stage = UsdStage::Open("SanityCube.ply:SDF_FORMAT_ARGS:plyTriangulate=true");
+    ASSERT_TRUE(stage);
+
+    size_t numTriangles = 0;
+    for (const UsdPrim& prim : stage->Traverse()) {
+        VtIntArray faceVertexCounts;
+        if (prim.GetAttribute(TfToken("faceVertexCounts")).Get(&faceVertexCounts)) {
+            for (int count : faceVertexCounts) {
+                ASSERT_EQ(count, 3);
+            }
+            numTriangles += faceVertexCounts.size();
+        }
+    }
+    // The 6 quads of the cube
+    ASSERT_EQ(numTriangles, 12u);
+}
+
+TEST(PLYSanityTests, CompressedGsplatsRoundTrip)
+{
+    PXR_NAMESPACE_USING_DIRECTIVE
+
+    // A grid of splats with degree 1 SH coefficients, which spans two chunks of the compressed
+    // layout. The first SH coefficient reaches the end of the quantized range of [-4, 4].
+    const int gridSize = 7;
+    const int numSplats = gridSize * gridSize * gridSize;
+    {
+        std::ofstream file("CompressedSplats.ply", std::ios::binary);
+        ASSERT_TRUE(file.is_open());
+        file << "ply\nformat ascii 1.0\nelement vertex " << numSplats << "\n";
+        for (const char* name : { "x", "y", "z", "f_dc_0", "f_dc_1", "f_dc_2" }) {
+            file << "property float " << name << "\n";
+        }
+        for (int i = 0; i < 9; i++) {
+            file << "property float f_rest_" << i << "\n";
+        }
+        for (const char* name :
+             { "opacity", "scale_0", "scale_1", "scale_2", "rot_0", "rot_1", "rot_2", "rot_3" }) {
+            file << "property float " << name << "\n";
+        }
+        file << "end_header\n";
+        for (int i = 0; i < numSplats; i++) {
+            const int x = i % gridSize;
+            const int y = (i / gridSize) % gridSize;
+            const int z = i / (gridSize * gridSize);
+            file << 0.25f * x - 0.75f << " " << 0.25f * y - 0.75f << " " << 0.25f * z - 0.75f;
+            file << " " << 0.1f * x << " " << 0.1f * y << " " << 0.1f * z;
+            file << " " << (i % 2 ? 4.0f : -0.5f);
+            for (int j = 1; j < 9; j++) {
+                file << " " << 0.05f * (j - 4);
+            }
+            file << " " << 0.5f * (i % 5) - 1.0f;
+            file << " " << -4.0f + 0.01f * x << " " << -4.0f + 0.01f * y << " " << -4.5f;
+            file << " 1 0 0 0\n";
+        }
+    }
+
+    UsdStageRefPtr stage = UsdStage::Open("CompressedSplats.ply");
+    ASSERT_TRUE(stage);
+    ASSERT_TRUE(
+      stage->Export("CompressedSplats.compressed.ply", false, { { "compressed", "true" } }));
+    UsdStageRefPtr compressed = UsdStage::Open("CompressedSplats.compressed.ply");
+    ASSERT_TRUE(compressed);
+
+    auto findSplats = [](const UsdStageRefPtr& stage) {
+        for (const UsdPrim& prim : stage->Traverse()) {
+            if (prim.HasAttribute(TfToken("primvars:rot"))) {
+                return prim;
+            }
+        }
+        return UsdPrim();
+    };
+    const UsdPrim source = findSplats(stage);
+    const UsdPrim result = findSplats(compressed);
+    ASSERT_TRUE(source);
+    ASSERT_TRUE(result);
+
+    VtVec3fArray sourcePoints, resultPoints;
+    VtFloatArray sourceOpacities, resultOpacities;
+    VtFloatArray sourceWidths, resultWidths;
+    VtFloatArray sourceSH, resultSH;
+    ASSERT_TRUE(source.GetAttribute(TfToken("points")).Get(&sourcePoints));
+    ASSERT_TRUE(result.GetAttribute(TfToken("points")).Get(&resultPoints));
+    ASSERT_TRUE(source.GetAttribute(TfToken("primvars:displayOpacity")).Get(&sourceOpacities));
+    ASSERT_TRUE(result.GetAttribute(TfToken("primvars:displayOpacity")).Get(&resultOpacities));
+    ASSERT_TRUE(source.GetAttribute(TfToken("widths")).Get(&sourceWidths));
+    ASSERT_TRUE(result.GetAttribute(TfToken("widths")).Get(&resultWidths));
+    ASSERT_TRUE(source.GetAttribute(TfToken("primvars:fRest0")).Get(&sourceSH));
+    ASSERT_TRUE(result.GetAttribute(TfToken("primvars:fRest0")).Get(&resultSH));
+    ASSERT_EQ(sourcePoints.size(), static_cast<size_t>(numSplats));
+    ASSERT_EQ(resultPoints.size(), sourcePoints.size());
+    ASSERT_EQ(resultOpacities.size(), sourcePoints.size());
+    ASSERT_EQ(resultWidths.size(), sourcePoints.size());
+    ASSERT_EQ(resultSH.size(), sourcePoints.size());
+
+    // The compressed splats are reordered along a space filling curve, so each one is matched to
+    // the nearest source splat, which is much closer than the spacing of the grid
+    for (size_t i = 0; i < resultPoints.size(); i++) {
+        size_t nearest = 0;
+        for (size_t j = 1; j < sourcePoints.size(); j++) {
+            if ((sourcePoints[j] - resultPoints[i]).GetLengthSq() <
+                (sourcePoints[nearest] - resultPoints[i]).GetLengthSq()) {
+                nearest = j;
+            }
+        }
+        // Positions have 10 or 11 bits and opacities and SH coefficients 8 bits
+        ASSERT_LT((sourcePoints[nearest] - resultPoints[i]).GetLength(), 0.01f);
+        ASSERT_NEAR(resultOpacities[i], sourceOpacities[nearest], 1.0f / 255.0f);
+        ASSERT_NEAR(resultWidths[i], sourceWidths[nearest], 0.02f * sourceWidths[nearest]);
+        ASSERT_NEAR(resultSH[i], sourceSH[nearest], 8.0f / 256.0f);
+    }
+}
@@ -16,6 +16,7 @@ governing permissions and limitations under the License.
 #include "spzImport.h"
 
 #include <fileformatutils/common.h>
+#include <fileformatutils/geometry.h>
 #include <fileformatutils/layerRead.h>
 #include <fileformatutils/layerWriteSdfData.h>
 #include <fileformatutils/usdData.h>
@@ -25,6 +26,10 @@ governing permissions and limitations under the License.
 #include <pxr/base/tf/fileUtils.h>
 #include <pxr/usd/usd/usdaFileFormat.h>
 
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
 using namespace adobe::usd;
 using namespace spz;
 
@@ -66,6 +71,26 @@ UsdSpzFileFormat::InitData(const FileFormatArguments& args) const
                       UsdSpzFileFormatTokens->gsplatsClippingBox.GetText(),
                       pd->gsplatsClippingBox,
                       DEBUG_TAG);
+    argReadBool(args,
+                UsdSpzFileFormatTokens->gsplatsHalfPrecision.GetText(),
+                pd->gsplatsHalfPrecision,
+                DEBUG_TAG);
+    argReadFloat(
+      args, UsdSpzFileFormatTokens->gsplatsMinOpacity.GetText(), pd->gsplatsMinOpacity, DEBUG_TAG);
+    argReadFloat(
+      args, UsdSpzFileFormatTokens->gsplatsMinScale.GetText(), pd->gsplatsMinScale, DEBUG_TAG);
+    argReadBool(
+      args, UsdSpzFileFormatTokens->gsplatsPackedSH.GetText(), pd->gsplatsPackedSH, DEBUG_TAG);
+    argReadFloat(
+      args, UsdSpzFileFormatTokens->gsplatsMaxScale.GetText(), pd->gsplatsMaxScale, DEBUG_TAG);
+    argReadBool(args,
+                UsdSpzFileFormatTokens->gsplatsCullToClippingBox.GetText(),
+                pd->gsplatsCullToClippingBox,
+                DEBUG_TAG);
+    argReadInt(args, UsdSpzFileFormatTokens->maxSHDegree.GetText(), pd->maxSHDegree, DEBUG_TAG);
+    argReadBool(args, UsdSpzFileFormatTokens->mortonOrder.GetText(), pd->mortonOrder, DEBUG_TAG);
+    argReadInt(args, UsdSpzFileFormatTokens->pointLevels.GetText(), pd->pointLevels, DEBUG_TAG);
+    argReadInt(args, UsdSpzFileFormatTokens->pointLevel.GetText(), pd->pointLevel, DEBUG_TAG);
     return pd;
 }
 
@@ -77,6 +102,16 @@ UsdSpzFileFormat::ComposeFieldsForFileFormatArguments(const std::string& assetPa
 {
     argComposeBool(context, args, UsdSpzFileFormatTokens->gsplatsWithZup, DEBUG_TAG);
     argComposeFloatArray(context, args, UsdSpzFileFormatTokens->gsplatsClippingBox, DEBUG_TAG);
+    argComposeBool(context, args, UsdSpzFileFormatTokens->gsplatsHalfPrecision, DEBUG_TAG);
+    argComposeFloat(context, args, UsdSpzFileFormatTokens->gsplatsMinOpacity, DEBUG_TAG);
+    argComposeFloat(context, args, UsdSpzFileFormatTokens->gsplatsMinScale, DEBUG_TAG);
+    argComposeBool(context, args, UsdSpzFileFormatTokens->gsplatsPackedSH, DEBUG_TAG);
+    argComposeFloat(context, args, UsdSpzFileFormatTokens->gsplatsMaxScale, DEBUG_TAG);
+    argComposeBool(context, args, UsdSpzFileFormatTokens->gsplatsCullToClippingBox, DEBUG_TAG);
+    argComposeInt(context, args, UsdSpzFileFormatTokens->maxSHDegree, DEBUG_TAG);
+    argComposeBool(context, args, UsdSpzFileFormatTokens->mortonOrder, DEBUG_TAG);
+    argComposeInt(context, args, UsdSpzFileFormatTokens->pointLevels, DEBUG_TAG);
+    argComposeInt(context, args, UsdSpzFileFormatTokens->pointLevel, DEBUG_TAG);
 }
 
 bool
@@ -108,12 +143,29 @@ UsdSpzFileFormat::Read(SdfLayer* layer, const std::string& resolvedPath, bool me
     UsdData usd;
     try {
         WriteLayerOptions layerOptions(*data);
+        layerOptions.packedGsplatSHCoeffs = data->gsplatsPackedSH;
         ImportSpzOptions importSpzOptions;
         importSpzOptions.importGsplatWithZup = data->gsplatsWithZup;
         importSpzOptions.importGsplatClippingBox = data->gsplatsClippingBox;
-        spz::UnpackOptions unpackOptions;
-        GaussianCloud gaussianCloud = loadSpz(resolvedPath, unpackOptions);
-        GUARD(importSpz(importSpzOptions, gaussianCloud, usd), "Error translating SPZ to USD\n");
+        importSpzOptions.gsplatPrune.minOpacity = data->gsplatsMinOpacity;
+        importSpzOptions.gsplatPrune.minScale = data->gsplatsMinScale;
+        importSpzOptions.gsplatPrune.maxScale = data->gsplatsMaxScale;
+        importSpzOptions.gsplatPrune.cullToClippingBox = data->gsplatsCullToClippingBox;
+        importSpzOptions.maxSHDegree = data->maxSHDegree;
+        importSpzOptions.halfPrecisionGsplats = data->gsplatsHalfPrecision;
+        // The packed splats are unpacked straight into the USD data
+        PackedGaussians packed = loadSpzPacked(resolvedPath);
+        GUARD(importSpz(importSpzOptions, packed, usd), "Error translating SPZ to USD\n");
+        if (data->mortonOrder) {
+            sortPointCloudsByMortonCode(usd);
+        }
+        if (data->pointLevels > 1) {
+            // Each level is loaded from this file read for that level only
+            const std::string levelArg = UsdSpzFileFormatTokens->pointLevel.GetString();
+            buildPointCloudLevels(usd, data->pointLevels, data->pointLevel, [&](size_t level) {
+                return argLayerAssetPath(*layer, levelArg, std::to_string(level));
+            });
+        }
         GUARD(
           writeLayer(
             layerOptions, usd, layer, layerData, fileType, DEBUG_TAG, SdfFileFormat::_SetLayerData),
@@ -129,6 +181,50 @@ UsdSpzFileFormat::Read(SdfLayer* layer, const std::string& resolvedPath, bool me
 bool
 UsdSpzFileFormat::ReadFromString(SdfLayer* layer, const std::string& input) const
 {
+    TfStopwatch w;
+    w.Start();
+    SdfAbstractDataRefPtr layerData = InitData(layer->GetFileFormatArguments());
+    SpzDataConstPtr data = TfDynamic_cast<const SpzDataConstPtr>(layerData);
+    UsdData usd;
+    try {
+        WriteLayerOptions layerOptions(*data);
+        layerOptions.packedGsplatSHCoeffs = data->gsplatsPackedSH;
+        ImportSpzOptions importSpzOptions;
+        importSpzOptions.importGsplatWithZup = data->gsplatsWithZup;
+        importSpzOptions.importGsplatClippingBox = data->gsplatsClippingBox;
+        importSpzOptions.gsplatPrune.minOpacity = data->gsplatsMinOpacity;
+        importSpzOptions.gsplatPrune.minScale = data->gsplatsMinScale;
+        importSpzOptions.gsplatPrune.maxScale = data->gsplatsMaxScale;
+        importSpzOptions.gsplatPrune.cullToClippingBox = data->gsplatsCullToClippingBox;
+        importSpzOptions.maxSHDegree = data->maxSHDegree;
+        importSpzOptions.halfPrecisionGsplats = data->gsplatsHalfPrecision;
+        GUARD(input.size() <= static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+              "SPZ data is too large\n");
+        // SPZ data is always gzip compressed, even for a cloud without splats, which is valid
+        GUARD(input.size() >= 2 && static_cast<uint8_t>(input[0]) == 0x1f &&
+                static_cast<uint8_t>(input[1]) == 0x8b,
+              "Error reading SPZ from string: not gzip compressed\n");
+        // Decode straight from the string, without copying it into a byte vector first
+        PackedGaussians packed = loadSpzPacked(reinterpret_cast<const uint8_t*>(input.data()),
+                                               static_cast<int32_t>(input.size()));
+        GUARD(importSpz(importSpzOptions, packed, usd), "Error translating SPZ to USD\n");
+        if (data->mortonOrder) {
+            sortPointCloudsByMortonCode(usd);
+        }
+        if (data->pointLevels > 1) {
+            // Without a file to load the levels from, they are authored as internal payloads
+            buildPointCloudLevels(usd, data->pointLevels, data->pointLevel);
+        }
+        GUARD(
+          writeLayer(
+            layerOptions, usd, layer, layerData, "spz", DEBUG_TAG, SdfFileFormat::_SetLayerData),
+          "Error writing to the USD stage\n");
+    } catch (std::exception& e) {
+        TF_RUNTIME_ERROR("Failed to read SPZ from string: %s\n", e.what());
+        return false;
+    }
+    w.Stop();
+    TF_DEBUG_MSG(FILE_FORMAT_SPZ, "Total time: %ld\n", static_cast<long int>(w.GetMilliseconds()));
     return true;
 }
 
@@ -141,7 +237,7 @@ UsdSpzFileFormat::WriteToFile(const SdfLayer& layer,
     TfStopwatch w;
     w.Start();
     UsdData usd;
-    GaussianCloud gaussianCloud;
+    PackedGaussians packed;
     ReadLayerOptions layerOptions;
     layerOptions.flatten = true;
     // SPZ doesn't support invisible primitives, so we filter them out here
@@ -149,15 +245,24 @@ UsdSpzFileFormat::WriteToFile(const SdfLayer& layer,
     SdfAbstractDataRefPtr layerData = InitData(layer.GetFileFormatArguments());
     SpzDataConstPtr data = TfDynamic_cast<const SpzDataConstPtr>(layerData);
     GUARD(readLayer(layerOptions, layer, usd, DEBUG_TAG), "Error reading USD\n");
-    GUARD(exportSpz(usd, gaussianCloud), "Error translating USD to SPZ\n");
-    try {
-        const std::string parentPath = TfGetPathName(filename);
-        TfMakeDirs(parentPath, -1, true);
-        spz::PackOptions packOptions;
-        saveSpz(gaussianCloud, packOptions, filename);
-    } catch (std::exception& e) {
-        TF_DEBUG_MSG(FILE_FORMAT_SPZ, "Error writing SPZ to %s: %s\n", filename.c_str(), e.what());
+    ExportSpzOptions exportOptions;
+    argReadInt(args, "maxSHDegree", exportOptions.maxSHDegree, DEBUG_TAG);
+    argReadInt(args, "compressionLevel", exportOptions.compressionLevel, DEBUG_TAG);
+    argReadBool(args, "parallelDeflate", exportOptions.parallelDeflate, DEBUG_TAG);
+    bool mortonOrder = false;
+    argReadBool(args, "mortonOrder", mortonOrder, DEBUG_TAG);
+    if (mortonOrder) {
+        sortPointCloudsByMortonCode(usd);
     }
+    GUARD(exportSpz(exportOptions, usd, packed), "Error translating USD to SPZ\n");
+    std::vector<uint8_t> output;
+    GUARD(serializeSpz(exportOptions, packed, output), "Error compressing SPZ\n");
+    const std::string parentPath = TfGetPathName(filename);
+    TfMakeDirs(parentPath, -1, true);
+    std::ofstream out(std::filesystem::u8path(filename), std::ios::binary);
+    GUARD(out.is_open(), "Error opening %s for writing\n", filename.c_str());
+    out.write(reinterpret_cast<const char*>(output.data()), output.size());
+    GUARD(out.good(), "Error writing SPZ to %s\n", filename.c_str());
     w.Stop();
     TF_DEBUG_MSG(FILE_FORMAT_SPZ, "Total time: %ld\n", static_cast<long int>(w.GetMilliseconds()));
     return true;
@@ -27,7 +27,17 @@ PXR_NAMESPACE_OPEN_SCOPE
     ((Version, FILE_FORMATS_VERSION)) \
     ((Target, "usd")) \
     ((gsplatsWithZup, "spzGsplatsWithZup")) \
-    ((gsplatsClippingBox, "spzGsplatsClippingBox"))
+    ((gsplatsClippingBox, "spzGsplatsClippingBox")) \
+    ((gsplatsHalfPrecision, "spzGsplatsHalfPrecision")) \
+    ((gsplatsMinOpacity, "spzGsplatsMinOpacity")) \
+    ((gsplatsMinScale, "spzGsplatsMinScale")) \
+    ((gsplatsPackedSH, "spzGsplatsPackedSH")) \
+    ((gsplatsMaxScale, "spzGsplatsMaxScale")) \
+    ((gsplatsCullToClippingBox, "spzGsplatsCullToClippingBox")) \
+    ((maxSHDegree, "spzMaxSHDegree")) \
+    ((mortonOrder, "spzMortonOrder")) \
+    ((pointLevels, "spzPointLevels")) \
+    ((pointLevel, "spzPointLevel"))
 // clang-format on
 
 TF_DECLARE_PUBLIC_TOKENS(UsdSpzFileFormatTokens, USDSPZ_FILE_FORMAT_TOKENS);
@@ -41,6 +51,16 @@ class SpzData : public FileFormatDataBase
   public:
     bool gsplatsWithZup = false;
     PXR_NS::VtFloatArray gsplatsClippingBox = { -2.0, -2.0, -2.0, 2.0, 2.0, 2.0 };
+    bool gsplatsHalfPrecision = false;
+    float gsplatsMinOpacity = 0.0f;
+    float gsplatsMinScale = 0.0f;
+    bool gsplatsPackedSH = false;
+    float gsplatsMaxScale = 0.0f;
+    bool gsplatsCullToClippingBox = false;
+    int maxSHDegree = 3;
+    bool mortonOrder = false;
+    int pointLevels = 0;
+    int pointLevel = -1;
     static SpzDataRefPtr InitData(const SdfFileFormat::FileFormatArguments& args);
 };
 
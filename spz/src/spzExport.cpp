@@ -15,9 +15,11 @@ governing permissions and limitations under the License.
 #include <fileformatutils/geometry.h>
 #include <fileformatutils/gsplatHelper.h>
 #include <fileformatutils/images.h>
+#include <fileformatutils/neuralAssetsHelper.h>
 #include <fileformatutils/transforms.h>
 #include <numeric>
 #include <pxr/base/tf/token.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/defaultResolver.h>
 #include <pxr/usd/ar/resolverContextBinder.h>
@@ -67,47 +69,84 @@ struct SpzTotalMesh
     std::vector<VtFloatArray> shCoeffs;
 };
 
-std::size_t
-findMaxSHCoeffSize(const UsdData& usd, int nodeIndex)
+/// Pointers to the arrays of the total mesh, which mesh instances fill in parallel. Like in the
+/// PLY export, they are taken once before the parallel writes, which then don't go through the
+/// copy-on-write checks of VtArray.
+struct SpzTotalMeshSlices
+{
+    GfVec3f* points = nullptr;
+    GfVec3f* color = nullptr;
+    float* opacity = nullptr;
+    float* widths[3] = {};
+    GfQuatf* rotations = nullptr;
+    std::vector<float*> shCoeffs;
+};
+
+/// A Gaussian splat mesh, the transform of the node that instantiates it and the offset of its
+/// splats in the total mesh
+struct SpzMeshInstance
+{
+    const Mesh* mesh = nullptr;
+    GfMatrix4d modelMatrix;
+    size_t offset = 0;
+};
+
+void
+traverseNodesAndCollectInstances(const UsdData& usd,
+                                 std::vector<SpzMeshInstance>& instances,
+                                 const GfMatrix4d& correctionTransform,
+                                 int nodeIndex)
 {
-    std::size_t maxSHCoeffSize = 0;
     const Node& node = usd.nodes[nodeIndex];
+    GfMatrix4d modelMatrix = node.worldTransform * correctionTransform;
+
     for (int meshIndex : node.staticMeshes) {
         const Mesh& mesh = usd.meshes[meshIndex];
         if (!mesh.asGsplats)
             continue;
-        maxSHCoeffSize = std::max(maxSHCoeffSize, mesh.pointSHCoeffs.size());
+        instances.push_back({ &mesh, modelMatrix });
     }
+
     for (size_t i = 0; i < node.children.size(); ++i) {
-        maxSHCoeffSize = std::max(maxSHCoeffSize, findMaxSHCoeffSize(usd, node.children[i]));
+        traverseNodesAndCollectInstances(usd, instances, correctionTransform, node.children[i]);
     }
-    return maxSHCoeffSize;
 }
 
+// Transform the splats of a mesh instance into its slice of the total mesh, whose arrays are
+// already sized for all instances. Instances only write their own slice, so that they can be
+// aggregated in parallel.
 void
-aggregateMeshInstance(SpzTotalMesh& totalMesh,
-                      const Mesh& mesh,
-                      const GfMatrix4d& modelMatrix)
+aggregateMeshInstance(const SpzTotalMeshSlices& out, const SpzMeshInstance& instance)
 {
-    size_t currentMeshPointsSize = mesh.points.size();
-    size_t offset = totalMesh.points.size();
-    totalMesh.points.resize(offset + currentMeshPointsSize);
-    totalMesh.opacity.resize(offset + mesh.points.size(), 1.0f);
-    totalMesh.color.resize(offset + mesh.points.size(), GfVec3f(0.0f, 0.0f, 0.0f));
-
-    for (size_t i = 0; i < currentMeshPointsSize; ++i) {
-        totalMesh.points[offset + i] = GfVec3f(modelMatrix.Transform(mesh.points[i]));
-    }
+    const Mesh& mesh = *instance.mesh;
+    const GfMatrix4d& modelMatrix = instance.modelMatrix;
+    const size_t currentMeshPointsSize = mesh.points.size();
+    const size_t offset = instance.offset;
+
+    GfVec3f* points = out.points + offset;
+    GfVec3f* color = out.color + offset;
+    float* opacity = out.opacity + offset;
+    // Large instances are also transformed in parallel, which matters when there are only a few
+    const GfVec3f* meshPoints = mesh.points.cdata();
+    WorkParallelForN(currentMeshPointsSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            points[i] = GfVec3f(modelMatrix.Transform(meshPoints[i]));
+        }
+    });
 
-    const size_t numPointOpacities = std::min(currentMeshPointsSize, mesh.opacities[0].values.size());
-    memcpy(totalMesh.opacity.data() + offset,
-           mesh.opacities[0].values.data(),
-           numPointOpacities * sizeof(mesh.opacities[0].values[0]));
+    const size_t numPointOpacities =
+      mesh.opacities.empty() ? 0 : std::min(currentMeshPointsSize, mesh.opacities[0].values.size());
+    if (numPointOpacities) {
+        memcpy(opacity, mesh.opacities[0].values.cdata(), numPointOpacities * sizeof(float));
+    }
+    std::fill(opacity + numPointOpacities, opacity + currentMeshPointsSize, 1.0f);
 
-    const size_t numPointColors = std::min(currentMeshPointsSize, mesh.colors[0].values.size());
-    memcpy(totalMesh.color.data() + offset,
-           mesh.colors[0].values.data(),
-           numPointColors * sizeof(mesh.colors[0].values[0]));
+    const size_t numPointColors =
+      mesh.colors.empty() ? 0 : std::min(currentMeshPointsSize, mesh.colors[0].values.size());
+    if (numPointColors) {
+        memcpy(color, mesh.colors[0].values.cdata(), numPointColors * sizeof(GfVec3f));
+    }
+    std::fill(color + numPointColors, color + currentMeshPointsSize, GfVec3f(0.0f, 0.0f, 0.0f));
 
     GfMatrix4f modelMatrixFloat(modelMatrix);
     const float modelScaling = std::cbrt(std::abs(modelMatrixFloat.GetDeterminant()));
@@ -117,13 +156,17 @@ aggregateMeshInstance(SpzTotalMesh& totalMesh,
                      mesh.pointExtraWidths,
                      currentMeshPointsSize,
                      modelScaling,
-                     totalMesh.widths,
-                     totalMesh.widths1,
-                     totalMesh.widths2);
+                     out.widths[0] + offset,
+                     out.widths[1] + offset,
+                     out.widths[2] + offset);
     rotatePointRotations(
-      mesh.pointRotations, modelRotation, currentMeshPointsSize, totalMesh.rotations);
+      mesh.pointRotations, modelRotation, currentMeshPointsSize, out.rotations + offset);
+    std::vector<float*> shCoeffs(out.shCoeffs.size());
+    for (size_t k = 0; k < shCoeffs.size(); ++k) {
+        shCoeffs[k] = out.shCoeffs[k] + offset;
+    }
     rotatePointSphericalHarmonics(
-      mesh.pointSHCoeffs, modelRotation, currentMeshPointsSize, totalMesh.shCoeffs);
+      mesh.pointSHCoeffs, modelRotation, currentMeshPointsSize, shCoeffs);
 
     TF_DEBUG_MSG(FILE_FORMAT_SPZ,
                  "spz::export aggregated mesh %s { v: %lu }\n",
@@ -131,38 +174,6 @@ aggregateMeshInstance(SpzTotalMesh& totalMesh,
                  currentMeshPointsSize);
 }
 
-void
-traverseNodesAndAggregateMeshes(const UsdData& usd,
-                                SpzTotalMesh& totalMesh,
-                                const GfMatrix4d& correctionTransform,
-                                int nodeIndex)
-{
-    const Node& node = usd.nodes[nodeIndex];
-    GfMatrix4d modelMatrix = node.worldTransform * correctionTransform;
-    
-    for (int meshIndex : node.staticMeshes) {
-        const Mesh& mesh = usd.meshes[meshIndex];
-        if (!mesh.asGsplats)
-            continue;
-        aggregateMeshInstance(totalMesh, mesh, modelMatrix);
-    }
-    
-    for (size_t i = 0; i < node.children.size(); ++i) {
-        traverseNodesAndAggregateMeshes(
-          usd, totalMesh, correctionTransform, node.children[i]);
-    }
-}
-
-float
-encodeGsplatOpacity(float opacity)
-{
-    // Make sure the inversed sigmoid function doesn't cause
-    // infinite result.
-    const float clampedOpacity = std::clamp(
-      opacity, std::numeric_limits<float>::min(), 1.0f - std::numeric_limits<float>::epsilon());
-    return -log(1.0f / clampedOpacity - 1.0f);
-}
-
 float
 encodeGsplatWidth(float width)
 {
@@ -172,8 +183,34 @@ encodeGsplatWidth(float width)
     return log(clamped_half_width);
 }
 
+namespace {
+// Number of fractional bits of the 24 bit fixed point positions, which is a resolution of about
+// 0.25 millimeters
+constexpr int spzFractionalBits = 12;
+// Scale of the colors, i.e. the zeroth SH coefficients, relative to the 8 bit range
+constexpr float spzColorScale = 0.15f;
+// Bits that the SH coefficients of degree 1 and of the higher degrees keep of their 8 bits, which
+// makes them compress better
+constexpr int spzSH1Bits = 5;
+constexpr int spzSHRestBits = 4;
+
+inline std::uint8_t
+toUint8(float value)
+{
+    return static_cast<std::uint8_t>(std::clamp(std::round(value), 0.0f, 255.0f));
+}
+
+inline std::uint8_t
+quantizeSH(float value, int bucketSize)
+{
+    int q = static_cast<int>(std::round(value * 128.0f) + 128.0f);
+    q = (q + bucketSize / 2) / bucketSize * bucketSize;
+    return static_cast<std::uint8_t>(std::clamp(q, 0, 255));
+}
+}
+
 bool
-exportSpz(const UsdData& usd, spz::GaussianCloud& gaussianCloud)
+exportSpz(const ExportSpzOptions& options, const UsdData& usd, spz::PackedGaussians& packed)
 {
     if (usd.meshes.size() <= 0) {
         TF_DEBUG_MSG(FILE_FORMAT_SPZ,
@@ -186,74 +223,174 @@ exportSpz(const UsdData& usd, spz::GaussianCloud& gaussianCloud)
     // correction transform.
     SpzTotalMesh totalMesh;
     GfMatrix4d correctionTransform = getTransformToMetersPositiveY(usd.metersPerUnit, usd.upAxis);
+    std::vector<SpzMeshInstance> instances;
+    for (size_t i = 0; i < usd.rootNodes.size(); ++i) {
+        traverseNodesAndCollectInstances(usd, instances, correctionTransform, usd.rootNodes[i]);
+    }
 
+    // The sizing pass assigns each instance its slice of the total mesh
     std::size_t numGsplatsSHCoeffs = 0;
-    for (size_t i = 0; i < usd.rootNodes.size(); ++i) {
-        numGsplatsSHCoeffs = std::max(numGsplatsSHCoeffs, findMaxSHCoeffSize(usd, usd.rootNodes[i]));
+    size_t numPoints = 0;
+    for (SpzMeshInstance& instance : instances) {
+        numGsplatsSHCoeffs = std::max(numGsplatsSHCoeffs, instance.mesh->pointSHCoeffs.size());
+        instance.offset = numPoints;
+        numPoints += instance.mesh->points.size();
     }
 
     // We only store SH coefficients up to the degree with complete bands (i.e., 0, 9, 24, or 45
-    // coefficients).
-    const std::size_t numSHDegrees = numSHDegreesFromGsplat(numGsplatsSHCoeffs);
+    // coefficients), and up to the maximum degree of the options.
+    const std::size_t numSHDegrees =
+      numSHDegreesFromGsplat(truncatedSHCoeffCount(numGsplatsSHCoeffs, options.maxSHDegree));
     const std::size_t numNonZeroSHBands = numNonZeroSHBandsFromDegree(numSHDegrees);
     numGsplatsSHCoeffs = numNonZeroSHBands * 3;
 
+    totalMesh.points.resize(numPoints);
+    totalMesh.color.resize(numPoints);
+    totalMesh.opacity.resize(numPoints);
+    totalMesh.widths.resize(numPoints);
+    totalMesh.widths1.resize(numPoints);
+    totalMesh.widths2.resize(numPoints);
+    totalMesh.rotations.resize(numPoints);
     totalMesh.shCoeffs.resize(numGsplatsSHCoeffs);
-
-    for (size_t i = 0; i < usd.rootNodes.size(); ++i) {
-        traverseNodesAndAggregateMeshes(
-          usd, totalMesh, correctionTransform, usd.rootNodes[i]);
+    SpzTotalMeshSlices slices;
+    slices.points = totalMesh.points.data();
+    slices.color = totalMesh.color.data();
+    slices.opacity = totalMesh.opacity.data();
+    slices.widths[0] = totalMesh.widths.data();
+    slices.widths[1] = totalMesh.widths1.data();
+    slices.widths[2] = totalMesh.widths2.data();
+    slices.rotations = totalMesh.rotations.data();
+    for (VtFloatArray& shCoeff : totalMesh.shCoeffs) {
+        shCoeff.resize(numPoints);
+        slices.shCoeffs.push_back(shCoeff.data());
     }
 
-    gaussianCloud.numPoints = totalMesh.points.size();
-    gaussianCloud.shDegree = numSHDegrees;
-    gaussianCloud.positions.resize(totalMesh.points.size() * 3);
-    memcpy(gaussianCloud.positions.data(),
-           totalMesh.points.data(),
-           totalMesh.points.size() * sizeof(totalMesh.points[0]));
+    // Each instance then fills its slice in parallel
+    WorkParallelForN(instances.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            aggregateMeshInstance(slices, instances[i]);
+        }
+    });
+
+    // The splats are quantized in parallel straight from the aggregated arrays into the packed
+    // layout of SPZ, in the same way as spz::packGaussians, which does it on a single thread and
+    // needs the splats as floats in a spz::GaussianCloud first
+    packed.numPoints = static_cast<int>(numPoints);
+    packed.shDegree = static_cast<int>(numSHDegrees);
+    packed.fractionalBits = spzFractionalBits;
+    packed.positions.resize(numPoints * 9);
+    packed.alphas.resize(numPoints);
+    packed.colors.resize(numPoints * 3);
+    packed.scales.resize(numPoints * 3);
+    packed.rotations.resize(numPoints * 3);
+    packed.sh.resize(numPoints * numGsplatsSHCoeffs);
 
     // Zeroth coefficient of SH, inversed as 2sqrt(pi)
     constexpr float invShC0 = 3.5449077018f;
-    gaussianCloud.colors.resize(totalMesh.color.size() * 3);
-    for (size_t i = 0; i < totalMesh.color.size(); ++i) {
-        gaussianCloud.colors[i * 3 + 0] = (totalMesh.color[i][0] - 0.5f) * invShC0;
-        gaussianCloud.colors[i * 3 + 1] = (totalMesh.color[i][1] - 0.5f) * invShC0;
-        gaussianCloud.colors[i * 3 + 2] = (totalMesh.color[i][2] - 0.5f) * invShC0;
-    }
-
-    gaussianCloud.alphas.resize(totalMesh.opacity.size());
-    for (size_t i = 0; i < totalMesh.opacity.size(); ++i) {
-        gaussianCloud.alphas[i] = encodeGsplatOpacity(totalMesh.opacity[i]);
+    const float positionScale = static_cast<float>(1 << spzFractionalBits);
+    const GfVec3f* points = totalMesh.points.cdata();
+    const GfVec3f* colors = totalMesh.color.cdata();
+    const float* opacities = totalMesh.opacity.cdata();
+    const float* widths[3] = { totalMesh.widths.cdata(),
+                               totalMesh.widths1.cdata(),
+                               totalMesh.widths2.cdata() };
+    const GfQuatf* rotations = totalMesh.rotations.cdata();
+    std::vector<const float*> shCoeffs;
+    for (const VtFloatArray& shCoeff : totalMesh.shCoeffs) {
+        shCoeffs.push_back(shCoeff.cdata());
     }
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t c = 0; c < 3; ++c) {
+                const int32_t fixed =
+                  static_cast<int32_t>(std::round(points[i][c] * positionScale));
+                packed.positions[i * 9 + c * 3 + 0] = fixed & 0xff;
+                packed.positions[i * 9 + c * 3 + 1] = (fixed >> 8) & 0xff;
+                packed.positions[i * 9 + c * 3 + 2] = (fixed >> 16) & 0xff;
+                packed.colors[i * 3 + c] =
+                  toUint8((colors[i][c] - 0.5f) * invShC0 * (spzColorScale * 255.0f) +
+                          0.5f * 255.0f);
+            }
+            // The opacities are stored after the sigmoid activation, i.e. as they are in USD
+            packed.alphas[i] = toUint8(opacities[i] * 255.0f);
+            for (size_t c = 0; c < 3; ++c) {
+                packed.scales[i * 3 + c] =
+                  toUint8((encodeGsplatWidth(widths[c][i]) + 10.0f) * 16.0f);
+            }
 
-    gaussianCloud.scales.resize(totalMesh.widths.size() * 3);
-    for (size_t i = 0; i < totalMesh.widths.size(); ++i) {
-        gaussianCloud.scales[i * 3 + 0] = encodeGsplatWidth(totalMesh.widths[i]);
-        gaussianCloud.scales[i * 3 + 1] = encodeGsplatWidth(totalMesh.widths1[i]);
-        gaussianCloud.scales[i * 3 + 2] = encodeGsplatWidth(totalMesh.widths2[i]);
-    }
+            // Only the imaginary part of the normalized rotation is stored, with the real part
+            // made positive so that it can be derived from the others
+            GfQuatf q = rotations[i];
+            const float length = q.GetLength();
+            q = length > 0.0f ? q / length : GfQuatf::GetIdentity();
+            const GfVec3f imaginary = q.GetImaginary() * (q.GetReal() < 0.0f ? -1.0f : 1.0f);
+            for (size_t c = 0; c < 3; ++c) {
+                packed.rotations[i * 3 + c] = toUint8(imaginary[c] * 127.5f + 127.5f);
+            }
 
-    gaussianCloud.rotations.resize(totalMesh.rotations.size() * 4);
-    memcpy(gaussianCloud.rotations.data(),
-           totalMesh.rotations.data(),
-           totalMesh.rotations.size() * sizeof(totalMesh.rotations[0]));
-
-    gaussianCloud.sh.resize(numGsplatsSHCoeffs * totalMesh.points.size());
-    // SPZ stores SH coefficients in row-major order, different than USD's column-major order.
-    // Also, SPZ stores SH coefficients in an Array-of-Structs (AoS) format.
-    for (size_t shRowIndex = 0; shRowIndex < numNonZeroSHBands; ++shRowIndex) {
-        for (size_t shColIndex = 0; shColIndex < 3; ++shColIndex) {
-            const std::size_t spzSHIndex = shRowIndex * 3 + shColIndex;
-            const std::size_t usdSHIndex = shColIndex * numNonZeroSHBands + shRowIndex;
-            const std::size_t spzShCoeffOffset = spzSHIndex * totalMesh.points.size();
-
-            for (size_t i = 0; i < totalMesh.points.size(); ++i) {
-                gaussianCloud.sh[i * numGsplatsSHCoeffs + spzSHIndex] =
-                  totalMesh.shCoeffs[usdSHIndex][i];
+            // SPZ stores the SH coefficients of a splat next to each other with the channels
+            // interleaved, unlike the planes of the coefficients per channel of USD
+            uint8_t* sh = packed.sh.data() + i * numGsplatsSHCoeffs;
+            for (size_t shRowIndex = 0; shRowIndex < numNonZeroSHBands; ++shRowIndex) {
+                const int bucketSize = 1 << (8 - (shRowIndex < 3 ? spzSH1Bits : spzSHRestBits));
+                for (size_t shColIndex = 0; shColIndex < 3; ++shColIndex) {
+                    const size_t usdSHIndex = shColIndex * numNonZeroSHBands + shRowIndex;
+                    sh[shRowIndex * 3 + shColIndex] =
+                      quantizeSH(shCoeffs[usdSHIndex][i], bucketSize);
+                }
             }
         }
+    });
+
+    return true;
+}
+
+bool
+serializeSpz(const ExportSpzOptions& options,
+             const spz::PackedGaussians& packed,
+             std::vector<uint8_t>& output)
+{
+    // The header of version 2 of the format, which stores the rotations in 3 bytes: the magic
+    // number "NGSP", the version, the number of splats, the SH degree, the fractional bits of the
+    // positions, the flags and a reserved byte
+    std::vector<uint8_t> data;
+    auto appendUInt32 = [&](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    };
+    appendUInt32(0x5053474e);
+    appendUInt32(2);
+    appendUInt32(static_cast<uint32_t>(packed.numPoints));
+    data.push_back(static_cast<uint8_t>(packed.shDegree));
+    data.push_back(static_cast<uint8_t>(packed.fractionalBits));
+    data.push_back(0);
+    data.push_back(0);
+
+    // The attributes follow the header one after another
+    const std::vector<uint8_t>* attributes[] = { &packed.positions, &packed.alphas,
+                                                 &packed.colors,    &packed.scales,
+                                                 &packed.rotations, &packed.sh };
+    size_t size = data.size();
+    for (const std::vector<uint8_t>* attribute : attributes) {
+        size += attribute->size();
+    }
+    data.reserve(size);
+    for (const std::vector<uint8_t>* attribute : attributes) {
+        data.insert(data.end(), attribute->begin(), attribute->end());
     }
 
+    if (!compressGzip(
+          data.data(), data.size(), options.compressionLevel, options.parallelDeflate, output)) {
+        TF_DEBUG_MSG(FILE_FORMAT_SPZ,
+                     "spz::export cannot compress with level %d\n",
+                     options.compressionLevel);
+        return false;
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_SPZ,
+                 "spz::export compressed %zu bytes to %zu bytes\n",
+                 data.size(),
+                 output.size());
     return true;
 }
 
@@ -10,14 +10,36 @@ OF ANY KIND, either express or implied. See the License for the specific languag
 governing permissions and limitations under the License.
 */
 #pragma once
-#include <splat-types.h>
+#include <load-spz.h>
+#include <cstdint>
 #include <fileformatutils/usdData.h>
+#include <vector>
 
 namespace adobe::usd {
 
 /// \ingroup usdspz
-/// \brief Export USD data to a spz model.
+/// \brief Options for exporting USD data to a spz model.
+struct ExportSpzOptions
+{
+    // Write the higher order SH coefficients of the splats only up to this degree
+    int maxSHDegree = 3;
+    // zlib compression level of the file, from 0 to 9, or -1 for the zlib default
+    int compressionLevel = -1;
+    // Deflate the file in blocks on all threads
+    bool parallelDeflate = false;
+};
+
+/// \ingroup usdspz
+/// \brief Export USD data to a spz model, whose splats are quantized into the packed layout of the
+/// file.
+bool
+exportSpz(const ExportSpzOptions& options, const UsdData& data, spz::PackedGaussians& spz);
+
+/// \ingroup usdspz
+/// \brief Serialize the packed splats into the gzip compressed bytes of a spz file.
 bool
-exportSpz(const UsdData& data, spz::GaussianCloud& spz);
+serializeSpz(const ExportSpzOptions& options,
+             const spz::PackedGaussians& spz,
+             std::vector<std::uint8_t>& output);
 
 }
\ No newline at end of file
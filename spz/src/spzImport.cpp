@@ -15,11 +15,13 @@ governing permissions and limitations under the License.
 #include <array>
 #include <fileformatutils/common.h>
 #include <fileformatutils/geometry.h>
+#include <fileformatutils/gsplatHelper.h>
 #include <fileformatutils/images.h>
 #include <fileformatutils/neuralAssetsHelper.h>
 #include <limits>
 #include <pxr/base/gf/range3f.h>
 #include <pxr/base/vt/array.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/sdf/path.h>
@@ -39,8 +41,14 @@ using namespace PXR_NS;
 using namespace spz;
 
 namespace adobe::usd {
+namespace {
+// Number of splats that are unpacked at once into a temporary buffer, from which they are decoded
+// into the arrays of the mesh
+constexpr size_t spzBlockSize = 1024;
+}
+
 bool
-importSpz(const ImportSpzOptions& options, const spz::GaussianCloud& gaussianCloud, UsdData& usd)
+importSpz(const ImportSpzOptions& options, const spz::PackedGaussians& packed, UsdData& usd)
 {
     auto [meshIndex, mesh] = usd.addMesh();
 
@@ -49,90 +57,74 @@ importSpz(const ImportSpzOptions& options, const spz::GaussianCloud& gaussianClo
     mesh.asGsplats = true;
 
     try {
-        mesh.points.resize(gaussianCloud.numPoints);
-        if (gaussianCloud.positions.size() < static_cast<size_t>(gaussianCloud.numPoints * 3))
+        if (packed.numPoints < 0)
+            throw std::runtime_error("Invalid number of points");
+        const size_t numPoints = static_cast<size_t>(packed.numPoints);
+        if (packed.positions.size() < numPoints * 3 * (packed.usesFloat16() ? 2 : 3))
             throw std::runtime_error("Invalid position data size");
-        for (size_t i = 0; i < mesh.points.size(); i++) {
-            mesh.points[i][0] = gaussianCloud.positions[i * 3 + 0];
-            mesh.points[i][1] = gaussianCloud.positions[i * 3 + 1];
-            mesh.points[i][2] = gaussianCloud.positions[i * 3 + 2];
-        }
-
-        // The 0th-order coefficient of spherical harmonics, which
-        // is 1/sqrt(4*pi).
-        constexpr float shC0 = 0.28209479177387814f;
-        auto [colorIndex, colors] = usd.addColorSet(meshIndex);
-        colors.interpolation = UsdGeomTokens->vertex;
-        colors.values.resize(gaussianCloud.numPoints);
-        if (gaussianCloud.colors.size() < static_cast<size_t>(gaussianCloud.numPoints * 3))
-            throw std::runtime_error("Invalid color data size");
-        for (size_t i = 0; i < colors.values.size(); i++) {
-            colors.values[i][0] = gaussianCloud.colors[i * 3 + 0] * shC0 + 0.5f;
-            colors.values[i][1] = gaussianCloud.colors[i * 3 + 1] * shC0 + 0.5f;
-            colors.values[i][2] = gaussianCloud.colors[i * 3 + 2] * shC0 + 0.5f;
-        }
-
-        auto [opacityIndex, opacity] = usd.addOpacitySet(meshIndex);
-        opacity.interpolation = UsdGeomTokens->vertex;
-        opacity.values.resize(gaussianCloud.numPoints);
-        if (gaussianCloud.alphas.size() < static_cast<size_t>(gaussianCloud.numPoints))
+        if (packed.rotations.size() < numPoints * 3)
+            throw std::runtime_error("Invalid rotation data size");
+        if (packed.alphas.size() < numPoints)
             throw std::runtime_error("Invalid opacity data size");
-        for (size_t i = 0; i < opacity.values.size(); i++) {
-            opacity.values[i] = 1.0f / (1.0f + std::exp(-gaussianCloud.alphas[i]));
-        }
-
-        if (gaussianCloud.scales.size() < static_cast<size_t>(gaussianCloud.numPoints * 3))
+        if (packed.colors.size() < numPoints * 3)
+            throw std::runtime_error("Invalid color data size");
+        if (packed.scales.size() < numPoints * 3)
             throw std::runtime_error("Invalid scale data size");
-        mesh.pointWidths.resize(gaussianCloud.numPoints);
-        for (size_t i = 0; i < mesh.pointWidths.size(); i++)
-            mesh.pointWidths[i] = std::exp(gaussianCloud.scales[i * 3 + 0]) * 2.0f;
-
-        auto [width1Index, widths1] = usd.addExtraPointWidthSet(meshIndex);
-        widths1.interpolation = UsdGeomTokens->vertex;
-        widths1.values.resize(gaussianCloud.numPoints);
-        for (size_t i = 0; i < mesh.pointWidths.size(); i++)
-            widths1.values[i] = std::exp(gaussianCloud.scales[i * 3 + 1]) * 2.0f;
-
-        auto [width2Index, widths2] = usd.addExtraPointWidthSet(meshIndex);
-        widths2.interpolation = UsdGeomTokens->vertex;
-        widths2.values.resize(gaussianCloud.numPoints);
-        for (size_t i = 0; i < mesh.pointWidths.size(); i++)
-            widths2.values[i] = std::exp(gaussianCloud.scales[i * 3 + 2]) * 2.0f;
-
-        mesh.pointRotations.interpolation = UsdGeomTokens->vertex;
-        mesh.pointRotations.values.resize(gaussianCloud.numPoints);
-        if (gaussianCloud.rotations.size() < static_cast<size_t>(gaussianCloud.numPoints * 4))
-            throw std::runtime_error("Invalid rotation data size");
-        for (size_t i = 0; i < mesh.pointRotations.values.size(); i++) {
-            mesh.pointRotations.values[i].SetReal(gaussianCloud.rotations[i * 4 + 3]);
-            mesh.pointRotations.values[i].SetImaginary(gaussianCloud.rotations[i * 4 + 0],
-                                                       gaussianCloud.rotations[i * 4 + 1],
-                                                       gaussianCloud.rotations[i * 4 + 2]);
-            mesh.pointRotations.values[i] = mesh.pointRotations.values[i].GetNormalized();
-        }
-
-        const size_t shDim = gaussianCloud.shDegree * (gaussianCloud.shDegree + 2);
-        const size_t numGsplatsSHCoeffs = shDim * 3;
-        if (gaussianCloud.sh.size() < static_cast<size_t>(gaussianCloud.numPoints * shDim * 3))
+        const size_t shDim = packed.shDegree * (packed.shDegree + 2);
+        if (shDim > 15 || packed.sh.size() < numPoints * shDim * 3)
             throw std::runtime_error("Invalid SH coefficient data size");
-        for (std::size_t shColIndex = 0; shColIndex < 3; ++shColIndex) {
-            for (std::size_t shRowIndex = 0; shRowIndex < shDim; ++shRowIndex) {
-                auto [shCoeffIndex, shCoeffs] = usd.addPointSHCoeffSet(meshIndex);
-                shCoeffs.interpolation = UsdGeomTokens->vertex;
-                shCoeffs.values.resize(gaussianCloud.numPoints);
+        // Only the bands up to the maximum degree are unpacked into the mesh
+        const size_t outShDim = truncatedSHCoeffCount(shDim * 3, options.maxSHDegree) / 3;
+
+        // The splats are unpacked block by block straight into the arrays of the mesh, so that
+        // the unpacked splats of the whole cloud are never held in memory. The SPZ data is
+        // imported in its own coordinate system, like with the default unpack options.
+        const GsplatDecodeTargets targets = prepareGsplats(numPoints, outShDim * 3, usd, meshIndex);
+        mesh.points.resize(numPoints);
+        GfVec3f* points = mesh.points.data();
+        const spz::CoordinateConverter converter;
+        // Each block is unpacked into planes of the attributes: the colors, opacity, scales,
+        // rotation with the real part first and the SH coefficients per channel, which is the
+        // order of the point SH coefficient sets
+        const size_t numPlanes = 11 + outShDim * 3;
+        WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+            std::vector<float> planes(numPlanes * spzBlockSize);
+            auto plane = [&](size_t p) { return planes.data() + p * spzBlockSize; };
+            GsplatRawAttributes raw;
+            raw.colors = { plane(0), plane(1), plane(2) };
+            raw.opacities = plane(3);
+            raw.scales = { plane(4), plane(5), plane(6) };
+            raw.rotations = { plane(7), plane(8), plane(9), plane(10) };
+            for (size_t k = 0; k < outShDim * 3; k++) {
+                raw.shCoeffs.push_back(plane(11 + k));
+            }
 
-                // SPZ stores SH coefficients in a row-major order, where
-                // we need to convert it to a column-major order that we
-                // use for USD.
-                // Also, SPZ stores SH coefficients in an Array-of-Structs (AoS) format,
-                // packing the SH coefficients for each point together, while USD expects 
-                // a Struct-of-Arrays (SoA) format, packing one coefficient for all points together.
-                const size_t spzShIndex = shRowIndex * 3 + shColIndex;
-                for (size_t i = 0; i < shCoeffs.values.size(); i++) {
-                    shCoeffs.values[i] = gaussianCloud.sh[i * numGsplatsSHCoeffs + spzShIndex];
+            for (size_t first = begin; first < end; first += spzBlockSize) {
+                const size_t count = std::min(spzBlockSize, end - first);
+                for (size_t i = 0; i < count; i++) {
+                    const spz::UnpackedGaussian g =
+                      packed.unpack(static_cast<int>(first + i), converter);
+                    points[first + i] = GfVec3f(g.position[0], g.position[1], g.position[2]);
+                    for (size_t c = 0; c < 3; c++) {
+                        plane(c)[i] = g.color[c];
+                        plane(4 + c)[i] = g.scale[c];
+                    }
+                    plane(3)[i] = g.alpha;
+                    // SPZ stores the real part of the rotations last
+                    plane(7)[i] = g.rotation[3];
+                    plane(8)[i] = g.rotation[0];
+                    plane(9)[i] = g.rotation[1];
+                    plane(10)[i] = g.rotation[2];
+                    for (size_t k = 0; k < outShDim; k++) {
+                        plane(11 + k)[i] = g.shR[k];
+                        plane(11 + outShDim + k)[i] = g.shG[k];
+                        plane(11 + 2 * outShDim + k)[i] = g.shB[k];
+                    }
                 }
+                decodeGsplatBlock(raw, count, targets, first);
             }
-        }
+        });
+        mesh.extent = computeExtent(mesh.points);
     } catch (std::exception& e) {
         TF_DEBUG_MSG(FILE_FORMAT_SPZ, "Cannot load SPZ: %s\n", e.what());
         return false;
@@ -145,17 +137,9 @@ importSpz(const ImportSpzOptions& options, const spz::GaussianCloud& gaussianClo
     usd.upAxis = options.importGsplatWithZup ? UsdGeomTokens->z : UsdGeomTokens->y;
 
     if (options.importGsplatClippingBox.size() >= 6) {
-        PXR_NS::GfVec3f minPos(std::numeric_limits<float>::max());
-        PXR_NS::GfVec3f maxPos(-std::numeric_limits<float>::max());
-        for (size_t i = 0; i < mesh.points.size(); i++) {
-            minPos[0] = std::min(mesh.points[i][0], minPos[0]);
-            minPos[1] = std::min(mesh.points[i][1], minPos[1]);
-            minPos[2] = std::min(mesh.points[i][2], minPos[2]);
-            maxPos[0] = std::max(mesh.points[i][0], maxPos[0]);
-            maxPos[1] = std::max(mesh.points[i][1], maxPos[1]);
-            maxPos[2] = std::max(mesh.points[i][2], maxPos[2]);
-        }
-        if (maxPos[0] < minPos[0] || maxPos[1] < minPos[1] || maxPos[2] < minPos[2]) {
+        const GfVec3f& minPos = mesh.extent.GetMin();
+        const GfVec3f& maxPos = mesh.extent.GetMax();
+        if (mesh.extent.IsEmpty()) {
             TF_DEBUG_MSG(FILE_FORMAT_SPZ,
                          "Invalid bounding box: (%f, %f, %f) - (%f, %f, %f)\n",
                          minPos[0],
@@ -181,6 +165,15 @@ importSpz(const ImportSpzOptions& options, const spz::GaussianCloud& gaussianClo
                           std::min(options.importGsplatClippingBox[5], maxPos[2]));
         mesh.clippingBox.interpolation = UsdGeomTokens->constant;
     }
+
+    if (mesh.asGsplats && options.gsplatPrune.enabled()) {
+        const size_t numPoints = mesh.points.size();
+        const size_t numPruned = pruneGsplats(mesh, options.gsplatPrune);
+        TF_DEBUG_MSG(FILE_FORMAT_SPZ, "Pruned %zu of %zu splats\n", numPruned, numPoints);
+    }
+    if (mesh.asGsplats && options.halfPrecisionGsplats) {
+        convertGsplatsToHalf(mesh);
+    }
     return true;
 }
 
@@ -10,7 +10,8 @@ OF ANY KIND, either express or implied. See the License for the specific languag
 governing permissions and limitations under the License.
 */
 #pragma once
-#include <splat-types.h>
+#include <load-spz.h>
+#include <fileformatutils/gsplatHelper.h>
 #include <fileformatutils/usdData.h>
 
 namespace adobe::usd {
@@ -19,11 +20,18 @@ struct ImportSpzOptions
 {
     bool importGsplatWithZup = false;
     PXR_NS::VtFloatArray importGsplatClippingBox = { -2.0, -2.0, -2.0, 2.0, 2.0, 2.0 };
+    // Drop faint, tiny, huge or clipped splats after the import
+    GsplatPruneOptions gsplatPrune;
+    // Unpack the higher order SH coefficients of the splats only up to this degree
+    int maxSHDegree = 3;
+    // Keep the colors, opacities and SH coefficients of the splats in half precision
+    bool halfPrecisionGsplats = false;
 };
 
 /// \ingroup usdspz
-/// \brief Import spz data into a USD data cache.
+/// \brief Import packed spz data into a USD data cache. The splats are unpacked straight into the
+/// arrays of the mesh, without an intermediate spz::GaussianCloud.
 bool
-importSpz(const ImportSpzOptions& options, const spz::GaussianCloud& spz, UsdData& data);
+importSpz(const ImportSpzOptions& options, const spz::PackedGaussians& spz, UsdData& data);
 
 }
\ No newline at end of file
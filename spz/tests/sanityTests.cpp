@@ -13,10 +13,15 @@ governing permissions and limitations under the License.
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/resolver.h>
 #include <pxr/usd/sdf/assetPath.h>
+#include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/usd/attribute.h>
 #include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
 
+#include <fstream>
+#include <sstream>
+
 TEST(SPZSanityTests, LoadCube)
 {
     PXR_NAMESPACE_USING_DIRECTIVE
@@ -25,3 +30,63 @@ TEST(SPZSanityTests, LoadCube)
     UsdStageRefPtr stage = UsdStage::Open("SanitySplats.spz");
     ASSERT_TRUE(stage);
 }
+
+TEST(SPZSanityTests, LoadSplatsFromString)
+{
+    PXR_NAMESPACE_USING_DIRECTIVE
+
+    std::ifstream file("SanitySplats.spz", std::ios::binary);
+    ASSERT_TRUE(file.is_open());
+    std::stringstream content;
+    content << file.rdbuf();
+
+    // The extension of the tag selects the file format of the anonymous layer
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("SanitySplats.spz");
+    ASSERT_TRUE(layer);
+    ASSERT_TRUE(layer->ImportFromString(content.str()));
+    UsdStageRefPtr stage = UsdStage::Open(layer);
+    ASSERT_TRUE(stage);
+
+    size_t numPoints = 0;
+    for (const UsdPrim& prim : stage->Traverse()) {
+        VtVec3fArray points;
+        if (prim.GetAttribute(TfToken("points")).Get(&points)) {
+            numPoints += points.size();
+        }
+    }
+    ASSERT_GT(numPoints, 0u);
+
+    // Data that doesn't decode to any splats is not a valid layer
+    SdfLayerRefPtr emptyLayer = SdfLayer::CreateAnonymous("Empty.spz");
+    ASSERT_TRUE(emptyLayer);
+    ASSERT_FALSE(emptyLayer->ImportFromString(std::string()));
+    ASSERT_FALSE(emptyLayer->ImportFromString("not spz data"));
+}
+
+TEST(SPZSanityTests, LoadEmptySplatsFromString)
+{
+    PXR_NAMESPACE_USING_DIRECTIVE
+
+    // A stage without splats exports a valid SPZ cloud of zero splats
+    UsdStageRefPtr emptyStage = UsdStage::CreateInMemory();
+    ASSERT_TRUE(emptyStage);
+    ASSERT_TRUE(emptyStage->Export("EmptySplats.spz"));
+    ASSERT_TRUE(UsdStage::Open("EmptySplats.spz"));
+
+    std::ifstream file("EmptySplats.spz", std::ios::binary);
+    ASSERT_TRUE(file.is_open());
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_FALSE(content.str().empty());
+
+    // It reads from a string like from the file
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("EmptySplats.spz");
+    ASSERT_TRUE(layer);
+    ASSERT_TRUE(layer->ImportFromString(content.str()));
+    UsdStageRefPtr stage = UsdStage::Open(layer);
+    ASSERT_TRUE(stage);
+    for (const UsdPrim& prim : stage->Traverse()) {
+        VtVec3fArray points;
+        ASSERT_FALSE(prim.GetAttribute(TfToken("points")).Get(&points) && !points.empty());
+    }
+}
@@ -17,6 +17,7 @@ governing permissions and limitations under the License.
 #include "stlModel.h"
 
 #include <fileformatutils/common.h>
+#include <fileformatutils/geometry.h>
 #include <fileformatutils/layerRead.h>
 #include <fileformatutils/layerWriteSdfData.h>
 
@@ -45,6 +46,25 @@ UsdStlFileFormat::UsdStlFileFormat()
 
 UsdStlFileFormat::~UsdStlFileFormat() {}
 
+void
+UsdStlFileFormat::ComposeFieldsForFileFormatArguments(const std::string& assetPath,
+                                                      const PcpDynamicFileFormatContext& context,
+                                                      FileFormatArguments* args,
+                                                      VtValue* dependencyContextData) const
+{
+    argComposeInt(context, args, UsdStlFileFormatTokens->maxFacesPerMesh, DEBUG_TAG);
+}
+
+bool
+UsdStlFileFormat::CanFieldChangeAffectFileFormatArguments(
+  const TfToken& field,
+  const VtValue& oldValue,
+  const VtValue& newValue,
+  const VtValue& dependencyContextData) const
+{
+    return true;
+}
+
 bool
 UsdStlFileFormat::CanRead(const std::string& filePath) const
 {
@@ -68,6 +88,14 @@ UsdStlFileFormat::Read(SdfLayer* layer, const std::string& resolvedPath, bool me
     std::string fileType = getFileExtension(resolvedPath, DEBUG_TAG);
     GUARD(stlModel.Populated(), "Failed opening STL file: %s \n", resolvedPath.c_str());
     GUARD(importStl(usd, stlModel), "Error translating STL to USD\n");
+    int maxFacesPerMesh = 0;
+    argReadInt(layer->GetFileFormatArguments(),
+               UsdStlFileFormatTokens->maxFacesPerMesh.GetText(),
+               maxFacesPerMesh,
+               DEBUG_TAG);
+    if (maxFacesPerMesh > 0) {
+        partitionMeshes(usd, maxFacesPerMesh);
+    }
     WriteLayerOptions layerOptions;
     GUARD(writeLayer(
             layerOptions, usd, layer, layerData, fileType, DEBUG_TAG, SdfFileFormat::_SetLayerData),
@@ -15,21 +15,41 @@ governing permissions and limitations under the License.
 #include <fileformatutils/sdfUtils.h>
 #include <pxr/base/tf/staticTokens.h>
 #include <pxr/pxr.h>
+#include <pxr/usd/pcp/dynamicFileFormatInterface.h>
 #include <pxr/usd/sdf/fileFormat.h>
 #include <string>
 #include <version.h>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
-#define USDSTL_FILE_FORMAT_TOKENS ((Id, "stl"))((Version, FILE_FORMATS_VERSION))((Target, "usd"))
+// clang-format off
+#define USDSTL_FILE_FORMAT_TOKENS \
+    ((Id, "stl")) \
+    ((Version, FILE_FORMATS_VERSION)) \
+    ((Target, "usd")) \
+    ((maxFacesPerMesh, "stlMaxFacesPerMesh"))
+// clang-format on
 TF_DECLARE_PUBLIC_TOKENS(UsdStlFileFormatTokens, USDSTL_FILE_FORMAT_TOKENS);
 TF_DECLARE_WEAK_AND_REF_PTRS(UsdStlFileFormat);
 
 /// \ingroup usdstl
 /// \brief SdfFileFormat specialization for working with stl files.
-class USDSTL_API UsdStlFileFormat : public SdfFileFormat
+class USDSTL_API UsdStlFileFormat
+  : public SdfFileFormat
+  , public PcpDynamicFileFormatInterface
 {
   public:
+    virtual void ComposeFieldsForFileFormatArguments(const std::string& assetPath,
+                                                     const PcpDynamicFileFormatContext& context,
+                                                     FileFormatArguments* args,
+                                                     VtValue* dependencyContextData) const override;
+
+    virtual bool CanFieldChangeAffectFileFormatArguments(
+      const TfToken& field,
+      const VtValue& oldValue,
+      const VtValue& newValue,
+      const VtValue& dependencyContextData) const override;
+
     virtual bool CanRead(const std::string& file) const override;
 
     virtual bool Read(SdfLayer* layer,
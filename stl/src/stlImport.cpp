@@ -12,10 +12,12 @@ governing permissions and limitations under the License.
 #include "stlImport.h"
 #include "stlModel.h"
 #include <fileformatutils/common.h>
+#include <fileformatutils/geometry.h>
 
 #include <pxr/base/gf/range3f.h>
 #include <pxr/base/gf/vec3f.h>
 #include <pxr/base/vt/array.h>
+#include <pxr/base/work/reduce.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/sdf/path.h>
@@ -61,39 +63,56 @@ importStl(UsdData& usd, const StlModel& stl)
     mesh.normals.values.resize(facetCount);
     mesh.normals.interpolation = UsdGeomTokens->uniform;
 
-    for (size_t i = 0; i < facetCount; ++i) {
-        StlFacet facet = stl.GetFacet(i);
-        StlVec3f v0 = facet.vertices[0];
-        StlVec3f v1 = facet.vertices[1];
-        StlVec3f v2 = facet.vertices[2];
-        mesh.faces[i] = 3;
-        mesh.indices[3 * i] = 3 * i;
-        mesh.indices[3 * i + 1] = 3 * i + 1;
-        mesh.indices[3 * i + 2] = 3 * i + 2;
-
-        // Store STL vertices and normals
-        mesh.points[3 * i] = GfVec3f(v0.x, v0.y, v0.z);
-        mesh.points[3 * i + 1] = GfVec3f(v1.x, v1.y, v1.z);
-        mesh.points[3 * i + 2] = GfVec3f(v2.x, v2.y, v2.z);
-
-        /*
-        // TODO: preserve original normals on import, once the same is done on export
-
-        StlNormal normal = facet.normal;
-
-        // Handle degenerate or missing normals
-        if (normal.lengthSq() < 1e-6f) {
-            normal = calculateNormalOfFacet(facet);
+    // The facets are independent of each other, so they are converted in parallel, while also
+    // reducing the bounds of the points
+    int* faces = mesh.faces.data();
+    int* indices = mesh.indices.data();
+    GfVec3f* points = mesh.points.data();
+    GfVec3f* normals = mesh.normals.values.data();
+    auto convertFacets = [&](size_t begin, size_t end, const GfRange3f& init) {
+        GfRange3f range = init;
+        for (size_t i = begin; i < end; ++i) {
+            StlFacet facet = stl.GetFacet(i);
+            StlVec3f v0 = facet.vertices[0];
+            StlVec3f v1 = facet.vertices[1];
+            StlVec3f v2 = facet.vertices[2];
+            faces[i] = 3;
+            indices[3 * i] = 3 * i;
+            indices[3 * i + 1] = 3 * i + 1;
+            indices[3 * i + 2] = 3 * i + 2;
+
+            // Store STL vertices and normals
+            points[3 * i] = GfVec3f(v0.x, v0.y, v0.z);
+            points[3 * i + 1] = GfVec3f(v1.x, v1.y, v1.z);
+            points[3 * i + 2] = GfVec3f(v2.x, v2.y, v2.z);
+            range.UnionWith(points[3 * i]);
+            range.UnionWith(points[3 * i + 1]);
+            range.UnionWith(points[3 * i + 2]);
+
+            /*
+            // TODO: preserve original normals on import, once the same is done on export
+
+            StlNormal normal = facet.normal;
+
+            // Handle degenerate or missing normals
+            if (normal.lengthSq() < 1e-6f) {
+                normal = calculateNormalOfFacet(facet);
+            }
+            */
+
+            StlNormal normal = calculateNormalOfFacet(facet);
+
+            GfVec3f usdNormal = GfVec3f(normal.x, normal.y, normal.z);
+            usdNormal.Normalize();
+
+            normals[i] = usdNormal;
         }
-        */
-
-        StlNormal normal = calculateNormalOfFacet(facet);
-
-        GfVec3f usdNormal = GfVec3f(normal.x, normal.y, normal.z);
-        usdNormal.Normalize();
-
-        mesh.normals.values[i] = usdNormal;
-    }
+        return range;
+    };
+    mesh.extent = WorkParallelReduceN(
+      GfRange3f(), facetCount, convertFacets, [](const GfRange3f& a, const GfRange3f& b) {
+          return GfRange3f::GetUnion(a, b);
+      });
 
     return true;
 }
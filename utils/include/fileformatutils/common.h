@@ -283,6 +283,8 @@ governing permissions and limitations under the License.
 /// fRest*: 1st and above (up to 3rd) orders of spherical harmonics coefficients.
 ///         There are 15 coefficients each of which is a 3D vector, and thus we
 ///         have 45 floats.
+///         They are either authored as a primvar per float, or packed into a single
+///         fRest primvar with all floats of a splat per element.
 // clang-format off
 #define ADOBE_GSPLAT_BASE_TOKENS \
     (rot) \
@@ -343,6 +345,12 @@ argComposeFloat(const PXR_NS::PcpDynamicFileFormatContext& context,
                 const PXR_NS::TfToken& token,
                 const std::string& debugTag);
 
+void USDFFUTILS_API
+argComposeInt(const PXR_NS::PcpDynamicFileFormatContext& context,
+              PXR_NS::SdfFileFormat::FileFormatArguments* args,
+              const PXR_NS::TfToken& token,
+              const std::string& debugTag);
+
 void USDFFUTILS_API
 argComposeFloatArray(const PXR_NS::PcpDynamicFileFormatContext& context,
                      PXR_NS::SdfFileFormat::FileFormatArguments* args,
@@ -367,6 +375,12 @@ argReadBool(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
             bool& target,
             const std::string& debugTag);
 
+void USDFFUTILS_API
+argReadInt(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
+           const std::string& arg,
+           int& target,
+           const std::string& debugTag);
+
 void USDFFUTILS_API
 argReadFloat(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
              const std::string& arg,
@@ -385,6 +399,12 @@ argWarnDeprecatedArg(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
                      const std::string& arg,
                      const std::string& debugTag);
 
+/// Returns the asset path of the layer read with the file format argument `arg` set to `value`,
+/// relative to the layer, so that the layer can reference itself read with other arguments.
+/// Returns an empty string if the layer has no asset.
+std::string USDFFUTILS_API
+argLayerAssetPath(const PXR_NS::SdfLayer& layer, const std::string& arg, const std::string& value);
+
 std::string USDFFUTILS_API
 getFileExtension(const std::string& filePath, const std::string& defaultValue);
 
@@ -12,6 +12,11 @@ governing permissions and limitations under the License.
 #pragma once
 #include "usdData.h"
 
+#include <pxr/base/gf/range3f.h>
+#include <pxr/base/work/reduce.h>
+
+#include <functional>
+
 namespace adobe::usd {
 
 // Struct that holds information about found issues in the scene
@@ -176,4 +181,96 @@ expandIndexedValuesIndirect(const PXR_NS::VtIntArray& vertexIndices,
 USDFFUTILS_API void
 transformMesh(Mesh& mesh, const PXR_NS::GfMatrix4d& transform);
 
+/// \ingroup utils_geometry
+/// \brief Compute the axis aligned bounding box of a set of points in parallel. Returns an empty
+/// range if there are no points.
+USDFFUTILS_API PXR_NS::GfRange3f
+computeExtent(const PXR_NS::VtVec3fArray& points);
+
+/// \ingroup utils_geometry
+/// \brief Resize the points to `count` and fill them in parallel with the values returned by
+/// `getPoint(i)`. Returns the bounds of the points, which are reduced in the same pass.
+template<typename F>
+PXR_NS::GfRange3f
+fillPoints(PXR_NS::VtVec3fArray& points, size_t count, const F& getPoint)
+{
+    points.resize(count);
+    PXR_NS::GfVec3f* dst = points.data();
+    return PXR_NS::WorkParallelReduceN(
+      PXR_NS::GfRange3f(),
+      count,
+      [&](size_t begin, size_t end, const PXR_NS::GfRange3f& init) {
+          PXR_NS::GfRange3f range = init;
+          for (size_t i = begin; i < end; i++) {
+              dst[i] = getPoint(i);
+              range.UnionWith(dst[i]);
+          }
+          return range;
+      },
+      [](const PXR_NS::GfRange3f& a, const PXR_NS::GfRange3f& b) {
+          return PXR_NS::GfRange3f::GetUnion(a, b);
+      });
+}
+
+/// \ingroup utils_geometry
+/// \brief Compute 63 bit Morton codes (21 bits per axis) for a set of positions, which are
+/// quantized relative to the given bounds. Sorting by these codes groups positions that are
+/// spatially close together.
+USDFFUTILS_API void
+computeMortonCodes(const PXR_NS::VtVec3fArray& positions,
+                   const PXR_NS::GfRange3f& bounds,
+                   std::vector<uint64_t>& codes);
+
+/// \ingroup utils_geometry
+/// \brief Split a mesh into spatially coherent chunks of at most `maxFacesPerChunk` faces each.
+/// The faces are ordered by the Morton code of their centroid and each chunk receives its own
+/// compacted points, primvars, subsets and extent. Returns false if the mesh was not partitioned,
+/// i.e. if it is small enough already, is a point cloud, is skinned, is instanced or has
+/// inconsistent topology.
+USDFFUTILS_API bool
+partitionMesh(const Mesh& mesh, size_t maxFacesPerChunk, std::vector<Mesh>& chunks);
+
+/// \ingroup utils_geometry
+/// \brief Replace all static meshes with more than `maxFacesPerChunk` faces with their
+/// partitioned chunks, which are added as sibling meshes under the same node.
+USDFFUTILS_API void
+partitionMeshes(UsdData& usd, size_t maxFacesPerChunk);
+
+/// \ingroup utils_geometry
+/// \brief Split a point cloud into `numLevels` levels of detail that are additive, i.e. the
+/// levels together hold each point exactly once. The points are sorted into an octree, and each
+/// coarse level adds one representative point to every cell of its depth that has none yet, which
+/// is the point nearest to the centroid of the cell, weighted by opacity for Gaussian splats. The
+/// finest level holds the remaining points. Fewer levels are returned if the octree is too
+/// shallow. Returns false if the mesh is not a point cloud or is too small to be split.
+USDFFUTILS_API bool
+buildPointLevels(const Mesh& mesh, size_t numLevels, std::vector<Mesh>& levels);
+
+/// \ingroup utils_geometry
+/// \brief Replace the point clouds of all nodes with their levels of detail. Each level is added
+/// as a child node `lod<k>` that is authored as a payload, so that the levels can be loaded one
+/// after the other, coarsest first. If `levelAssetPath` is given, it returns the asset that holds
+/// level k, i.e. the same asset read with `level` set to k, and each node loads its level as an
+/// external payload from that asset, so that the levels are not authored in this layer. If `level`
+/// is not negative, only that level is kept, as the content of its child node.
+USDFFUTILS_API void
+buildPointCloudLevels(UsdData& usd,
+                      size_t numLevels,
+                      int level = -1,
+                      const std::function<std::string(size_t)>& levelAssetPath = {});
+
+/// \ingroup utils_geometry
+/// \brief Reorder the points of a point cloud by the Morton code of their positions, so that
+/// points that are spatially close are also close in memory, which helps the caches of all later
+/// passes over the points and the compression of the arrays. The same permutation is applied to
+/// the widths and all per point primvars. Returns false if the mesh is not a point cloud or is
+/// skinned.
+USDFFUTILS_API bool
+sortPointsByMortonCode(Mesh& mesh);
+
+/// \ingroup utils_geometry
+/// \brief Reorder the points of all point clouds by the Morton code of their positions.
+USDFFUTILS_API void
+sortPointCloudsByMortonCode(UsdData& usd);
+
 }
@@ -13,27 +13,144 @@ governing permissions and limitations under the License.
 #include "api.h"
 
 #include "usdData.h"
+#include <array>
 #include <vector>
 
 namespace adobe::usd {
+/// Raw Gaussian splat attributes, as stored in PLY and SPZ files, that are decoded by
+/// `decodeGsplats`. Component c of point i of an attribute is read from `attribute[c][i * stride]`,
+/// which covers both interleaved and planar layouts without copies.
+struct GsplatRawAttributes
+{
+    // Zeroth-order SH coefficients of the R, G and B channels
+    std::array<const float*, 3> colors = {};
+    size_t colorStride = 1;
+    // Opacities before the sigmoid activation
+    const float* opacities = nullptr;
+    size_t opacityStride = 1;
+    // Logarithms of the scales along the three axes
+    std::array<const float*, 3> scales = {};
+    size_t scaleStride = 1;
+    // Real and imaginary parts of the rotations, which need not be normalized
+    std::array<const float*, 4> rotations = {};
+    size_t rotationStride = 1;
+    // Higher order SH coefficients in the order of the point SH coefficient sets
+    std::vector<const float*> shCoeffs;
+    size_t shCoeffStride = 1;
+};
+
+/// Decode the raw attributes of `numPoints` Gaussian splats into the colors, opacities, widths,
+/// rotations and SH coefficients of the mesh, adding the primvar sets as needed.
+///
+/// All attributes are decoded in a single parallel pass over blocks of points. The exponentials
+/// use an approximation with a relative error below 2e-7, i.e. about one float ulp, which is well
+/// below the precision at which splats are stored. Non-finite opacities are decoded as 0.
+USDFFUTILS_API void
+decodeGsplats(const GsplatRawAttributes& raw, size_t numPoints, UsdData& usd, int meshIndex);
+
+/// The arrays of the mesh that Gaussian splats are decoded into, as returned by `prepareGsplats`.
+/// The colors hold 3 values per point.
+struct GsplatDecodeTargets
+{
+    float* colors = nullptr;
+    float* opacities = nullptr;
+    std::array<float*, 3> widths = {};
+    PXR_NS::GfQuatf* rotations = nullptr;
+    std::vector<float*> shCoeffs;
+};
+
+/// Add the primvar sets for `numPoints` Gaussian splats with `numSHCoeffs` higher order SH
+/// coefficients to the mesh, and return their arrays.
+USDFFUTILS_API GsplatDecodeTargets
+prepareGsplats(size_t numPoints, size_t numSHCoeffs, UsdData& usd, int meshIndex);
+
+/// Decode the raw attributes of `count` Gaussian splats into the targets, starting at point
+/// `first` of the targets. Unlike `decodeGsplats`, the raw attributes are indexed relative to the
+/// block, so that callers can decode a block from a temporary buffer, in parallel with the other
+/// blocks.
+USDFFUTILS_API void
+decodeGsplatBlock(const GsplatRawAttributes& raw,
+                  size_t count,
+                  const GsplatDecodeTargets& targets,
+                  size_t first);
+
+/// Criteria for dropping Gaussian splats that contribute little to the rendering. Splats are kept
+/// by default, and each criterion is only applied if it is set.
+struct GsplatPruneOptions
+{
+    // Drop splats with an opacity, after the sigmoid activation, below this
+    float minOpacity = 0.0f;
+    // Drop splats whose largest scale, i.e. half of their largest width, is below this
+    float minScale = 0.0f;
+    // Drop splats whose largest scale is above this, unless it is 0
+    float maxScale = 0.0f;
+    // Drop splats whose center is outside of the clipping box of the mesh
+    bool cullToClippingBox = false;
+
+    bool enabled() const
+    {
+        return minOpacity > 0.0f || minScale > 0.0f || maxScale > 0.0f || cullToClippingBox;
+    }
+};
+
+/// Drop the Gaussian splats of the mesh that meet the criteria of the options from the points and
+/// all per point primvars, and update the extent. This is a parallel stream compaction that keeps
+/// the order of the remaining splats. Returns the number of dropped splats.
+USDFFUTILS_API size_t
+pruneGsplats(Mesh& mesh, const GsplatPruneOptions& options);
+
+/// Move the colors, opacities and higher order SH coefficients of the Gaussian splats of the mesh
+/// to its half precision sets. Each float set is released as soon as it is converted, so that only
+/// one set is held in both precisions at a time.
+USDFFUTILS_API void
+convertGsplatsToHalf(Mesh& mesh);
+
 USDFFUTILS_API size_t
 numSHDegreesFromGsplat(size_t numCoefficients);
 
 USDFFUTILS_API size_t
 numNonZeroSHBandsFromDegree(size_t numDegrees);
 
+/// Returns the number of higher order SH coefficients of Gaussian splats, over all three channels,
+/// that remain when `numCoefficients` coefficients are truncated to the bands up to `maxDegree`.
+USDFFUTILS_API size_t
+truncatedSHCoeffCount(size_t numCoefficients, int maxDegree);
+
+/// Returns the indices of the higher order SH coefficients of Gaussian splats that remain when
+/// `numCoefficients` coefficients, ordered by channel and then by band, are truncated to the bands
+/// up to `maxDegree`.
+USDFFUTILS_API std::vector<size_t>
+truncatedSHCoeffIndices(size_t numCoefficients, int maxDegree);
+
 USDFFUTILS_API void
 rotatePointRotations(const Primvar<PXR_NS::GfQuatf>& pointRotations,
                      const PXR_NS::GfQuatf& rotation,
                      size_t numPoints,
                      PXR_NS::VtQuatfArray& outPointRotations);
 
+/// Rotate the rotations of `numPoints` splats into `outPointRotations`, which holds `numPoints`
+/// values. Splats without a rotation get the identity.
+USDFFUTILS_API void
+rotatePointRotations(const Primvar<PXR_NS::GfQuatf>& pointRotations,
+                     const PXR_NS::GfQuatf& rotation,
+                     size_t numPoints,
+                     PXR_NS::GfQuatf* outPointRotations);
+
 USDFFUTILS_API void
 rotatePointSphericalHarmonics(const std::vector<Primvar<float>>& inSH,
                               const PXR_NS::GfQuatf& rotation,
                               size_t numPoints,
                               std::vector<PXR_NS::VtFloatArray>& outSH);
 
+/// Rotate the SH coefficients of `numPoints` splats into `outSH`, which holds a pointer to
+/// `numPoints` values for each output coefficient. The input and output coefficients are ordered
+/// by channel and then by band, and the bands missing from the input are set to 0.
+USDFFUTILS_API void
+rotatePointSphericalHarmonics(const std::vector<Primvar<float>>& inSH,
+                              const PXR_NS::GfQuatf& rotation,
+                              size_t numPoints,
+                              const std::vector<float*>& outSH);
+
 USDFFUTILS_API void
 scalePointWidths(const PXR_NS::VtFloatArray& inWidths,
                  const std::vector<Primvar<float>>& inExtraWidths,
@@ -42,4 +159,15 @@ scalePointWidths(const PXR_NS::VtFloatArray& inWidths,
                  PXR_NS::VtFloatArray& outWidths,
                  PXR_NS::VtFloatArray& outWidths1,
                  PXR_NS::VtFloatArray& outWidths2);
+
+/// Scale the widths of `numPoints` splats along the three axes into the output pointers, which
+/// hold `numPoints` values each. Missing widths are set to 0.
+USDFFUTILS_API void
+scalePointWidths(const PXR_NS::VtFloatArray& inWidths,
+                 const std::vector<Primvar<float>>& inExtraWidths,
+                 size_t numPoints,
+                 float widthScale,
+                 float* outWidths,
+                 float* outWidths1,
+                 float* outWidths2);
 }
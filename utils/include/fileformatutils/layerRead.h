@@ -30,6 +30,9 @@ struct USDFFUTILS_API ReadLayerOptions
     bool triangulate = false;
     bool flatten = false;
     bool ignoreInvisible = false;
+    // Read UsdGeomPointInstancers into PointInstancer structs instead of expanding every instance
+    // into its own node. For exporters that can represent instancing natively.
+    bool pointInstancers = false;
 
     // The default max for the number of mesh joints indices and weights is 4.  Specific file
     // format exporters can modify this prior to export. Setting the value to -1 means the max is
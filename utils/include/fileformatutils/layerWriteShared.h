@@ -36,6 +36,9 @@ struct WriteLayerOptions
     bool pruneJoints = false;
     bool animationTracks = false;
     bool createRenderSettingsPrim = false;
+    // Author the SH coefficients of Gaussian splats as a single primvar with all coefficients of a
+    // splat per element, instead of a primvar per coefficient
+    bool packedGsplatSHCoeffs = false;
     std::string assetsPath;
 };
 
@@ -41,6 +41,17 @@ decompress(const std::uint8_t* inputData, std::size_t inLen, std::vector<std::ui
 USDFFUTILS_API bool
 compress(const std::uint8_t* inputData, std::size_t inLen, std::vector<std::uint8_t>& outputData);
 
+/// Compress the data into a gzip stream with the zlib compression `level`, from 0 to 9, or -1 for
+/// the zlib default. With `parallel` the data is deflated in blocks on all threads, which are
+/// joined into a single stream that any gzip reader accepts, at the cost of a slightly larger
+/// output.
+USDFFUTILS_API bool
+compressGzip(const std::uint8_t* inputData,
+             std::size_t inLen,
+             int level,
+             bool parallel,
+             std::vector<std::uint8_t>& outputData);
+
 USDFFUTILS_API const char*
 getNerfExtString();
 }
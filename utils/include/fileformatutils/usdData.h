@@ -25,7 +25,9 @@ governing permissions and limitations under the License.
 #include <pxr/base/gf/matrix4d.h>
 #include <pxr/base/gf/matrix4f.h>
 #include <pxr/base/gf/quath.h>
+#include <pxr/base/gf/range3f.h>
 #include <pxr/base/gf/rotation.h>
+#include <pxr/base/gf/vec3h.h>
 #include <pxr/base/vt/array.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/usd/common.h>
@@ -84,6 +86,7 @@ struct USDFFUTILS_API Node
     int camera = -1;
     int ngp = -1;
     int light = -1;
+    int pointInstancer = -1;
     std::vector<int> nurbs = {};
     std::vector<int> staticMeshes = {};
     std::vector<std::pair<int, std::vector<int>>> skinnedMeshes = {}; // Only used during export
@@ -92,6 +95,12 @@ struct USDFFUTILS_API Node
 
     std::string path;
     bool isJoint = false;
+    // Author the content of the node in a separate prim that the node loads as a payload. If
+    // `payloadAssetPath` is set, the node loads its content from the prim of the same path in that
+    // asset instead, its content is not authored, and `payloadExtent` bounds the content.
+    bool payload = false;
+    std::string payloadAssetPath;
+    PXR_NS::GfRange3f payloadExtent;
 };
 
 /// \ingroup utils_geometry
@@ -158,6 +167,11 @@ struct USDFFUTILS_API Mesh
     std::vector<Primvar<float>> opacities;
     std::vector<Primvar<float>> pointExtraWidths;
     std::vector<Primvar<float>> pointSHCoeffs;
+    // Colors, opacities and SH coefficients of Gaussian splats in half precision, which importers
+    // can keep instead of the float sets above to halve the memory of the dominant splat data
+    std::vector<Primvar<PXR_NS::GfVec3h>> halfColors;
+    std::vector<Primvar<PXR_NS::GfHalf>> halfOpacities;
+    std::vector<Primvar<PXR_NS::GfHalf>> halfPointSHCoeffs;
     Primvar<PXR_NS::GfQuatf> pointRotations;
     PXR_NS::VtIntArray joints;
     PXR_NS::VtFloatArray weights;
@@ -172,6 +186,8 @@ struct USDFFUTILS_API Mesh
     PXR_NS::GfMatrix4d geomBindTransform = PXR_NS::GfMatrix4d(1.0);
     PXR_NS::TfToken subdivisionScheme = PXR_NS::UsdGeomTokens->none;
     Primvar<PXR_NS::GfVec3f> clippingBox;
+    // Bounds of the points. Left empty if unknown, in which case no extent is authored.
+    PXR_NS::GfRange3f extent;
 };
 
 /// \ingroup utils_geometry
@@ -232,6 +248,21 @@ struct USDFFUTILS_API NgpData
     PXR_NS::GfMatrix4d transform = PXR_NS::GfMatrix4d(1);
 };
 
+/// \ingroup utils_nodes
+/// \brief Instances of a set of prototypes, authored as a UsdGeomPointInstancer in the node that
+/// references it. Each prototype is a group of mesh indices, and each instance has a prototype
+/// index and a position, orientation and scale relative to that node. Orientations and scales are
+/// optional.
+struct USDFFUTILS_API PointInstancer
+{
+    std::string name;
+    std::vector<std::vector<int>> prototypes;
+    PXR_NS::VtIntArray protoIndices;
+    PXR_NS::VtVec3fArray positions;
+    PXR_NS::VtQuathArray orientations;
+    PXR_NS::VtVec3fArray scales;
+};
+
 /// \ingroup utils_skeletons
 struct USDFFUTILS_API SkeletonAnimation
 {
@@ -456,6 +487,7 @@ struct USDFFUTILS_API UsdData
     std::vector<Material> materials;
     std::vector<Skeleton> skeletons;
     std::vector<NgpData> ngps;
+    std::vector<PointInstancer> pointInstancers;
 
     std::pair<int, Node&> addNode(int parent);
     std::pair<int, Node&> getParent(int parent);
@@ -473,6 +505,7 @@ struct USDFFUTILS_API UsdData
     std::pair<int, Camera&> addCamera();
     std::pair<int, Skeleton&> addSkeleton();
     std::pair<int, NgpData&> addNgp();
+    std::pair<int, PointInstancer&> addPointInstancer();
 };
 
 // Returns true if the Input has a constant value of supported type
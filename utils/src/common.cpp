@@ -13,9 +13,11 @@ governing permissions and limitations under the License.
 
 #include <fileformatutils/debugCodes.h>
 
+#include <pxr/base/tf/pathUtils.h>
 #include <pxr/base/tf/token.h>
 #include <pxr/usd/ar/defaultResolver.h>
 #include <pxr/usd/ar/packageUtils.h>
+#include <pxr/usd/sdf/layer.h>
 
 #include <algorithm>
 #include <cctype>
@@ -100,6 +102,24 @@ argComposeFloat(const PXR_NS::PcpDynamicFileFormatContext& context,
     }
 }
 
+void
+argComposeInt(const PXR_NS::PcpDynamicFileFormatContext& context,
+              PXR_NS::SdfFileFormat::FileFormatArguments* args,
+              const PXR_NS::TfToken& token,
+              const std::string& debugTag)
+{
+    VtValue value;
+    if (context.ComposeValue(token, &value) && value.IsHolding<int>()) {
+        std::string val = std::to_string(value.Get<int>());
+        TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                     "%s: ComposeFileFormatArg: %s = %s\n",
+                     debugTag.c_str(),
+                     token.GetText(),
+                     val.c_str());
+        (*args)[token.GetString()] = val;
+    }
+}
+
 void
 argComposeFloatArray(const PcpDynamicFileFormatContext& context,
                      SdfFileFormat::FileFormatArguments* args,
@@ -171,6 +191,30 @@ argReadBool(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
     }
 }
 
+void
+argReadInt(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
+           const std::string& arg,
+           int& target,
+           const std::string& debugTag)
+{
+    if (const auto& it = args.find(arg); it != args.end()) {
+        try {
+            target = std::stoi(it->second);
+        } catch (const std::exception& e) {
+            TF_WARN("%s: Invalid int arg: \"%s\" = \"%s\"",
+                    debugTag.c_str(),
+                    arg.c_str(),
+                    it->second.c_str());
+            return;
+        }
+        TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                     "%s: Read int arg: \"%s\" = \"%s\"\n",
+                     debugTag.c_str(),
+                     arg.c_str(),
+                     it->second.c_str());
+    }
+}
+
 void
 argReadFloat(const PXR_NS::SdfFileFormat::FileFormatArguments& args,
              const std::string& arg,
@@ -225,6 +269,22 @@ argWarnDeprecatedArg(const SdfFileFormat::FileFormatArguments& args,
     }
 }
 
+std::string
+argLayerAssetPath(const SdfLayer& layer, const std::string& arg, const std::string& value)
+{
+    std::string path = layer.GetRealPath();
+    if (path.empty()) {
+        return std::string();
+    }
+    // The asset path is anchored to the layer, which for a file in a package is the package
+    if (ArIsPackageRelativePath(path)) {
+        path = ArSplitPackageRelativePathInner(path).second;
+    }
+    SdfFileFormat::FileFormatArguments args = layer.GetFileFormatArguments();
+    args[arg] = value;
+    return SdfLayer::CreateIdentifier("./" + TfGetBaseName(path), args);
+}
+
 std::string
 getFileExtension(const std::string& filePath, const std::string& defaultValue = "")
 {
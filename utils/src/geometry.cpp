@@ -13,6 +13,17 @@ governing permissions and limitations under the License.
 
 #include <fileformatutils/debugCodes.h>
 
+#include <pxr/base/work/loops.h>
+#include <pxr/base/work/reduce.h>
+#include <pxr/base/work/sort.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
 using namespace PXR_NS;
 
 namespace adobe::usd {
@@ -1193,4 +1204,865 @@ transformMesh(Mesh& mesh, const GfMatrix4d& modelMatrix)
     }
 }
 
+GfRange3f
+computeExtent(const VtVec3fArray& points)
+{
+    const GfVec3f* src = points.cdata();
+    return WorkParallelReduceN(
+      GfRange3f(),
+      points.size(),
+      [src](size_t begin, size_t end, const GfRange3f& init) {
+          GfRange3f range = init;
+          for (size_t i = begin; i < end; i++) {
+              range.UnionWith(src[i]);
+          }
+          return range;
+      },
+      [](const GfRange3f& a, const GfRange3f& b) { return GfRange3f::GetUnion(a, b); });
+}
+
+namespace {
+// Spread the lower 21 bits of the value so that there are two zero bits between each of them
+uint64_t
+expandMortonBits(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffff;
+    v = (v | v << 16) & 0x1f0000ff0000ff;
+    v = (v | v << 8) & 0x100f00f00f00f00f;
+    v = (v | v << 4) & 0x10c30c30c30c30c3;
+    v = (v | v << 2) & 0x1249249249249249;
+    return v;
+}
+}
+
+void
+computeMortonCodes(const VtVec3fArray& positions,
+                   const GfRange3f& bounds,
+                   std::vector<uint64_t>& codes)
+{
+    codes.resize(positions.size());
+    if (positions.empty()) {
+        return;
+    }
+    const float maxCoord = static_cast<float>((1 << 21) - 1);
+    const GfVec3f minPos = bounds.IsEmpty() ? GfVec3f(0.0f) : bounds.GetMin();
+    const GfVec3f size = bounds.IsEmpty() ? GfVec3f(0.0f) : bounds.GetSize();
+    GfVec3f scale;
+    for (int k = 0; k < 3; k++) {
+        scale[k] = size[k] > 0.0f ? maxCoord / size[k] : 0.0f;
+    }
+
+    const GfVec3f* src = positions.cdata();
+    uint64_t* dst = codes.data();
+    WorkParallelForN(positions.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            uint64_t q[3];
+            for (int k = 0; k < 3; k++) {
+                // Written so that NaNs end up at 0
+                const float v = (src[i][k] - minPos[k]) * scale[k];
+                q[k] = static_cast<uint64_t>(v > 0.0f ? std::min(v, maxCoord) : 0.0f);
+            }
+            dst[i] = expandMortonBits(q[0]) | (expandMortonBits(q[1]) << 1) |
+                     (expandMortonBits(q[2]) << 2);
+        }
+    });
+}
+
+namespace {
+// Turn a list of indices into local indices into the returned sorted list of unique indices
+void
+compactIndices(std::vector<int>& indices, std::vector<int>& uniqueIndices)
+{
+    uniqueIndices = indices;
+    std::sort(uniqueIndices.begin(), uniqueIndices.end());
+    uniqueIndices.erase(std::unique(uniqueIndices.begin(), uniqueIndices.end()),
+                        uniqueIndices.end());
+    for (int& index : indices) {
+        index = static_cast<int>(
+          std::lower_bound(uniqueIndices.begin(), uniqueIndices.end(), index) -
+          uniqueIndices.begin());
+    }
+}
+
+// Transfer the part of a primvar that is referenced by a chunk of a partitioned mesh. The maps
+// hold the source faces, face vertices and points of the chunk.
+template<typename T>
+void
+partitionPrimvar(const Primvar<T>& src,
+                 const std::vector<size_t>& faceMap,
+                 const std::vector<size_t>& faceVertexMap,
+                 const std::vector<size_t>& pointMap,
+                 Primvar<T>& dst)
+{
+    dst.interpolation = src.interpolation;
+    const std::vector<size_t>* map = nullptr;
+    if (src.interpolation == UsdGeomTokens->uniform) {
+        map = &faceMap;
+    } else if (src.interpolation == UsdGeomTokens->faceVarying) {
+        map = &faceVertexMap;
+    } else if (src.interpolation == UsdGeomTokens->vertex ||
+               src.interpolation == UsdGeomTokens->varying) {
+        map = &pointMap;
+    }
+    if (map == nullptr || src.values.empty()) {
+        // Constant primvars are shared as is
+        dst.values = src.values;
+        dst.indices = src.indices;
+        return;
+    }
+
+    const T* values = src.values.cdata();
+    const size_t valuesSize = src.values.size();
+    const size_t size = map->size();
+    if (src.indices.empty()) {
+        dst.values.resize(size);
+        T* out = dst.values.data();
+        for (size_t i = 0; i < size; i++) {
+            const size_t index = (*map)[i];
+            out[i] = values[index < valuesSize ? index : 0];
+        }
+    } else {
+        // Keep the primvar indexed, but only with the values used by this chunk
+        const int* indices = src.indices.cdata();
+        const size_t indicesSize = src.indices.size();
+        std::vector<int> localIndices(size);
+        for (size_t i = 0; i < size; i++) {
+            const size_t index = (*map)[i];
+            const int valueIndex = index < indicesSize ? indices[index] : 0;
+            localIndices[i] =
+              valueIndex >= 0 && static_cast<size_t>(valueIndex) < valuesSize ? valueIndex : 0;
+        }
+        std::vector<int> usedValues;
+        compactIndices(localIndices, usedValues);
+        dst.values.resize(usedValues.size());
+        T* out = dst.values.data();
+        for (size_t i = 0; i < usedValues.size(); i++) {
+            out[i] = values[usedValues[i]];
+        }
+        dst.indices.assign(localIndices.begin(), localIndices.end());
+    }
+}
+}
+
+bool
+partitionMesh(const Mesh& mesh, size_t maxFacesPerChunk, std::vector<Mesh>& chunks)
+{
+    chunks.clear();
+    const size_t numFaces = mesh.faces.size();
+    if (maxFacesPerChunk == 0 || numFaces <= maxFacesPerChunk || mesh.asPoints ||
+        !mesh.joints.empty() || mesh.instanceable) {
+        return false;
+    }
+
+    // Offsets of each face into the face vertex indices
+    const int* faceCounts = mesh.faces.cdata();
+    const int* indices = mesh.indices.cdata();
+    const GfVec3f* points = mesh.points.cdata();
+    const size_t numPoints = mesh.points.size();
+    std::vector<size_t> faceOffsets(numFaces + 1);
+    faceOffsets[0] = 0;
+    for (size_t i = 0; i < numFaces; i++) {
+        if (faceCounts[i] < 0) {
+            return false;
+        }
+        faceOffsets[i + 1] = faceOffsets[i] + faceCounts[i];
+    }
+    if (faceOffsets[numFaces] != mesh.indices.size()) {
+        TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                     "partitionMesh: skipping mesh %s with inconsistent topology\n",
+                     mesh.name.c_str());
+        return false;
+    }
+
+    // Face centroids, which are the basis for the spatial ordering
+    VtVec3fArray centroids(numFaces);
+    GfVec3f* centroidsData = centroids.data();
+    std::atomic<bool> validIndices(true);
+    WorkParallelForN(numFaces, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            GfVec3f centroid(0.0f);
+            for (size_t j = faceOffsets[i]; j < faceOffsets[i + 1]; j++) {
+                const int index = indices[j];
+                if (index < 0 || static_cast<size_t>(index) >= numPoints) {
+                    validIndices = false;
+                    continue;
+                }
+                centroid += points[index];
+            }
+            const int count = faceCounts[i];
+            centroidsData[i] = count > 0 ? centroid / static_cast<float>(count) : centroid;
+        }
+    });
+    if (!validIndices) {
+        TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                     "partitionMesh: skipping mesh %s with invalid indices\n",
+                     mesh.name.c_str());
+        return false;
+    }
+
+    std::vector<uint64_t> codes;
+    computeMortonCodes(centroids, computeExtent(centroids), codes);
+    std::vector<std::pair<uint64_t, int>> order(numFaces);
+    WorkParallelForN(numFaces, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            order[i] = { codes[i], static_cast<int>(i) };
+        }
+    });
+    WorkParallelSort(&order);
+
+    // Consecutive runs of faces in Morton order form the chunks. The chunk and local index of each
+    // source face are recorded to redistribute the subsets afterwards.
+    const size_t numChunks = (numFaces + maxFacesPerChunk - 1) / maxFacesPerChunk;
+    chunks.resize(numChunks);
+    std::vector<int> faceChunk(numFaces);
+    std::vector<int> faceLocal(numFaces);
+    WorkParallelForN(numChunks, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            Mesh& chunk = chunks[c];
+            const size_t first = c * maxFacesPerChunk;
+            const size_t last = std::min(first + maxFacesPerChunk, numFaces);
+
+            // Keep the original face order inside of a chunk
+            std::vector<size_t> faceMap(last - first);
+            for (size_t i = first; i < last; i++) {
+                faceMap[i - first] = static_cast<size_t>(order[i].second);
+            }
+            std::sort(faceMap.begin(), faceMap.end());
+
+            const size_t chunkFaces = faceMap.size();
+            std::vector<size_t> faceVertexMap;
+            chunk.faces.resize(chunkFaces);
+            for (size_t f = 0; f < chunkFaces; f++) {
+                const size_t srcFace = faceMap[f];
+                chunk.faces[f] = faceCounts[srcFace];
+                for (size_t j = faceOffsets[srcFace]; j < faceOffsets[srcFace + 1]; j++) {
+                    faceVertexMap.push_back(j);
+                }
+                faceChunk[srcFace] = static_cast<int>(c);
+                faceLocal[srcFace] = static_cast<int>(f);
+            }
+
+            std::vector<int> localIndices(faceVertexMap.size());
+            for (size_t i = 0; i < faceVertexMap.size(); i++) {
+                localIndices[i] = indices[faceVertexMap[i]];
+            }
+            std::vector<int> usedPoints;
+            compactIndices(localIndices, usedPoints);
+            chunk.indices.assign(localIndices.begin(), localIndices.end());
+            std::vector<size_t> pointMap(usedPoints.begin(), usedPoints.end());
+            chunk.points.resize(pointMap.size());
+            for (size_t i = 0; i < pointMap.size(); i++) {
+                chunk.points[i] = points[pointMap[i]];
+                chunk.extent.UnionWith(chunk.points[i]);
+            }
+
+            partitionPrimvar(mesh.normals, faceMap, faceVertexMap, pointMap, chunk.normals);
+            partitionPrimvar(mesh.tangents, faceMap, faceVertexMap, pointMap, chunk.tangents);
+            partitionPrimvar(mesh.bitangents, faceMap, faceVertexMap, pointMap, chunk.bitangents);
+            partitionPrimvar(mesh.uvs, faceMap, faceVertexMap, pointMap, chunk.uvs);
+            chunk.extraUVSets.resize(mesh.extraUVSets.size());
+            for (size_t i = 0; i < mesh.extraUVSets.size(); i++) {
+                partitionPrimvar(
+                  mesh.extraUVSets[i], faceMap, faceVertexMap, pointMap, chunk.extraUVSets[i]);
+            }
+            chunk.colors.resize(mesh.colors.size());
+            for (size_t i = 0; i < mesh.colors.size(); i++) {
+                partitionPrimvar(mesh.colors[i], faceMap, faceVertexMap, pointMap, chunk.colors[i]);
+            }
+            chunk.opacities.resize(mesh.opacities.size());
+            for (size_t i = 0; i < mesh.opacities.size(); i++) {
+                partitionPrimvar(
+                  mesh.opacities[i], faceMap, faceVertexMap, pointMap, chunk.opacities[i]);
+            }
+
+            chunk.name = mesh.name + "_" + std::to_string(c);
+            chunk.displayName = mesh.displayName;
+            chunk.markedInvisible = mesh.markedInvisible;
+            chunk.material = mesh.material;
+            chunk.doubleSided = mesh.doubleSided;
+            chunk.isRigid = mesh.isRigid;
+            chunk.geomBindTransform = mesh.geomBindTransform;
+            chunk.subdivisionScheme = mesh.subdivisionScheme;
+        }
+    });
+
+    // Redistribute the subsets over the chunks, dropping the ones that end up empty
+    for (const Subset& subset : mesh.subsets) {
+        std::vector<Subset> chunkSubsets(numChunks);
+        for (int face : subset.faces) {
+            if (face < 0 || static_cast<size_t>(face) >= numFaces) {
+                continue;
+            }
+            chunkSubsets[faceChunk[face]].faces.push_back(faceLocal[face]);
+        }
+        for (size_t c = 0; c < numChunks; c++) {
+            Subset& chunkSubset = chunkSubsets[c];
+            if (chunkSubset.faces.empty()) {
+                continue;
+            }
+            chunkSubset.material = subset.material;
+            // The face vertex indices of the subset are only kept if the source had them
+            if (!subset.indices.empty()) {
+                computeFaceVertexIndicesForSubset(
+                  chunks[c].faces, chunks[c].indices, chunkSubset.faces, chunkSubset.indices);
+            }
+            chunks[c].subsets.push_back(std::move(chunkSubset));
+        }
+    }
+
+    return true;
+}
+
+void
+partitionMeshes(UsdData& usd, size_t maxFacesPerChunk)
+{
+    if (maxFacesPerChunk == 0) {
+        return;
+    }
+    std::unordered_map<int, std::vector<int>> partitionedMeshes;
+    const size_t numMeshes = usd.meshes.size();
+    for (size_t i = 0; i < numMeshes; i++) {
+        std::vector<Mesh> chunks;
+        if (!partitionMesh(usd.meshes[i], maxFacesPerChunk, chunks)) {
+            continue;
+        }
+        TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                     "partitionMeshes: split mesh %s with %zu faces into %zu chunks\n",
+                     usd.meshes[i].name.c_str(),
+                     usd.meshes[i].faces.size(),
+                     chunks.size());
+        // The source mesh is no longer referenced, so release its data
+        usd.meshes[i] = Mesh();
+        std::vector<int>& chunkIndices = partitionedMeshes[static_cast<int>(i)];
+        for (Mesh& chunk : chunks) {
+            auto [chunkIndex, chunkMesh] = usd.addMesh();
+            chunkMesh = std::move(chunk);
+            chunkIndices.push_back(chunkIndex);
+        }
+    }
+    if (partitionedMeshes.empty()) {
+        return;
+    }
+
+    for (Node& node : usd.nodes) {
+        std::vector<int> staticMeshes;
+        for (int meshIndex : node.staticMeshes) {
+            const auto it = partitionedMeshes.find(meshIndex);
+            if (it == partitionedMeshes.end()) {
+                staticMeshes.push_back(meshIndex);
+            } else {
+                staticMeshes.insert(staticMeshes.end(), it->second.begin(), it->second.end());
+            }
+        }
+        node.staticMeshes = std::move(staticMeshes);
+    }
+}
+
+namespace {
+// Gather the values at the indices of the map in parallel. Indices past the end of the source
+// pick its first value.
+template<typename T>
+void
+gatherValues(const VtArray<T>& src, const std::vector<size_t>& map, VtArray<T>& dst)
+{
+    dst.resize(map.size());
+    const T* values = src.cdata();
+    const size_t valuesSize = src.size();
+    T* out = dst.data();
+    WorkParallelForN(map.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            out[i] = values[map[i] < valuesSize ? map[i] : 0];
+        }
+    });
+}
+
+// Gather the values of a vertex primvar of a point cloud for the points of a level. Primvars of
+// other interpolations are shared as is.
+template<typename T>
+void
+gatherPointPrimvar(const Primvar<T>& src, const std::vector<size_t>& pointMap, Primvar<T>& dst)
+{
+    const bool perPoint = src.interpolation == UsdGeomTokens->vertex ||
+                          src.interpolation == UsdGeomTokens->varying;
+    if (!perPoint || !src.indices.empty() || src.values.empty()) {
+        static const std::vector<size_t> noMap;
+        partitionPrimvar(src, noMap, noMap, pointMap, dst);
+        return;
+    }
+    dst.interpolation = src.interpolation;
+    dst.indices.clear();
+    gatherValues(src.values, pointMap, dst.values);
+}
+}
+
+bool
+buildPointLevels(const Mesh& mesh, size_t numLevels, std::vector<Mesh>& levels)
+{
+    levels.clear();
+    const size_t numPoints = mesh.points.size();
+    if (!mesh.asPoints || mesh.instanceable || !mesh.joints.empty() || numLevels < 2 ||
+        numPoints < 2 * numLevels) {
+        return false;
+    }
+
+    // Sorted by Morton code, the points of each cell of an octree over the points are consecutive,
+    // at every depth of the octree
+    std::vector<uint64_t> codes;
+    computeMortonCodes(mesh.points, computeExtent(mesh.points), codes);
+    std::vector<std::pair<uint64_t, size_t>> order(numPoints);
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            order[i] = { codes[i], i };
+        }
+    });
+    WorkParallelSort(&order);
+
+    // The codes have 21 bits per axis, so the octree has 22 depths. Consecutive points are in
+    // different cells from the depth of the highest bit in which their codes differ.
+    constexpr int maxDepth = 21;
+    auto cellShift = [](int depth) { return 3 * (maxDepth - depth); };
+    using DepthCounts = std::array<size_t, maxDepth + 1>;
+    const DepthCounts splits = WorkParallelReduceN(
+      DepthCounts{},
+      numPoints - 1,
+      [&](size_t begin, size_t end, const DepthCounts& init) {
+          DepthCounts counts = init;
+          for (size_t i = begin; i < end; i++) {
+              const uint64_t diff = order[i].first ^ order[i + 1].first;
+              if (diff) {
+                  int highestBit = 63;
+                  while (!(diff >> highestBit)) {
+                      highestBit--;
+                  }
+                  counts[maxDepth - highestBit / 3]++;
+              }
+          }
+          return counts;
+      },
+      [](const DepthCounts& a, const DepthCounts& b) {
+          DepthCounts counts;
+          for (size_t d = 0; d < counts.size(); d++) {
+              counts[d] = a[d] + b[d];
+          }
+          return counts;
+      });
+    // Every cell holds exactly one representative of its own or a coarser depth, so the coarse
+    // levels together hold as many points as there are cells at the depth of the finest of them.
+    // That depth is chosen so that they hold at most an eighth of the points.
+    DepthCounts numCells;
+    size_t cells = 1;
+    for (int d = 0; d <= maxDepth; d++) {
+        cells += splits[d];
+        numCells[d] = cells;
+    }
+    int finestDepth = 0;
+    while (finestDepth < maxDepth && numCells[finestDepth + 1] <= numPoints / 8) {
+        finestDepth++;
+    }
+    const int coarsestDepth = std::max(0, finestDepth - static_cast<int>(numLevels) + 2);
+    numLevels = static_cast<size_t>(finestDepth - coarsestDepth) + 2;
+
+    // Gaussian splats are represented by the splat nearest to the centroid of the cell, weighted
+    // by opacity, so that faint splats don't pull it away from the visible ones
+    const float* weights = nullptr;
+    std::vector<float> halfWeights;
+    if (mesh.asGsplats && !mesh.opacities.empty() && mesh.opacities[0].indices.empty() &&
+        mesh.opacities[0].values.size() == numPoints) {
+        weights = mesh.opacities[0].values.cdata();
+    } else if (mesh.asGsplats && !mesh.halfOpacities.empty() &&
+               mesh.halfOpacities[0].indices.empty() &&
+               mesh.halfOpacities[0].values.size() == numPoints) {
+        halfWeights.assign(mesh.halfOpacities[0].values.cbegin(),
+                           mesh.halfOpacities[0].values.cend());
+        weights = halfWeights.data();
+    }
+
+    // The level of each point in Morton order, with the finest level for the remaining points
+    const GfVec3f* points = mesh.points.cdata();
+    const uint8_t finestLevel = static_cast<uint8_t>(numLevels - 1);
+    std::vector<uint8_t> pointLevels(numPoints, finestLevel);
+    constexpr size_t blockSize = 4096;
+    const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+    for (size_t level = 0; level + 1 < numLevels; level++) {
+        const int shift = cellShift(coarsestDepth + static_cast<int>(level));
+        auto cellOf = [&](size_t i) { return order[i].first >> shift; };
+        // Each block handles the cells that start in it, which may extend into the next blocks
+        WorkParallelForN(numBlocks, [&](size_t beginBlock, size_t endBlock) {
+            size_t first = beginBlock * blockSize;
+            const size_t blocksEnd = std::min(endBlock * blockSize, numPoints);
+            while (first > 0 && first < blocksEnd && cellOf(first) == cellOf(first - 1)) {
+                first++;
+            }
+            while (first < blocksEnd) {
+                const uint64_t cell = cellOf(first);
+                size_t last = first + 1;
+                while (last < numPoints && cellOf(last) == cell) {
+                    last++;
+                }
+                bool covered = false;
+                GfVec3d centroid(0.0);
+                double totalWeight = 0.0;
+                for (size_t i = first; i < last && !covered; i++) {
+                    covered = pointLevels[i] != finestLevel;
+                    const size_t index = order[i].second;
+                    const double weight = weights ? std::max(weights[index], 0.0f) : 1.0f;
+                    centroid += GfVec3d(points[index]) * weight;
+                    totalWeight += weight;
+                }
+                if (!covered) {
+                    if (totalWeight > 0.0) {
+                        centroid /= totalWeight;
+                    } else {
+                        centroid = GfVec3d(points[order[first].second]);
+                    }
+                    size_t nearest = first;
+                    double nearestDistance = std::numeric_limits<double>::max();
+                    for (size_t i = first; i < last; i++) {
+                        const double distance =
+                          (GfVec3d(points[order[i].second]) - centroid).GetLengthSq();
+                        if (distance < nearestDistance) {
+                            nearest = i;
+                            nearestDistance = distance;
+                        }
+                    }
+                    pointLevels[nearest] = static_cast<uint8_t>(level);
+                }
+                first = last;
+            }
+        });
+    }
+
+    // Scatter the points to their levels, keeping the Morton order within each level
+    std::vector<size_t> blockOffsets(numBlocks * numLevels, 0);
+    WorkParallelForN(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            for (size_t i = b * blockSize; i < std::min((b + 1) * blockSize, numPoints); i++) {
+                blockOffsets[b * numLevels + pointLevels[i]]++;
+            }
+        }
+    });
+    std::vector<std::vector<size_t>> pointMaps(numLevels);
+    for (size_t level = 0; level < numLevels; level++) {
+        size_t count = 0;
+        for (size_t b = 0; b < numBlocks; b++) {
+            const size_t blockCount = blockOffsets[b * numLevels + level];
+            blockOffsets[b * numLevels + level] = count;
+            count += blockCount;
+        }
+        pointMaps[level].resize(count);
+    }
+    WorkParallelForN(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            for (size_t i = b * blockSize; i < std::min((b + 1) * blockSize, numPoints); i++) {
+                size_t& offset = blockOffsets[b * numLevels + pointLevels[i]];
+                pointMaps[pointLevels[i]][offset++] = order[i].second;
+            }
+        }
+    });
+
+    levels.resize(numLevels);
+    for (size_t level = 0; level < numLevels; level++) {
+        const std::vector<size_t>& pointMap = pointMaps[level];
+        Mesh& lod = levels[level];
+        lod.points.resize(pointMap.size());
+        GfVec3f* lodPoints = lod.points.data();
+        WorkParallelForN(pointMap.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                lodPoints[i] = points[pointMap[i]];
+            }
+        });
+        lod.extent = computeExtent(lod.points);
+        if (mesh.pointWidths.size() == numPoints) {
+            lod.pointWidths.resize(pointMap.size());
+            for (size_t i = 0; i < pointMap.size(); i++) {
+                lod.pointWidths[i] = mesh.pointWidths[pointMap[i]];
+            }
+        } else {
+            lod.pointWidths = mesh.pointWidths;
+        }
+        gatherPointPrimvar(mesh.normals, pointMap, lod.normals);
+        gatherPointPrimvar(mesh.uvs, pointMap, lod.uvs);
+        gatherPointPrimvar(mesh.pointRotations, pointMap, lod.pointRotations);
+        auto gatherSets = [&](const auto& srcSets, auto& dstSets) {
+            dstSets.resize(srcSets.size());
+            for (size_t i = 0; i < srcSets.size(); i++) {
+                gatherPointPrimvar(srcSets[i], pointMap, dstSets[i]);
+            }
+        };
+        gatherSets(mesh.colors, lod.colors);
+        gatherSets(mesh.opacities, lod.opacities);
+        gatherSets(mesh.pointExtraWidths, lod.pointExtraWidths);
+        gatherSets(mesh.pointSHCoeffs, lod.pointSHCoeffs);
+        gatherSets(mesh.halfColors, lod.halfColors);
+        gatherSets(mesh.halfOpacities, lod.halfOpacities);
+        gatherSets(mesh.halfPointSHCoeffs, lod.halfPointSHCoeffs);
+
+        lod.name = mesh.name + "_lod" + std::to_string(level);
+        lod.displayName = mesh.displayName;
+        lod.markedInvisible = mesh.markedInvisible;
+        lod.material = mesh.material;
+        lod.asPoints = true;
+        lod.asGsplats = mesh.asGsplats;
+        lod.clippingBox = mesh.clippingBox;
+    }
+    return true;
+}
+
+namespace {
+// Remove the meshes at the given indices and remap the mesh indices of the nodes and point
+// instancers to the remaining meshes
+void
+eraseMeshes(UsdData& usd, const std::vector<int>& erasedMeshes)
+{
+    if (erasedMeshes.empty()) {
+        return;
+    }
+    std::vector<int> remap(usd.meshes.size(), 0);
+    for (int meshIndex : erasedMeshes) {
+        remap[meshIndex] = -1;
+    }
+    int numMeshes = 0;
+    for (size_t i = 0; i < usd.meshes.size(); i++) {
+        if (remap[i] >= 0) {
+            remap[i] = numMeshes;
+            if (numMeshes != static_cast<int>(i)) {
+                usd.meshes[numMeshes] = std::move(usd.meshes[i]);
+            }
+            numMeshes++;
+        }
+    }
+    usd.meshes.resize(numMeshes);
+
+    auto remapIndices = [&](std::vector<int>& meshIndices) {
+        std::vector<int> remapped;
+        remapped.reserve(meshIndices.size());
+        for (int meshIndex : meshIndices) {
+            if (remap[meshIndex] >= 0) {
+                remapped.push_back(remap[meshIndex]);
+            }
+        }
+        meshIndices = std::move(remapped);
+    };
+    for (Node& node : usd.nodes) {
+        remapIndices(node.staticMeshes);
+        for (auto& [skeletonIndex, meshIndices] : node.skinnedMeshes) {
+            remapIndices(meshIndices);
+        }
+    }
+    for (PointInstancer& pointInstancer : usd.pointInstancers) {
+        for (std::vector<int>& prototype : pointInstancer.prototypes) {
+            remapIndices(prototype);
+        }
+    }
+}
+}
+
+void
+buildPointCloudLevels(UsdData& usd,
+                      size_t numLevels,
+                      int level,
+                      const std::function<std::string(size_t)>& levelAssetPath)
+{
+    if (numLevels < 2) {
+        return;
+    }
+    std::vector<int> splitMeshes;
+    const size_t numNodes = usd.nodes.size();
+    for (size_t n = 0; n < numNodes; n++) {
+        std::vector<int> staticMeshes;
+        std::vector<std::vector<Mesh>> nodeLevels;
+        for (int meshIndex : usd.nodes[n].staticMeshes) {
+            std::vector<Mesh> levels;
+            if (buildPointLevels(usd.meshes[meshIndex], numLevels, levels)) {
+                TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                             "buildPointCloudLevels: split points %s into %zu levels\n",
+                             usd.meshes[meshIndex].name.c_str(),
+                             levels.size());
+                // The source points are no longer referenced, so release their data
+                usd.meshes[meshIndex] = Mesh();
+                splitMeshes.push_back(meshIndex);
+                nodeLevels.push_back(std::move(levels));
+            } else {
+                staticMeshes.push_back(meshIndex);
+            }
+        }
+        if (nodeLevels.empty()) {
+            continue;
+        }
+        usd.nodes[n].staticMeshes = std::move(staticMeshes);
+        // Each level becomes a child node, so that viewers can load the levels one after the
+        // other. The levels of multiple point clouds of the node share the child node of their
+        // level. All child nodes are added in every mode, so that the paths of their prims match
+        // between the layer of all levels and the layers of the single levels.
+        const size_t maxLevels = std::max_element(nodeLevels.begin(),
+                                                  nodeLevels.end(),
+                                                  [](const auto& a, const auto& b) {
+                                                      return a.size() < b.size();
+                                                  })
+                                   ->size();
+        for (size_t k = 0; k < maxLevels; k++) {
+            auto [levelNodeIndex, levelNode] = usd.addNode(static_cast<int>(n));
+            levelNode.name = "lod" + std::to_string(k);
+            levelNode.worldTransform = usd.nodes[n].worldTransform;
+            const std::string assetPath =
+              level < 0 && levelAssetPath ? levelAssetPath(k) : std::string();
+            if (level >= 0) {
+                // Only the requested level is read, which is the content of its node
+                if (k != static_cast<size_t>(level)) {
+                    continue;
+                }
+            } else if (!assetPath.empty()) {
+                // The level is loaded from the asset read for that level, only its bounds are
+                // needed here
+                levelNode.payload = true;
+                levelNode.payloadAssetPath = assetPath;
+                for (const std::vector<Mesh>& levels : nodeLevels) {
+                    if (k < levels.size()) {
+                        levelNode.payloadExtent.UnionWith(levels[k].extent);
+                    }
+                }
+                continue;
+            } else {
+                levelNode.payload = true;
+            }
+            for (std::vector<Mesh>& levels : nodeLevels) {
+                if (k < levels.size()) {
+                    auto [levelMeshIndex, levelMesh] = usd.addMesh();
+                    levelMesh = std::move(levels[k]);
+                    usd.nodes[levelNodeIndex].staticMeshes.push_back(levelMeshIndex);
+                }
+            }
+        }
+    }
+    // Remove the emptied source meshes, so that they don't linger in the data
+    eraseMeshes(usd, splitMeshes);
+}
+
+namespace {
+// Sort the indices of the keys by the lower `numBits` bits of the keys, with a parallel least
+// significant digit radix sort, which is stable. Each pass counts the digits of blocks of keys in
+// parallel, and the prefix sums of the counts give each block the output positions of its keys,
+// to which the blocks then scatter their keys in parallel.
+void
+radixSortIndices(const std::vector<uint64_t>& keys, int numBits, std::vector<size_t>& order)
+{
+    constexpr int digitBits = 8;
+    constexpr size_t numDigits = size_t(1) << digitBits;
+    constexpr size_t blockSize = 1 << 16;
+    const size_t numKeys = keys.size();
+    const size_t numBlocks = (numKeys + blockSize - 1) / blockSize;
+    std::vector<uint64_t> srcKeys(keys);
+    std::vector<uint64_t> dstKeys(numKeys);
+    std::vector<size_t> srcOrder(numKeys);
+    std::vector<size_t> dstOrder(numKeys);
+    WorkParallelForN(numKeys, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            srcOrder[i] = i;
+        }
+    });
+    std::vector<size_t> offsets(numBlocks * numDigits);
+    for (int shift = 0; shift < numBits; shift += digitBits) {
+        WorkParallelForN(numBlocks, [&](size_t beginBlock, size_t endBlock) {
+            for (size_t b = beginBlock; b < endBlock; b++) {
+                size_t* counts = offsets.data() + b * numDigits;
+                std::fill(counts, counts + numDigits, 0);
+                const size_t last = std::min((b + 1) * blockSize, numKeys);
+                for (size_t i = b * blockSize; i < last; i++) {
+                    counts[(srcKeys[i] >> shift) & (numDigits - 1)]++;
+                }
+            }
+        });
+        // The keys of a digit follow those of the smaller digits, and within a digit the keys of
+        // a block follow those of the previous blocks. Passes in which all keys have the same
+        // digit keep the order.
+        size_t offset = 0;
+        bool sameDigit = false;
+        for (size_t d = 0; d < numDigits; d++) {
+            const size_t digitOffset = offset;
+            for (size_t b = 0; b < numBlocks; b++) {
+                const size_t count = offsets[b * numDigits + d];
+                offsets[b * numDigits + d] = offset;
+                offset += count;
+            }
+            sameDigit = sameDigit || offset - digitOffset == numKeys;
+        }
+        if (sameDigit) {
+            continue;
+        }
+        WorkParallelForN(numBlocks, [&](size_t beginBlock, size_t endBlock) {
+            for (size_t b = beginBlock; b < endBlock; b++) {
+                size_t* positions = offsets.data() + b * numDigits;
+                const size_t last = std::min((b + 1) * blockSize, numKeys);
+                for (size_t i = b * blockSize; i < last; i++) {
+                    const size_t position = positions[(srcKeys[i] >> shift) & (numDigits - 1)]++;
+                    dstKeys[position] = srcKeys[i];
+                    dstOrder[position] = srcOrder[i];
+                }
+            }
+        });
+        srcKeys.swap(dstKeys);
+        srcOrder.swap(dstOrder);
+    }
+    order = std::move(srcOrder);
+}
+}
+
+bool
+sortPointsByMortonCode(Mesh& mesh)
+{
+    const size_t numPoints = mesh.points.size();
+    if (!mesh.asPoints || !mesh.joints.empty() || numPoints < 2) {
+        return false;
+    }
+    std::vector<uint64_t> codes;
+    computeMortonCodes(mesh.points, computeExtent(mesh.points), codes);
+    // The codes have 21 bits per axis
+    std::vector<size_t> order;
+    radixSortIndices(codes, 63, order);
+    codes = std::vector<uint64_t>();
+
+    VtVec3fArray points;
+    gatherValues(mesh.points, order, points);
+    mesh.points = std::move(points);
+    if (mesh.pointWidths.size() == numPoints) {
+        VtFloatArray widths;
+        gatherValues(mesh.pointWidths, order, widths);
+        mesh.pointWidths = std::move(widths);
+    }
+    auto reorder = [&](auto& primvar) {
+        std::remove_reference_t<decltype(primvar)> reordered;
+        gatherPointPrimvar(primvar, order, reordered);
+        primvar = std::move(reordered);
+    };
+    auto reorderSets = [&](auto& primvars) {
+        for (auto& primvar : primvars) {
+            reorder(primvar);
+        }
+    };
+    reorder(mesh.normals);
+    reorder(mesh.uvs);
+    reorder(mesh.pointRotations);
+    reorderSets(mesh.colors);
+    reorderSets(mesh.opacities);
+    reorderSets(mesh.pointExtraWidths);
+    reorderSets(mesh.pointSHCoeffs);
+    reorderSets(mesh.halfColors);
+    reorderSets(mesh.halfOpacities);
+    reorderSets(mesh.halfPointSHCoeffs);
+    return true;
+}
+
+void
+sortPointCloudsByMortonCode(UsdData& usd)
+{
+    for (Mesh& mesh : usd.meshes) {
+        if (sortPointsByMortonCode(mesh)) {
+            TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                         "sortPointCloudsByMortonCode: sorted %zu points of %s\n",
+                         mesh.points.size(),
+                         mesh.name.c_str());
+        }
+    }
+}
 }
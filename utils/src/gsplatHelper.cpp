@@ -11,13 +11,326 @@ governing permissions and limitations under the License.
 */
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <fileformatutils/geometry.h>
 #include <fileformatutils/gsplatHelper.h>
+#include <limits>
+#include <type_traits>
+#include <pxr/base/gf/limits.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/usdGeom/tokens.h>
 #include <sh/spherical_harmonics.h>
 
 using namespace PXR_NS;
 
 namespace adobe::usd {
+namespace {
+// Number of points that are decoded at once. The loops over the points of a block get vectorized,
+// while the attributes of the block stay in the cache.
+constexpr size_t gsplatBlockSize = 1024;
+
+// exp(x) computed as 2^n * exp(r) with |r| <= ln(2)/2 and the polynomial approximation of the
+// Cephes library, which has a relative error below 2e-7 for x in [-87, 88]. Inputs outside of
+// that range, including NaN, are clamped to it. Only plain arithmetic and bit casts are used, so
+// that the loops calling it are vectorized by the compiler.
+inline float
+fastExp(float x)
+{
+    x = x > -87.0f ? x : -87.0f;
+    x = x < 88.0f ? x : 88.0f;
+    // Round to nearest by adding and subtracting 1.5 * 2^23
+    const float n = (x * 1.44269504088896341f + 12582912.0f) - 12582912.0f;
+    // Reduce the range with ln(2) split in two parts to keep the precision
+    const float r = (x - n * 0.693359375f) + n * 2.12194440e-4f;
+    const float p =
+      ((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r +
+        4.1665795894e-2f) *
+         r +
+       1.6666665459e-1f) *
+        r +
+      5.0000001201e-1f;
+    const float expR = p * r * r + r + 1.0f;
+    const std::int32_t bits = (static_cast<std::int32_t>(n) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(float));
+    return expR * scale;
+}
+
+// The 0th-order coefficient of spherical harmonics, which is 1/sqrt(4*pi).
+constexpr float shC0 = 0.28209479177387814f;
+}
+
+GsplatDecodeTargets
+prepareGsplats(size_t numPoints, size_t numSHCoeffs, UsdData& usd, int meshIndex)
+{
+    // Add all the primvar sets first, since adding sets can move the previous ones
+    const int colorIndex = usd.addColorSet(meshIndex).first;
+    const int opacityIndex = usd.addOpacitySet(meshIndex).first;
+    const int widths1Index = usd.addExtraPointWidthSet(meshIndex).first;
+    const int widths2Index = usd.addExtraPointWidthSet(meshIndex).first;
+    std::vector<int> shCoeffIndices;
+    shCoeffIndices.reserve(numSHCoeffs);
+    for (size_t i = 0; i < numSHCoeffs; i++) {
+        shCoeffIndices.push_back(usd.addPointSHCoeffSet(meshIndex).first);
+    }
+
+    Mesh& mesh = usd.meshes[meshIndex];
+    auto preparePrimvar = [numPoints](auto& primvar) {
+        primvar.interpolation = UsdGeomTokens->vertex;
+        primvar.values.resize(numPoints);
+        return primvar.values.data();
+    };
+    GsplatDecodeTargets targets;
+    targets.colors = reinterpret_cast<float*>(preparePrimvar(mesh.colors[colorIndex]));
+    targets.opacities = preparePrimvar(mesh.opacities[opacityIndex]);
+    mesh.pointWidths.resize(numPoints);
+    targets.widths = { mesh.pointWidths.data(),
+                       preparePrimvar(mesh.pointExtraWidths[widths1Index]),
+                       preparePrimvar(mesh.pointExtraWidths[widths2Index]) };
+    targets.rotations = preparePrimvar(mesh.pointRotations);
+    targets.shCoeffs.reserve(shCoeffIndices.size());
+    for (int shCoeffIndex : shCoeffIndices) {
+        targets.shCoeffs.push_back(preparePrimvar(mesh.pointSHCoeffs[shCoeffIndex]));
+    }
+    return targets;
+}
+
+void
+decodeGsplatBlock(const GsplatRawAttributes& raw,
+                  size_t count,
+                  const GsplatDecodeTargets& targets,
+                  size_t first)
+{
+    for (size_t c = 0; c < 3; c++) {
+        const float* src = raw.colors[c];
+        const size_t stride = raw.colorStride;
+        float* dst = targets.colors + first * 3;
+        for (size_t i = 0; i < count; i++) {
+            dst[i * 3 + c] = src[i * stride] * shC0 + 0.5f;
+        }
+    }
+    {
+        const float* src = raw.opacities;
+        const size_t stride = raw.opacityStride;
+        float* dst = targets.opacities + first;
+        for (size_t i = 0; i < count; i++) {
+            // Non-finite opacities, which are NaN in some files, are set to 0
+            const float op = src[i * stride];
+            dst[i] = std::fabs(op) <= std::numeric_limits<float>::max()
+                       ? 1.0f / (1.0f + fastExp(-op))
+                       : 0.0f;
+        }
+    }
+    for (size_t c = 0; c < 3; c++) {
+        const float* src = raw.scales[c];
+        const size_t stride = raw.scaleStride;
+        float* dst = targets.widths[c] + first;
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = fastExp(src[i * stride]) * 2.0f;
+        }
+    }
+    {
+        const size_t stride = raw.rotationStride;
+        GfQuatf* dst = targets.rotations + first;
+        for (size_t i = 0; i < count; i++) {
+            const float w = raw.rotations[0][i * stride];
+            const float x = raw.rotations[1][i * stride];
+            const float y = raw.rotations[2][i * stride];
+            const float z = raw.rotations[3][i * stride];
+            // Same as GfQuatf::GetNormalized()
+            const float length = std::sqrt(w * w + x * x + y * y + z * z);
+            if (length < GF_MIN_VECTOR_LENGTH) {
+                dst[i] = GfQuatf::GetIdentity();
+            } else {
+                const float scale = 1.0f / length;
+                dst[i] = GfQuatf(w * scale, x * scale, y * scale, z * scale);
+            }
+        }
+    }
+    const size_t numSHCoeffs = std::min(raw.shCoeffs.size(), targets.shCoeffs.size());
+    for (size_t k = 0; k < numSHCoeffs; k++) {
+        const float* src = raw.shCoeffs[k];
+        const size_t stride = raw.shCoeffStride;
+        float* dst = targets.shCoeffs[k] + first;
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = src[i * stride];
+        }
+    }
+}
+
+void
+decodeGsplats(const GsplatRawAttributes& raw, size_t numPoints, UsdData& usd, int meshIndex)
+{
+    const GsplatDecodeTargets targets =
+      prepareGsplats(numPoints, raw.shCoeffs.size(), usd, meshIndex);
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        GsplatRawAttributes block = raw;
+        for (size_t first = begin; first < end; first += gsplatBlockSize) {
+            // The raw attributes of the block start at its first point
+            for (size_t c = 0; c < 3; c++) {
+                block.colors[c] = raw.colors[c] + first * raw.colorStride;
+                block.scales[c] = raw.scales[c] + first * raw.scaleStride;
+            }
+            block.opacities = raw.opacities + first * raw.opacityStride;
+            for (size_t c = 0; c < 4; c++) {
+                block.rotations[c] = raw.rotations[c] + first * raw.rotationStride;
+            }
+            for (size_t k = 0; k < raw.shCoeffs.size(); k++) {
+                block.shCoeffs[k] = raw.shCoeffs[k] + first * raw.shCoeffStride;
+            }
+            decodeGsplatBlock(block, std::min(gsplatBlockSize, end - first), targets, first);
+        }
+    });
+}
+
+size_t
+pruneGsplats(Mesh& mesh, const GsplatPruneOptions& options)
+{
+    const size_t numPoints = mesh.points.size();
+    if (!mesh.asGsplats || numPoints == 0 || !options.enabled()) {
+        return 0;
+    }
+    auto perPoint = [numPoints](const auto& primvar) {
+        return primvar.indices.empty() && primvar.values.size() == numPoints &&
+               (primvar.interpolation == UsdGeomTokens->vertex ||
+                primvar.interpolation == UsdGeomTokens->varying);
+    };
+    const float* opacities = nullptr;
+    if (options.minOpacity > 0.0f && !mesh.opacities.empty() && perPoint(mesh.opacities[0])) {
+        opacities = mesh.opacities[0].values.cdata();
+    }
+    // The widths along the three axes, which are twice the scales
+    std::vector<const float*> widths;
+    if (options.minScale > 0.0f || options.maxScale > 0.0f) {
+        if (mesh.pointWidths.size() == numPoints) {
+            widths.push_back(mesh.pointWidths.cdata());
+        }
+        for (const Primvar<float>& extraWidths : mesh.pointExtraWidths) {
+            if (perPoint(extraWidths)) {
+                widths.push_back(extraWidths.values.cdata());
+            }
+        }
+    }
+    const bool cull = options.cullToClippingBox && mesh.clippingBox.values.size() >= 2;
+    const GfRange3f clippingBox =
+      cull ? GfRange3f(mesh.clippingBox.values[0], mesh.clippingBox.values[1]) : GfRange3f();
+    const float minWidth = 2.0f * options.minScale;
+    const float maxWidth = options.maxScale > 0.0f ? 2.0f * options.maxScale
+                                                   : std::numeric_limits<float>::infinity();
+    const GfVec3f* points = mesh.points.cdata();
+
+    // Count the kept splats per block, which yields the offsets of the blocks in the compacted
+    // arrays, so that all arrays can then be compacted in parallel
+    const size_t numBlocks = (numPoints + gsplatBlockSize - 1) / gsplatBlockSize;
+    std::vector<std::uint8_t> keep(numPoints);
+    std::vector<size_t> blockOffsets(numBlocks + 1, 0);
+    WorkParallelForN(numBlocks, [&](size_t beginBlock, size_t endBlock) {
+        for (size_t b = beginBlock; b < endBlock; b++) {
+            const size_t first = b * gsplatBlockSize;
+            const size_t last = std::min(first + gsplatBlockSize, numPoints);
+            size_t kept = 0;
+            for (size_t i = first; i < last; i++) {
+                bool keepPoint = !opacities || opacities[i] >= options.minOpacity;
+                if (!widths.empty()) {
+                    float width = widths[0][i];
+                    for (size_t k = 1; k < widths.size(); k++) {
+                        width = std::max(width, widths[k][i]);
+                    }
+                    keepPoint = keepPoint && width >= minWidth && width <= maxWidth;
+                }
+                keepPoint = keepPoint && (!cull || clippingBox.Contains(points[i]));
+                keep[i] = keepPoint;
+                kept += keepPoint;
+            }
+            blockOffsets[b + 1] = kept;
+        }
+    });
+    for (size_t b = 0; b < numBlocks; b++) {
+        blockOffsets[b + 1] += blockOffsets[b];
+    }
+    const size_t numKept = blockOffsets[numBlocks];
+    if (numKept == numPoints) {
+        return 0;
+    }
+
+    auto compact = [&](auto& values) {
+        if (values.size() != numPoints) {
+            return;
+        }
+        std::remove_reference_t<decltype(values)> compacted(numKept);
+        const auto* src = values.cdata();
+        auto* dst = compacted.data();
+        WorkParallelForN(numBlocks, [&](size_t beginBlock, size_t endBlock) {
+            for (size_t b = beginBlock; b < endBlock; b++) {
+                size_t offset = blockOffsets[b];
+                const size_t last = std::min((b + 1) * gsplatBlockSize, numPoints);
+                for (size_t i = b * gsplatBlockSize; i < last; i++) {
+                    if (keep[i]) {
+                        dst[offset++] = src[i];
+                    }
+                }
+            }
+        });
+        values = std::move(compacted);
+    };
+    auto compactPrimvar = [&](auto& primvar) {
+        if (perPoint(primvar)) {
+            compact(primvar.values);
+        }
+    };
+    auto compactPrimvars = [&](auto& primvars) {
+        for (auto& primvar : primvars) {
+            compactPrimvar(primvar);
+        }
+    };
+    compact(mesh.points);
+    compact(mesh.pointWidths);
+    compactPrimvar(mesh.normals);
+    compactPrimvar(mesh.uvs);
+    compactPrimvar(mesh.pointRotations);
+    compactPrimvars(mesh.colors);
+    compactPrimvars(mesh.opacities);
+    compactPrimvars(mesh.pointExtraWidths);
+    compactPrimvars(mesh.pointSHCoeffs);
+    mesh.extent = computeExtent(mesh.points);
+    return numPoints - numKept;
+}
+
+namespace {
+template<typename H, typename T>
+void
+convertSetsToHalf(std::vector<Primvar<T>>& sets, std::vector<Primvar<H>>& halfSets)
+{
+    halfSets.resize(sets.size());
+    for (size_t k = 0; k < sets.size(); k++) {
+        Primvar<T>& primvar = sets[k];
+        Primvar<H>& halfPrimvar = halfSets[k];
+        halfPrimvar.interpolation = primvar.interpolation;
+        halfPrimvar.indices = std::move(primvar.indices);
+        halfPrimvar.values.resize(primvar.values.size());
+        const T* src = primvar.values.cdata();
+        H* dst = halfPrimvar.values.data();
+        WorkParallelForN(primvar.values.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                dst[i] = H(src[i]);
+            }
+        });
+        primvar.values = VtArray<T>();
+    }
+    sets.clear();
+}
+}
+
+void
+convertGsplatsToHalf(Mesh& mesh)
+{
+    convertSetsToHalf(mesh.colors, mesh.halfColors);
+    convertSetsToHalf(mesh.opacities, mesh.halfOpacities);
+    convertSetsToHalf(mesh.pointSHCoeffs, mesh.halfPointSHCoeffs);
+}
+
 size_t
 numSHDegreesFromGsplat(size_t numGsplatCoefficients)
 {
@@ -34,30 +347,67 @@ numNonZeroSHBandsFromDegree(size_t numDegrees)
     return numDegrees * (numDegrees + 2);
 }
 
+size_t
+truncatedSHCoeffCount(size_t numCoefficients, int maxDegree)
+{
+    const size_t maxDegrees = static_cast<size_t>(std::max(maxDegree, 0));
+    if (numSHDegreesFromGsplat(numCoefficients) <= maxDegrees) {
+        return numCoefficients;
+    }
+    return numNonZeroSHBandsFromDegree(maxDegrees) * 3;
+}
+
+std::vector<size_t>
+truncatedSHCoeffIndices(size_t numCoefficients, int maxDegree)
+{
+    // The first bands of each channel remain
+    const size_t numCoeffsPerChannel = numCoefficients / 3;
+    const size_t numTruncatedPerChannel = truncatedSHCoeffCount(numCoefficients, maxDegree) / 3;
+    std::vector<size_t> indices;
+    indices.reserve(numTruncatedPerChannel * 3);
+    for (size_t channel = 0; channel < 3; channel++) {
+        for (size_t k = 0; k < numTruncatedPerChannel; k++) {
+            indices.push_back(channel * numCoeffsPerChannel + k);
+        }
+    }
+    return indices;
+}
+
 void
 rotatePointRotations(const Primvar<GfQuatf>& pointRotations,
                      const GfQuatf& rotation,
                      size_t numPoints,
-                     VtQuatfArray& outPointRotations)
+                     GfQuatf* outPointRotations)
 {
-    size_t rotationsOffset = outPointRotations.size();
-    outPointRotations.resize(rotationsOffset + numPoints, GfQuatf::GetIdentity());
-
     // We need to find the minimum number of points that have rotations. This acts as a safe guard
     // in case some input data is missing.
     const size_t numPointsWithRotations = std::min(numPoints, pointRotations.values.size());
+    const GfQuatf* inPointRotations = pointRotations.values.cdata();
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            outPointRotations[i] =
+              i < numPointsWithRotations ? rotation * inPointRotations[i] : GfQuatf::GetIdentity();
+        }
+    });
+}
 
-    std::transform(pointRotations.values.begin(),
-                   pointRotations.values.begin() + numPointsWithRotations,
-                   outPointRotations.begin() + rotationsOffset,
-                   [&rotation](const GfQuatf& quat) { return rotation * quat; });
+void
+rotatePointRotations(const Primvar<GfQuatf>& pointRotations,
+                     const GfQuatf& rotation,
+                     size_t numPoints,
+                     VtQuatfArray& outPointRotations)
+{
+    size_t rotationsOffset = outPointRotations.size();
+    outPointRotations.resize(rotationsOffset + numPoints);
+    rotatePointRotations(
+      pointRotations, rotation, numPoints, outPointRotations.data() + rotationsOffset);
 }
 
 void
 rotatePointSphericalHarmonics(const std::vector<Primvar<float>>& inSH,
                               const PXR_NS::GfQuatf& rotation,
                               size_t numPoints,
-                              std::vector<VtFloatArray>& outSH)
+                              const std::vector<float*>& outSH)
 {
     // We need to find the minimum number of points that have SH coefficients in all channels.
     // This acts as a safe guard in case some input data is missing.
@@ -66,64 +416,140 @@ rotatePointSphericalHarmonics(const std::vector<Primvar<float>>& inSH,
         numPointsCompleteSH = std::min(numPointsCompleteSH, inSH[shIndex].values.size());
     }
 
-    if (1.0f - std::abs(rotation.GetReal()) > 1e-6f) {
-        // The rotation is not an identity, so we need to rotate the SH coefficients.
-        std::vector<size_t> shDataOffset(outSH.size());
-
-        // If the input SH has less channels than the output, we need to fill these output SH
-        // with zeros.
-        for (size_t shIndex = 0; shIndex < outSH.size(); shIndex++) {
-            size_t shCoeffOffset = outSH[shIndex].size();
-            shDataOffset[shIndex] = shCoeffOffset;
-            outSH[shIndex].resize(shCoeffOffset + numPoints, 0.0f);
-        }
-
-        const size_t pointSHDegrees = numSHDegreesFromGsplat(std::min(inSH.size(), outSH.size()));
-        if (pointSHDegrees > 0) {
-            const size_t numSHCoeffsPerChannel = numNonZeroSHBandsFromDegree(pointSHDegrees);
-            Eigen::Quaterniond quatRot(rotation.GetReal(),
-                                       rotation.GetImaginary()[0],
-                                       rotation.GetImaginary()[1],
-                                       rotation.GetImaginary()[2]);
-
-            // Need to renormalize due to floating precision differences.
-            quatRot.normalize();
-            const auto shRot = sh::Rotation::Create(static_cast<int>(pointSHDegrees), quatRot);
-
-            std::vector<float> shCoeffsBuffer(numSHCoeffsPerChannel + 1);
-            // We do not need to rotate the zeroth-order coefficient, while the
-            // SphericalHarmonics library needs coefficients from the zeroth to the highest
-            // order. Thus we just put a zero there.
-            shCoeffsBuffer[0] = 0.0f;
-
-            for (size_t i = 0; i < numPointsCompleteSH; ++i) {
-                for (size_t iChannel = 0; iChannel < 3; ++iChannel) {
-                    for (size_t iCoeff = 0; iCoeff < numSHCoeffsPerChannel; ++iCoeff) {
-                        shCoeffsBuffer[iCoeff + 1] =
-                          inSH[iCoeff + iChannel * numSHCoeffsPerChannel].values[i];
-                    }
-                    shRot->Apply(shCoeffsBuffer, &shCoeffsBuffer);
-                    for (size_t iCoeff = 0; iCoeff < numSHCoeffsPerChannel; ++iCoeff) {
-                        const size_t coeffIndex = iCoeff + iChannel * numSHCoeffsPerChannel;
-                        const size_t shOffset = shDataOffset[coeffIndex];
-                        outSH[coeffIndex][shOffset + i] = shCoeffsBuffer[iCoeff + 1];
-                    }
-                }
-            }
+    // The coefficients of each channel are stored consecutively, so the channels of the input and
+    // the output are strided by their own number of bands. Only the complete bands that both have
+    // are carried over, and the output is zero elsewhere.
+    const size_t inSHCoeffsPerChannel = inSH.size() / 3;
+    const size_t outSHCoeffsPerChannel = outSH.size() / 3;
+    const size_t pointSHDegrees = numSHDegreesFromGsplat(std::min(inSH.size(), outSH.size()));
+    const size_t numSHCoeffsPerChannel = numNonZeroSHBandsFromDegree(pointSHDegrees);
+    for (size_t shIndex = 0; shIndex < outSH.size(); shIndex++) {
+        const size_t band = outSHCoeffsPerChannel ? shIndex % outSHCoeffsPerChannel : 0;
+        const bool carried = shIndex < outSHCoeffsPerChannel * 3 && band < numSHCoeffsPerChannel;
+        const size_t first = carried ? numPointsCompleteSH : 0;
+        std::fill(outSH[shIndex] + first, outSH[shIndex] + numPoints, 0.0f);
+    }
+    if (numSHCoeffsPerChannel == 0) {
+        return;
+    }
+
+    std::vector<const float*> in(numSHCoeffsPerChannel * 3);
+    std::vector<float*> out(numSHCoeffsPerChannel * 3);
+    for (size_t iChannel = 0; iChannel < 3; ++iChannel) {
+        for (size_t iCoeff = 0; iCoeff < numSHCoeffsPerChannel; ++iCoeff) {
+            in[iChannel * numSHCoeffsPerChannel + iCoeff] =
+              inSH[iChannel * inSHCoeffsPerChannel + iCoeff].values.cdata();
+            out[iChannel * numSHCoeffsPerChannel + iCoeff] =
+              outSH[iChannel * outSHCoeffsPerChannel + iCoeff];
         }
-    } else {
+    }
+
+    if (1.0f - std::abs(rotation.GetReal()) <= 1e-6f) {
         // The rotation is an identity, so we can skip the rotation and just copy the SH
         // coefficients.
-        for (size_t shIndex = 0; shIndex < outSH.size(); shIndex++) {
-            size_t shCoeffOffset = outSH[shIndex].size();
-            outSH[shIndex].resize(shCoeffOffset + numPoints, 0.0f);
-            if (shIndex < inSH.size()) {
-                memcpy(outSH[shIndex].data() + shCoeffOffset,
-                       inSH[shIndex].values.data(),
-                       numPointsCompleteSH * sizeof(inSH[shIndex].values[0]));
+        for (size_t k = 0; k < in.size(); k++) {
+            memcpy(out[k], in[k], numPointsCompleteSH * sizeof(float));
+        }
+        return;
+    }
+
+    Eigen::Quaterniond quatRot(rotation.GetReal(),
+                               rotation.GetImaginary()[0],
+                               rotation.GetImaginary()[1],
+                               rotation.GetImaginary()[2]);
+
+    // Need to renormalize due to floating precision differences.
+    quatRot.normalize();
+    const auto shRot = sh::Rotation::Create(static_cast<int>(pointSHDegrees), quatRot);
+
+    // The rotation of the coefficients of band l is a dense (2l+1)x(2l+1) matrix, i.e. 3x3, 5x5 and
+    // 7x7 for the bands of Gaussian splats. The matrices are converted to float once, and are
+    // applied to blocks of points with the coefficients in the SoA arrays, so that the inner loops
+    // over the points get vectorized, while the coefficients of a block stay in the cache. The
+    // zeroth-order coefficient is not rotated.
+    std::vector<std::vector<float>> bandRotations(pointSHDegrees + 1);
+    for (size_t l = 1; l <= pointSHDegrees; l++) {
+        const Eigen::MatrixXd& bandRotation = shRot->band_rotation(static_cast<int>(l));
+        const size_t bandSize = 2 * l + 1;
+        bandRotations[l].resize(bandSize * bandSize);
+        for (size_t r = 0; r < bandSize; r++) {
+            for (size_t c = 0; c < bandSize; c++) {
+                bandRotations[l][r * bandSize + c] =
+                  static_cast<float>(bandRotation(static_cast<Eigen::Index>(r),
+                                                  static_cast<Eigen::Index>(c)));
             }
         }
     }
+
+    WorkParallelForN(numPointsCompleteSH, [&](size_t begin, size_t end) {
+        float rotated[gsplatBlockSize];
+        for (size_t first = begin; first < end; first += gsplatBlockSize) {
+            const size_t count = std::min(gsplatBlockSize, end - first);
+            for (size_t iChannel = 0; iChannel < 3; ++iChannel) {
+                for (size_t l = 1; l <= pointSHDegrees; l++) {
+                    // The coefficients of band l follow those of the lower bands, without the
+                    // zeroth-order coefficient
+                    const size_t bandOffset = iChannel * numSHCoeffsPerChannel + l * l - 1;
+                    const size_t bandSize = 2 * l + 1;
+                    const float* matrix = bandRotations[l].data();
+                    for (size_t r = 0; r < bandSize; r++) {
+                        std::fill(rotated, rotated + count, 0.0f);
+                        for (size_t c = 0; c < bandSize; c++) {
+                            const float m = matrix[r * bandSize + c];
+                            const float* src = in[bandOffset + c] + first;
+                            for (size_t i = 0; i < count; i++) {
+                                rotated[i] += m * src[i];
+                            }
+                        }
+                        std::memcpy(out[bandOffset + r] + first, rotated, count * sizeof(float));
+                    }
+                }
+            }
+        }
+    });
+}
+
+void
+rotatePointSphericalHarmonics(const std::vector<Primvar<float>>& inSH,
+                              const PXR_NS::GfQuatf& rotation,
+                              size_t numPoints,
+                              std::vector<VtFloatArray>& outSH)
+{
+    std::vector<float*> outSHData(outSH.size());
+    for (size_t shIndex = 0; shIndex < outSH.size(); shIndex++) {
+        size_t shCoeffOffset = outSH[shIndex].size();
+        outSH[shIndex].resize(shCoeffOffset + numPoints);
+        outSHData[shIndex] = outSH[shIndex].data() + shCoeffOffset;
+    }
+    rotatePointSphericalHarmonics(inSH, rotation, numPoints, outSHData);
+}
+
+void
+scalePointWidths(const VtFloatArray& inWidths,
+                 const std::vector<Primvar<float>>& inExtraWidths,
+                 size_t numPoints,
+                 float widthScale,
+                 float* outWidths,
+                 float* outWidths1,
+                 float* outWidths2)
+{
+    // We need to use the number of points as the size (and fill with default values) in case
+    // there's a mix of regular point cloud and Gsplats.
+    static const VtFloatArray noWidths;
+    const VtFloatArray& inWidths1 = inExtraWidths.size() >= 2 ? inExtraWidths[0].values : noWidths;
+    const VtFloatArray& inWidths2 = inExtraWidths.size() >= 2 ? inExtraWidths[1].values : noWidths;
+    const std::pair<const VtFloatArray*, float*> widths[3] = { { &inWidths, outWidths },
+                                                               { &inWidths1, outWidths1 },
+                                                               { &inWidths2, outWidths2 } };
+    for (const auto& [in, out] : widths) {
+        const size_t numPointWidths = std::min(numPoints, in->size());
+        const float* src = in->cdata();
+        WorkParallelForN(numPoints, [&, out = out](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                out[i] = i < numPointWidths ? src[i] * widthScale : 0.0f;
+            }
+        });
+    }
 }
 
 void
@@ -138,29 +564,15 @@ scalePointWidths(const VtFloatArray& inWidths,
     size_t widthsOffset = outWidths.size();
     size_t widths1Offset = outWidths1.size();
     size_t widths2Offset = outWidths2.size();
-
-    // We need to use the number of points as the new size (and fill with default values)
-    // in case there's a mix of regular point cloud and Gsplats.
-    outWidths.resize(widthsOffset + numPoints, 0.0f);
-    outWidths1.resize(widths1Offset + numPoints, 0.0f);
-    outWidths2.resize(widths2Offset + numPoints, 0.0f);
-
-    const size_t numPointWidths = std::min(numPoints, inWidths.size());
-    std::transform(inWidths.begin(),
-                   inWidths.begin() + numPointWidths,
-                   outWidths.begin() + widthsOffset,
-                   [widthScale](float width) { return width * widthScale; });
-    if (inExtraWidths.size() >= 2) {
-        const size_t numPointWidths1 = std::min(numPoints, inExtraWidths[0].values.size());
-        const size_t numPointWidths2 = std::min(numPoints, inExtraWidths[1].values.size());
-        std::transform(inExtraWidths[0].values.begin(),
-                       inExtraWidths[0].values.begin() + numPointWidths1,
-                       outWidths1.begin() + widths1Offset,
-                       [widthScale](float width) { return width * widthScale; });
-        std::transform(inExtraWidths[1].values.begin(),
-                       inExtraWidths[1].values.begin() + numPointWidths2,
-                       outWidths2.begin() + widths2Offset,
-                       [widthScale](float width) { return width * widthScale; });
-    }
+    outWidths.resize(widthsOffset + numPoints);
+    outWidths1.resize(widths1Offset + numPoints);
+    outWidths2.resize(widths2Offset + numPoints);
+    scalePointWidths(inWidths,
+                     inExtraWidths,
+                     numPoints,
+                     widthScale,
+                     outWidths.data() + widthsOffset,
+                     outWidths1.data() + widths1Offset,
+                     outWidths2.data() + widths2Offset);
 }
 }
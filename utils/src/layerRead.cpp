@@ -19,6 +19,10 @@ governing permissions and limitations under the License.
 #include <fileformatutils/layerWriteShared.h>
 #include <fileformatutils/usdData.h>
 
+#include <pxr/base/gf/half.h>
+#include <pxr/base/gf/vec3h.h>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usdGeom/camera.h>
 #include <pxr/usd/usdGeom/metrics.h>
 #include <pxr/usd/usdGeom/pointInstancer.h>
@@ -53,6 +57,7 @@ governing permissions and limitations under the License.
 #include <iomanip>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace PXR_NS;
@@ -338,6 +343,27 @@ readXform(ReadLayerContext& ctx, const UsdPrim& prim, int parent)
     return true;
 }
 
+// Read the values of a primvar that is authored with the half precision type H, if it is
+template<typename H, typename T>
+static bool
+readHalfPrimvarValues(const UsdGeomPrimvar& pv, VtArray<T>& values)
+{
+    if (pv.GetTypeName().GetType() != TfType::Find<VtArray<H>>()) {
+        return false;
+    }
+    VtArray<H> halfValues;
+    pv.Get(&halfValues, 0);
+    values.resize(halfValues.size());
+    const H* src = halfValues.cdata();
+    T* dst = values.data();
+    WorkParallelForN(halfValues.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            dst[i] = T(src[i]);
+        }
+    });
+    return true;
+}
+
 template<typename T>
 static bool
 readPrimvar(UsdGeomPrimvarsAPI& api, const TfToken& name, Primvar<T>& primvar)
@@ -345,7 +371,17 @@ readPrimvar(UsdGeomPrimvarsAPI& api, const TfToken& name, Primvar<T>& primvar)
     std::string str = name.GetString();
     UsdGeomPrimvar pv = api.GetPrimvar(name);
     if (pv.IsDefined()) {
-        pv.Get(&primvar.values, 0);
+        // Colors, opacities and SH coefficients of Gaussian splats may be authored in half
+        // precision, which is widened to the float values of UsdData
+        bool converted = false;
+        if constexpr (std::is_same_v<T, float>) {
+            converted = readHalfPrimvarValues<GfHalf>(pv, primvar.values);
+        } else if constexpr (std::is_same_v<T, GfVec3f>) {
+            converted = readHalfPrimvarValues<GfVec3h>(pv, primvar.values);
+        }
+        if (!converted) {
+            pv.Get(&primvar.values, 0);
+        }
         pv.GetIndices(&primvar.indices, 0);
         primvar.interpolation = pv.GetInterpolation();
         return true;
@@ -620,18 +656,54 @@ readMeshOrPointsData(ReadLayerContext& ctx, Mesh& mesh, int meshIndex, const Usd
                     }
                 }
             }
-            int shIndex = 0;
-            while (true) {
-                Primvar<float> shCoeffs;
-                if (!readPrimvar(
-                      primvarsAPI, TfToken(std::string("fRest") + std::to_string(shIndex)), shCoeffs) || !shCoeffs.values.size())
-                    break;
-                auto [pointSHCoeffSetIndex, pointSHCoeffSet] =
-                  ctx.usd->addPointSHCoeffSet(meshIndex);
-                pointSHCoeffSet.indices = shCoeffs.indices;
-                pointSHCoeffSet.values = shCoeffs.values;
-                pointSHCoeffSet.interpolation = shCoeffs.interpolation;
-                ++shIndex;
+            // The SH coefficients are either packed into a single primvar, with all coefficients
+            // of a splat per element, or authored as a primvar per coefficient
+            const TfToken packedSHToken("fRest");
+            Primvar<float> packedSHCoeffs;
+            if (readPrimvar(primvarsAPI, packedSHToken, packedSHCoeffs) &&
+                packedSHCoeffs.values.size()) {
+                const size_t numCoeffs = static_cast<size_t>(
+                  std::max(primvarsAPI.GetPrimvar(packedSHToken).GetElementSize(), 1));
+                const size_t numPoints = packedSHCoeffs.values.size() / numCoeffs;
+                // Add all the sets first, since adding sets can move the previous ones
+                const size_t firstSet = mesh.pointSHCoeffs.size();
+                for (size_t k = 0; k < numCoeffs; k++) {
+                    auto [pointSHCoeffSetIndex, pointSHCoeffSet] =
+                      ctx.usd->addPointSHCoeffSet(meshIndex);
+                    // The indices of a packed primvar index its elements, i.e. the splats
+                    pointSHCoeffSet.indices = packedSHCoeffs.indices;
+                    pointSHCoeffSet.interpolation = packedSHCoeffs.interpolation;
+                    pointSHCoeffSet.values.resize(numPoints);
+                }
+                std::vector<float*> dst(numCoeffs);
+                for (size_t k = 0; k < numCoeffs; k++) {
+                    dst[k] = mesh.pointSHCoeffs[firstSet + k].values.data();
+                }
+                const float* src = packedSHCoeffs.values.cdata();
+                WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+                    for (size_t k = 0; k < numCoeffs; k++) {
+                        float* coeffs = dst[k];
+                        for (size_t i = begin; i < end; i++) {
+                            coeffs[i] = src[i * numCoeffs + k];
+                        }
+                    }
+                });
+            } else {
+                int shIndex = 0;
+                while (true) {
+                    Primvar<float> shCoeffs;
+                    if (!readPrimvar(primvarsAPI,
+                                     TfToken(std::string("fRest") + std::to_string(shIndex)),
+                                     shCoeffs) ||
+                        !shCoeffs.values.size())
+                        break;
+                    auto [pointSHCoeffSetIndex, pointSHCoeffSet] =
+                      ctx.usd->addPointSHCoeffSet(meshIndex);
+                    pointSHCoeffSet.indices = shCoeffs.indices;
+                    pointSHCoeffSet.values = shCoeffs.values;
+                    pointSHCoeffSet.interpolation = shCoeffs.interpolation;
+                    ++shIndex;
+                }
             }
         }
     }
@@ -877,6 +949,93 @@ readSkelRoot(ReadLayerContext& ctx, const UsdPrim& prim, int parent)
     return true;
 }
 
+// Removes the values of the instances that are not in the mask of a point instancer. Unlike
+// UsdGeomPointInstancer::ApplyMaskToArray, arrays that are shorter than the mask are accepted.
+template<typename T>
+void
+applyInstanceMask(const std::vector<bool>& mask, VtArray<T>& values)
+{
+    if (mask.empty()) {
+        return;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i >= mask.size() || mask[i]) {
+            values[kept++] = values[i];
+        }
+    }
+    values.resize(kept);
+}
+
+// Reads the prototypes and per instance data of a point instancer into a PointInstancer struct
+// referenced by the node. The meshes of each prototype are flattened into the space of the
+// prototype root's parent, so that the prototype root's own transform is kept.
+bool
+readPointInstancerData(ReadLayerContext& ctx,
+                       const UsdGeomPointInstancer& pointInstancer,
+                       Node& node,
+                       UsdTimeCode time)
+{
+    auto [instancerIndex, instancer] = ctx.usd->addPointInstancer();
+    node.pointInstancer = instancerIndex;
+    instancer.name = pointInstancer.GetPrim().GetName().GetString();
+
+    SdfPathVector prototypePaths;
+    pointInstancer.GetPrototypesRel().GetForwardedTargets(&prototypePaths);
+    instancer.prototypes.resize(prototypePaths.size());
+    for (size_t i = 0; i < prototypePaths.size(); i++) {
+        const UsdPrim prototypePrim = ctx.stage->GetPrimAtPath(prototypePaths[i]);
+        if (!prototypePrim) {
+            TF_WARN("%s: Missing prototype %s of point instancer %s\n",
+                    ctx.debugTag.c_str(),
+                    prototypePaths[i].GetText(),
+                    pointInstancer.GetPath().GetText());
+            continue;
+        }
+        const UsdPrim prototypeParent = prototypePrim.GetParent();
+        for (const UsdPrim& p :
+             UsdPrimRange(prototypePrim, UsdTraverseInstanceProxies(UsdPrimAllPrimsPredicate))) {
+            if (!p.IsA<UsdGeomMesh>() && !p.IsA<UsdGeomPoints>()) {
+                continue;
+            }
+            // Indices are taken before each read, since reading appends to the mesh vector
+            const int meshIndex = ctx.usd->meshes.size();
+            instancer.prototypes[i].push_back(meshIndex);
+            Mesh& mesh = ctx.usd->addMesh().second;
+            if (!readMeshOrPointsData(ctx, mesh, meshIndex, p)) {
+                return false;
+            }
+            bool resetsXformStack = false;
+            const GfMatrix4d transform =
+              ctx.xformCache.ComputeRelativeTransform(p, prototypeParent, &resetsXformStack);
+            if (transform != GfMatrix4d(1.0)) {
+                transformMesh(mesh, transform);
+            }
+        }
+    }
+
+    pointInstancer.GetProtoIndicesAttr().Get(&instancer.protoIndices, time);
+    pointInstancer.GetPositionsAttr().Get(&instancer.positions, time);
+    pointInstancer.GetOrientationsAttr().Get(&instancer.orientations, time);
+    pointInstancer.GetScalesAttr().Get(&instancer.scales, time);
+    // Instances that are hidden by invisibleIds or deactivated by inactiveIds are dropped
+    const std::vector<bool> mask = pointInstancer.ComputeMaskAtTime(time);
+    applyInstanceMask(mask, instancer.protoIndices);
+    applyInstanceMask(mask, instancer.positions);
+    applyInstanceMask(mask, instancer.orientations);
+    applyInstanceMask(mask, instancer.scales);
+    // Instances without a position are not well defined, and not worth keeping
+    if (instancer.positions.size() < instancer.protoIndices.size()) {
+        instancer.protoIndices.resize(instancer.positions.size());
+    }
+    TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                 "%s: layer::read PointInstancer with %zu prototypes and %zu instances\n",
+                 ctx.debugTag.c_str(),
+                 instancer.prototypes.size(),
+                 instancer.protoIndices.size());
+    return true;
+}
+
 bool
 readPointInstancer(ReadLayerContext& ctx, const UsdPrim& prim, int parent)
 {
@@ -893,6 +1052,10 @@ readPointInstancer(ReadLayerContext& ctx, const UsdPrim& prim, int parent)
 
     UsdTimeCode time = UsdTimeCode::EarliestTime();
     UsdGeomPointInstancer pointInstancer(prim);
+    if (ctx.options->pointInstancers) {
+        return readPointInstancerData(ctx, pointInstancer, node, time);
+    }
+
     const UsdAttribute positionsAttr = pointInstancer.GetPositionsAttr();
     VtVec3fArray positions;
     positionsAttr.Get(&positions, time);
@@ -903,6 +1066,8 @@ readPointInstancer(ReadLayerContext& ctx, const UsdPrim& prim, int parent)
     const UsdAttribute protoInstanceAttr = pointInstancer.GetProtoIndicesAttr();
     VtIntArray protoIndices;
     protoInstanceAttr.Get(&protoIndices, time);
+    // The transforms leave out the masked instances, and so do the prototype indices
+    applyInstanceMask(pointInstancer.ComputeMaskAtTime(time), protoIndices);
 
     const int meshesBeforePrototypesAdded = ctx.usd->meshes.size();
     UsdPrimSiblingRange children =
@@ -21,8 +21,11 @@ governing permissions and limitations under the License.
 #include <fileformatutils/usdData.h>
 #include <version.h>
 
+#include <pxr/base/gf/half.h>
+#include <pxr/base/gf/vec3h.h>
 #include <pxr/base/tf/fileUtils.h>
 #include <pxr/base/tf/pathUtils.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/pxr.h>
 #include <pxr/usd/sdf/assetPath.h>
 #include <pxr/usd/usdGeom/tokens.h>
@@ -32,6 +35,7 @@ governing permissions and limitations under the License.
 #include <pxr/usd/usdSkel/tokens.h>
 #include <pxr/usd/usdVol/tokens.h>
 
+#include <algorithm>
 #include <fstream>
 
 using namespace PXR_NS;
@@ -56,6 +60,8 @@ TF_DEFINE_PRIVATE_TOKENS(_tokens,
     // Render settings
     ((render, "Render"))
     ((primarySetting, "PrimarySetting"))
+    // Point instancers
+    ((prototypes, "Prototypes"))
 );
 // clang-format on
 
@@ -539,8 +545,60 @@ _writePrimvar(SdfAbstractData* sdfData,
     return primvarAttrPath;
 }
 
+// Write the SH coefficients of Gaussian splats as a single "fRest" primvar, with an element of all
+// coefficients of a splat per point, so that the coefficients of each splat are contiguous, in
+// the float or half precision of the coefficients. Returns false if the coefficients can't be
+// packed, since they are indexed or differ in size or interpolation.
+template<typename T>
+bool
+_writePackedSHCoeffs(SdfAbstractData* sdfData,
+                     const SdfPath& primPath,
+                     const PXR_NS::SdfValueTypeName& typeName,
+                     const std::vector<Primvar<T>>& shCoeffs)
+{
+    const size_t numCoeffs = shCoeffs.size();
+    const size_t numPoints = shCoeffs[0].values.size();
+    std::vector<const T*> src(numCoeffs);
+    for (size_t k = 0; k < numCoeffs; k++) {
+        const Primvar<T>& coeffs = shCoeffs[k];
+        if (!coeffs.indices.empty() || coeffs.values.size() != numPoints ||
+            coeffs.interpolation != shCoeffs[0].interpolation) {
+            return false;
+        }
+        src[k] = coeffs.values.cdata();
+    }
+
+    Primvar<T> packed;
+    packed.interpolation = shCoeffs[0].interpolation;
+    packed.values.resize(numPoints * numCoeffs);
+    T* dst = packed.values.data();
+    // The coefficients are transposed in blocks of points, which keeps the reads sequential and
+    // the written rows in cache
+    constexpr size_t blockSize = 256;
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end) {
+        for (size_t first = begin; first < end; first += blockSize) {
+            const size_t last = std::min(first + blockSize, end);
+            for (size_t k = 0; k < numCoeffs; k++) {
+                const T* coeffs = src[k];
+                for (size_t i = first; i < last; i++) {
+                    dst[i * numCoeffs + k] = coeffs[i];
+                }
+            }
+        }
+    });
+    SdfPath primvarAttrPath = _writePrimvar(sdfData, primPath, "fRest", typeName, packed);
+    setAttributeMetadata(sdfData,
+                         primvarAttrPath,
+                         UsdGeomTokens->elementSize,
+                         VtValue(static_cast<int>(numCoeffs)));
+    return true;
+}
+
 void
-_writePrimvars(SdfAbstractData* sdfData, const SdfPath& primPath, const Mesh& mesh)
+_writePrimvars(SdfAbstractData* sdfData,
+               const SdfPath& primPath,
+               const Mesh& mesh,
+               bool packedGsplatSHCoeffs = false)
 {
     // Primvars. Note, for points we currently do not emit texcoords, normals and tangents
     if (!mesh.asPoints) {
@@ -571,6 +629,18 @@ _writePrimvars(SdfAbstractData* sdfData, const SdfPath& primPath, const Mesh& me
         std::string name = indexedName("displayOpacity", i);
         _writePrimvar(sdfData, primPath, name, SdfValueTypeNames->FloatArray, opacity);
     }
+    // Gaussian splats may keep their colors, opacities and SH coefficients in half precision,
+    // which are authored as they are, sharing their values with the layer
+    for (size_t i = 0; i < mesh.halfColors.size(); i++) {
+        const Primvar<GfVec3h>& color = mesh.halfColors[i];
+        std::string name = indexedName("displayColor", i);
+        _writePrimvar(sdfData, primPath, name, SdfValueTypeNames->Color3hArray, color);
+    }
+    for (size_t i = 0; i < mesh.halfOpacities.size(); i++) {
+        const Primvar<GfHalf>& opacity = mesh.halfOpacities[i];
+        std::string name = indexedName("displayOpacity", i);
+        _writePrimvar(sdfData, primPath, name, SdfValueTypeNames->HalfArray, opacity);
+    }
 
     if (mesh.asGsplats) {
         _writePrimvar(sdfData, primPath, "rot", SdfValueTypeNames->QuatfArray, mesh.pointRotations);
@@ -581,13 +651,21 @@ _writePrimvars(SdfAbstractData* sdfData, const SdfPath& primPath, const Mesh& me
             _writePrimvar(sdfData, primPath, name, SdfValueTypeNames->FloatArray, extraWidth);
         }
 
-        for (size_t i = 0; i < mesh.pointSHCoeffs.size(); i++) {
-            const Primvar<float>& shCoeffs = mesh.pointSHCoeffs[i];
-            // The non-zero-order SH coefficients are always multiple, and it's meaningless to only
-            // have a single one. Thus all the names are indexed.
-            std::string name = std::string("fRest") + std::to_string(i);
-            _writePrimvar(sdfData, primPath, name, SdfValueTypeNames->FloatArray, shCoeffs);
-        }
+        auto writeSHCoeffs = [&](const auto& shCoeffs, const SdfValueTypeName& typeName) {
+            if (shCoeffs.empty() ||
+                (packedGsplatSHCoeffs &&
+                 _writePackedSHCoeffs(sdfData, primPath, typeName, shCoeffs))) {
+                return;
+            }
+            for (size_t i = 0; i < shCoeffs.size(); i++) {
+                // The non-zero-order SH coefficients are always multiple, and it's meaningless to
+                // only have a single one. Thus all the names are indexed.
+                std::string name = std::string("fRest") + std::to_string(i);
+                _writePrimvar(sdfData, primPath, name, typeName, shCoeffs[i]);
+            }
+        };
+        writeSHCoeffs(mesh.pointSHCoeffs, SdfValueTypeNames->FloatArray);
+        writeSHCoeffs(mesh.halfPointSHCoeffs, SdfValueTypeNames->HalfArray);
 
         if (mesh.clippingBox.values.size() >= 2) {
             _writePrimvar(
@@ -605,8 +683,47 @@ _writePrimvars(SdfAbstractData* sdfData, const SdfPath& primPath, const Mesh& me
     }
 }
 
+// The bounds of the points of a mesh, padded by the largest point radius for points. Importers
+// usually provide the bounds of the points as they fill them, otherwise they are computed here.
+GfRange3f
+_meshExtent(const Mesh& mesh)
+{
+    GfRange3f extent = mesh.extent.IsEmpty() ? computeExtent(mesh.points) : mesh.extent;
+    if (!extent.IsEmpty() && mesh.asPoints && !mesh.pointWidths.empty()) {
+        // Like UsdGeomPoints::ComputeExtent, pad the bounds by the largest point radius
+        const float maxWidth =
+          *std::max_element(mesh.pointWidths.cbegin(), mesh.pointWidths.cend());
+        const GfVec3f padding(0.5f * std::max(maxWidth, 0.0f));
+        extent = GfRange3f(extent.GetMin() - padding, extent.GetMax() + padding);
+    }
+    return extent;
+}
+
+// Author the extent of a mesh or points prim, so that consumers don't have to scan all points after
+// loading. Gaussian splats get their extent from the clipping box instead. Skinned meshes get the
+// extent of their rest points, like the points attribute, so it does not cover posed geometry.
+// Consumers get the posed bounds from the UsdSkelRoot, whose extent is computed from the skeleton.
+void
+_writeExtent(SdfAbstractData* sdfData, const SdfPath& primPath, const Mesh& mesh)
+{
+    if (mesh.clippingBox.values.size() >= 2) {
+        return;
+    }
+    const GfRange3f extent = _meshExtent(mesh);
+    if (extent.IsEmpty()) {
+        return;
+    }
+    SdfPath extentAttrSpec = createAttributeSpec(
+      sdfData, primPath, UsdGeomTokens->extent, SdfValueTypeNames->Float3Array);
+    setAttributeDefaultValue(
+      sdfData, extentAttrSpec, VtVec3fArray{ extent.GetMin(), extent.GetMax() });
+}
+
 SdfPath
-_writePoints(SdfAbstractData* sdfData, const SdfPath& parentPath, const Mesh& mesh)
+_writePoints(SdfAbstractData* sdfData,
+             const SdfPath& parentPath,
+             const Mesh& mesh,
+             bool packedGsplatSHCoeffs)
 {
     SdfPath primPath =
       createPrimSpec(sdfData, parentPath, TfToken(mesh.name), UsdGeomTokens->Points);
@@ -626,8 +743,9 @@ _writePoints(SdfAbstractData* sdfData, const SdfPath& parentPath, const Mesh& me
       createAttr(UsdGeomTokens->widths, SdfValueTypeNames->FloatArray, mesh.pointWidths);
     setAttributeMetadata(
       sdfData, widthsAttrPath, UsdGeomTokens->interpolation, VtValue(UsdGeomTokens->vertex));
+    _writeExtent(sdfData, primPath, mesh);
 
-    _writePrimvars(sdfData, primPath, mesh);
+    _writePrimvars(sdfData, primPath, mesh, packedGsplatSHCoeffs);
 
     return primPath;
 }
@@ -680,6 +798,7 @@ _writeMesh(SdfAbstractData* sdfData,
 
     // UsdMesh basics
     createAttr(UsdGeomTokens->points, SdfValueTypeNames->Point3fArray, mesh.points);
+    _writeExtent(sdfData, primPath, mesh);
     createAttr(UsdGeomTokens->faceVertexCounts, SdfValueTypeNames->IntArray, mesh.faces);
     createAttr(UsdGeomTokens->faceVertexIndices, SdfValueTypeNames->IntArray, mesh.indices);
     // Subdivision rules
@@ -747,7 +866,7 @@ _writePointsOrMesh(WriteSdfContext& ctx,
                    const SdfPath& skeletonPath = SdfPath::EmptyPath())
 {
     if (mesh.asPoints) {
-        _writePoints(ctx.sdfData, parentPath, mesh);
+        _writePoints(ctx.sdfData, parentPath, mesh, ctx.options->packedGsplatSHCoeffs);
     } else {
         SdfPath meshPath =
           _writeMesh(ctx.sdfData, parentPath, ctx.materialMap, mesh, mesh.name, skeletonPath);
@@ -814,6 +933,64 @@ _writeInstancedMesh(WriteSdfContext& ctx,
                  meshName.c_str());
 }
 
+// Writes a UsdGeomPointInstancer with its prototypes nested under a `Prototypes` scope below it,
+// so that the prototypes are only imaged through the instancer
+void
+_writePointInstancer(WriteSdfContext& ctx,
+                     const SdfPath& parentPath,
+                     const PointInstancer& instancer)
+{
+    SdfPath instancerPath = createPrimSpec(
+      ctx.sdfData, parentPath, TfToken(instancer.name), UsdGeomTokens->PointInstancer);
+    SdfPath prototypesPath =
+      createPrimSpec(ctx.sdfData, instancerPath, _tokens->prototypes, UsdGeomTokens->Scope);
+    SdfPath prototypesRelPath =
+      createRelationshipSpec(ctx.sdfData, instancerPath, UsdGeomTokens->prototypes);
+
+    for (size_t i = 0; i < instancer.prototypes.size(); i++) {
+        SdfPath prototypePath = createPrimSpec(ctx.sdfData,
+                                               prototypesPath,
+                                               TfToken("Prototype" + std::to_string(i)),
+                                               UsdGeomTokens->Xform);
+        // Meshes of a prototype can be shared with other nodes, hence their names are only made
+        // unique here
+        UniqueNameEnforcer enforcer;
+        for (int meshIndex : instancer.prototypes[i]) {
+            const Mesh& mesh = ctx.usdData->meshes[meshIndex];
+            if (mesh.asPoints) {
+                _writePointsOrMesh(ctx, prototypePath, mesh);
+                continue;
+            }
+            std::string meshName = mesh.name;
+            enforcer.enforceUniqueness(meshName);
+            SdfPath meshPath =
+              _writeMesh(ctx.sdfData, prototypePath, ctx.materialMap, mesh, meshName);
+            _bindMeshMaterial(ctx.sdfData, meshPath, ctx.materialMap, mesh);
+        }
+        appendRelationshipTarget(ctx.sdfData, prototypesRelPath, prototypePath);
+    }
+
+    auto createAttr = [&](const TfToken& name, const SdfValueTypeName& type, const auto& value) {
+        SdfPath attrPath = createAttributeSpec(ctx.sdfData, instancerPath, name, type);
+        setAttributeDefaultValue(ctx.sdfData, attrPath, value);
+    };
+    createAttr(UsdGeomTokens->protoIndices, SdfValueTypeNames->IntArray, instancer.protoIndices);
+    createAttr(UsdGeomTokens->positions, SdfValueTypeNames->Point3fArray, instancer.positions);
+    if (!instancer.orientations.empty()) {
+        createAttr(
+          UsdGeomTokens->orientations, SdfValueTypeNames->QuathArray, instancer.orientations);
+    }
+    if (!instancer.scales.empty()) {
+        createAttr(UsdGeomTokens->scales, SdfValueTypeNames->Float3Array, instancer.scales);
+    }
+
+    TF_DEBUG_MSG(FILE_FORMAT_UTIL,
+                 "layer::write point instancer %s with %zu prototypes and %zu instances\n",
+                 instancerPath.GetText(),
+                 instancer.prototypes.size(),
+                 instancer.protoIndices.size());
+}
+
 // Layout of control points in USD is: row-major with U considered rows, and V columns.
 // So: u0v0, u0v1, ... u0vx, u1v0, ...
 // but after tests, seems USD is really column-major, as are its transforms.
@@ -956,6 +1133,25 @@ _writeNodes(WriteSdfContext& ctx,
             const SdfPath& parentPath,
             const std::vector<int>& childNodeIndices);
 
+// Author the extents hint of a payload node from the extents of its meshes, so that consumers can
+// cull the node without loading its payload
+void
+_writeExtentsHint(WriteSdfContext& ctx, const SdfPath& primPath, const Node& node)
+{
+    GfRange3f extent = node.payloadExtent;
+    for (int meshIndex : node.staticMeshes) {
+        const Mesh& mesh = ctx.usdData->meshes[meshIndex];
+        extent.UnionWith(_meshExtent(mesh));
+    }
+    if (extent.IsEmpty()) {
+        return;
+    }
+    SdfPath extentsHintAttrSpec = createAttributeSpec(
+      ctx.sdfData, primPath, UsdGeomTokens->extentsHint, SdfValueTypeNames->Float3Array);
+    setAttributeDefaultValue(
+      ctx.sdfData, extentsHintAttrSpec, VtVec3fArray{ extent.GetMin(), extent.GetMax() });
+}
+
 // Creates a prim spec without adding the prim as a child of the parent. The list of children to be
 // added to the parent is accumulated and then added to the parent once all the children are
 // created. This provides a significant improvement in load performance, especially when the number
@@ -1002,23 +1198,42 @@ _writeNode(WriteSdfContext& ctx, const SdfPath& primPath, const Node& node)
           ctx.sdfData, primPath, SdfFieldKeys->DisplayName, VtValue(node.displayName));
     }
 
+    // The content of an external payload is authored by the layer of its asset
+    if (node.payload && !node.payloadAssetPath.empty()) {
+        addPrimPayload(ctx.sdfData, primPath, SdfPayload(node.payloadAssetPath, primPath));
+        _writeExtentsHint(ctx, primPath, node);
+        return true;
+    }
+
+    // The content of a payload node is written under a typeless `over` prim spec next to the node,
+    // so that it does not appear in the scene by itself, and the node loads it as an internal
+    // payload. This lets consumers load parts of a large scene on demand.
+    SdfPath contentPath = primPath;
+    if (node.payload) {
+        contentPath = createPrimSpec(ctx.sdfData,
+                                     primPath.GetParentPath(),
+                                     TfToken("_Payload_" + node.name),
+                                     TfToken(),
+                                     SdfSpecifierOver);
+    }
+
     if (node.camera >= 0) {
-        _writeCamera(ctx.sdfData, primPath, ctx.usdData->cameras[node.camera]);
+        _writeCamera(ctx.sdfData, contentPath, ctx.usdData->cameras[node.camera]);
     }
 
     if (node.ngp >= 0) {
-        _writeNgp(ctx.sdfData, primPath, ctx.usdData->ngps[node.ngp]);
+        _writeNgp(ctx.sdfData, contentPath, ctx.usdData->ngps[node.ngp]);
     }
 
     if (node.light >= 0) {
-        _writeLight(ctx.sdfData, primPath, ctx.usdData->lights[node.light]);
+        _writeLight(ctx.sdfData, contentPath, ctx.usdData->lights[node.light]);
     }
 
     // Uninstanced meshes first
     for (int meshIndex : node.staticMeshes) {
         const Mesh& mesh = ctx.usdData->meshes[meshIndex];
         if (!mesh.instanceable) {
-            _writePointsOrMesh(ctx, primPath, mesh);
+            _writePointsOrMesh(ctx, contentPath, mesh);
         }
     }
 
@@ -1030,17 +1245,26 @@ _writeNode(WriteSdfContext& ctx, const SdfPath& primPath, const Node& node)
         if (mesh.instanceable) {
             std::string meshName = mesh.name;
             enforcer.enforceUniqueness(meshName);
-            _writeInstancedMesh(ctx, primPath, mesh, meshIndex, meshName);
+            _writeInstancedMesh(ctx, contentPath, mesh, meshIndex, meshName);
         }
     }
 
+    if (node.pointInstancer >= 0) {
+        _writePointInstancer(ctx, contentPath, ctx.usdData->pointInstancers[node.pointInstancer]);
+    }
+
     // Curves
     for (int curveIndex : node.curves) {
         const Curve& curve = ctx.usdData->curves[curveIndex];
-        _writeCurve(ctx, primPath, curve);
+        _writeCurve(ctx, contentPath, curve);
     }
 
-    _writeNodes(ctx, primPath, node.children);
+    _writeNodes(ctx, contentPath, node.children);
+
+    if (node.payload) {
+        addPrimPayload(ctx.sdfData, primPath, SdfPayload(std::string(), contentPath));
+        _writeExtentsHint(ctx, primPath, node);
+    }
 
     return true;
 }
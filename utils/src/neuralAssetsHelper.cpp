@@ -12,8 +12,10 @@ governing permissions and limitations under the License.
 #include <fileformatutils/neuralAssetsHelper.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <limits>
+#include <pxr/base/work/loops.h>
 #include <zlib.h>
 
 namespace adobe::usd {
@@ -80,6 +82,52 @@ float16ToFloat32(const std::uint16_t h)
 
     return o.f;
 }
+
+// Size of the blocks that are deflated in parallel. Each block is primed with the last 32KB of
+// the previous block as dictionary, so that matches across the block boundaries are still found.
+constexpr std::size_t deflateBlockSize = 1 << 20;
+constexpr std::size_t deflateDictionarySize = 1 << 15;
+
+// Deflate a block into raw deflate data. Blocks other than the last one are ended with a sync
+// flush, which byte aligns their data, so that the blocks can be concatenated into one stream.
+bool
+deflateBlock(const std::uint8_t* dictionary,
+             std::size_t dictionaryLen,
+             const std::uint8_t* inputData,
+             std::size_t inLen,
+             int level,
+             bool last,
+             std::vector<std::uint8_t>& outputData)
+{
+    z_stream strm = {};
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    if (dictionaryLen &&
+        deflateSetDictionary(&strm, dictionary, static_cast<uInt>(dictionaryLen)) != Z_OK) {
+        deflateEnd(&strm);
+        return false;
+    }
+    // The bound does not cover the empty stored block that the sync flush appends
+    outputData.resize(deflateBound(&strm, static_cast<uLong>(inLen)) + 16);
+    strm.next_in = const_cast<Bytef*>(inputData);
+    strm.avail_in = static_cast<uInt>(inLen);
+    strm.next_out = outputData.data();
+    strm.avail_out = static_cast<uInt>(outputData.size());
+    const int ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+    const bool ok = last ? ret == Z_STREAM_END : ret == Z_OK && strm.avail_in == 0;
+    outputData.resize(outputData.size() - strm.avail_out);
+    deflateEnd(&strm);
+    return ok;
+}
+
+void
+appendUInt32LE(std::vector<std::uint8_t>& outputData, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        outputData.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
 }
 
 bool
@@ -181,6 +229,98 @@ compress(const std::uint8_t* inputData, std::size_t inLen, std::vector<std::uint
     return true;
 }
 
+bool
+compressGzip(const std::uint8_t* inputData,
+             std::size_t inLen,
+             int level,
+             bool parallel,
+             std::vector<std::uint8_t>& outputData)
+{
+    outputData.clear();
+    if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+        return false;
+    }
+
+    if (!parallel) {
+        z_stream strm = {};
+        if (deflateInit2(&strm, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) !=
+            Z_OK) {
+            return false;
+        }
+        // The input is fed in slices, since the sizes of zlib streams are 32 bit
+        const std::size_t maxSliceSize = 1 << 30;
+        std::size_t consumed = 0;
+        std::vector<std::uint8_t> buffer(1 << 16);
+        int ret;
+        do {
+            if (strm.avail_in == 0 && consumed < inLen) {
+                const std::size_t sliceSize = std::min(maxSliceSize, inLen - consumed);
+                strm.next_in = const_cast<Bytef*>(inputData + consumed);
+                strm.avail_in = static_cast<uInt>(sliceSize);
+                consumed += sliceSize;
+            }
+            strm.next_out = buffer.data();
+            strm.avail_out = static_cast<uInt>(buffer.size());
+            ret = deflate(&strm, consumed == inLen ? Z_FINISH : Z_NO_FLUSH);
+            if (ret == Z_STREAM_ERROR) {
+                deflateEnd(&strm);
+                return false;
+            }
+            outputData.insert(
+              outputData.end(), buffer.begin(), buffer.end() - strm.avail_out);
+        } while (ret != Z_STREAM_END);
+        deflateEnd(&strm);
+        return true;
+    }
+
+    // The blocks are deflated and checksummed independently, and then joined into a single gzip
+    // member, like pigz does
+    const std::size_t numBlocks =
+      std::max<std::size_t>(1, (inLen + deflateBlockSize - 1) / deflateBlockSize);
+    std::vector<std::vector<std::uint8_t>> blocks(numBlocks);
+    std::vector<uLong> blockCrcs(numBlocks);
+    std::atomic<bool> ok = true;
+    PXR_NS::WorkParallelForN(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            const std::size_t first = b * deflateBlockSize;
+            const std::size_t count = std::min(deflateBlockSize, inLen - first);
+            const std::size_t dictionaryLen = std::min(first, deflateDictionarySize);
+            if (!deflateBlock(inputData + first - dictionaryLen,
+                              dictionaryLen,
+                              inputData + first,
+                              count,
+                              level,
+                              b + 1 == numBlocks,
+                              blocks[b])) {
+                ok = false;
+            }
+            blockCrcs[b] = crc32(0L, inputData + first, static_cast<uInt>(count));
+        }
+    });
+    if (!ok) {
+        return false;
+    }
+
+    std::size_t compressedSize = 0;
+    for (const std::vector<std::uint8_t>& block : blocks) {
+        compressedSize += block.size();
+    }
+    outputData.reserve(compressedSize + 18);
+    // The gzip header without a file name or modification time, and an unknown OS
+    const std::uint8_t header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+    outputData.insert(outputData.end(), header, header + 10);
+    uLong crc = crc32(0L, Z_NULL, 0);
+    for (size_t b = 0; b < numBlocks; b++) {
+        outputData.insert(outputData.end(), blocks[b].begin(), blocks[b].end());
+        const std::size_t count = std::min(deflateBlockSize, inLen - b * deflateBlockSize);
+        crc = crc32_combine(crc, blockCrcs[b], static_cast<z_off_t>(count));
+    }
+    appendUInt32LE(outputData, static_cast<std::uint32_t>(crc));
+    // The size modulo 2^32
+    appendUInt32LE(outputData, static_cast<std::uint32_t>(inLen));
+    return true;
+}
+
 void
 float16ToFloat32(const std::uint16_t* inputData, float* outputData, std::size_t numElements)
 {
@@ -468,6 +468,14 @@ UsdData::addNgp()
     return { index, ngps[index] };
 }
 
+std::pair<int, PointInstancer&>
+UsdData::addPointInstancer()
+{
+    int index = pointInstancers.size();
+    pointInstancers.push_back(PointInstancer());
+    return { index, pointInstancers[index] };
+}
+
 std::string
 _makeValidPrimName(const std::string& name, const std::string& defaultName)
 {
@@ -665,6 +673,10 @@ uniquifyNames(UsdData& data)
         light.name = nodeName;
         light.displayName = displayName;
     }
+    // Point instancers are children of a node with a unique name as well
+    for (PointInstancer& instancer : data.pointInstancers) {
+        instancer.name = _makeValidPrimName(instancer.name, "PointInstancer");
+    }
     _uniquifySiblings(data.materials, "Material");
     _uniquifySiblings(data.skeletons, "Skeleton");
 
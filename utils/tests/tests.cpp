@@ -12,17 +12,30 @@ governing permissions and limitations under the License.
 #include <fileformatutils/test.h>
 #include <gtest/gtest.h>
 
+#include <fileformatutils/geometry.h>
+#include <fileformatutils/gsplatHelper.h>
+#include <fileformatutils/layerRead.h>
 #include <fileformatutils/layerWriteSdfData.h>
 #include <fileformatutils/layerWriteShared.h>
+#include <fileformatutils/neuralAssetsHelper.h>
 
+#include <pxr/base/gf/rotation.h>
 #include <pxr/base/gf/vec3f.h>
+#include <pxr/base/tf/stringUtils.h>
 #include <pxr/usd/sdf/data.h>
 #include <pxr/usd/sdf/fileFormat.h>
 #include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
 
+#include <sh/spherical_harmonics.h>
+
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
 
 // Run with this turned on to (re-)generate the baselines
 #define UPDATE_USDA_BASELINES 0
@@ -285,4 +298,662 @@ TEST(FileFormatUtilsTests, writeOpenPBR)
     layer->SetDocumentation("");
 
     ASSERT_USDA(layer, "data/baseline_writeOpenPBR.usda");
-}
\ No newline at end of file
+}
+
+TEST(FileFormatUtilsTests, writeExtent)
+{
+    UsdData data;
+    auto [modelIndex, model] = data.addNode(-1);
+    model.name = "Model";
+    auto [triangleIndex, triangle] = data.addMesh();
+    triangle.name = "Triangle";
+    triangle.points = { GfVec3f(-1, 0, 2), GfVec3f(3, 1, 0), GfVec3f(0, -2, 1) };
+    triangle.faces = { 3 };
+    triangle.indices = { 0, 1, 2 };
+    auto [cloudIndex, cloud] = data.addMesh();
+    cloud.name = "Cloud";
+    cloud.asPoints = true;
+    cloud.points = { GfVec3f(0, 0, 0), GfVec3f(1, 1, 1) };
+    cloud.pointWidths = { 0.5f, 2.0f };
+    data.nodes[modelIndex].staticMeshes = { triangleIndex, cloudIndex };
+
+    // A payload node holding a copy of the points, and an external one with the extent of its asset
+    auto [lazyIndex, lazy] = data.addNode(-1);
+    lazy.name = "Lazy";
+    lazy.payload = true;
+    lazy.staticMeshes = { cloudIndex };
+    auto [remoteIndex, remote] = data.addNode(-1);
+    remote.name = "Remote";
+    remote.payload = true;
+    remote.payloadAssetPath = "remote.usda";
+    remote.payloadExtent = GfRange3f(GfVec3f(-5, -5, -5), GfVec3f(5, 6, 7));
+
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("Extent.usda");
+    SdfAbstractDataRefPtr sdfData(new SdfData());
+    WriteLayerOptions options;
+    writeLayer(
+      options, data, &*layer, sdfData, "Test Data", "Testing", TestFileFormat::SetLayerData);
+    std::map<std::string, VtVec3fArray> extents;
+    std::map<std::string, VtVec3fArray> extentsHints;
+    layer->Traverse(SdfPath::AbsoluteRootPath(), [&](const SdfPath& path) {
+        if (!path.IsPropertyPath()) {
+            return;
+        }
+        SdfAttributeSpecHandle attr = layer->GetAttributeAtPath(path);
+        const std::string primName = path.GetPrimPath().GetName();
+        if (path.GetNameToken() == UsdGeomTokens->extent) {
+            extents[primName] = attr->GetDefaultValue().Get<VtVec3fArray>();
+        } else if (path.GetNameToken() == UsdGeomTokens->extentsHint) {
+            extentsHints[primName] = attr->GetDefaultValue().Get<VtVec3fArray>();
+        }
+    });
+
+    // The points are padded by the largest point radius
+    const VtVec3fArray triangleExtent = { GfVec3f(-1, -2, 0), GfVec3f(3, 1, 2) };
+    const VtVec3fArray cloudExtent = { GfVec3f(-1, -1, -1), GfVec3f(2, 2, 2) };
+    ASSERT_EQ(extents["Triangle"], triangleExtent);
+    ASSERT_EQ(extents["Cloud"], cloudExtent);
+    ASSERT_EQ(extentsHints.count("Model"), 0u);
+    ASSERT_EQ(extentsHints["Lazy"], cloudExtent);
+    const VtVec3fArray remoteExtent = { GfVec3f(-5, -5, -5), GfVec3f(5, 6, 7) };
+    ASSERT_EQ(extentsHints["Remote"], remoteExtent);
+}
+
+TEST(FileFormatUtilsTests, readPointInstancerMask)
+{
+    // Five instances of a triangle along the x axis, of which the second is invisible and the
+    // fourth inactive
+    UsdStageRefPtr stage = UsdStage::CreateInMemory("Instancer.usda");
+    UsdGeomPointInstancer instancer =
+      UsdGeomPointInstancer::Define(stage, SdfPath("/Instancer"));
+    UsdGeomMesh triangle = UsdGeomMesh::Define(stage, SdfPath("/Instancer/Prototypes/Triangle"));
+    triangle.CreatePointsAttr(
+      VtValue(VtVec3fArray{ GfVec3f(0, 0, 0), GfVec3f(1, 0, 0), GfVec3f(0, 1, 0) }));
+    triangle.CreateFaceVertexCountsAttr(VtValue(VtIntArray{ 3 }));
+    triangle.CreateFaceVertexIndicesAttr(VtValue(VtIntArray{ 0, 1, 2 }));
+    instancer.CreatePrototypesRel().AddTarget(triangle.GetPath());
+    VtVec3fArray positions;
+    VtVec3fArray scales;
+    for (int i = 0; i < 5; i++) {
+        positions.push_back(GfVec3f(i, 0, 0));
+        scales.push_back(GfVec3f(i + 1));
+    }
+    instancer.CreateProtoIndicesAttr(VtValue(VtIntArray(5, 0)));
+    instancer.CreatePositionsAttr(VtValue(positions));
+    instancer.CreateScalesAttr(VtValue(scales));
+    instancer.CreateInvisibleIdsAttr(VtValue(VtInt64Array{ 1 }));
+    instancer.DeactivateId(3);
+
+    // The point instancer keeps only the visible and active instances
+    ReadLayerOptions options;
+    options.pointInstancers = true;
+    UsdData data;
+    ASSERT_TRUE(readLayer(options, *stage->GetRootLayer(), data, "Testing"));
+    ASSERT_EQ(data.pointInstancers.size(), 1u);
+    const PointInstancer& readInstancer = data.pointInstancers[0];
+    ASSERT_EQ(readInstancer.protoIndices, VtIntArray(3, 0));
+    const VtVec3fArray expectedPositions = { GfVec3f(0, 0, 0), GfVec3f(2, 0, 0), GfVec3f(4, 0, 0) };
+    const VtVec3fArray expectedScales = { GfVec3f(1), GfVec3f(3), GfVec3f(5) };
+    ASSERT_EQ(readInstancer.positions, expectedPositions);
+    ASSERT_EQ(readInstancer.scales, expectedScales);
+    ASSERT_TRUE(readInstancer.orientations.empty());
+
+    // So do the nodes that the instances are expanded into
+    UsdData expanded;
+    ASSERT_TRUE(readLayer(ReadLayerOptions(), *stage->GetRootLayer(), expanded, "Testing"));
+    std::vector<GfVec3d> translations;
+    for (const Node& node : expanded.nodes) {
+        if (TfStringStartsWith(node.name, "MeshTransform")) {
+            translations.push_back(node.transform.ExtractTranslation());
+        }
+    }
+    const std::vector<GfVec3d> expectedTranslations = { GfVec3d(2, 0, 0), GfVec3d(4, 0, 0) };
+    ASSERT_EQ(translations, expectedTranslations);
+}
+
+TEST(FileFormatUtilsTests, partitionMesh)
+{
+    // A 16x16 grid of quads with a uniform primvar and a subset covering every other face
+    const int gridSize = 16;
+    Mesh mesh;
+    mesh.name = "Grid";
+    for (int y = 0; y <= gridSize; y++) {
+        for (int x = 0; x <= gridSize; x++) {
+            mesh.points.push_back(GfVec3f(x, y, 0.0f));
+        }
+    }
+    Subset subset;
+    subset.material = 0;
+    mesh.uvs.interpolation = UsdGeomTokens->uniform;
+    for (int y = 0; y < gridSize; y++) {
+        for (int x = 0; x < gridSize; x++) {
+            const int p = y * (gridSize + 1) + x;
+            mesh.faces.push_back(4);
+            mesh.indices.push_back(p);
+            mesh.indices.push_back(p + 1);
+            mesh.indices.push_back(p + gridSize + 2);
+            mesh.indices.push_back(p + gridSize + 1);
+            mesh.uvs.values.push_back(GfVec2f(x, y));
+            if ((x + y) % 2 == 0) {
+                subset.faces.push_back(y * gridSize + x);
+            }
+        }
+    }
+    mesh.subsets.push_back(subset);
+
+    std::vector<Mesh> chunks;
+    ASSERT_FALSE(partitionMesh(mesh, gridSize * gridSize, chunks));
+    ASSERT_TRUE(partitionMesh(mesh, 64, chunks));
+    ASSERT_EQ(chunks.size(), 4u);
+
+    size_t totalFaces = 0;
+    size_t totalSubsetFaces = 0;
+    for (const Mesh& chunk : chunks) {
+        ASSERT_EQ(chunk.faces.size(), 64u);
+        ASSERT_EQ(chunk.indices.size(), 256u);
+        ASSERT_EQ(chunk.uvs.values.size(), 64u);
+        // Morton order over a regular grid yields 8x8 blocks of quads
+        ASSERT_EQ(chunk.points.size(), 81u);
+        ASSERT_EQ(chunk.extent.GetSize(), GfVec3f(8.0f, 8.0f, 0.0f));
+        for (size_t i = 0; i < chunk.faces.size(); i++) {
+            // The uvs hold the position of the lower left corner of each quad
+            const GfVec3f& corner = chunk.points[chunk.indices[4 * i]];
+            ASSERT_EQ(GfVec2f(corner[0], corner[1]), chunk.uvs.values[i]);
+        }
+        ASSERT_EQ(chunk.subsets.size(), 1u);
+        totalFaces += chunk.faces.size();
+        totalSubsetFaces += chunk.subsets[0].faces.size();
+    }
+    ASSERT_EQ(totalFaces, mesh.faces.size());
+    ASSERT_EQ(totalSubsetFaces, subset.faces.size());
+}
+
+TEST(FileFormatUtilsTests, buildPointLevels)
+{
+    // A 16x16x16 grid of Gaussian splats, with the index of each splat as its opacity
+    const int gridSize = 16;
+    Mesh mesh;
+    mesh.name = "Splats";
+    mesh.asPoints = true;
+    mesh.asGsplats = true;
+    Primvar<float> opacities;
+    opacities.interpolation = UsdGeomTokens->vertex;
+    for (int z = 0; z < gridSize; z++) {
+        for (int y = 0; y < gridSize; y++) {
+            for (int x = 0; x < gridSize; x++) {
+                opacities.values.push_back(static_cast<float>(mesh.points.size()));
+                mesh.points.push_back(GfVec3f(x, y, z));
+            }
+        }
+    }
+    mesh.opacities.push_back(opacities);
+
+    std::vector<Mesh> levels;
+    ASSERT_TRUE(buildPointLevels(mesh, 3, levels));
+    ASSERT_EQ(levels.size(), 3u);
+    // The coarse levels hold one splat per cell of the 4x4x4 and the 8x8x8 octree levels
+    ASSERT_EQ(levels[0].points.size(), 64u);
+    ASSERT_EQ(levels[1].points.size(), 512u - 64u);
+
+    std::vector<int> counts(mesh.points.size(), 0);
+    for (const Mesh& level : levels) {
+        ASSERT_TRUE(level.asGsplats);
+        ASSERT_EQ(level.opacities.size(), 1u);
+        ASSERT_EQ(level.opacities[0].values.size(), level.points.size());
+        for (size_t i = 0; i < level.points.size(); i++) {
+            const size_t index = static_cast<size_t>(level.opacities[0].values[i]);
+            ASSERT_EQ(level.points[i], mesh.points[index]);
+            counts[index]++;
+        }
+    }
+    // The levels are additive, each splat is in exactly one of them
+    for (int count : counts) {
+        ASSERT_EQ(count, 1);
+    }
+}
+
+TEST(FileFormatUtilsTests, buildPointCloudLevels)
+{
+    // A 16x16x16 grid of points, followed by a triangle that is not split
+    auto fillData = [](UsdData& data) {
+        const int gridSize = 16;
+        auto [nodeIndex, node] = data.addNode(-1);
+        node.name = "Scan";
+        auto [pointsIndex, points] = data.addMesh();
+        points.name = "Points";
+        points.asPoints = true;
+        for (int z = 0; z < gridSize; z++) {
+            for (int y = 0; y < gridSize; y++) {
+                for (int x = 0; x < gridSize; x++) {
+                    points.points.push_back(GfVec3f(x, y, z));
+                }
+            }
+        }
+        auto [triangleIndex, triangle] = data.addMesh();
+        triangle.name = "Triangle";
+        triangle.points = { GfVec3f(0, 0, 0), GfVec3f(1, 0, 0), GfVec3f(0, 1, 0) };
+        triangle.faces = { 3 };
+        triangle.indices = { 0, 1, 2 };
+        data.nodes[nodeIndex].staticMeshes = { pointsIndex, triangleIndex };
+    };
+
+    // Reading all levels adds a child node per level, which loads the level as an external payload
+    // and holds no points. The source points are removed and the triangle is remapped.
+    UsdData all;
+    fillData(all);
+    buildPointCloudLevels(all, 3, -1, [](size_t level) {
+        return "scan.ply:SDF_FORMAT_ARGS:level=" + std::to_string(level);
+    });
+    ASSERT_EQ(all.meshes.size(), 1u);
+    ASSERT_EQ(all.meshes[0].name, "Triangle");
+    ASSERT_EQ(all.nodes[0].staticMeshes, std::vector<int>{ 0 });
+    ASSERT_EQ(all.nodes[0].children.size(), 3u);
+    GfRange3f bounds;
+    for (size_t k = 0; k < 3; k++) {
+        const Node& levelNode = all.nodes[all.nodes[0].children[k]];
+        ASSERT_EQ(levelNode.name, "lod" + std::to_string(k));
+        ASSERT_TRUE(levelNode.payload);
+        ASSERT_EQ(levelNode.payloadAssetPath,
+                  "scan.ply:SDF_FORMAT_ARGS:level=" + std::to_string(k));
+        ASSERT_TRUE(levelNode.staticMeshes.empty());
+        ASSERT_FALSE(levelNode.payloadExtent.IsEmpty());
+        bounds.UnionWith(levelNode.payloadExtent);
+    }
+    ASSERT_EQ(bounds, GfRange3f(GfVec3f(0, 0, 0), GfVec3f(15, 15, 15)));
+
+    // The levels are authored as payloads of the prims of the same path in the level assets
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("Scan.usda");
+    SdfAbstractDataRefPtr sdfData(new SdfData());
+    WriteLayerOptions options;
+    writeLayer(
+      options, all, &*layer, sdfData, "Test Data", "Testing", TestFileFormat::SetLayerData);
+    size_t numPayloads = 0;
+    layer->Traverse(SdfPath::AbsoluteRootPath(), [&](const SdfPath& path) {
+        SdfPrimSpecHandle prim = layer->GetPrimAtPath(path);
+        if (!prim || !prim->HasPayloads()) {
+            return;
+        }
+        const SdfPayloadVector payloads = prim->GetPayloadList().GetPrependedItems();
+        ASSERT_EQ(payloads.size(), 1u);
+        ASSERT_EQ(payloads[0].GetAssetPath(),
+                  "scan.ply:SDF_FORMAT_ARGS:level=" + path.GetName().substr(3));
+        ASSERT_EQ(payloads[0].GetPrimPath(), path);
+        ASSERT_TRUE(prim->GetChildren().empty());
+        numPayloads++;
+    });
+    ASSERT_EQ(numPayloads, 3u);
+
+    // Reading a single level keeps only its points, in the child node of that level
+    UsdData single;
+    fillData(single);
+    buildPointCloudLevels(single, 3, 1);
+    ASSERT_EQ(single.meshes.size(), 2u);
+    ASSERT_EQ(single.meshes[0].name, "Triangle");
+    ASSERT_EQ(single.nodes[0].staticMeshes, std::vector<int>{ 0 });
+    ASSERT_EQ(single.nodes[0].children.size(), 3u);
+    for (size_t k = 0; k < 3; k++) {
+        const Node& levelNode = single.nodes[single.nodes[0].children[k]];
+        ASSERT_FALSE(levelNode.payload);
+        ASSERT_EQ(levelNode.staticMeshes.size(), k == 1 ? 1u : 0u);
+    }
+    ASSERT_EQ(single.meshes[1].points.size(), 512u - 64u);
+}
+
+TEST(FileFormatUtilsTests, rotatePointSphericalHarmonics)
+{
+    // Degree 3 coefficients of a few thousand splats, which spans multiple blocks of points
+    const size_t numPoints = 3000;
+    const size_t numCoeffs = 45;
+    std::vector<Primvar<float>> sh(numCoeffs);
+    for (size_t k = 0; k < numCoeffs; k++) {
+        sh[k].interpolation = UsdGeomTokens->vertex;
+        for (size_t i = 0; i < numPoints; i++) {
+            sh[k].values.push_back(std::sin(static_cast<float>(i * numCoeffs + k)));
+        }
+    }
+
+    const GfQuatf rotation =
+      GfQuatf(GfRotation(GfVec3d(1.0, 2.0, 3.0).GetNormalized(), 40.0).GetQuat());
+    std::vector<VtFloatArray> rotated(numCoeffs);
+    rotatePointSphericalHarmonics(sh, rotation, numPoints, rotated);
+
+    std::vector<Primvar<float>> rotatedSH(numCoeffs);
+    for (size_t k = 0; k < numCoeffs; k++) {
+        rotatedSH[k].interpolation = UsdGeomTokens->vertex;
+        rotatedSH[k].values = rotated[k];
+    }
+    std::vector<VtFloatArray> restored(numCoeffs);
+    rotatePointSphericalHarmonics(rotatedSH, rotation.GetInverse(), numPoints, restored);
+
+    // The reference rotates the coefficients of each point and channel with the
+    // SphericalHarmonics library, which takes them from the zeroth order coefficient on
+    Eigen::Quaterniond quatRot(rotation.GetReal(),
+                               rotation.GetImaginary()[0],
+                               rotation.GetImaginary()[1],
+                               rotation.GetImaginary()[2]);
+    quatRot.normalize();
+    const auto shRot = sh::Rotation::Create(3, quatRot);
+    std::vector<float> coeffs(16);
+    std::vector<float> expected(16);
+
+    for (size_t i = 0; i < numPoints; i++) {
+        for (size_t channel = 0; channel < 3; channel++) {
+            coeffs[0] = 0.0f;
+            for (size_t k = 0; k < 15; k++) {
+                coeffs[k + 1] = sh[channel * 15 + k].values[i];
+            }
+            shRot->Apply(coeffs, &expected);
+            for (size_t k = 0; k < 15; k++) {
+                ASSERT_NEAR(rotated[channel * 15 + k][i], expected[k + 1], 1e-4f);
+            }
+            // Rotations preserve the norm of each band
+            for (size_t l = 1; l <= 3; l++) {
+                float norm = 0.0f;
+                float rotatedNorm = 0.0f;
+                for (size_t k = l * l - 1; k < (l + 1) * (l + 1) - 1; k++) {
+                    norm += sh[channel * 15 + k].values[i] * sh[channel * 15 + k].values[i];
+                    rotatedNorm += rotated[channel * 15 + k][i] * rotated[channel * 15 + k][i];
+                }
+                ASSERT_NEAR(norm, rotatedNorm, 1e-4f);
+            }
+        }
+        for (size_t k = 0; k < numCoeffs; k++) {
+            ASSERT_NEAR(restored[k][i], sh[k].values[i], 1e-4f);
+        }
+    }
+}
+
+TEST(FileFormatUtilsTests, pruneGsplats)
+{
+    // Splats along the x axis, with opacities and widths that cycle through a few values
+    const size_t numPoints = 3000;
+    Mesh mesh;
+    mesh.asPoints = true;
+    mesh.asGsplats = true;
+    Primvar<float> opacities;
+    opacities.interpolation = UsdGeomTokens->vertex;
+    Primvar<float> extraWidths;
+    extraWidths.interpolation = UsdGeomTokens->vertex;
+    for (size_t i = 0; i < numPoints; i++) {
+        mesh.points.push_back(GfVec3f(static_cast<float>(i), 0.0f, 0.0f));
+        opacities.values.push_back(i % 2 ? 0.5f : 0.001f);
+        mesh.pointWidths.push_back(0.01f);
+        extraWidths.values.push_back(i % 3 ? 0.2f : 0.002f);
+    }
+    mesh.opacities.push_back(opacities);
+    mesh.pointExtraWidths.push_back(extraWidths);
+    mesh.clippingBox.values = { GfVec3f(0.0f, -1.0f, -1.0f), GfVec3f(1999.0f, 1.0f, 1.0f) };
+
+    GsplatPruneOptions options;
+    options.minOpacity = 0.01f;
+    options.minScale = 0.05f;
+    options.cullToClippingBox = true;
+    const size_t numPruned = pruneGsplats(mesh, options);
+
+    // Odd indices that are not a multiple of 3 within the clipping box remain
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < 2000; i++) {
+        if (i % 2 && i % 3) {
+            kept.push_back(i);
+        }
+    }
+    ASSERT_EQ(numPruned, numPoints - kept.size());
+    ASSERT_EQ(mesh.points.size(), kept.size());
+    ASSERT_EQ(mesh.pointWidths.size(), kept.size());
+    ASSERT_EQ(mesh.opacities[0].values.size(), kept.size());
+    ASSERT_EQ(mesh.pointExtraWidths[0].values.size(), kept.size());
+    for (size_t i = 0; i < kept.size(); i++) {
+        ASSERT_EQ(mesh.points[i][0], static_cast<float>(kept[i]));
+    }
+    ASSERT_EQ(mesh.extent.GetMin()[0], static_cast<float>(kept.front()));
+    ASSERT_EQ(mesh.extent.GetMax()[0], static_cast<float>(kept.back()));
+}
+
+TEST(FileFormatUtilsTests, truncatedSHCoeffIndices)
+{
+    // Degree 3 coefficients keep the first 3 of the 15 coefficients of each channel at degree 1
+    const std::vector<size_t> degree1 = truncatedSHCoeffIndices(45, 1);
+    ASSERT_EQ(degree1, std::vector<size_t>({ 0, 1, 2, 15, 16, 17, 30, 31, 32 }));
+    ASSERT_EQ(truncatedSHCoeffCount(45, 1), 9u);
+    ASSERT_EQ(truncatedSHCoeffCount(45, 0), 0u);
+    ASSERT_TRUE(truncatedSHCoeffIndices(24, 0).empty());
+    // Coefficients up to the maximum degree are all kept
+    ASSERT_EQ(truncatedSHCoeffCount(24, 3), 24u);
+    ASSERT_EQ(truncatedSHCoeffIndices(24, 2).size(), 24u);
+}
+
+TEST(FileFormatUtilsTests, packedGsplatSHCoeffs)
+{
+    // Gaussian splats with the 9 SH coefficients of degree 1
+    const size_t numPoints = 100;
+    const size_t numCoeffs = 9;
+    UsdData data;
+    auto [meshIndex, mesh] = data.addMesh();
+    mesh.name = "Splats";
+    mesh.asPoints = true;
+    mesh.asGsplats = true;
+    mesh.pointRotations.interpolation = UsdGeomTokens->vertex;
+    for (size_t i = 0; i < numPoints; i++) {
+        mesh.points.push_back(GfVec3f(static_cast<float>(i), 0.0f, 0.0f));
+        mesh.pointWidths.push_back(0.1f);
+        mesh.pointRotations.values.push_back(GfQuatf(1.0f));
+    }
+    for (size_t k = 0; k < 2; k++) {
+        Primvar<float> extraWidths;
+        extraWidths.interpolation = UsdGeomTokens->vertex;
+        extraWidths.values.assign(numPoints, 0.1f);
+        mesh.pointExtraWidths.push_back(extraWidths);
+    }
+    for (size_t k = 0; k < numCoeffs; k++) {
+        Primvar<float> shCoeffs;
+        shCoeffs.interpolation = UsdGeomTokens->vertex;
+        for (size_t i = 0; i < numPoints; i++) {
+            shCoeffs.values.push_back(static_cast<float>(i * numCoeffs + k));
+        }
+        mesh.pointSHCoeffs.push_back(shCoeffs);
+    }
+    auto [nodeIndex, node] = data.addNode(-1);
+    node.name = "Root";
+    node.staticMeshes.push_back(meshIndex);
+
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("Scene.usda");
+    SdfAbstractDataRefPtr sdfData(new SdfData());
+    WriteLayerOptions options;
+    options.packedGsplatSHCoeffs = true;
+    writeLayer(
+      options, data, &*layer, sdfData, "Test Data", "Testing", TestFileFormat::SetLayerData);
+
+    // A single primvar holds all coefficients, with an element per splat
+    std::vector<SdfPath> shPaths;
+    layer->Traverse(SdfPath::AbsoluteRootPath(), [&](const SdfPath& path) {
+        if (path.IsPropertyPath() && TfStringStartsWith(path.GetName(), "primvars:fRest")) {
+            shPaths.push_back(path);
+        }
+    });
+    ASSERT_EQ(shPaths.size(), 1u);
+    ASSERT_EQ(shPaths[0].GetName(), "primvars:fRest");
+    ASSERT_EQ(layer->GetAttributeAtPath(shPaths[0])->GetInfo(UsdGeomTokens->elementSize),
+              VtValue(static_cast<int>(numCoeffs)));
+
+    // Reading the layer unpacks the coefficients again
+    UsdData readData;
+    ASSERT_TRUE(readLayer(ReadLayerOptions(), *layer, readData, "Testing"));
+    ASSERT_EQ(readData.meshes.size(), 1u);
+    const Mesh& readMesh = readData.meshes[0];
+    ASSERT_TRUE(readMesh.asGsplats);
+    ASSERT_EQ(readMesh.pointSHCoeffs.size(), numCoeffs);
+    for (size_t k = 0; k < numCoeffs; k++) {
+        ASSERT_EQ(readMesh.pointSHCoeffs[k].values.size(), numPoints);
+        for (size_t i = 0; i < numPoints; i++) {
+            ASSERT_EQ(readMesh.pointSHCoeffs[k].values[i], static_cast<float>(i * numCoeffs + k));
+        }
+    }
+}
+
+TEST(FileFormatUtilsTests, halfPrecisionGsplats)
+{
+    // Gaussian splats with values that are exact in half precision
+    const size_t numPoints = 64;
+    const size_t numCoeffs = 9;
+    UsdData data;
+    auto [meshIndex, mesh] = data.addMesh();
+    mesh.name = "Splats";
+    mesh.asPoints = true;
+    mesh.asGsplats = true;
+    mesh.pointRotations.interpolation = UsdGeomTokens->vertex;
+    for (size_t i = 0; i < numPoints; i++) {
+        mesh.points.push_back(GfVec3f(static_cast<float>(i), 0.0f, 0.0f));
+        mesh.pointWidths.push_back(0.125f);
+        mesh.pointRotations.values.push_back(GfQuatf(1.0f));
+    }
+    for (size_t k = 0; k < 2; k++) {
+        Primvar<float> extraWidths;
+        extraWidths.interpolation = UsdGeomTokens->vertex;
+        extraWidths.values.assign(numPoints, 0.125f);
+        mesh.pointExtraWidths.push_back(extraWidths);
+    }
+    Primvar<GfVec3f>& colors = data.addColorSet(meshIndex).second;
+    colors.interpolation = UsdGeomTokens->vertex;
+    Primvar<float>& opacities = data.addOpacitySet(meshIndex).second;
+    opacities.interpolation = UsdGeomTokens->vertex;
+    for (size_t i = 0; i < numPoints; i++) {
+        colors.values.push_back(GfVec3f(i / 64.0f, 0.5f, 1.0f - i / 64.0f));
+        opacities.values.push_back(i / 128.0f);
+    }
+    for (size_t k = 0; k < numCoeffs; k++) {
+        Primvar<float>& shCoeffs = data.addPointSHCoeffSet(meshIndex).second;
+        shCoeffs.interpolation = UsdGeomTokens->vertex;
+        for (size_t i = 0; i < numPoints; i++) {
+            shCoeffs.values.push_back(static_cast<float>(i) - static_cast<float>(k) * 0.25f);
+        }
+    }
+    auto [nodeIndex, node] = data.addNode(-1);
+    node.name = "Root";
+    node.staticMeshes.push_back(meshIndex);
+
+    // The float sets are replaced by the half precision sets
+    convertGsplatsToHalf(data.meshes[meshIndex]);
+    const Mesh& halfMesh = data.meshes[meshIndex];
+    ASSERT_TRUE(halfMesh.colors.empty());
+    ASSERT_TRUE(halfMesh.opacities.empty());
+    ASSERT_TRUE(halfMesh.pointSHCoeffs.empty());
+    ASSERT_EQ(halfMesh.halfColors.size(), 1u);
+    ASSERT_EQ(halfMesh.halfOpacities.size(), 1u);
+    ASSERT_EQ(halfMesh.halfPointSHCoeffs.size(), numCoeffs);
+
+    SdfLayerRefPtr layer = SdfLayer::CreateAnonymous("Scene.usda");
+    SdfAbstractDataRefPtr sdfData(new SdfData());
+    writeLayer(WriteLayerOptions(),
+               data,
+               &*layer,
+               sdfData,
+               "Test Data",
+               "Testing",
+               TestFileFormat::SetLayerData);
+
+    // The half precision sets are authored as half primvars
+    std::map<std::string, SdfValueTypeName> typeNames;
+    layer->Traverse(SdfPath::AbsoluteRootPath(), [&](const SdfPath& path) {
+        if (path.IsPropertyPath() && TfStringStartsWith(path.GetName(), "primvars:")) {
+            typeNames[path.GetName()] = layer->GetAttributeAtPath(path)->GetTypeName();
+        }
+    });
+    auto typeNameOf = [&](const std::string& name) {
+        auto it = typeNames.find(name);
+        return it != typeNames.end() ? it->second : SdfValueTypeName();
+    };
+    ASSERT_EQ(typeNameOf("primvars:displayColor"), SdfValueTypeNames->Color3hArray);
+    ASSERT_EQ(typeNameOf("primvars:displayOpacity"), SdfValueTypeNames->HalfArray);
+    for (size_t k = 0; k < numCoeffs; k++) {
+        ASSERT_EQ(typeNameOf("primvars:fRest" + std::to_string(k)), SdfValueTypeNames->HalfArray);
+    }
+
+    // Reading the layer widens the half primvars to the float sets again
+    UsdData readData;
+    ASSERT_TRUE(readLayer(ReadLayerOptions(), *layer, readData, "Testing"));
+    ASSERT_EQ(readData.meshes.size(), 1u);
+    const Mesh& readMesh = readData.meshes[0];
+    ASSERT_TRUE(readMesh.asGsplats);
+    ASSERT_EQ(readMesh.colors.size(), 1u);
+    ASSERT_EQ(readMesh.opacities.size(), 1u);
+    ASSERT_EQ(readMesh.pointSHCoeffs.size(), numCoeffs);
+    ASSERT_EQ(readMesh.colors[0].values.size(), numPoints);
+    ASSERT_EQ(readMesh.opacities[0].values.size(), numPoints);
+    for (size_t i = 0; i < numPoints; i++) {
+        ASSERT_EQ(readMesh.colors[0].values[i], GfVec3f(i / 64.0f, 0.5f, 1.0f - i / 64.0f));
+        ASSERT_EQ(readMesh.opacities[0].values[i], i / 128.0f);
+    }
+    for (size_t k = 0; k < numCoeffs; k++) {
+        ASSERT_EQ(readMesh.pointSHCoeffs[k].values.size(), numPoints);
+        for (size_t i = 0; i < numPoints; i++) {
+            ASSERT_EQ(readMesh.pointSHCoeffs[k].values[i],
+                      static_cast<float>(i) - static_cast<float>(k) * 0.25f);
+        }
+    }
+}
+
+TEST(FileFormatUtilsTests, sortPointsByMortonCode)
+{
+    // A 32x32x32 grid of splats in a shuffled order, with the index of each splat as its opacity
+    const int gridSize = 32;
+    std::vector<GfVec3f> grid;
+    for (int z = 0; z < gridSize; z++) {
+        for (int y = 0; y < gridSize; y++) {
+            for (int x = 0; x < gridSize; x++) {
+                grid.push_back(GfVec3f(x, y, z));
+            }
+        }
+    }
+    std::vector<size_t> shuffled(grid.size());
+    for (size_t i = 0; i < shuffled.size(); i++) {
+        // 7919 is prime, so this is a permutation
+        shuffled[i] = (i * 7919) % grid.size();
+    }
+    Mesh mesh;
+    mesh.asPoints = true;
+    mesh.asGsplats = true;
+    Primvar<float> opacities;
+    opacities.interpolation = UsdGeomTokens->vertex;
+    for (size_t i = 0; i < shuffled.size(); i++) {
+        mesh.points.push_back(grid[shuffled[i]]);
+        mesh.pointWidths.push_back(static_cast<float>(i));
+        opacities.values.push_back(static_cast<float>(i));
+    }
+    mesh.opacities.push_back(opacities);
+    const VtVec3fArray points = mesh.points;
+
+    ASSERT_TRUE(sortPointsByMortonCode(mesh));
+    ASSERT_EQ(mesh.points.size(), points.size());
+    ASSERT_EQ(mesh.opacities[0].values.size(), points.size());
+    std::vector<uint64_t> codes;
+    computeMortonCodes(mesh.points, computeExtent(mesh.points), codes);
+    for (size_t i = 0; i < mesh.points.size(); i++) {
+        // The points are sorted, and each keeps its own primvar values
+        if (i > 0) {
+            ASSERT_LE(codes[i - 1], codes[i]);
+        }
+        const size_t index = static_cast<size_t>(mesh.opacities[0].values[i]);
+        ASSERT_EQ(mesh.points[i], points[index]);
+        ASSERT_EQ(mesh.pointWidths[i], mesh.opacities[0].values[i]);
+    }
+}
+
+TEST(FileFormatUtilsTests, compressGzip)
+{
+    // Several blocks of the parallel deflate, with repeated and irregular data
+    std::vector<std::uint8_t> input(3 * (1 << 20) + 123);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<std::uint8_t>(i % 7 == 0 ? (i * 2654435761u) >> 24 : (i / 3) % 50);
+    }
+    for (int level : { -1, 0, 1, 9 }) {
+        for (bool parallel : { false, true }) {
+            std::vector<std::uint8_t> compressed;
+            ASSERT_TRUE(compressGzip(input.data(), input.size(), level, parallel, compressed));
+            std::vector<std::uint8_t> decompressed;
+            ASSERT_TRUE(decompress(compressed.data(), compressed.size(), decompressed));
+            ASSERT_EQ(decompressed, input);
+        }
+    }
+    std::vector<std::uint8_t> compressed;
+    ASSERT_FALSE(compressGzip(input.data(), input.size(), 10, false, compressed));
+}